@@ -275,10 +275,16 @@ namespace bq {
 #define BQ_HW_CRC_TARGET __attribute__((target("sse4.2")))
 #define BQ_HW_SIMD_TARGET __attribute__((target("avx2")))
 #define BQ_HW_SIMD_SSE_TARGET __attribute__((target("sse4.1")))
+#define BQ_HW_SIMD_AVX512_TARGET __attribute__((target("avx2,avx512f,avx512bw,avx512vl")))
+#define BQ_HW_AES_TARGET __attribute__((target("sse4.1,aes")))
+#define BQ_HW_VAES_TARGET __attribute__((target("avx2,avx512f,avx512bw,avx512vl,aes,vaes")))
 #else
 #define BQ_HW_CRC_TARGET
 #define BQ_HW_SIMD_TARGET
 #define BQ_HW_SIMD_SSE_TARGET
+#define BQ_HW_SIMD_AVX512_TARGET
+#define BQ_HW_AES_TARGET
+#define BQ_HW_VAES_TARGET
 #endif
 #define BQ_CRC_HW_INLINE inline
 #define BQ_SIMD_HW_INLINE inline
@@ -286,6 +292,9 @@ namespace bq {
 #define BQ_HW_CRC_TARGET
 #define BQ_HW_SIMD_TARGET
 #define BQ_HW_SIMD_SSE_TARGET
+#define BQ_HW_SIMD_AVX512_TARGET
+#define BQ_HW_AES_TARGET
+#define BQ_HW_VAES_TARGET
 #define BQ_CRC_HW_INLINE bq_forceinline
 #define BQ_SIMD_HW_INLINE bq_forceinline
 #endif
@@ -233,6 +233,23 @@ namespace bq {
         /// <returns>the decoded snapshot buffer</returns>
         bq::string take_snapshot(const bq::string& time_zone_config) const;
 
+        /// <summary>
+        /// Works only when snapshot is configured.
+        /// It will write the snapshot buffer to a raw binary log file (.lograw) without formatting it,
+        /// use the log decoders to turn it into text later.
+        /// </summary>
+        /// <param name="path">path of the file to write, it will be overwritten if it exists</param>
+        /// <returns>whether the file was written</returns>
+        bool take_snapshot_binary(const bq::string& path) const;
+
+        /// <summary>
+        /// Works only when "log.template_stats" is configured to true.
+        /// Count, serialized bytes and rate of the logs written since it was enabled, per format string, level and category,
+        /// as a text table with the largest first. Use it to find the call sites producing most of the log volume.
+        /// </summary>
+        /// <returns>the stats table</returns>
+        bq::string take_template_stats() const;
+
     public:
         /// Core log functions, there are 6 log levels:
         /// verbose, debug, info, warning, error, fatal
@@ -301,7 +318,8 @@ namespace bq {
             /// </summary>
             /// <param name="log_file_path">the path of a binary log file, is can be relative path or absolute path</param>
             /// <param name="priv_key">private key generated by "ssh-keygen" to decrypt encrypted log file, left it to empty when log file is not encrypted.</param>
-            log_decoder(const bq::string& log_file_path, const bq::string& priv_key = "");
+            /// <param name="filter">optional, only log entries matching it are returned by decode(), entries filtered out are not formatted at all. Zero fields match everything.</param>
+            log_decoder(const bq::string& log_file_path, const bq::string& priv_key = "", const bq::log_decode_filter* filter = nullptr);
             ~log_decoder();
             /// <summary>
             /// Decode a log entry. each call of this function will decode only 1 log entry
@@ -309,6 +327,27 @@ namespace bq {
             /// <returns>decode result, appender_decode_result::eof means the whole log file was decoded</returns>
             bq::appender_decode_result decode();
             /// <summary>
+            /// Move to the first log entry whose epoch is not earlier than epoch_ms, the next call of decode() returns it.
+            /// It works even if a previous decode() has reached eof.
+            /// </summary>
+            /// <param name="epoch_ms">epoch in milliseconds</param>
+            /// <returns>success if found, appender_decode_result::eof if all log entries are earlier than epoch_ms</returns>
+            bq::appender_decode_result seek_to_time(uint64_t epoch_ms);
+            /// <summary>
+            /// Decode a log entry like decode(), but when the whole file is decoded, wait up to timeout_ms for new log entries
+            /// written by a running process. New segments and rotation to the next indexed file are followed.
+            /// </summary>
+            /// <param name="timeout_ms">how long to wait for a new log entry</param>
+            /// <returns>success if decoded, appender_decode_result::eof on timeout, call it again to keep following</returns>
+            bq::appender_decode_result decode_follow(uint64_t timeout_ms);
+            /// <summary>
+            /// Choose what the following decode() calls produce: formatted text (default),
+            /// or a json_lines / csv record with the format string and the typed arguments.
+            /// </summary>
+            /// <param name="format">output format</param>
+            /// <returns>appender_decode_result::failed_invalid_handle if the decoder was not created</returns>
+            bq::appender_decode_result set_output_format(bq::log_decode_output_format format);
+            /// <summary>
             /// get the last decode result
             /// </summary>
             /// <returns></returns>
@@ -181,9 +181,10 @@ namespace bq {
         /// </summary>
         /// <param name="log_file_path"></param>
         /// <param name="priv_key"></param>
+        /// <param name="filter">can be null, only matching log entries are decoded, the filter is copied</param>
         /// <param name="out_handle">will be used in __api_log_decoder_decode and __api_log_decoder_destroy</param>
         /// <returns></returns>
-        BQ_API bq::appender_decode_result __api_log_decoder_create(const char* log_file_path, const char* priv_key, uint32_t* out_handle);
+        BQ_API bq::appender_decode_result __api_log_decoder_create(const char* log_file_path, const char* priv_key, const bq::log_decode_filter* filter, uint32_t* out_handle);
 
         /// <summary>
         /// decode binary log file
@@ -193,6 +194,49 @@ namespace bq {
         /// <returns>if result is not success, you should stop invoke this function, and call __api_log_decoder_destroy to release memory</returns>
         BQ_API bq::appender_decode_result __api_log_decoder_decode(uint32_t handle, bq::_api_string_def* out_decoded_log_text);
 
+        /// <summary>
+        /// move the decoder to the first log entry whose epoch is not earlier than epoch_ms, the entry is returned by the next __api_log_decoder_decode.
+        /// restart points written by the appender are used as a sparse index, so only a small part of the file is decoded.
+        /// </summary>
+        /// <param name="handle"></param>
+        /// <param name="epoch_ms">epoch in milliseconds</param>
+        /// <returns>success if found, eof if all log entries are earlier than epoch_ms</returns>
+        BQ_API bq::appender_decode_result __api_log_decoder_seek_to_time(uint32_t handle, uint64_t epoch_ms);
+
+        /// <summary>
+        /// same as __api_log_decoder_decode, but waits up to timeout_ms for the log file to grow when all of it is decoded.
+        /// new segments and rotation to the next indexed log file are followed.
+        /// </summary>
+        /// <param name="handle"></param>
+        /// <param name="timeout_ms">how long to wait for a new log entry</param>
+        /// <param name="out_decoded_log_text">same as __api_log_decoder_decode</param>
+        /// <returns>success if a log entry is decoded, eof on timeout, it can be called again after eof</returns>
+        BQ_API bq::appender_decode_result __api_log_decoder_decode_follow(uint32_t handle, uint64_t timeout_ms, bq::_api_string_def* out_decoded_log_text);
+
+        /// <summary>
+        /// decode up to max_entry_count log entries with one call, for wrappers paying a cost per native call.
+        /// the text of entry i is text_buffer[out_text_offsets[i], out_text_offsets[i + 1]), it is not '\0' terminated.
+        /// an entry which doesn't fit into text_buffer is returned by the next call. if not even the first one fits,
+        /// *out_entry_count is 0 and out_text_offsets[1] is the text_buffer_size needed, call again with a bigger buffer.
+        /// </summary>
+        /// <param name="handle"></param>
+        /// <param name="text_buffer">receives the texts of the entries back to back</param>
+        /// <param name="text_buffer_size">size of text_buffer in bytes</param>
+        /// <param name="out_text_offsets">array of max_entry_count + 1 elements</param>
+        /// <param name="out_entries">optional array of max_entry_count elements, receives time, thread, category and level of each entry</param>
+        /// <param name="max_entry_count">the most entries to decode</param>
+        /// <param name="out_entry_count">number of entries decoded</param>
+        /// <returns>success if any entry is decoded (or the buffer is too small), otherwise the same as __api_log_decoder_decode</returns>
+        BQ_API bq::appender_decode_result __api_log_decoder_decode_batch(uint32_t handle, char* text_buffer, uint32_t text_buffer_size, uint32_t* out_text_offsets, bq::log_decode_entry_info* out_entries, uint32_t max_entry_count, uint32_t* out_entry_count);
+
+        /// <summary>
+        /// Set what the decoder produces for each log entry from the next decoded one on, the default is text.
+        /// </summary>
+        /// <param name="handle"></param>
+        /// <param name="format">text, json_lines or csv, see README for the fields</param>
+        /// <returns>success, or failed_invalid_handle</returns>
+        BQ_API bq::appender_decode_result __api_log_decoder_set_output_format(uint32_t handle, bq::log_decode_output_format format);
+
         /// <summary>
         /// destroy decoder to release memory
         /// </summary>
@@ -268,6 +312,26 @@ namespace bq {
         /// <returns></returns>
         BQ_API void __api_release_snapshot_string(uint64_t log_id, bq::_api_string_def* snapshot_string);
 
+        /// <summary>
+        /// Write the snapshot entries to a raw binary log file (.lograw format) without formatting them.
+        /// Note: if snapshot is not enabled, nothing is written and false is returned.
+        /// </summary>
+        /// <param name="log_id"></param>
+        /// <param name="path_utf8">file path, relative paths are relative to the same base directory as file appenders with base_dir_type 0</param>
+        /// <returns>whether the file was written</returns>
+        BQ_API bool __api_take_snapshot_binary(uint64_t log_id, const char* path_utf8);
+
+        /// <summary>
+        /// Note: if "log.template_stats" is not enabled, this API will return empty string.
+        /// Must be called in pairs with __api_release_template_stats_string, same as __api_take_snapshot_string.
+        /// </summary>
+        /// <param name="log_id"></param>
+        /// <param name="out_stats_string">the stats table of log_template_stats</param>
+        /// <returns></returns>
+        BQ_API void __api_take_template_stats_string(uint64_t log_id, bq::_api_string_def* out_stats_string);
+
+        BQ_API void __api_release_template_stats_string(uint64_t log_id, bq::_api_string_def* stats_string);
+
         /// <summary>
         /// Get stack trace of current thread.
         /// The result is safe only in current thread until next call to this api.
@@ -145,6 +145,40 @@ namespace bq {
         failed_io_error
     };
 
+    /// <summary>
+    /// What binary log decoders produce for each log entry.
+    /// </summary>
+    enum class log_decode_output_format : uint8_t {
+        text, // formatted by the layout, the same as a text file appender
+        json_lines, // a json object with the typed arguments instead of the formatted message
+        csv // a csv row with the same fields as json_lines
+    };
+
+    /// <summary>
+    /// Filter applied by binary log decoders before log entries are formatted,
+    /// entries which don't match are skipped without any layout work.
+    /// A zero initialized field matches everything.
+    /// </summary>
+    struct log_decode_filter {
+        uint32_t level_mask; // bit (1 << bq::log_level) set for each accepted level
+        const char* category_prefixes; // ',' separated category name prefixes, "*" matches all, same rule as "categories_mask" config
+        uint64_t thread_id;
+        uint64_t begin_epoch_ms; // entries earlier than this are skipped
+        uint64_t end_epoch_ms; // entries not earlier than this are skipped
+        const uint64_t* format_hashes; // accepted hashes of format strings (bq::util::get_hash_64 of the utf8 or utf16 format string data)
+        uint32_t format_hash_count;
+    };
+
+    /// <summary>
+    /// Fields of a log entry decoded by __api_log_decoder_decode_batch.
+    /// </summary>
+    struct log_decode_entry_info {
+        uint64_t epoch_ms;
+        uint64_t thread_id;
+        uint32_t category_idx;
+        uint32_t level; // bq::log_level
+    };
+
     /// <summary>
     /// `content` is a C-style string and end with '\0';
     /// </summary>
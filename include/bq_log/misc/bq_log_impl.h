@@ -199,6 +199,21 @@ namespace bq {
         return result;
     }
 
+    inline bool log::take_snapshot_binary(const bq::string& path) const
+    {
+        return bq::api::__api_take_snapshot_binary(log_id_, path.c_str());
+    }
+
+    inline bq::string log::take_template_stats() const
+    {
+        bq::_api_string_def stats_def;
+        bq::api::__api_take_template_stats_string(log_id_, &stats_def);
+        bq::string result;
+        result.insert_batch(result.begin(), stats_def.str, stats_def.len);
+        bq::api::__api_release_template_stats_string(log_id_, &stats_def);
+        return result;
+    }
+
     template <typename STR>
     bq_forceinline bq::tuple<const char*, uint32_t> get_stack_trace()
     {
@@ -368,9 +383,9 @@ namespace bq {
     }
 
     namespace tools {
-        inline log_decoder::log_decoder(const bq::string& log_file_path, const bq::string& priv_key)
+        inline log_decoder::log_decoder(const bq::string& log_file_path, const bq::string& priv_key, const bq::log_decode_filter* filter)
         {
-            result_ = bq::api::__api_log_decoder_create(log_file_path.c_str(), priv_key.c_str(), &handle_);
+            result_ = bq::api::__api_log_decoder_create(log_file_path.c_str(), priv_key.c_str(), filter, &handle_);
             if (result_ != appender_decode_result::success) {
                 handle_ = 0xFFFFFFFF;
             }
@@ -395,6 +410,35 @@ namespace bq {
             return result_;
         }
 
+        inline bq::appender_decode_result log_decoder::seek_to_time(uint64_t epoch_ms)
+        {
+            if (handle_ == 0xFFFFFFFF) {
+                return result_;
+            }
+            decode_text_.clear();
+            result_ = bq::api::__api_log_decoder_seek_to_time(handle_, epoch_ms);
+            return result_;
+        }
+
+        inline bq::appender_decode_result log_decoder::decode_follow(uint64_t timeout_ms)
+        {
+            if (handle_ == 0xFFFFFFFF) {
+                return result_;
+            }
+            bq::_api_string_def text;
+            decode_text_.clear();
+            result_ = bq::api::__api_log_decoder_decode_follow(handle_, timeout_ms, &text);
+            if (result_ == bq::appender_decode_result::success) {
+                decode_text_.insert_batch(decode_text_.begin(), text.str, (size_t)text.len);
+            }
+            return result_;
+        }
+
+        inline bq::appender_decode_result log_decoder::set_output_format(bq::log_decode_output_format format)
+        {
+            return bq::api::__api_log_decoder_set_output_format(handle_, format);
+        }
+
         inline bq::appender_decode_result log_decoder::get_last_decode_result() const
         {
             return result_;
@@ -0,0 +1,555 @@
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "bq_common/compression/deflate.h"
+
+namespace bq {
+    static constexpr uint32_t LITERAL_CODES = 286;
+    static constexpr uint32_t DISTANCE_CODES = 30;
+    static constexpr uint32_t CODE_LENGTH_CODES = 19;
+    static constexpr uint32_t END_OF_BLOCK = 256;
+    static constexpr uint8_t MAX_CODE_BITS = 15;
+    static constexpr uint8_t MAX_CODE_LENGTH_BITS = 7;
+
+    static const uint16_t length_base_[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const uint8_t length_extra_[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static const uint16_t dist_base_[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    static const uint8_t dist_extra_[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    static const uint8_t code_length_order_[CODE_LENGTH_CODES] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    static const uint32_t crc32_table_[256] = {
+        0x00000000U, 0x77073096U, 0xEE0E612CU, 0x990951BAU, 0x076DC419U, 0x706AF48FU, 0xE963A535U, 0x9E6495A3U,
+        0x0EDB8832U, 0x79DCB8A4U, 0xE0D5E91EU, 0x97D2D988U, 0x09B64C2BU, 0x7EB17CBDU, 0xE7B82D07U, 0x90BF1D91U,
+        0x1DB71064U, 0x6AB020F2U, 0xF3B97148U, 0x84BE41DEU, 0x1ADAD47DU, 0x6DDDE4EBU, 0xF4D4B551U, 0x83D385C7U,
+        0x136C9856U, 0x646BA8C0U, 0xFD62F97AU, 0x8A65C9ECU, 0x14015C4FU, 0x63066CD9U, 0xFA0F3D63U, 0x8D080DF5U,
+        0x3B6E20C8U, 0x4C69105EU, 0xD56041E4U, 0xA2677172U, 0x3C03E4D1U, 0x4B04D447U, 0xD20D85FDU, 0xA50AB56BU,
+        0x35B5A8FAU, 0x42B2986CU, 0xDBBBC9D6U, 0xACBCF940U, 0x32D86CE3U, 0x45DF5C75U, 0xDCD60DCFU, 0xABD13D59U,
+        0x26D930ACU, 0x51DE003AU, 0xC8D75180U, 0xBFD06116U, 0x21B4F4B5U, 0x56B3C423U, 0xCFBA9599U, 0xB8BDA50FU,
+        0x2802B89EU, 0x5F058808U, 0xC60CD9B2U, 0xB10BE924U, 0x2F6F7C87U, 0x58684C11U, 0xC1611DABU, 0xB6662D3DU,
+        0x76DC4190U, 0x01DB7106U, 0x98D220BCU, 0xEFD5102AU, 0x71B18589U, 0x06B6B51FU, 0x9FBFE4A5U, 0xE8B8D433U,
+        0x7807C9A2U, 0x0F00F934U, 0x9609A88EU, 0xE10E9818U, 0x7F6A0DBBU, 0x086D3D2DU, 0x91646C97U, 0xE6635C01U,
+        0x6B6B51F4U, 0x1C6C6162U, 0x856530D8U, 0xF262004EU, 0x6C0695EDU, 0x1B01A57BU, 0x8208F4C1U, 0xF50FC457U,
+        0x65B0D9C6U, 0x12B7E950U, 0x8BBEB8EAU, 0xFCB9887CU, 0x62DD1DDFU, 0x15DA2D49U, 0x8CD37CF3U, 0xFBD44C65U,
+        0x4DB26158U, 0x3AB551CEU, 0xA3BC0074U, 0xD4BB30E2U, 0x4ADFA541U, 0x3DD895D7U, 0xA4D1C46DU, 0xD3D6F4FBU,
+        0x4369E96AU, 0x346ED9FCU, 0xAD678846U, 0xDA60B8D0U, 0x44042D73U, 0x33031DE5U, 0xAA0A4C5FU, 0xDD0D7CC9U,
+        0x5005713CU, 0x270241AAU, 0xBE0B1010U, 0xC90C2086U, 0x5768B525U, 0x206F85B3U, 0xB966D409U, 0xCE61E49FU,
+        0x5EDEF90EU, 0x29D9C998U, 0xB0D09822U, 0xC7D7A8B4U, 0x59B33D17U, 0x2EB40D81U, 0xB7BD5C3BU, 0xC0BA6CADU,
+        0xEDB88320U, 0x9ABFB3B6U, 0x03B6E20CU, 0x74B1D29AU, 0xEAD54739U, 0x9DD277AFU, 0x04DB2615U, 0x73DC1683U,
+        0xE3630B12U, 0x94643B84U, 0x0D6D6A3EU, 0x7A6A5AA8U, 0xE40ECF0BU, 0x9309FF9DU, 0x0A00AE27U, 0x7D079EB1U,
+        0xF00F9344U, 0x8708A3D2U, 0x1E01F268U, 0x6906C2FEU, 0xF762575DU, 0x806567CBU, 0x196C3671U, 0x6E6B06E7U,
+        0xFED41B76U, 0x89D32BE0U, 0x10DA7A5AU, 0x67DD4ACCU, 0xF9B9DF6FU, 0x8EBEEFF9U, 0x17B7BE43U, 0x60B08ED5U,
+        0xD6D6A3E8U, 0xA1D1937EU, 0x38D8C2C4U, 0x4FDFF252U, 0xD1BB67F1U, 0xA6BC5767U, 0x3FB506DDU, 0x48B2364BU,
+        0xD80D2BDAU, 0xAF0A1B4CU, 0x36034AF6U, 0x41047A60U, 0xDF60EFC3U, 0xA867DF55U, 0x316E8EEFU, 0x4669BE79U,
+        0xCB61B38CU, 0xBC66831AU, 0x256FD2A0U, 0x5268E236U, 0xCC0C7795U, 0xBB0B4703U, 0x220216B9U, 0x5505262FU,
+        0xC5BA3BBEU, 0xB2BD0B28U, 0x2BB45A92U, 0x5CB36A04U, 0xC2D7FFA7U, 0xB5D0CF31U, 0x2CD99E8BU, 0x5BDEAE1DU,
+        0x9B64C2B0U, 0xEC63F226U, 0x756AA39CU, 0x026D930AU, 0x9C0906A9U, 0xEB0E363FU, 0x72076785U, 0x05005713U,
+        0x95BF4A82U, 0xE2B87A14U, 0x7BB12BAEU, 0x0CB61B38U, 0x92D28E9BU, 0xE5D5BE0DU, 0x7CDCEFB7U, 0x0BDBDF21U,
+        0x86D3D2D4U, 0xF1D4E242U, 0x68DDB3F8U, 0x1FDA836EU, 0x81BE16CDU, 0xF6B9265BU, 0x6FB077E1U, 0x18B74777U,
+        0x88085AE6U, 0xFF0F6A70U, 0x66063BCAU, 0x11010B5CU, 0x8F659EFFU, 0xF862AE69U, 0x616BFFD3U, 0x166CCF45U,
+        0xA00AE278U, 0xD70DD2EEU, 0x4E048354U, 0x3903B3C2U, 0xA7672661U, 0xD06016F7U, 0x4969474DU, 0x3E6E77DBU,
+        0xAED16A4AU, 0xD9D65ADCU, 0x40DF0B66U, 0x37D83BF0U, 0xA9BCAE53U, 0xDEBB9EC5U, 0x47B2CF7FU, 0x30B5FFE9U,
+        0xBDBDF21CU, 0xCABAC28AU, 0x53B39330U, 0x24B4A3A6U, 0xBAD03605U, 0xCDD70693U, 0x54DE5729U, 0x23D967BFU,
+        0xB3667A2EU, 0xC4614AB8U, 0x5D681B02U, 0x2A6F2B94U, 0xB40BBE37U, 0xC30C8EA1U, 0x5A05DF1BU, 0x2D02EF8DU
+    };
+
+    static bq_forceinline uint32_t get_length_code(uint32_t len)
+    {
+        uint32_t code = 0;
+        while (code < 28 && length_base_[code + 1] <= len) {
+            ++code;
+        }
+        return code;
+    }
+
+    static bq_forceinline uint32_t get_dist_code(uint32_t dist)
+    {
+        uint32_t code = 0;
+        while (code < 29 && dist_base_[code + 1] <= dist) {
+            ++code;
+        }
+        return code;
+    }
+
+    static uint32_t reverse_bits(uint32_t code, uint32_t len)
+    {
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < len; ++i) {
+            result = (result << 1) | (code & 1U);
+            code >>= 1;
+        }
+        return result;
+    }
+
+    // Build length-limited Huffman code lengths. Frequencies are halved and rebuilt until the depth fits the limit,
+    // which is slightly suboptimal but simple and robust.
+    static void build_code_lengths(const uint32_t* freqs, uint32_t symbol_count, uint8_t max_bits, uint8_t* out_lengths)
+    {
+        memset(out_lengths, 0, symbol_count);
+        uint32_t scaled[LITERAL_CODES];
+        uint32_t leaves[LITERAL_CODES];
+        uint32_t leaf_count = 0;
+        for (uint32_t i = 0; i < symbol_count; ++i) {
+            scaled[i] = freqs[i];
+            if (freqs[i] > 0) {
+                leaves[leaf_count++] = i;
+            }
+        }
+        if (leaf_count == 0) {
+            return;
+        }
+        if (leaf_count == 1) {
+            // A single code is still required to be decodable, pair it with a dummy symbol.
+            out_lengths[leaves[0]] = 1;
+            out_lengths[leaves[0] == 0 ? 1 : 0] = 1;
+            return;
+        }
+        uint32_t weights[LITERAL_CODES * 2];
+        uint32_t parents[LITERAL_CODES * 2];
+        uint8_t depths[LITERAL_CODES * 2];
+        while (true) {
+            // insertion sort leaves by weight, stable by symbol
+            for (uint32_t i = 1; i < leaf_count; ++i) {
+                uint32_t sym = leaves[i];
+                uint32_t j = i;
+                while (j > 0 && scaled[leaves[j - 1]] > scaled[sym]) {
+                    leaves[j] = leaves[j - 1];
+                    --j;
+                }
+                leaves[j] = sym;
+            }
+            for (uint32_t i = 0; i < leaf_count; ++i) {
+                weights[i] = scaled[leaves[i]];
+            }
+            // two-queue Huffman construction: leaves are [0, leaf_count), internal nodes are appended after them.
+            uint32_t leaf_cursor = 0;
+            uint32_t node_cursor = leaf_count;
+            uint32_t node_end = leaf_count;
+            auto pick_min = [&]() -> uint32_t {
+                if (leaf_cursor < leaf_count && (node_cursor >= node_end || weights[leaf_cursor] <= weights[node_cursor])) {
+                    return leaf_cursor++;
+                }
+                return node_cursor++;
+            };
+            while (node_end < leaf_count * 2 - 1) {
+                uint32_t a = pick_min();
+                uint32_t b = pick_min();
+                weights[node_end] = weights[a] + weights[b];
+                parents[a] = node_end;
+                parents[b] = node_end;
+                ++node_end;
+            }
+            uint32_t root = node_end - 1;
+            depths[root] = 0;
+            uint8_t max_depth = 0;
+            for (uint32_t i = root; i > 0; --i) {
+                uint32_t idx = i - 1;
+                depths[idx] = static_cast<uint8_t>(depths[parents[idx]] + 1);
+                if (idx < leaf_count && depths[idx] > max_depth) {
+                    max_depth = depths[idx];
+                }
+            }
+            if (max_depth <= max_bits) {
+                for (uint32_t i = 0; i < leaf_count; ++i) {
+                    out_lengths[leaves[i]] = depths[i];
+                }
+                return;
+            }
+            for (uint32_t i = 0; i < leaf_count; ++i) {
+                scaled[leaves[i]] = (scaled[leaves[i]] >> 1) | 1U;
+            }
+        }
+    }
+
+    // Canonical Huffman codes (RFC 1951 3.2.2), bit-reversed because DEFLATE emits bits LSB first.
+    static void build_codes(const uint8_t* lengths, uint32_t symbol_count, uint16_t* out_codes)
+    {
+        uint32_t bl_count[MAX_CODE_BITS + 1] = { 0 };
+        for (uint32_t i = 0; i < symbol_count; ++i) {
+            ++bl_count[lengths[i]];
+        }
+        bl_count[0] = 0;
+        uint32_t next_code[MAX_CODE_BITS + 1] = { 0 };
+        uint32_t code = 0;
+        for (uint32_t bits = 1; bits <= MAX_CODE_BITS; ++bits) {
+            code = (code + bl_count[bits - 1]) << 1;
+            next_code[bits] = code;
+        }
+        for (uint32_t i = 0; i < symbol_count; ++i) {
+            uint32_t len = lengths[i];
+            out_codes[i] = len ? static_cast<uint16_t>(reverse_bits(next_code[len]++, len)) : static_cast<uint16_t>(0);
+        }
+    }
+
+    static void get_fixed_lengths(uint8_t* lit_lengths, uint8_t* dist_lengths)
+    {
+        for (uint32_t i = 0; i < 288; ++i) {
+            lit_lengths[i] = (i < 144) ? 8 : (i < 256) ? 9
+                : (i < 280)                            ? 7
+                                                       : 8;
+        }
+        for (uint32_t i = 0; i < DISTANCE_CODES; ++i) {
+            dist_lengths[i] = 5;
+        }
+    }
+
+    uint32_t deflate_encoder::crc32(uint32_t crc, const void* data, size_t len)
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        crc = ~crc;
+        for (size_t i = 0; i < len; ++i) {
+            crc = crc32_table_[(crc ^ p[i]) & 0xFFU] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    deflate_encoder::deflate_encoder(container container_type /* = container::gzip*/)
+        : container_type_(container_type)
+    {
+        window_.fill_uninitialized(WINDOW_SIZE * 2);
+        head_.fill_uninitialized(HASH_SIZE);
+        prev_.fill_uninitialized(WINDOW_SIZE);
+        symbols_.set_capacity(MAX_BLOCK_SYMBOLS);
+        reset();
+    }
+
+    void deflate_encoder::reset()
+    {
+        out_.clear();
+        window_end_ = 0;
+        window_pos_ = 0;
+        for (auto& h : head_) {
+            h = NIL;
+        }
+        for (auto& p : prev_) {
+            p = NIL;
+        }
+        symbols_.clear();
+        bit_buf_ = 0;
+        bit_count_ = 0;
+        crc_ = 0;
+        total_in_ = 0;
+        header_written_ = false;
+        finished_ = false;
+    }
+
+    void deflate_encoder::update(const void* data, size_t len)
+    {
+        assert(!finished_ && "deflate_encoder::update called after finish()");
+        if (!header_written_) {
+            write_header();
+        }
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        crc_ = crc32(crc_, src, len);
+        total_in_ += static_cast<uint64_t>(len);
+        while (len > 0) {
+            uint32_t space = static_cast<uint32_t>(window_.size()) - window_end_;
+            if (space == 0) {
+                compress_window(false);
+                slide_window();
+                continue;
+            }
+            uint32_t copy_size = static_cast<uint32_t>(bq::min_value(static_cast<size_t>(space), len));
+            memcpy(window_.begin() + window_end_, src, copy_size);
+            window_end_ += copy_size;
+            src += copy_size;
+            len -= copy_size;
+        }
+    }
+
+    void deflate_encoder::finish()
+    {
+        if (finished_) {
+            return;
+        }
+        if (!header_written_) {
+            write_header();
+        }
+        compress_window(true);
+        flush_block(true);
+        align_to_byte();
+        if (container_type_ == container::gzip) {
+            uint32_t isize = static_cast<uint32_t>(total_in_ & 0xFFFFFFFFU);
+            for (uint32_t i = 0; i < 4; ++i) {
+                out_.push_back(static_cast<uint8_t>((crc_ >> (i * 8)) & 0xFFU));
+            }
+            for (uint32_t i = 0; i < 4; ++i) {
+                out_.push_back(static_cast<uint8_t>((isize >> (i * 8)) & 0xFFU));
+            }
+        }
+        finished_ = true;
+    }
+
+    void deflate_encoder::write_header()
+    {
+        if (container_type_ == container::gzip) {
+            // ID1 ID2 CM FLG MTIME(4) XFL OS(unknown)
+            const uint8_t header[10] = { 0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF };
+            out_.insert_batch(out_.end(), header, sizeof(header));
+        }
+        header_written_ = true;
+    }
+
+    void deflate_encoder::insert_hash(uint32_t pos)
+    {
+        uint32_t h = hash_at(pos);
+        prev_[pos & (WINDOW_SIZE - 1)] = head_[h];
+        head_[h] = static_cast<int32_t>(pos);
+    }
+
+    uint32_t deflate_encoder::longest_match(uint32_t pos, uint32_t max_len, uint32_t& out_dist) const
+    {
+        int32_t candidate = head_[hash_at(pos)];
+        uint32_t chain = MAX_CHAIN;
+        uint32_t best_len = 0;
+        const uint8_t* cur = window_.begin() + pos;
+        while (candidate != NIL && chain-- > 0) {
+            uint32_t cand_pos = static_cast<uint32_t>(candidate);
+            uint32_t dist = pos - cand_pos;
+            if (dist >= WINDOW_SIZE) {
+                break;
+            }
+            const uint8_t* match = window_.begin() + cand_pos;
+            if (match[best_len] == cur[best_len] && match[0] == cur[0]) {
+                uint32_t len = 0;
+                while (len < max_len && match[len] == cur[len]) {
+                    ++len;
+                }
+                if (len > best_len) {
+                    best_len = len;
+                    out_dist = dist;
+                    if (len >= GOOD_ENOUGH_MATCH || len >= max_len) {
+                        break;
+                    }
+                }
+            }
+            candidate = prev_[cand_pos & (WINDOW_SIZE - 1)];
+        }
+        return best_len;
+    }
+
+    void deflate_encoder::compress_window(bool flush_all)
+    {
+        uint32_t limit = flush_all ? window_end_ : (window_end_ > MAX_MATCH ? window_end_ - MAX_MATCH : 0);
+        while (window_pos_ < limit) {
+            uint32_t avail = window_end_ - window_pos_;
+            uint32_t match_len = 0;
+            uint32_t match_dist = 0;
+            if (avail >= MIN_MATCH) {
+                match_len = longest_match(window_pos_, bq::min_value(avail, MAX_MATCH), match_dist);
+            }
+            if (match_len >= MIN_MATCH) {
+                symbols_.push_back(symbol { static_cast<uint16_t>(match_len), static_cast<uint16_t>(match_dist) });
+                uint32_t end_pos = window_pos_ + match_len;
+                for (; window_pos_ < end_pos; ++window_pos_) {
+                    if (window_pos_ + MIN_MATCH <= window_end_) {
+                        insert_hash(window_pos_);
+                    }
+                }
+            } else {
+                symbols_.push_back(symbol { static_cast<uint16_t>(window_[window_pos_]), 0 });
+                if (avail >= MIN_MATCH) {
+                    insert_hash(window_pos_);
+                }
+                ++window_pos_;
+            }
+            if (symbols_.size() >= MAX_BLOCK_SYMBOLS) {
+                flush_block(false);
+            }
+        }
+    }
+
+    void deflate_encoder::slide_window()
+    {
+        assert(window_pos_ >= WINDOW_SIZE && "deflate_encoder slide_window without enough consumed data");
+        memmove(window_.begin(), window_.begin() + WINDOW_SIZE, window_end_ - WINDOW_SIZE);
+        window_end_ -= WINDOW_SIZE;
+        window_pos_ -= WINDOW_SIZE;
+        constexpr int32_t shift = static_cast<int32_t>(WINDOW_SIZE);
+        for (auto& h : head_) {
+            h = (h >= shift) ? (h - shift) : NIL;
+        }
+        for (auto& p : prev_) {
+            p = (p >= shift) ? (p - shift) : NIL;
+        }
+    }
+
+    void deflate_encoder::write_bits(uint32_t bits, uint32_t count)
+    {
+        bit_buf_ |= static_cast<uint64_t>(bits) << bit_count_;
+        bit_count_ += count;
+        while (bit_count_ >= 8) {
+            out_.push_back(static_cast<uint8_t>(bit_buf_ & 0xFFU));
+            bit_buf_ >>= 8;
+            bit_count_ -= 8;
+        }
+    }
+
+    void deflate_encoder::align_to_byte()
+    {
+        if (bit_count_ > 0) {
+            out_.push_back(static_cast<uint8_t>(bit_buf_ & 0xFFU));
+        }
+        bit_buf_ = 0;
+        bit_count_ = 0;
+    }
+
+    void deflate_encoder::flush_block(bool is_final)
+    {
+        uint32_t lit_freqs[LITERAL_CODES] = { 0 };
+        uint32_t dist_freqs[DISTANCE_CODES] = { 0 };
+        for (const auto& sym : symbols_) {
+            if (sym.dist == 0) {
+                ++lit_freqs[sym.lit_or_len];
+            } else {
+                ++lit_freqs[257 + get_length_code(sym.lit_or_len)];
+                ++dist_freqs[get_dist_code(sym.dist)];
+            }
+        }
+        lit_freqs[END_OF_BLOCK] = 1;
+
+        // dynamic trees
+        uint8_t lit_lengths[288] = { 0 };
+        uint8_t dist_lengths[DISTANCE_CODES] = { 0 };
+        build_code_lengths(lit_freqs, LITERAL_CODES, MAX_CODE_BITS, lit_lengths);
+        build_code_lengths(dist_freqs, DISTANCE_CODES, MAX_CODE_BITS, dist_lengths);
+        uint32_t hlit = LITERAL_CODES;
+        while (hlit > 257 && lit_lengths[hlit - 1] == 0) {
+            --hlit;
+        }
+        uint32_t hdist = DISTANCE_CODES;
+        while (hdist > 1 && dist_lengths[hdist - 1] == 0) {
+            --hdist;
+        }
+
+        // run-length encode the code lengths
+        uint8_t all_lengths[LITERAL_CODES + DISTANCE_CODES];
+        memcpy(all_lengths, lit_lengths, hlit);
+        memcpy(all_lengths + hlit, dist_lengths, hdist);
+        uint32_t total_lengths = hlit + hdist;
+        struct rle_item {
+            uint8_t sym;
+            uint8_t extra;
+        };
+        rle_item rle[LITERAL_CODES + DISTANCE_CODES];
+        uint32_t rle_count = 0;
+        uint32_t cl_freqs[CODE_LENGTH_CODES] = { 0 };
+        for (uint32_t i = 0; i < total_lengths;) {
+            uint8_t cur = all_lengths[i];
+            uint32_t run = 1;
+            while (i + run < total_lengths && all_lengths[i + run] == cur) {
+                ++run;
+            }
+            i += run;
+            if (cur == 0) {
+                while (run >= 11) {
+                    uint32_t r = bq::min_value(run, static_cast<uint32_t>(138));
+                    rle[rle_count++] = { 18, static_cast<uint8_t>(r - 11) };
+                    run -= r;
+                }
+                if (run >= 3) {
+                    rle[rle_count++] = { 17, static_cast<uint8_t>(run - 3) };
+                    run = 0;
+                }
+            } else {
+                rle[rle_count++] = { cur, 0 };
+                --run;
+                while (run >= 3) {
+                    uint32_t r = bq::min_value(run, static_cast<uint32_t>(6));
+                    rle[rle_count++] = { 16, static_cast<uint8_t>(r - 3) };
+                    run -= r;
+                }
+            }
+            for (; run > 0; --run) {
+                rle[rle_count++] = { cur, 0 };
+            }
+        }
+        for (uint32_t i = 0; i < rle_count; ++i) {
+            ++cl_freqs[rle[i].sym];
+        }
+        uint8_t cl_lengths[CODE_LENGTH_CODES] = { 0 };
+        build_code_lengths(cl_freqs, CODE_LENGTH_CODES, MAX_CODE_LENGTH_BITS, cl_lengths);
+        uint32_t hclen = CODE_LENGTH_CODES;
+        while (hclen > 4 && cl_lengths[code_length_order_[hclen - 1]] == 0) {
+            --hclen;
+        }
+
+        // choose cheaper block type
+        uint8_t fixed_lit_lengths[288];
+        uint8_t fixed_dist_lengths[DISTANCE_CODES];
+        get_fixed_lengths(fixed_lit_lengths, fixed_dist_lengths);
+        uint64_t dynamic_bits = 3 + 5 + 5 + 4 + static_cast<uint64_t>(hclen) * 3;
+        for (uint32_t i = 0; i < rle_count; ++i) {
+            static constexpr uint8_t rle_extra_bits[3] = { 2, 3, 7 };
+            dynamic_bits += cl_lengths[rle[i].sym] + (rle[i].sym >= 16 ? rle_extra_bits[rle[i].sym - 16] : 0U);
+        }
+        uint64_t fixed_bits = 3;
+        for (uint32_t i = 0; i < LITERAL_CODES; ++i) {
+            uint64_t extra = (i > END_OF_BLOCK) ? length_extra_[i - 257] : 0U;
+            dynamic_bits += static_cast<uint64_t>(lit_freqs[i]) * (lit_lengths[i] + extra);
+            fixed_bits += static_cast<uint64_t>(lit_freqs[i]) * (fixed_lit_lengths[i] + extra);
+        }
+        for (uint32_t i = 0; i < DISTANCE_CODES; ++i) {
+            dynamic_bits += static_cast<uint64_t>(dist_freqs[i]) * (dist_lengths[i] + dist_extra_[i]);
+            fixed_bits += static_cast<uint64_t>(dist_freqs[i]) * (fixed_dist_lengths[i] + dist_extra_[i]);
+        }
+
+        uint16_t lit_codes[288];
+        uint16_t dist_codes[DISTANCE_CODES];
+        const uint8_t* used_lit_lengths = lit_lengths;
+        const uint8_t* used_dist_lengths = dist_lengths;
+        write_bits(is_final ? 1U : 0U, 1);
+        if (dynamic_bits < fixed_bits) {
+            write_bits(2, 2);
+            write_bits(hlit - 257, 5);
+            write_bits(hdist - 1, 5);
+            write_bits(hclen - 4, 4);
+            for (uint32_t i = 0; i < hclen; ++i) {
+                write_bits(cl_lengths[code_length_order_[i]], 3);
+            }
+            uint16_t cl_codes[CODE_LENGTH_CODES];
+            build_codes(cl_lengths, CODE_LENGTH_CODES, cl_codes);
+            for (uint32_t i = 0; i < rle_count; ++i) {
+                uint8_t sym = rle[i].sym;
+                write_bits(cl_codes[sym], cl_lengths[sym]);
+                if (sym == 16) {
+                    write_bits(rle[i].extra, 2);
+                } else if (sym == 17) {
+                    write_bits(rle[i].extra, 3);
+                } else if (sym == 18) {
+                    write_bits(rle[i].extra, 7);
+                }
+            }
+            build_codes(lit_lengths, LITERAL_CODES, lit_codes);
+            build_codes(dist_lengths, DISTANCE_CODES, dist_codes);
+        } else {
+            write_bits(1, 2);
+            used_lit_lengths = fixed_lit_lengths;
+            used_dist_lengths = fixed_dist_lengths;
+            build_codes(fixed_lit_lengths, 288, lit_codes);
+            build_codes(fixed_dist_lengths, DISTANCE_CODES, dist_codes);
+        }
+
+        for (const auto& sym : symbols_) {
+            if (sym.dist == 0) {
+                write_bits(lit_codes[sym.lit_or_len], used_lit_lengths[sym.lit_or_len]);
+            } else {
+                uint32_t len_code = get_length_code(sym.lit_or_len);
+                write_bits(lit_codes[257 + len_code], used_lit_lengths[257 + len_code]);
+                write_bits(sym.lit_or_len - length_base_[len_code], length_extra_[len_code]);
+                uint32_t dist_code = get_dist_code(sym.dist);
+                write_bits(dist_codes[dist_code], used_dist_lengths[dist_code]);
+                write_bits(sym.dist - dist_base_[dist_code], dist_extra_[dist_code]);
+            }
+        }
+        write_bits(lit_codes[END_OF_BLOCK], used_lit_lengths[END_OF_BLOCK]);
+        symbols_.clear();
+    }
+}
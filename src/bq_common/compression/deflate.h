@@ -0,0 +1,106 @@
+#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * \file deflate.h
+ *
+ * \brief
+ *
+ * Streaming DEFLATE (RFC 1951) encoder with optional GZIP (RFC 1952) container.
+ * LZ77 with hash chains + dynamic Huffman blocks (falls back to fixed Huffman when smaller).
+ * Output is readable by gzip/zlib, no external dependency is required.
+ *
+ */
+
+#include "bq_common/bq_common.h"
+
+namespace bq {
+    class deflate_encoder {
+    public:
+        enum class container {
+            raw,
+            gzip
+        };
+
+    public:
+        deflate_encoder(container container_type = container::gzip);
+
+        deflate_encoder(const deflate_encoder& rhs) = delete;
+        deflate_encoder& operator=(const deflate_encoder& rhs) = delete;
+
+        /// <summary>
+        /// Feed input data, compressed bytes are appended to output().
+        /// Input is not required to be kept alive after this call.
+        /// </summary>
+        void update(const void* data, size_t len);
+
+        /// <summary>
+        /// Flush all pending data and write the stream trailer.
+        /// No more update() is allowed after this call until reset().
+        /// </summary>
+        void finish();
+
+        void reset();
+
+        /// Compressed bytes produced so far. Caller can drain (write out and clear) it at any time.
+        bq_forceinline bq::array<uint8_t>& output() { return out_; }
+
+        bq_forceinline uint64_t get_total_in() const { return total_in_; }
+
+        /// CRC-32 (IEEE 802.3, reflected, used by gzip and zip)
+        static uint32_t crc32(uint32_t crc, const void* data, size_t len);
+
+    private:
+        static constexpr uint32_t WINDOW_SIZE = 32 * 1024;
+        static constexpr uint32_t MIN_MATCH = 3;
+        static constexpr uint32_t MAX_MATCH = 258;
+        static constexpr uint32_t HASH_BITS = 15;
+        static constexpr uint32_t HASH_SIZE = 1 << HASH_BITS;
+        static constexpr uint32_t MAX_CHAIN = 48;
+        static constexpr uint32_t GOOD_ENOUGH_MATCH = 128;
+        static constexpr uint32_t MAX_BLOCK_SYMBOLS = 32 * 1024;
+        static constexpr int32_t NIL = -1;
+
+        struct symbol {
+            uint16_t lit_or_len; // literal byte, or match length when dist > 0
+            uint16_t dist;
+        };
+
+        void write_header();
+        void compress_window(bool flush_all);
+        void slide_window();
+        uint32_t longest_match(uint32_t pos, uint32_t max_len, uint32_t& out_dist) const;
+        bq_forceinline uint32_t hash_at(uint32_t pos) const
+        {
+            return ((static_cast<uint32_t>(window_[pos]) << 10) ^ (static_cast<uint32_t>(window_[pos + 1]) << 5) ^ static_cast<uint32_t>(window_[pos + 2])) & (HASH_SIZE - 1);
+        }
+        void insert_hash(uint32_t pos);
+        void flush_block(bool is_final);
+        void write_bits(uint32_t bits, uint32_t count);
+        void align_to_byte();
+
+    private:
+        container container_type_;
+        bq::array<uint8_t> out_;
+        bq::array<uint8_t> window_;
+        uint32_t window_end_;
+        uint32_t window_pos_;
+        bq::array<int32_t> head_;
+        bq::array<int32_t> prev_;
+        bq::array<symbol> symbols_;
+        uint64_t bit_buf_;
+        uint32_t bit_count_;
+        uint32_t crc_;
+        uint64_t total_in_;
+        bool header_written_;
+        bool finished_;
+    };
+}
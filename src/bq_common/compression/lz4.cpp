@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "bq_common/compression/lz4.h"
+
+namespace bq {
+    static constexpr size_t MIN_MATCH = 4;
+    // the last match must start at least MFLIMIT bytes before the end, the last LAST_LITERALS bytes are always literals.
+    static constexpr size_t MFLIMIT = 12;
+    static constexpr size_t LAST_LITERALS = 5;
+    static constexpr size_t MAX_DISTANCE = 65535;
+    static constexpr uint32_t RUN_MASK = 15;
+    // fast level: every 2^SKIP_TRIGGER failed lookups the step over incompressible data grows by 1.
+    static constexpr uint32_t SKIP_TRIGGER = 6;
+
+    static bq_forceinline uint32_t read_32(const uint8_t* ptr)
+    {
+        uint32_t value;
+        memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    static bq_forceinline uint32_t hash_32(uint32_t sequence, uint32_t hash_bits)
+    {
+        return (sequence * 2654435761U) >> (32 - hash_bits);
+    }
+
+    static bq_forceinline size_t count_match(const uint8_t* src, size_t pos, size_t ref, size_t limit)
+    {
+        size_t start = pos;
+        while (pos < limit && src[pos] == src[ref]) {
+            ++pos;
+            ++ref;
+        }
+        return pos - start;
+    }
+
+    static bq_forceinline uint8_t* write_length(uint8_t* op, size_t len)
+    {
+        while (len >= 255) {
+            *op++ = 255;
+            len -= 255;
+        }
+        *op++ = static_cast<uint8_t>(len);
+        return op;
+    }
+
+    // match_len 0 writes the last sequence, literals only
+    static uint8_t* write_sequence(uint8_t* op, const uint8_t* literals, size_t literal_len, size_t offset, size_t match_len)
+    {
+        uint8_t* token = op++;
+        *token = static_cast<uint8_t>((literal_len >= RUN_MASK ? RUN_MASK : literal_len) << 4);
+        if (literal_len >= RUN_MASK) {
+            op = write_length(op, literal_len - RUN_MASK);
+        }
+        memcpy(op, literals, literal_len);
+        op += literal_len;
+        if (match_len == 0) {
+            return op;
+        }
+        *op++ = static_cast<uint8_t>(offset & 0xFF);
+        *op++ = static_cast<uint8_t>((offset >> 8) & 0xFF);
+        size_t match_code = match_len - MIN_MATCH;
+        *token = static_cast<uint8_t>(*token | (match_code >= RUN_MASK ? RUN_MASK : match_code));
+        if (match_code >= RUN_MASK) {
+            op = write_length(op, match_code - RUN_MASK);
+        }
+        return op;
+    }
+
+    lz4::lz4(level compression_level)
+        : level_(compression_level)
+    {
+    }
+
+    size_t lz4::compress(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_capacity)
+    {
+        if (dst_capacity < get_max_compressed_size(src_len)) {
+            return 0;
+        }
+        if (src_len < MFLIMIT + 1) {
+            return static_cast<size_t>(write_sequence(dst, src, src_len, 0, 0) - dst);
+        }
+        return level_ == level::high ? compress_high(src, src_len, dst) : compress_fast(src, src_len, dst);
+    }
+
+    size_t lz4::compress_fast(const uint8_t* src, size_t src_len, uint8_t* dst)
+    {
+        // positions are only candidates, a stale or zero entry is rejected by comparing the bytes.
+        hash_table_.clear();
+        hash_table_.fill_uninitialized(static_cast<size_t>(1) << FAST_HASH_BITS);
+        memset(hash_table_.begin(), 0, hash_table_.size() * sizeof(uint32_t));
+        uint32_t* table = hash_table_.begin();
+        const size_t match_start_limit = src_len - MFLIMIT;
+        const size_t match_end_limit = src_len - LAST_LITERALS;
+        uint8_t* op = dst;
+        size_t anchor = 0;
+        size_t pos = 1;
+        uint32_t search_count = 1U << SKIP_TRIGGER;
+        while (pos < match_start_limit) {
+            uint32_t sequence = read_32(src + pos);
+            uint32_t hash = hash_32(sequence, FAST_HASH_BITS);
+            size_t ref = table[hash];
+            table[hash] = static_cast<uint32_t>(pos);
+            if (pos - ref > MAX_DISTANCE || read_32(src + ref) != sequence) {
+                pos += search_count++ >> SKIP_TRIGGER;
+                continue;
+            }
+            while (pos > anchor && ref > 0 && src[pos - 1] == src[ref - 1]) {
+                --pos;
+                --ref;
+            }
+            size_t match_len = MIN_MATCH + count_match(src, pos + MIN_MATCH, ref + MIN_MATCH, match_end_limit);
+            op = write_sequence(op, src + anchor, pos - anchor, pos - ref, match_len);
+            pos += match_len;
+            anchor = pos;
+            search_count = 1U << SKIP_TRIGGER;
+            if (pos < match_start_limit) {
+                table[hash_32(read_32(src + pos - 2), FAST_HASH_BITS)] = static_cast<uint32_t>(pos - 2);
+            }
+        }
+        op = write_sequence(op, src + anchor, src_len - anchor, 0, 0);
+        return static_cast<size_t>(op - dst);
+    }
+
+    size_t lz4::compress_high(const uint8_t* src, size_t src_len, uint8_t* dst)
+    {
+        hash_table_.clear();
+        hash_table_.fill_uninitialized(static_cast<size_t>(1) << HIGH_HASH_BITS);
+        memset(hash_table_.begin(), 0, hash_table_.size() * sizeof(uint32_t));
+        if (chain_table_.size() != WINDOW_SIZE) {
+            chain_table_.clear();
+            chain_table_.fill_uninitialized(WINDOW_SIZE);
+        }
+        uint32_t* table = hash_table_.begin();
+        uint16_t* chain = chain_table_.begin();
+        const size_t match_start_limit = src_len - MFLIMIT;
+        const size_t match_end_limit = src_len - LAST_LITERALS;
+        uint8_t* op = dst;
+        size_t anchor = 0;
+        size_t pos = 0;
+        size_t next_to_insert = 0;
+        while (pos < match_start_limit) {
+            // every position up to pos is in the chains, positions covered by matches included
+            for (; next_to_insert <= pos; ++next_to_insert) {
+                uint32_t hash = hash_32(read_32(src + next_to_insert), HIGH_HASH_BITS);
+                size_t distance = table[hash] == 0 ? 0 : next_to_insert - (table[hash] - 1);
+                chain[next_to_insert & (WINDOW_SIZE - 1)] = static_cast<uint16_t>(distance > MAX_DISTANCE ? 0 : distance);
+                table[hash] = static_cast<uint32_t>(next_to_insert + 1);
+            }
+            const uint32_t sequence = read_32(src + pos);
+            size_t best_len = 0;
+            size_t best_ref = 0;
+            size_t ref = pos;
+            for (uint32_t attempts = 0; attempts < HIGH_MAX_ATTEMPTS; ++attempts) {
+                size_t distance = chain[ref & (WINDOW_SIZE - 1)];
+                if (distance == 0 || pos - (ref - distance) > MAX_DISTANCE) {
+                    break;
+                }
+                ref -= distance;
+                // a longer match than the best one must differ from it at best_len
+                if (pos + best_len < match_end_limit && src[ref + best_len] == src[pos + best_len] && read_32(src + ref) == sequence) {
+                    size_t match_len = MIN_MATCH + count_match(src, pos + MIN_MATCH, ref + MIN_MATCH, match_end_limit);
+                    if (match_len > best_len) {
+                        best_len = match_len;
+                        best_ref = ref;
+                        if (pos + best_len >= match_end_limit) {
+                            break;
+                        }
+                    }
+                }
+            }
+            if (best_len < MIN_MATCH) {
+                ++pos;
+                continue;
+            }
+            while (pos > anchor && best_ref > 0 && src[pos - 1] == src[best_ref - 1]) {
+                --pos;
+                --best_ref;
+                ++best_len;
+            }
+            op = write_sequence(op, src + anchor, pos - anchor, pos - best_ref, best_len);
+            pos += best_len;
+            anchor = pos;
+        }
+        op = write_sequence(op, src + anchor, src_len - anchor, 0, 0);
+        return static_cast<size_t>(op - dst);
+    }
+
+    size_t lz4::decompress(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_capacity)
+    {
+        const uint8_t* ip = src;
+        const uint8_t* const ip_end = src + src_len;
+        uint8_t* op = dst;
+        uint8_t* const op_end = dst + dst_capacity;
+        while (true) {
+            if (ip >= ip_end) {
+                return SIZE_MAX;
+            }
+            uint32_t token = *ip++;
+            size_t literal_len = token >> 4;
+            if (literal_len == RUN_MASK) {
+                uint8_t byte;
+                do {
+                    if (ip >= ip_end) {
+                        return SIZE_MAX;
+                    }
+                    byte = *ip++;
+                    literal_len += byte;
+                } while (byte == 255);
+            }
+            if (literal_len > static_cast<size_t>(ip_end - ip) || literal_len > static_cast<size_t>(op_end - op)) {
+                return SIZE_MAX;
+            }
+            memcpy(op, ip, literal_len);
+            ip += literal_len;
+            op += literal_len;
+            if (ip == ip_end) {
+                // the last sequence has no match
+                break;
+            }
+            if (ip_end - ip < 2) {
+                return SIZE_MAX;
+            }
+            size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+                return SIZE_MAX;
+            }
+            size_t match_len = token & RUN_MASK;
+            if (match_len == RUN_MASK) {
+                uint8_t byte;
+                do {
+                    if (ip >= ip_end) {
+                        return SIZE_MAX;
+                    }
+                    byte = *ip++;
+                    match_len += byte;
+                } while (byte == 255);
+            }
+            match_len += MIN_MATCH;
+            if (match_len > static_cast<size_t>(op_end - op)) {
+                return SIZE_MAX;
+            }
+            const uint8_t* match = op - offset;
+            if (offset >= match_len) {
+                memcpy(op, match, match_len);
+                op += match_len;
+            } else {
+                // overlapping copy repeats the last offset bytes
+                for (size_t i = 0; i < match_len; ++i) {
+                    *op++ = *match++;
+                }
+            }
+        }
+        return static_cast<size_t>(op - dst);
+    }
+}
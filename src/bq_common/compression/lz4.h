@@ -0,0 +1,78 @@
+#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * \file lz4.h
+ *
+ * \brief
+ *
+ * Block compressor producing the LZ4 block format (no frame), no external dependency is required.
+ * "fast" looks up one candidate per position and skips ahead faster over data it can't compress,
+ * "high" walks hash chains for the longest match in the 64 KiB window, trading worker CPU for size.
+ * Both produce the same format, one decompressor reads them.
+ *
+ */
+
+#include "bq_common/bq_common.h"
+
+namespace bq {
+    class lz4 {
+    public:
+        enum class level : uint8_t {
+            fast,
+            high
+        };
+
+    public:
+        lz4(level compression_level = level::fast);
+
+        lz4(const lz4& rhs) = delete;
+        lz4& operator=(const lz4& rhs) = delete;
+
+        /// <summary>
+        /// Compress src into dst as one block.
+        /// </summary>
+        /// <param name="dst_capacity">must be at least get_max_compressed_size(src_len)</param>
+        /// <returns>compressed size, 0 if dst_capacity is not enough</returns>
+        size_t compress(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_capacity);
+
+        /// <summary>
+        /// Decompress one block. Damaged data is detected by bounds checks, nothing is read or written out of range.
+        /// </summary>
+        /// <returns>decompressed size, SIZE_MAX if the data is invalid or doesn't fit into dst_capacity</returns>
+        static size_t decompress(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_capacity);
+
+        static constexpr size_t get_max_compressed_size(size_t src_len)
+        {
+            return src_len + src_len / 255 + 16;
+        }
+
+        bq_forceinline level get_level() const { return level_; }
+
+        bq_forceinline void set_level(level compression_level) { level_ = compression_level; }
+
+    private:
+        static constexpr uint32_t FAST_HASH_BITS = 14;
+        static constexpr uint32_t HIGH_HASH_BITS = 15;
+        static constexpr uint32_t WINDOW_SIZE = 64 * 1024;
+        static constexpr uint32_t HIGH_MAX_ATTEMPTS = 64;
+
+        size_t compress_fast(const uint8_t* src, size_t src_len, uint8_t* dst);
+        size_t compress_high(const uint8_t* src, size_t src_len, uint8_t* dst);
+
+    private:
+        level level_;
+        // fast: last position of each hash. high: last position + 1 of each hash, 0 for none.
+        bq::array<uint32_t> hash_table_;
+        // high only: distance to the previous position with the same hash, indexed by position in the window
+        bq::array<uint16_t> chain_table_;
+    };
+}
@@ -269,8 +269,176 @@ namespace bq {
 
             memcpy(block, state, 16);
         }
+
+        bq_forceinline const uint8_t* get_round_keys() const
+        {
+            return round_key_.begin();
+        }
+
+        bq_forceinline size_t get_rounds() const
+        {
+            return nr_;
+        }
     };
 
+#if defined(BQ_X86)
+    // =================================================================================================
+    // AES-NI / VAES Implementation
+    // The round keys produced by aes_core::key_expansion are in FIPS-197 byte order, which is exactly
+    // the layout the AES instructions expect, so they can be loaded directly.
+    // =================================================================================================
+    static constexpr size_t AES_MAX_ROUNDS = 14;
+
+    BQ_HW_AES_TARGET static void aes_cbc_encrypt_aesni(uint8_t* buf, size_t len, const uint8_t* round_keys, size_t nr, const uint8_t* iv)
+    {
+        __m128i rk[AES_MAX_ROUNDS + 1];
+        for (size_t r = 0; r <= nr; ++r) {
+            rk[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(round_keys + 16 * r));
+        }
+        // CBC encryption is inherently serial, each block depends on the previous ciphertext.
+        __m128i chain = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+        for (size_t i = 0; i < len; i += 16) {
+            __m128i state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i)), chain);
+            state = _mm_xor_si128(state, rk[0]);
+            for (size_t r = 1; r < nr; ++r) {
+                state = _mm_aesenc_si128(state, rk[r]);
+            }
+            chain = _mm_aesenclast_si128(state, rk[nr]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buf + i), chain);
+        }
+    }
+
+    // Equivalent inverse cipher key schedule: reversed order, InvMixColumns applied to the middle round keys.
+    BQ_HW_AES_TARGET static void aes_prepare_decrypt_keys_aesni(__m128i* dk, const uint8_t* round_keys, size_t nr)
+    {
+        dk[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(round_keys + 16 * nr));
+        for (size_t r = 1; r < nr; ++r) {
+            dk[r] = _mm_aesimc_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(round_keys + 16 * (nr - r))));
+        }
+        dk[nr] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(round_keys));
+    }
+
+    BQ_HW_AES_TARGET static __m128i aes_decrypt_block_aesni(__m128i state, const __m128i* dk, size_t nr)
+    {
+        state = _mm_xor_si128(state, dk[0]);
+        for (size_t r = 1; r < nr; ++r) {
+            state = _mm_aesdec_si128(state, dk[r]);
+        }
+        return _mm_aesdeclast_si128(state, dk[nr]);
+    }
+
+    // Decrypts [offset, len) of buf in place, prev is the ciphertext block preceding offset (or the iv).
+    BQ_HW_AES_TARGET static void aes_cbc_decrypt_aesni_range(uint8_t* buf, size_t offset, size_t len, const __m128i* dk, size_t nr, __m128i prev)
+    {
+        size_t i = offset;
+        // CBC decryption has no dependency between blocks, interleave 4 of them to hide the aesdec latency.
+        for (; i + 64 <= len; i += 64) {
+            const __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i));
+            const __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i + 16));
+            const __m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i + 32));
+            const __m128i c3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i + 48));
+            __m128i s0 = _mm_xor_si128(c0, dk[0]);
+            __m128i s1 = _mm_xor_si128(c1, dk[0]);
+            __m128i s2 = _mm_xor_si128(c2, dk[0]);
+            __m128i s3 = _mm_xor_si128(c3, dk[0]);
+            for (size_t r = 1; r < nr; ++r) {
+                s0 = _mm_aesdec_si128(s0, dk[r]);
+                s1 = _mm_aesdec_si128(s1, dk[r]);
+                s2 = _mm_aesdec_si128(s2, dk[r]);
+                s3 = _mm_aesdec_si128(s3, dk[r]);
+            }
+            s0 = _mm_aesdeclast_si128(s0, dk[nr]);
+            s1 = _mm_aesdeclast_si128(s1, dk[nr]);
+            s2 = _mm_aesdeclast_si128(s2, dk[nr]);
+            s3 = _mm_aesdeclast_si128(s3, dk[nr]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buf + i), _mm_xor_si128(s0, prev));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buf + i + 16), _mm_xor_si128(s1, c0));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buf + i + 32), _mm_xor_si128(s2, c1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buf + i + 48), _mm_xor_si128(s3, c2));
+            prev = c3;
+        }
+        for (; i < len; i += 16) {
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buf + i), _mm_xor_si128(aes_decrypt_block_aesni(c, dk, nr), prev));
+            prev = c;
+        }
+    }
+
+    BQ_HW_AES_TARGET static void aes_cbc_decrypt_aesni(uint8_t* buf, size_t len, const uint8_t* round_keys, size_t nr, const uint8_t* iv)
+    {
+        __m128i dk[AES_MAX_ROUNDS + 1];
+        aes_prepare_decrypt_keys_aesni(dk, round_keys, nr);
+        aes_cbc_decrypt_aesni_range(buf, 0, len, dk, nr, _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv)));
+    }
+
+    BQ_HW_VAES_TARGET static void aes_cbc_decrypt_vaes(uint8_t* buf, size_t len, const uint8_t* round_keys, size_t nr, const uint8_t* iv)
+    {
+        __m128i dk[AES_MAX_ROUNDS + 1];
+        aes_prepare_decrypt_keys_aesni(dk, round_keys, nr);
+        __m512i dk512[AES_MAX_ROUNDS + 1];
+        for (size_t r = 0; r <= nr; ++r) {
+            dk512[r] = _mm512_broadcast_i32x4(dk[r]);
+        }
+        // Only the highest 128-bit lane of prev_c is consumed: it holds the ciphertext block preceding the current group.
+        __m512i prev_c = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(iv)));
+        size_t i = 0;
+        // 8 blocks per iteration in two zmm registers, 4 blocks each.
+        for (; i + 128 <= len; i += 128) {
+            const __m512i c0 = _mm512_loadu_si512(reinterpret_cast<const void*>(buf + i));
+            const __m512i c1 = _mm512_loadu_si512(reinterpret_cast<const void*>(buf + i + 64));
+            __m512i s0 = _mm512_xor_si512(c0, dk512[0]);
+            __m512i s1 = _mm512_xor_si512(c1, dk512[0]);
+            for (size_t r = 1; r < nr; ++r) {
+                s0 = _mm512_aesdec_epi128(s0, dk512[r]);
+                s1 = _mm512_aesdec_epi128(s1, dk512[r]);
+            }
+            s0 = _mm512_aesdeclast_epi128(s0, dk512[nr]);
+            s1 = _mm512_aesdeclast_epi128(s1, dk512[nr]);
+            // {prev[3], c[0], c[1], c[2]}
+            _mm512_storeu_si512(reinterpret_cast<void*>(buf + i), _mm512_xor_si512(s0, _mm512_alignr_epi64(c0, prev_c, 6)));
+            _mm512_storeu_si512(reinterpret_cast<void*>(buf + i + 64), _mm512_xor_si512(s1, _mm512_alignr_epi64(c1, c0, 6)));
+            prev_c = c1;
+        }
+        aes_cbc_decrypt_aesni_range(buf, i, len, dk, nr, _mm512_extracti32x4_epi32(prev_c, 3));
+    }
+
+    enum class aes_hw_level {
+        software,
+        aes_ni,
+        vaes
+    };
+
+    static aes_hw_level get_aes_hw_level()
+    {
+#ifdef BQ_UNIT_TEST
+        switch (aes::hardware_acceleration_mode_) {
+        case aes::acceleration_mode::software:
+            return aes_hw_level::software;
+        case aes::acceleration_mode::aes_ni:
+            return common_global_vars::get().aes_ni_support_ ? aes_hw_level::aes_ni : aes_hw_level::software;
+        default:
+            break;
+        }
+#endif
+        if (common_global_vars::get().vaes_support_) {
+            return aes_hw_level::vaes;
+        }
+        if (common_global_vars::get().aes_ni_support_) {
+            return aes_hw_level::aes_ni;
+        }
+        return aes_hw_level::software;
+    }
+#endif
+
+#ifdef BQ_UNIT_TEST
+    aes::acceleration_mode aes::hardware_acceleration_mode_ = aes::acceleration_mode::auto_detect;
+
+    void aes::set_hardware_acceleration_mode(acceleration_mode m)
+    {
+        hardware_acceleration_mode_ = m;
+    }
+#endif
+
     uint8_t aes_core::sbox_[256] = {
         0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
         0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
@@ -371,6 +539,13 @@ namespace bq {
         aes_core core(mode_, key_bits_);
         core.key_expansion(key);
 
+#if defined(BQ_X86)
+        if (get_aes_hw_level() != aes_hw_level::software) {
+            aes_cbc_encrypt_aesni(out_ciphertext, n, core.get_round_keys(), core.get_rounds(), iv.begin());
+            return true;
+        }
+#endif
+
         // working buffers
         bq::array<uint8_t> chain;
         chain.fill_uninitialized(iv_size_);
@@ -416,6 +591,19 @@ namespace bq {
         aes_core core(mode_, key_bits_);
         core.key_expansion(key);
 
+#if defined(BQ_X86)
+        switch (get_aes_hw_level()) {
+        case aes_hw_level::vaes:
+            aes_cbc_decrypt_vaes(out_plaintext, n, core.get_round_keys(), core.get_rounds(), iv.begin());
+            return true;
+        case aes_hw_level::aes_ni:
+            aes_cbc_decrypt_aesni(out_plaintext, n, core.get_round_keys(), core.get_rounds(), iv.begin());
+            return true;
+        default:
+            break;
+        }
+#endif
+
         // working buffers
         uint8_t prev[16];
         uint8_t cur[16];
@@ -18,6 +18,7 @@
  * \brief
  *
  * Simple AES implementation supporting ECB, CBC, CFB, OFB, CTR modes with 128, 192, and 256-bit keys.
+ * On x86 the block cipher runs on AES-NI (and VAES for CBC decryption) when the CPU supports it.
  *
  */
 
@@ -77,6 +78,17 @@ namespace bq {
             return decrypt(key, iv, ciphertext.begin(), ciphertext.size(), out_plaintext.begin(), out_plaintext.size());
         }
 
+#ifdef BQ_UNIT_TEST
+        enum class acceleration_mode : int32_t {
+            auto_detect = 0,
+            software = 1,
+            aes_ni = 2,
+            vaes = 3
+        };
+        static acceleration_mode hardware_acceleration_mode_;
+        static void set_hardware_acceleration_mode(acceleration_mode m);
+#endif
+
     private:
         enum_cipher_mode mode_;
         enum_key_bits key_bits_;
@@ -39,7 +39,7 @@ namespace bq {
 // Define scalar if we are in unit test (to allow fallback) OR if we don't have any HW acceleration available
 #if defined(BQ_UNIT_TEST) || (!defined(BQ_X86) && !defined(BQ_ARM_NEON))
     // -------------------------------------------------------------------------------------------------
-    static void vernam_encrypt_scalar(uint8_t* BQ_RESTRICT buf, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
+    static void vernam_encrypt_scalar(uint8_t* dst, const uint8_t* src, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
     {
         if (len == 0)
             return;
@@ -50,10 +50,11 @@ namespace bq {
 #ifndef NDEBUG
         assert((key_size_pow2 & (key_size_pow2 - 1)) == 0 && "key_size_pow2 must be power of two");
         assert((key_size_pow2 & align_mask) == 0 && "vernam_encrypt_scalar key_size_pow2 should be multiple of 8 for u64 path");
-        assert(((static_cast<size_t>(reinterpret_cast<uintptr_t>(buf)) & align_mask) == (key_stream_offset & align_mask)) && "vernam_encrypt_32bytes_aligned: relative alignment mismatch");
+        assert(((static_cast<size_t>(reinterpret_cast<uintptr_t>(dst)) & align_mask) == (key_stream_offset & align_mask)) && "vernam_encrypt_32bytes_aligned: relative alignment mismatch");
 #endif
 
-        uint8_t* p = buf;
+        uint8_t* p = dst;
+        const uint8_t* s = src;
         size_t remaining = len;
         size_t current_key_pos = key_stream_offset & key_mask;
 
@@ -62,11 +63,12 @@ namespace bq {
         size_t head_len = (align_diff < remaining) ? align_diff : remaining;
 
         for (size_t j = 0; j < head_len; ++j) {
-            p[j] ^= key[current_key_pos];
+            p[j] = static_cast<uint8_t>(s[j] ^ key[current_key_pos]);
             current_key_pos = (current_key_pos + 1) & key_mask;
         }
 
         p += head_len;
+        s += head_len;
         remaining -= head_len;
 
         if (remaining == 0)
@@ -85,10 +87,14 @@ namespace bq {
             const uint64_t* k64 = reinterpret_cast<const uint64_t*>(key + current_key_pos);
 
             for (size_t i = 0; i < u64_count; ++i) {
-                p64[i] ^= k64[i];
+                // src has no alignment requirement
+                uint64_t v;
+                memcpy(&v, s + (i << 3), sizeof(v));
+                p64[i] = v ^ k64[i];
             }
 
             p += loop_len;
+            s += loop_len;
             p64 += u64_count;
             remaining -= loop_len;
             current_key_pos += loop_len;
@@ -101,7 +107,7 @@ namespace bq {
         // Tail
         current_key_pos &= key_mask;
         for (size_t j = 0; j < remaining; ++j) {
-            p[j] ^= key[current_key_pos];
+            p[j] = static_cast<uint8_t>(s[j] ^ key[current_key_pos]);
             current_key_pos = (current_key_pos + 1) & key_mask;
         }
     }
@@ -111,7 +117,7 @@ namespace bq {
 
     // 2. SSE Implementation (x86/x64)
     // -------------------------------------------------------------------------------------------------
-    static BQ_HW_SIMD_SSE_TARGET void vernam_encrypt_sse(uint8_t* BQ_RESTRICT buf, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
+    static BQ_HW_SIMD_SSE_TARGET void vernam_encrypt_sse(uint8_t* dst, const uint8_t* src, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
     {
         const size_t key_mask = key_size_pow2 - 1;
         constexpr size_t align_mask = 15; // 16-byte alignment
@@ -121,7 +127,8 @@ namespace bq {
         assert((key_size_pow2 & align_mask) == 0 && "vernam_encrypt_sse key_size_pow2 should be multiple of 16");
 #endif
 
-        uint8_t* p = buf;
+        uint8_t* p = dst;
+        const uint8_t* s = src;
         size_t remaining = len;
         size_t current_key_pos = key_stream_offset & key_mask;
 
@@ -130,16 +137,17 @@ namespace bq {
         size_t head_len = (align_diff < remaining) ? align_diff : remaining;
 
         for (size_t j = 0; j < head_len; ++j) {
-            p[j] ^= key[current_key_pos];
+            p[j] = static_cast<uint8_t>(s[j] ^ key[current_key_pos]);
             current_key_pos = (current_key_pos + 1) & key_mask;
         }
         p += head_len;
+        s += head_len;
         remaining -= head_len;
 
         if (remaining < 16) {
             current_key_pos &= key_mask;
             for (size_t j = 0; j < remaining; ++j) {
-                p[j] ^= key[current_key_pos];
+                p[j] = static_cast<uint8_t>(s[j] ^ key[current_key_pos]);
                 current_key_pos = (current_key_pos + 1) & key_mask;
             }
             return;
@@ -155,7 +163,8 @@ namespace bq {
             size_t num_blocks = loop_len >> 4;
 
             for (size_t i = 0; i < num_blocks; ++i) {
-                __m128i v_buf = _mm_load_si128(reinterpret_cast<__m128i*>(p));
+                // src has no alignment requirement, it is the dst that is aligned
+                __m128i v_buf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
                 __m128i v_key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(k_ptr));
 
                 __m128i v_res = _mm_xor_si128(v_buf, v_key);
@@ -163,6 +172,7 @@ namespace bq {
                 _mm_store_si128(reinterpret_cast<__m128i*>(p), v_res);
 
                 p += 16;
+                s += 16;
                 k_ptr += 16;
             }
 
@@ -176,7 +186,7 @@ namespace bq {
 
         current_key_pos &= key_mask;
         for (size_t j = 0; j < remaining; ++j) {
-            p[j] ^= key[current_key_pos];
+            p[j] = static_cast<uint8_t>(s[j] ^ key[current_key_pos]);
             current_key_pos = (current_key_pos + 1) & key_mask;
         }
     }
@@ -185,7 +195,7 @@ namespace bq {
     // -------------------------------------------------------------------------------------------------
     // We use intrinsics to FORCE AVX2 instructions regardless of compiler flags.
     // This function is only called if g_has_avx2 is true.
-    static BQ_HW_SIMD_TARGET void vernam_encrypt_avx2(uint8_t* BQ_RESTRICT buf, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
+    static BQ_HW_SIMD_TARGET void vernam_encrypt_avx2(uint8_t* dst, const uint8_t* src, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
     {
         // ... (Header alignment same as scalar, omitted for brevity, usually caller handles large chunks) ...
         // Re-implementing logic with AVX2 intrinsics
@@ -196,10 +206,11 @@ namespace bq {
 #ifndef NDEBUG
         assert((key_size_pow2 & (key_size_pow2 - 1)) == 0 && "key_size_pow2 must be power of two");
         assert((key_size_pow2 & align_mask) == 0 && "vernam_encrypt_avx2 key_size_pow2 should be multiple of 32");
-        assert(((static_cast<size_t>(reinterpret_cast<uintptr_t>(buf)) & align_mask) == (key_stream_offset & align_mask)) && "vernam_encrypt_avx2: relative alignment mismatch");
+        assert(((static_cast<size_t>(reinterpret_cast<uintptr_t>(dst)) & align_mask) == (key_stream_offset & align_mask)) && "vernam_encrypt_avx2: relative alignment mismatch");
 #endif
 
-        uint8_t* p = buf;
+        uint8_t* p = dst;
+        const uint8_t* s = src;
         size_t remaining = len;
         size_t current_key_pos = key_stream_offset & key_mask;
 
@@ -208,17 +219,18 @@ namespace bq {
         size_t head_len = (align_diff < remaining) ? align_diff : remaining;
 
         for (size_t j = 0; j < head_len; ++j) {
-            p[j] ^= key[current_key_pos];
+            p[j] = static_cast<uint8_t>(s[j] ^ key[current_key_pos]);
             current_key_pos++;
         }
         p += head_len;
+        s += head_len;
         remaining -= head_len;
 
         if (remaining < 32) {
             // Fallback to scalar tail handling if remaining is small
             current_key_pos &= key_mask;
             for (size_t j = 0; j < remaining; ++j) {
-                p[j] ^= key[current_key_pos];
+                p[j] = static_cast<uint8_t>(s[j] ^ key[current_key_pos]);
                 current_key_pos = (current_key_pos + 1) & key_mask;
             }
             return;
@@ -236,18 +248,19 @@ namespace bq {
             // Using intrinsics
             size_t num_blocks = loop_len >> 5; // divide by 32
             for (size_t i = 0; i < num_blocks; ++i) {
-                // Load 32 bytes from buffer (aligned)
-                __m256i v_buf = _mm256_load_si256(reinterpret_cast<__m256i*>(p));
+                // Load 32 bytes from source (no alignment requirement, it is the dst that is aligned)
+                __m256i v_buf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
                 // Load 32 bytes from key (unaligned potentially, loadu handles it)
                 __m256i v_key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(k_ptr));
 
                 // VERNAM
                 __m256i v_res = _mm256_xor_si256(v_buf, v_key);
 
-                // Store back (aligned)
+                // Store to destination (aligned)
                 _mm256_store_si256(reinterpret_cast<__m256i*>(p), v_res);
 
                 p += 32;
+                s += 32;
                 k_ptr += 32;
             }
 
@@ -261,18 +274,80 @@ namespace bq {
 
         current_key_pos &= key_mask;
         for (size_t j = 0; j < remaining; ++j) {
-            p[j] ^= key[current_key_pos];
+            p[j] = static_cast<uint8_t>(s[j] ^ key[current_key_pos]);
             current_key_pos = (current_key_pos + 1) & key_mask;
         }
     }
+
+    // 3. AVX-512 Implementation (x86/x64 Only)
+    // -------------------------------------------------------------------------------------------------
+    // Only called if AVX-512 F/BW/VL are supported. The head and the tail before each key wrap are
+    // handled with masked loads/stores instead of byte loops.
+    static BQ_HW_SIMD_AVX512_TARGET void vernam_encrypt_avx512(uint8_t* dst, const uint8_t* src, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
+    {
+        const size_t key_mask = key_size_pow2 - 1;
+        constexpr size_t align_mask = 63; // 64-byte alignment for ZMM stores
+
+#ifndef NDEBUG
+        assert((key_size_pow2 & (key_size_pow2 - 1)) == 0 && "key_size_pow2 must be power of two");
+        assert((key_size_pow2 & 31) == 0 && "vernam_encrypt_avx512 key_size_pow2 should be multiple of 32");
+#endif
+
+        uint8_t* p = dst;
+        const uint8_t* s = src;
+        size_t remaining = len;
+        size_t current_key_pos = key_stream_offset & key_mask;
+
+        // Head: align dst to 64 bytes with one masked operation, it never crosses the key end
+        // because the key size is a multiple of 32 and dst is aligned to 32 relative to the key.
+        size_t head_len = (64 - (reinterpret_cast<uintptr_t>(p) & align_mask)) & align_mask;
+        head_len = bq::min_value(bq::min_value(head_len, remaining), key_size_pow2 - current_key_pos);
+        if (head_len > 0) {
+            const __mmask64 m = static_cast<__mmask64>((static_cast<uint64_t>(1) << head_len) - 1);
+            const __m512i v_buf = _mm512_maskz_loadu_epi8(m, s);
+            const __m512i v_key = _mm512_maskz_loadu_epi8(m, key + current_key_pos);
+            _mm512_mask_storeu_epi8(p, m, _mm512_xor_si512(v_buf, v_key));
+            p += head_len;
+            s += head_len;
+            remaining -= head_len;
+            current_key_pos = (current_key_pos + head_len) & key_mask;
+        }
+
+        while (remaining > 0) {
+            size_t contiguous_key_len = key_size_pow2 - current_key_pos;
+            size_t chunk_len = (contiguous_key_len < remaining) ? contiguous_key_len : remaining;
+            size_t num_blocks = chunk_len >> 6;
+            const uint8_t* k_ptr = key + current_key_pos;
+
+            for (size_t i = 0; i < num_blocks; ++i) {
+                const __m512i v_buf = _mm512_loadu_si512(s);
+                const __m512i v_key = _mm512_loadu_si512(k_ptr);
+                _mm512_storeu_si512(p, _mm512_xor_si512(v_buf, v_key));
+                p += 64;
+                s += 64;
+                k_ptr += 64;
+            }
+            size_t tail_len = chunk_len & align_mask;
+            if (tail_len > 0) {
+                const __mmask64 m = static_cast<__mmask64>((static_cast<uint64_t>(1) << tail_len) - 1);
+                const __m512i v_buf = _mm512_maskz_loadu_epi8(m, s);
+                const __m512i v_key = _mm512_maskz_loadu_epi8(m, k_ptr);
+                _mm512_mask_storeu_epi8(p, m, _mm512_xor_si512(v_buf, v_key));
+                p += tail_len;
+                s += tail_len;
+            }
+            remaining -= chunk_len;
+            current_key_pos = (current_key_pos + chunk_len) & key_mask;
+        }
+    }
 #endif
 
 #if defined(BQ_ARM) && defined(BQ_ARM_NEON)
-    // 3. NEON Implementation (ARMv7 / ARMv8)
+    // 4. NEON Implementation (ARMv7 / ARMv8)
     // -------------------------------------------------------------------------------------------------
     // ARMv8 (AArch64) guarantees NEON support.
     // ARMv7 usually supports it (Android requires it for most ABIs now).
-    static void vernam_encrypt_neon(uint8_t* BQ_RESTRICT buf, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
+    static void vernam_encrypt_neon(uint8_t* dst, const uint8_t* src, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
     {
         const size_t key_mask = key_size_pow2 - 1;
         constexpr size_t align_mask = 15; // 16-byte alignment for NEON
@@ -280,10 +355,11 @@ namespace bq {
 #ifndef NDEBUG
         assert((key_size_pow2 & (key_size_pow2 - 1)) == 0 && "key_size_pow2 must be power of two");
         assert((key_size_pow2 & align_mask) == 0 && "vernam_encrypt_neon key_size_pow2 should be multiple of 16");
-        assert(((static_cast<size_t>(reinterpret_cast<uintptr_t>(buf)) & align_mask) == (key_stream_offset & align_mask)) && "vernam_encrypt_neon: relative alignment mismatch");
+        assert(((static_cast<size_t>(reinterpret_cast<uintptr_t>(dst)) & align_mask) == (key_stream_offset & align_mask)) && "vernam_encrypt_neon: relative alignment mismatch");
 #endif
 
-        uint8_t* p = buf;
+        uint8_t* p = dst;
+        const uint8_t* s = src;
         size_t remaining = len;
         size_t current_key_pos = key_stream_offset & key_mask;
 
@@ -292,10 +368,11 @@ namespace bq {
         size_t head_len = (align_diff < remaining) ? align_diff : remaining;
 
         for (size_t j = 0; j < head_len; ++j) {
-            p[j] ^= key[current_key_pos];
+            p[j] = static_cast<uint8_t>(s[j] ^ key[current_key_pos]);
             current_key_pos++;
         }
         p += head_len;
+        s += head_len;
         remaining -= head_len;
 
         // NEON Loop (128-bit)
@@ -309,7 +386,7 @@ namespace bq {
 
             for (size_t i = 0; i < num_blocks; ++i) {
                 // vld1q_u8 loads 128-bit (16 bytes)
-                uint8x16_t v_buf = vld1q_u8(p);
+                uint8x16_t v_buf = vld1q_u8(s);
                 uint8x16_t v_key = vld1q_u8(k_ptr);
 
                 // veorq_u8 does VERNAM
@@ -319,6 +396,7 @@ namespace bq {
                 vst1q_u8(p, v_res);
 
                 p += 16;
+                s += 16;
                 k_ptr += 16;
             }
 
@@ -332,7 +410,7 @@ namespace bq {
 
         current_key_pos &= key_mask;
         for (size_t j = 0; j < remaining; ++j) {
-            p[j] ^= key[current_key_pos];
+            p[j] = static_cast<uint8_t>(s[j] ^ key[current_key_pos]);
             current_key_pos = (current_key_pos + 1) & key_mask;
         }
     }
@@ -342,43 +420,61 @@ namespace bq {
     // Public Entry Point (Dispatcher)
     // =================================================================================================
 
-    void vernam::vernam_encrypt_32bytes_aligned(uint8_t* BQ_RESTRICT buf, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
+    static void vernam_encrypt_dispatch(uint8_t* dst, const uint8_t* src, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
     {
 #if defined(BQ_X86)
 #ifdef BQ_UNIT_TEST
-        if (hardware_acceleration_mode_ == mode::scalar) {
-            vernam_encrypt_scalar(buf, len, key, key_size_pow2, key_stream_offset);
+        if (vernam::hardware_acceleration_mode_ == vernam::mode::scalar) {
+            vernam_encrypt_scalar(dst, src, len, key, key_size_pow2, key_stream_offset);
+            return;
+        }
+        if (vernam::hardware_acceleration_mode_ == vernam::mode::sse) {
+            vernam_encrypt_sse(dst, src, len, key, key_size_pow2, key_stream_offset);
             return;
         }
-        if (hardware_acceleration_mode_ == mode::sse) {
-            vernam_encrypt_sse(buf, len, key, key_size_pow2, key_stream_offset);
+        if (vernam::hardware_acceleration_mode_ == vernam::mode::avx2) {
+            vernam_encrypt_avx2(dst, src, len, key, key_size_pow2, key_stream_offset);
             return;
         }
 #endif
+        if (common_global_vars::get().avx512_support_) {
+            vernam_encrypt_avx512(dst, src, len, key, key_size_pow2, key_stream_offset);
+            return;
+        }
         if (common_global_vars::get().avx2_support_) {
-            vernam_encrypt_avx2(buf, len, key, key_size_pow2, key_stream_offset);
+            vernam_encrypt_avx2(dst, src, len, key, key_size_pow2, key_stream_offset);
             return;
         }
         // Fallback for non-AVX2 x86 (Use SSE)
-        vernam_encrypt_sse(buf, len, key, key_size_pow2, key_stream_offset);
+        vernam_encrypt_sse(dst, src, len, key, key_size_pow2, key_stream_offset);
 #elif defined(BQ_ARM)
 #ifdef BQ_UNIT_TEST
-        if (hardware_acceleration_mode_ == mode::scalar) {
-            vernam_encrypt_scalar(buf, len, key, key_size_pow2, key_stream_offset);
+        if (vernam::hardware_acceleration_mode_ == vernam::mode::scalar) {
+            vernam_encrypt_scalar(dst, src, len, key, key_size_pow2, key_stream_offset);
             return;
         }
 #endif
 #if defined(BQ_ARM_NEON)
         // For Android/iOS ARM64/ARMv7, NEON is effectively standard.
         // We can use it directly without complex runtime checks for most modern contexts.
-        vernam_encrypt_neon(buf, len, key, key_size_pow2, key_stream_offset);
+        vernam_encrypt_neon(dst, src, len, key, key_size_pow2, key_stream_offset);
 #else
-        vernam_encrypt_scalar(buf, len, key, key_size_pow2, key_stream_offset);
+        vernam_encrypt_scalar(dst, src, len, key, key_size_pow2, key_stream_offset);
 #endif
 #else
         // Fallback for non-AVX2 x86 or other architectures
-        vernam_encrypt_scalar(buf, len, key, key_size_pow2, key_stream_offset);
+        vernam_encrypt_scalar(dst, src, len, key, key_size_pow2, key_stream_offset);
 #endif
     }
 
+    void vernam::vernam_encrypt_32bytes_aligned(uint8_t* BQ_RESTRICT buf, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
+    {
+        vernam_encrypt_dispatch(buf, buf, len, key, key_size_pow2, key_stream_offset);
+    }
+
+    void vernam::vernam_encrypt_32bytes_aligned_copy(uint8_t* BQ_RESTRICT dst, const uint8_t* BQ_RESTRICT src, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset)
+    {
+        vernam_encrypt_dispatch(dst, src, len, key, key_size_pow2, key_stream_offset);
+    }
+
 }
@@ -39,12 +39,20 @@ namespace bq {
         /// <param name="key_stream_offset"></param>
         static void vernam_encrypt_32bytes_aligned(uint8_t* BQ_RESTRICT buf, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset);
 
+        /// <summary>
+        /// Encrypt/Decrypt src into dst with Vernam Cipher in a single pass, src is left untouched.
+        /// Attention: dst must be aligned to DEFAULT_BUFFER_ALIGNMENT relative to key_stream_offset, src has no alignment requirement.
+        /// dst and src must not overlap.
+        /// </summary>
+        static void vernam_encrypt_32bytes_aligned_copy(uint8_t* BQ_RESTRICT dst, const uint8_t* BQ_RESTRICT src, size_t len, const uint8_t* BQ_RESTRICT key, size_t key_size_pow2, size_t key_stream_offset);
+
 #ifdef BQ_UNIT_TEST
         enum class mode : int32_t {
             auto_detect = 0,
             scalar = 1,
             sse = 2,
-            avx2 = 3
+            avx2 = 3,
+            avx512 = 4
         };
         static mode hardware_acceleration_mode_;
         static void set_hardware_acceleration_mode(mode m);
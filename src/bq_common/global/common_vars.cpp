@@ -74,6 +74,96 @@ namespace bq {
 #endif
         return result;
     }
+
+    static void log_hardware_support(const char* feature_name, bool supported)
+    {
+#ifdef BQ_UNIT_TEST
+        bq::util::set_log_device_console_min_level(bq::log_level::info);
+#endif
+        bq::util::log_device_console(bq::log_level::info, "Hardware %s support:%s", feature_name, supported ? "true" : "false");
+#ifdef BQ_UNIT_TEST
+        bq::util::set_log_device_console_min_level(bq::log_level::warning);
+#endif
+    }
+
+    // XCR0 tells which register states the OS saves on context switches, the CPUID bits alone are not enough.
+    static uint64_t get_xcr0()
+    {
+        int32_t regs[4];
+#if defined(BQ_MSVC)
+        __cpuid(regs, 1);
+#else
+        __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        // ECX bit 27 is OSXSAVE
+        if ((regs[2] & (1 << 27)) == 0) {
+            return 0;
+        }
+#if defined(BQ_MSVC)
+        return static_cast<uint64_t>(_xgetbv(0));
+#else
+        uint32_t eax, edx;
+        __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | static_cast<uint64_t>(eax);
+#endif
+    }
+
+    static bool check_avx512_support()
+    {
+        bool result = false;
+        int32_t regs[4];
+#if defined(BQ_MSVC)
+        __cpuid(regs, 0);
+#else
+        __cpuid(0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        // XMM, YMM, opmask, ZMM_Hi256 and Hi16_ZMM states
+        constexpr uint64_t avx512_states = 0xE6;
+        if (regs[0] >= 7 && (get_xcr0() & avx512_states) == avx512_states) {
+#if defined(BQ_MSVC)
+            __cpuidex(regs, 7, 0);
+#else
+            __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+            // EBX bit 16 is AVX512F, bit 30 is AVX512BW, bit 31 is AVX512VL
+            const uint32_t ebx = static_cast<uint32_t>(regs[1]);
+            constexpr uint32_t required_bits = (1u << 16) | (1u << 30) | (1u << 31);
+            result = (ebx & required_bits) == required_bits;
+        }
+        log_hardware_support("AVX-512", result);
+        return result;
+    }
+
+    static bool check_aes_ni_support()
+    {
+        int32_t regs[4];
+#if defined(BQ_MSVC)
+        __cpuid(regs, 1);
+#else
+        __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        // ECX bit 25 is AES, bit 19 is SSE4.1
+        bool result = (regs[2] & (1 << 25)) != 0 && (regs[2] & (1 << 19)) != 0;
+        log_hardware_support("AES-NI", result);
+        return result;
+    }
+
+    static bool check_vaes_support(bool avx512_supported, bool aes_ni_supported)
+    {
+        bool result = false;
+        if (avx512_supported && aes_ni_supported) {
+            int32_t regs[4];
+#if defined(BQ_MSVC)
+            __cpuidex(regs, 7, 0);
+#else
+            __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+            // ECX bit 9 is VAES
+            result = (regs[2] & (1 << 9)) != 0;
+        }
+        log_hardware_support("VAES", result);
+        return result;
+    }
 #endif
 
     static bool check_crc32_support()
@@ -170,6 +260,9 @@ namespace bq {
 
 #if defined(BQ_X86)
         avx2_support_ = check_avx2_support();
+        avx512_support_ = avx2_support_ && check_avx512_support();
+        aes_ni_support_ = check_aes_ni_support();
+        vaes_support_ = check_vaes_support(avx512_support_, aes_ni_support_);
 #endif
         crc32_supported_ = check_crc32_support();
 #if defined(BQ_ANDROID)
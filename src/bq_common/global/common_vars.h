@@ -150,6 +150,11 @@ namespace bq {
         bq::platform::mutex console_mutex_;
 #if defined(BQ_X86)
         bool avx2_support_;
+        // AVX-512 F/BW/VL, with the ZMM state enabled by the OS
+        bool avx512_support_;
+        bool aes_ni_support_;
+        // 512 bits VAES, implies avx512_support_ and aes_ni_support_
+        bool vaes_support_;
 #endif
         bool crc32_supported_;
         bq::platform::base_dir_initializer base_dir_init_inst_;
@@ -0,0 +1,86 @@
+﻿/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "bq_common/platform/io/file_watcher.h"
+#if defined(BQ_LINUX) || defined(BQ_ANDROID)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace bq {
+    // polling interval when changes can not be notified
+    static constexpr uint64_t FILE_WATCHER_POLL_INTERVAL_MS = 50;
+
+    file_watcher::file_watcher()
+        : fd_(-1)
+    {
+    }
+
+    file_watcher::~file_watcher()
+    {
+        close();
+    }
+
+    void file_watcher::close()
+    {
+#if defined(BQ_LINUX) || defined(BQ_ANDROID)
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+#endif
+        fd_ = -1;
+    }
+
+    bool file_watcher::watch(const bq::string& file_abs_path)
+    {
+        close();
+#if defined(BQ_LINUX) || defined(BQ_ANDROID)
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd_ < 0) {
+            bq::util::log_device_console(log_level::warning, "inotify_init1 failed, error code:%d, fall back to polling", errno);
+            return false;
+        }
+        bq::string dir_path = bq::file_manager::get_directory_from_path(file_abs_path);
+        if (inotify_add_watch(fd_, file_abs_path.c_str(), IN_MODIFY) < 0
+            || inotify_add_watch(fd_, dir_path.c_str(), IN_CREATE | IN_MOVED_TO) < 0) {
+            bq::util::log_device_console(log_level::warning, "inotify_add_watch failed, path:%s, error code:%d, fall back to polling", file_abs_path.c_str(), errno);
+            close();
+            return false;
+        }
+        return true;
+#else
+        (void)file_abs_path;
+        return false;
+#endif
+    }
+
+    void file_watcher::wait(uint64_t timeout_ms)
+    {
+#if defined(BQ_LINUX) || defined(BQ_ANDROID)
+        if (fd_ >= 0) {
+            struct pollfd poll_fd;
+            poll_fd.fd = fd_;
+            poll_fd.events = POLLIN;
+            poll_fd.revents = 0;
+            int32_t poll_timeout = static_cast<int32_t>(bq::min_value(timeout_ms, static_cast<uint64_t>(INT32_MAX)));
+            if (poll(&poll_fd, 1, poll_timeout) > 0) {
+                // the events themselves are not needed, drain them so the next wait blocks again.
+                char events_buffer[4096];
+                while (read(fd_, events_buffer, sizeof(events_buffer)) > 0) {
+                }
+            }
+            return;
+        }
+#endif
+        bq::platform::thread::sleep(bq::min_value(timeout_ms, FILE_WATCHER_POLL_INTERVAL_MS));
+    }
+}
@@ -0,0 +1,40 @@
+﻿#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+/*!
+ * \file file_watcher.h
+ * wait until a file is modified or a file is created beside it.
+ * inotify is used on Linux and Android, other platforms poll.
+ *
+ */
+#include "bq_common/bq_common.h"
+namespace bq {
+    class file_watcher {
+    public:
+        file_watcher();
+        ~file_watcher();
+        file_watcher(const file_watcher&) = delete;
+        file_watcher& operator=(const file_watcher&) = delete;
+
+        // watch modifications of the file and files created in its directory, previous watches are dropped.
+        bool watch(const bq::string& file_abs_path);
+
+        // returns after a watched change or timeout_ms, it may also return early without any change.
+        void wait(uint64_t timeout_ms);
+
+    private:
+        void close();
+
+    private:
+        int32_t fd_;
+    };
+}
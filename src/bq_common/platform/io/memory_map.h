@@ -58,6 +58,12 @@ namespace bq {
 
         static memory_map_handle create_memory_map(const bq::file_handle& map_file, const size_t offset, const size_t size);
 
+        // map_file only needs to be opened for reading, and it is never resized, so offset + size must not exceed the file size.
+        static memory_map_handle create_memory_map_read_only(const bq::file_handle& map_file, const size_t offset, const size_t size);
+
+        // hint that the mapped data will be read in order, so the system can read ahead more aggressively.
+        static void advise_sequential(const memory_map_handle& handle);
+
         static void flush_memory_map(const memory_map_handle& handle);
 
         static void release_memory_map(memory_map_handle& handle);
@@ -75,6 +75,43 @@ namespace bq {
         return result;
     }
 
+    memory_map_handle memory_map::create_memory_map_read_only(const bq::file_handle& map_file, const size_t offset, const size_t size)
+    {
+        memory_map_handle result;
+        if (!map_file.is_valid()) {
+            result.error_code_ = EBADF;
+            bq::util::log_device_console_plain_text(log_level::error, "create_memory_map_read_only with invalid map_file");
+            return result;
+        }
+        size_t real_mapping_offset = get_real_map_offset(offset);
+        size_t real_mapping_size = get_real_map_size(offset, size);
+        size_t alignment_offset = offset - real_mapping_offset;
+
+        result.real_data_ = mmap(NULL, real_mapping_size, PROT_READ, MAP_SHARED, map_file.platform_handle(), static_cast<off_t>(real_mapping_offset));
+        if (MAP_FAILED == result.real_data_) {
+            result.real_data_ = nullptr;
+            result.error_code_ = errno;
+            bq::util::log_device_console(log_level::error, "create_memory_map_read_only file failed, path:%s, error_code:%d", map_file.abs_file_path().c_str(), result.error_code_);
+            return result;
+        }
+
+        result.mapped_data_ = (void*)((uint8_t*)result.real_data_ + alignment_offset);
+        result.file_ = map_file;
+        result.size_ = size;
+        *(size_t*)result.platform_data_ = real_mapping_size;
+        return result;
+    }
+
+    void memory_map::advise_sequential(const memory_map_handle& handle)
+    {
+        if (!handle.has_been_mapped()) {
+            return;
+        }
+        if (0 != madvise(handle.real_data_, *(const size_t*)handle.platform_data_, MADV_SEQUENTIAL)) {
+            bq::util::log_device_console(log_level::warning, "advise_sequential failed, error_code:%d", errno);
+        }
+    }
+
     void memory_map::flush_memory_map(const memory_map_handle& handle)
     {
 #ifndef NDEBUG
@@ -84,6 +84,49 @@ namespace bq {
         return result;
     }
 
+    memory_map_handle memory_map::create_memory_map_read_only(const bq::file_handle& map_file, const size_t offset, const size_t size)
+    {
+        memory_map_handle result;
+        if (!map_file.is_valid()) {
+            result.error_code_ = ERROR_INVALID_HANDLE;
+            bq::util::log_device_console_plain_text(log_level::error, "create_memory_map_read_only with invalid map_file");
+            return result;
+        }
+        HANDLE file_handle = map_file.platform_handle();
+
+        HANDLE& memory_map_handle = *(HANDLE*)(result.platform_data_);
+
+        size_t real_mapping_offset = get_real_map_offset(offset);
+        size_t alignment_offset = offset - real_mapping_offset;
+
+        // a read only mapping can not be larger than the file, map the whole file and view only the required range.
+        memory_map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!memory_map_handle) {
+            result.error_code_ = static_cast<int32_t>(GetLastError());
+            bq::util::log_device_console(log_level::error, "create_memory_map_read_only file failed, path:%s, error_code:%d", map_file.abs_file_path().c_str(), result.error_code_);
+            return result;
+        }
+
+        result.real_data_ = MapViewOfFile(memory_map_handle, FILE_MAP_READ, (DWORD)(real_mapping_offset >> 32), (DWORD)(real_mapping_offset & 0x00000000FFFFFFFF), alignment_offset + size);
+        if (!result.real_data_) {
+            CloseHandle(memory_map_handle);
+            memory_map_handle = 0;
+            result.error_code_ = static_cast<int32_t>(GetLastError());
+            bq::util::log_device_console(log_level::error, "map_to_memory read only file failed, path:%s, error_code:%d", map_file.abs_file_path().c_str(), result.error_code_);
+            return result;
+        }
+        result.mapped_data_ = (void*)((uint8_t*)result.real_data_ + alignment_offset);
+        result.file_ = map_file;
+        result.size_ = size;
+        return result;
+    }
+
+    void memory_map::advise_sequential(const memory_map_handle& handle)
+    {
+        // Windows has no per mapping access pattern hint, the file cache detects sequential reads itself.
+        (void)handle;
+    }
+
     void memory_map::flush_memory_map(const memory_map_handle& handle)
     {
 #ifndef NDEBUG
@@ -18,6 +18,7 @@ namespace bq {
 
 #if defined(BQ_X86)
     bool _bq_avx2_supported_ = common_global_vars::get().avx2_support_;
+    bool _bq_avx512_supported_ = common_global_vars::get().avx512_support_;
 #endif
 
 }
\ No newline at end of file
@@ -37,6 +37,26 @@
 #define __SSE4_2__
 #define BQ_DEF_SSE4_2
 #endif
+#ifndef __AVX512F__
+#define __AVX512F__
+#define BQ_DEF_AVX512F
+#endif
+#ifndef __AVX512BW__
+#define __AVX512BW__
+#define BQ_DEF_AVX512BW
+#endif
+#ifndef __AVX512VL__
+#define __AVX512VL__
+#define BQ_DEF_AVX512VL
+#endif
+#ifndef __AES__
+#define __AES__
+#define BQ_DEF_AES
+#endif
+#ifndef __VAES__
+#define __VAES__
+#define BQ_DEF_VAES
+#endif
 
 #include <immintrin.h>
 
@@ -56,6 +76,26 @@
 #undef __SSE4_2__
 #undef BQ_DEF_SSE4_2
 #endif
+#ifdef BQ_DEF_AVX512F
+#undef __AVX512F__
+#undef BQ_DEF_AVX512F
+#endif
+#ifdef BQ_DEF_AVX512BW
+#undef __AVX512BW__
+#undef BQ_DEF_AVX512BW
+#endif
+#ifdef BQ_DEF_AVX512VL
+#undef __AVX512VL__
+#undef BQ_DEF_AVX512VL
+#endif
+#ifdef BQ_DEF_AES
+#undef __AES__
+#undef BQ_DEF_AES
+#endif
+#ifdef BQ_DEF_VAES
+#undef __VAES__
+#undef BQ_DEF_VAES
+#endif
 #else
 #include <immintrin.h>
 #endif
@@ -77,6 +117,7 @@ namespace bq {
 
 #if defined(BQ_X86)
     extern bool _bq_avx2_supported_;
+    extern bool _bq_avx512_supported_;
 #endif
 
     // Internal flag to check if SIMD UTF is supported on current platform
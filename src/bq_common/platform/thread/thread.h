@@ -80,6 +80,9 @@ namespace bq {
 
             static void sleep(uint64_t millsec);
 
+            // lower the scheduling priority of the calling thread, used by background housekeeping threads
+            static void set_current_thread_background_priority();
+
             // get thread name of current thread which calls this function
             static bq::string get_current_thread_name();
 
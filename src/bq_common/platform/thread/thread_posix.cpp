@@ -17,6 +17,11 @@
 #include <sched.h>
 #include <sys/select.h>
 #include <sys/time.h>
+#include <sys/resource.h>
+#if defined(BQ_LINUX) || defined(BQ_ANDROID)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #if defined(__has_include)
 #if __has_include(<sys/prctl.h>)
@@ -420,6 +425,23 @@ namespace bq {
             }
         }
 
+        void thread::set_current_thread_background_priority()
+        {
+#if defined(BQ_LINUX) || defined(BQ_ANDROID)
+            // Linux nice value is per thread(task), PRIO_PROCESS with tid only affects calling thread.
+            setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#elif defined(BQ_APPLE)
+            pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#else
+            int policy = 0;
+            struct sched_param param;
+            if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+                param.sched_priority = sched_get_priority_min(policy);
+                pthread_setschedparam(pthread_self(), policy, &param);
+            }
+#endif
+        }
+
         bq::string thread::get_current_thread_name()
         {
             return get_thread_name_impl<pthread_t>(pthread_self());
@@ -144,6 +144,11 @@ namespace bq {
             SleepEx((DWORD)millsec, true);
         }
 
+        void thread::set_current_thread_background_priority()
+        {
+            SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+        }
+
         static bool is_thread_name_supported_tested_; // false by zero initialization
         static HRESULT(WINAPI* get_thread_desc_func_)(HANDLE hThread, PWSTR* ppszThreadDescription);
         static HRESULT(WINAPI* set_thread_desc_func_)(HANDLE hThread, PCWSTR ppszThreadDescription);
@@ -650,6 +650,69 @@ namespace bq {
     // Fast Implementation (SIMD + Optimized Scalar)
     // =================================================================================================
 
+#if defined(BQ_X86)
+    enum class _utf_simd_level {
+        sw,
+        sse,
+        avx2,
+        avx512
+    };
+
+#ifdef BQ_UNIT_TEST
+    static util::utf_acceleration_mode utf_hardware_acceleration_mode_ = util::utf_acceleration_mode::auto_detect;
+
+    void util::set_utf_hardware_acceleration_mode(utf_acceleration_mode m)
+    {
+        utf_hardware_acceleration_mode_ = m;
+    }
+#endif
+
+    bq_forceinline _utf_simd_level _impl_get_utf_simd_level()
+    {
+#ifdef BQ_UNIT_TEST
+        switch (utf_hardware_acceleration_mode_) {
+        case util::utf_acceleration_mode::scalar:
+            return _utf_simd_level::sw;
+        case util::utf_acceleration_mode::sse:
+            return _utf_simd_level::sse;
+        case util::utf_acceleration_mode::avx2:
+            return _bq_avx2_supported_ ? _utf_simd_level::avx2 : _utf_simd_level::sse;
+        default:
+            break;
+        }
+#endif
+        if (_bq_avx512_supported_) {
+            return _utf_simd_level::avx512;
+        }
+        return _bq_avx2_supported_ ? _utf_simd_level::avx2 : _utf_simd_level::sse;
+    }
+
+    // mask != 0
+    bq_forceinline uint32_t _impl_count_trailing_zeros(uint64_t mask)
+    {
+#if defined(BQ_MSVC)
+        unsigned long index;
+#if defined(BQ_X86_64)
+        _BitScanForward64(&index, mask);
+#else
+        if (!_BitScanForward(&index, static_cast<unsigned long>(mask))) {
+            _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+            index += 32;
+        }
+#endif
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(mask));
+#endif
+    }
+
+    // lowest n bits set, n <= 64
+    bq_forceinline uint64_t _impl_low_bits_mask(size_t n)
+    {
+        return n >= 64 ? UINT64_MAX : ((static_cast<uint64_t>(1) << n) - 1);
+    }
+#endif
+
     // Fallback
     bq_forceinline uint32_t _impl_utf16_to_utf8_sw(const char16_t* BQ_RESTRICT src, uint32_t src_character_num, char* BQ_RESTRICT dst, uint32_t dst_character_num)
     {
@@ -773,6 +836,53 @@ namespace bq {
     }
 #endif
 
+#if defined(BQ_X86)
+    // AVX-512 Optimistic. Masked loads and stores take the tail, and the prefix in front of the first non-ASCII character is converted too.
+    BQ_SIMD_HW_INLINE BQ_HW_SIMD_AVX512_TARGET uint32_t _impl_utf16_to_utf8_ascii_optimistic_avx512(const char16_t* BQ_RESTRICT src_ptr, const char16_t* src_end, char* BQ_RESTRICT dst_ptr)
+    {
+        const char16_t* start_src = src_ptr;
+        const __m512i non_ascii_bits = _mm512_set1_epi16(static_cast<int16_t>(0xFF80u));
+        while (src_ptr < src_end) {
+            const size_t left = static_cast<size_t>(src_end - src_ptr);
+            const auto load_mask = static_cast<__mmask32>(_impl_low_bits_mask(bq::min_value(left, static_cast<size_t>(32))));
+            const __m512i v = _mm512_maskz_loadu_epi16(load_mask, src_ptr);
+            const __mmask32 non_ascii = _mm512_test_epi16_mask(v, non_ascii_bits);
+            if (non_ascii) {
+                const uint32_t ascii_count = _impl_count_trailing_zeros(non_ascii);
+                _mm256_mask_storeu_epi8(dst_ptr, static_cast<__mmask32>(_impl_low_bits_mask(ascii_count)), _mm512_cvtepi16_epi8(v));
+                return static_cast<uint32_t>(src_ptr - start_src) + ascii_count;
+            }
+            _mm256_mask_storeu_epi8(dst_ptr, load_mask, _mm512_cvtepi16_epi8(v));
+            const size_t count = bq::min_value(left, static_cast<size_t>(32));
+            src_ptr += count;
+            dst_ptr += count;
+        }
+        return static_cast<uint32_t>(src_ptr - start_src);
+    }
+
+    // AVX-512 Safe Implementation. Unlike the AVX2 one it goes back to the vector path after every non-ASCII chunk.
+    BQ_SIMD_HW_INLINE BQ_HW_SIMD_AVX512_TARGET uint32_t _impl_utf16_to_utf8_simd_avx512(const char16_t* BQ_RESTRICT src_ptr, const char16_t* src_end, char* BQ_RESTRICT dst_ptr)
+    {
+        const char* dst_start = dst_ptr;
+        while (src_ptr < src_end) {
+            const uint32_t ascii_count = _impl_utf16_to_utf8_ascii_optimistic_avx512(src_ptr, src_end, dst_ptr);
+            src_ptr += ascii_count;
+            dst_ptr += ascii_count;
+            if (src_ptr == src_end) {
+                break;
+            }
+            size_t chunk = bq::min_value(static_cast<size_t>(src_end - src_ptr), static_cast<size_t>(32));
+            if (src_ptr + chunk < src_end && src_ptr[chunk - 1] >= 0xD800 && src_ptr[chunk - 1] <= 0xDBFF) {
+                // keep surrogate pairs together
+                ++chunk;
+            }
+            dst_ptr += _impl_utf16_to_utf8_sw(src_ptr, static_cast<uint32_t>(chunk), dst_ptr, 0);
+            src_ptr += chunk;
+        }
+        return static_cast<uint32_t>(dst_ptr - dst_start);
+    }
+#endif
+
     BQ_SIMD_HW_INLINE uint32_t _impl_utf16_to_utf8_simd(const char16_t* BQ_RESTRICT src, uint32_t src_character_num, char* BQ_RESTRICT dst, uint32_t dst_character_num)
     {
         const char16_t* src_ptr = src;
@@ -783,10 +893,15 @@ namespace bq {
         (void)src_end;
         (void)dst_ptr;
 #if defined(BQ_X86)
-        if (_bq_avx2_supported_) {
+        switch (_impl_get_utf_simd_level()) {
+        case _utf_simd_level::avx512:
+            return _impl_utf16_to_utf8_simd_avx512(src_ptr, src_end, dst_ptr);
+        case _utf_simd_level::avx2:
             return _impl_utf16_to_utf8_simd_avx2(src_ptr, src_end, dst_ptr);
-        } else {
+        case _utf_simd_level::sse:
             return _impl_utf16_to_utf8_simd_sse(src_ptr, src_end, dst_ptr);
+        default:
+            return _impl_utf16_to_utf8_sw(src, src_character_num, dst, dst_character_num);
         }
 #elif defined(BQ_ARM_NEON)
         return _impl_utf16_to_utf8_simd_neon(src_ptr, src_end, dst_ptr);
@@ -934,6 +1049,62 @@ namespace bq {
     }
 #endif
 
+#if defined(BQ_X86)
+    // AVX-512 Optimistic. Masked loads and stores take the tail, and the prefix in front of the first non-ASCII character is converted too.
+    BQ_SIMD_HW_INLINE BQ_HW_SIMD_AVX512_TARGET uint32_t _impl_utf8_to_utf16_ascii_optimistic_avx512(const uint8_t* BQ_RESTRICT src_ptr, const uint8_t* src_end, char16_t* BQ_RESTRICT dst_ptr)
+    {
+        const uint8_t* start_src = src_ptr;
+        while (src_ptr < src_end) {
+            const size_t left = static_cast<size_t>(src_end - src_ptr);
+            const __mmask64 load_mask = _impl_low_bits_mask(bq::min_value(left, static_cast<size_t>(64)));
+            const __m512i v = _mm512_maskz_loadu_epi8(load_mask, src_ptr);
+            const __mmask64 non_ascii = _mm512_movepi8_mask(v);
+            const size_t count = non_ascii ? static_cast<size_t>(_impl_count_trailing_zeros(non_ascii)) : bq::min_value(left, static_cast<size_t>(64));
+            const auto lo_mask = static_cast<__mmask32>(_impl_low_bits_mask(bq::min_value(count, static_cast<size_t>(32))));
+            const auto hi_mask = static_cast<__mmask32>(_impl_low_bits_mask(count > 32 ? count - 32 : 0));
+            _mm512_mask_storeu_epi16(dst_ptr, lo_mask, _mm512_cvtepu8_epi16(_mm512_castsi512_si256(v)));
+            _mm512_mask_storeu_epi16(dst_ptr + 32, hi_mask, _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(v, 1)));
+            src_ptr += count;
+            dst_ptr += count;
+            if (non_ascii) {
+                break;
+            }
+        }
+        return static_cast<uint32_t>(src_ptr - start_src);
+    }
+
+    // AVX-512 Safe Implementation. Unlike the AVX2 one it goes back to the vector path after every non-ASCII chunk.
+    BQ_SIMD_HW_INLINE BQ_HW_SIMD_AVX512_TARGET uint32_t _impl_utf8_to_utf16_simd_avx512(const uint8_t* BQ_RESTRICT src_ptr, const uint8_t* src_end, char16_t* BQ_RESTRICT dst_ptr)
+    {
+        const char16_t* dst_start = dst_ptr;
+        while (src_ptr < src_end) {
+            const uint32_t ascii_count = _impl_utf8_to_utf16_ascii_optimistic_avx512(src_ptr, src_end, dst_ptr);
+            src_ptr += ascii_count;
+            dst_ptr += ascii_count;
+            if (src_ptr == src_end) {
+                break;
+            }
+            size_t chunk = bq::min_value(static_cast<size_t>(src_end - src_ptr), static_cast<size_t>(64));
+            if (src_ptr + chunk < src_end) {
+                // don't split the last sequence of the chunk
+                for (size_t k = 1; k <= 3; ++k) {
+                    const uint8_t c = src_ptr[chunk - k];
+                    if ((c & 0xC0) != 0x80) {
+                        const size_t seq_len = (c < 0x80) ? 1 : (((c & 0xE0) == 0xC0) ? 2 : (((c & 0xF0) == 0xE0) ? 3 : 4));
+                        if (seq_len > k) {
+                            chunk -= k;
+                        }
+                        break;
+                    }
+                }
+            }
+            dst_ptr += _impl_utf8_to_utf16_sw(reinterpret_cast<const char*>(src_ptr), static_cast<uint32_t>(chunk), dst_ptr, 0);
+            src_ptr += chunk;
+        }
+        return static_cast<uint32_t>(dst_ptr - dst_start);
+    }
+#endif
+
     BQ_SIMD_HW_INLINE uint32_t _impl_utf8_to_utf16_simd(const char* BQ_RESTRICT src, uint32_t src_character_num, char16_t* BQ_RESTRICT dst, uint32_t dst_character_num)
     {
         const auto* src_ptr = reinterpret_cast<const uint8_t*>(src);
@@ -944,10 +1115,15 @@ namespace bq {
         (void)src_end;
         (void)dst_ptr;
 #if defined(BQ_X86)
-        if (_bq_avx2_supported_) {
+        switch (_impl_get_utf_simd_level()) {
+        case _utf_simd_level::avx512:
+            return _impl_utf8_to_utf16_simd_avx512(src_ptr, src_end, dst_ptr);
+        case _utf_simd_level::avx2:
             return _impl_utf8_to_utf16_simd_avx2(src_ptr, src_end, dst_ptr);
-        } else {
+        case _utf_simd_level::sse:
             return _impl_utf8_to_utf16_simd_sse(src_ptr, src_end, dst_ptr);
+        default:
+            return _impl_utf8_to_utf16_sw(src, src_character_num, dst, dst_character_num);
         }
 #elif defined(BQ_ARM_NEON)
         return _impl_utf8_to_utf16_simd_neon(src_ptr, src_end, dst_ptr);
@@ -1218,10 +1394,16 @@ namespace bq {
         (void)src_end;
         (void)dst_ptr;
 #if defined(BQ_X86)
-        if (_bq_avx2_supported_) {
+        switch (_impl_get_utf_simd_level()) {
+        case _utf_simd_level::avx512:
+            return _impl_utf16_to_utf8_ascii_optimistic_avx512(src_ptr, src_end, dst_ptr);
+        case _utf_simd_level::avx2:
             return _impl_utf16_to_utf8_ascii_optimistic_avx2(src_ptr, src_end, dst_ptr);
+        case _utf_simd_level::sse:
+            return _impl_utf16_to_utf8_ascii_optimistic_sse(src_ptr, src_end, dst_ptr);
+        default:
+            return _impl_utf16_to_utf8_ascii_optimistic_sw(src_ptr, src_end, dst_ptr);
         }
-        return _impl_utf16_to_utf8_ascii_optimistic_sse(src_ptr, src_end, dst_ptr);
 #elif defined(BQ_ARM_NEON)
         return _impl_utf16_to_utf8_ascii_optimistic_neon(src_ptr, src_end, dst_ptr);
 #else
@@ -1493,10 +1675,16 @@ namespace bq {
         (void)src_end;
         (void)dst_ptr;
 #if defined(BQ_X86)
-        if (_bq_avx2_supported_) {
+        switch (_impl_get_utf_simd_level()) {
+        case _utf_simd_level::avx512:
+            return _impl_utf8_to_utf16_ascii_optimistic_avx512(src_ptr, src_end, dst_ptr);
+        case _utf_simd_level::avx2:
             return _impl_utf8_to_utf16_ascii_optimistic_avx2(src_ptr, src_end, dst_ptr);
+        case _utf_simd_level::sse:
+            return _impl_utf8_to_utf16_ascii_optimistic_sse(src_ptr, src_end, dst_ptr);
+        default:
+            return _impl_utf8_to_utf16_ascii_optimistic_sw(src_ptr, src_end, dst_ptr);
         }
-        return _impl_utf8_to_utf16_ascii_optimistic_sse(src_ptr, src_end, dst_ptr);
 #elif defined(BQ_ARM_NEON)
         return _impl_utf8_to_utf16_ascii_optimistic_neon(src_ptr, src_end, dst_ptr);
 #else
@@ -1,4 +1,4 @@
-#pragma once
+﻿#pragma once
 /*
  * Copyright (C) 2025 Tencent.
  * BQLOG is licensed under the Apache License, Version 2.0.
@@ -125,6 +125,18 @@ namespace bq {
         static uint32_t utf8_to_utf16_ascii(const char* BQ_RESTRICT src, uint32_t src_character_num, char16_t* BQ_RESTRICT dst, uint32_t dst_character_num);
 
 #ifdef BQ_UNIT_TEST
+        enum class utf_acceleration_mode : int32_t {
+            auto_detect = 0,
+            scalar = 1,
+            sse = 2,
+            avx2 = 3,
+            avx512 = 4
+        };
+        /// <summary>
+        /// Forces the UTF-16/UTF-8 converters onto one implementation, only takes effect on x86.
+        /// </summary>
+        static void set_utf_hardware_acceleration_mode(utf_acceleration_mode m);
+
         static uint32_t utf16_to_utf8_legacy(const char16_t* BQ_RESTRICT src_utf16_str, uint32_t src_character_num, char* BQ_RESTRICT dst_utf8_str, uint32_t dst_character_num);
         static uint32_t utf8_to_utf16_legacy(const char* BQ_RESTRICT src_utf8_str, uint32_t src_character_num, char16_t* BQ_RESTRICT dst_utf16_str, uint32_t dst_character_num);
 
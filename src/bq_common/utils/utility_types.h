@@ -206,6 +206,11 @@ namespace bq {
             : ptr_(nullptr)
         {
         }
+        // new_ptr must be allocated by bq::aligned_alloc, e.g. a pointer released from another unique_ptr.
+        explicit unique_ptr(T* new_ptr)
+            : ptr_(new_ptr)
+        {
+        }
         ~unique_ptr() { reset(); }
         template <typename D>
         unique_ptr(unique_ptr<D>&& rhs) noexcept
@@ -312,6 +317,13 @@ namespace bq {
                 ptr_ = nullptr;
             }
         }
+        // give up ownership without destructing the object.
+        T* release()
+        {
+            auto old = ptr_;
+            ptr_ = nullptr;
+            return old;
+        }
 
     private:
         template <typename>
@@ -323,11 +335,6 @@ namespace bq {
         template <typename U>
         friend unique_ptr<U> make_unique();
 
-        explicit unique_ptr(T* new_ptr)
-            : ptr_(new_ptr)
-        {
-        }
-
         T* ptr_;
     };
 
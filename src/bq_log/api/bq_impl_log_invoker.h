@@ -147,6 +147,13 @@ JNIEXPORT jlong JNICALL Java_bq_impl_log_1invoker__1_1api_1log_1decoder_1create(
  */
 JNIEXPORT jint JNICALL Java_bq_impl_log_1invoker__1_1api_1log_1decoder_1decode(JNIEnv*, jclass, jlong, jobject);
 
+/*
+ * Class:     bq_impl_log_invoker
+ * Method:    __api_log_decoder_decode_batch
+ * Signature: (J[B[I[J[J[I[II)I
+ */
+JNIEXPORT jint JNICALL Java_bq_impl_log_1invoker__1_1api_1log_1decoder_1decode_1batch(JNIEnv*, jclass, jlong, jbyteArray, jintArray, jlongArray, jlongArray, jintArray, jintArray, jint);
+
 /*
  * Class:     bq_impl_log_invoker
  * Method:    __api_log_decoder_destroy
@@ -415,9 +415,9 @@ namespace bq {
             return tls_base_dir_cache_.get().c_str();
         }
 
-        BQ_API bq::appender_decode_result __api_log_decoder_create(const char* log_file_path, const char* priv_key, uint32_t* out_handle)
+        BQ_API bq::appender_decode_result __api_log_decoder_create(const char* log_file_path, const char* priv_key, const bq::log_decode_filter* filter, uint32_t* out_handle)
         {
-            return bq::appender_decoder_manager::instance().create_decoder(log_file_path, priv_key, *out_handle);
+            return bq::appender_decoder_manager::instance().create_decoder(log_file_path, priv_key, filter, *out_handle);
         }
 
         BQ_API bq::appender_decode_result __api_log_decoder_decode(uint32_t handle, bq::_api_string_def* out_decoded_log_text)
@@ -431,6 +431,32 @@ namespace bq {
             return result;
         }
 
+        BQ_API bq::appender_decode_result __api_log_decoder_decode_follow(uint32_t handle, uint64_t timeout_ms, bq::_api_string_def* out_decoded_log_text)
+        {
+            const bq::string* decoded_text;
+            auto result = bq::appender_decoder_manager::instance().decode_follow(handle, timeout_ms, decoded_text);
+            if (result == bq::appender_decode_result::success) {
+                out_decoded_log_text->str = decoded_text->c_str();
+                out_decoded_log_text->len = (uint32_t)decoded_text->size();
+            }
+            return result;
+        }
+
+        BQ_API bq::appender_decode_result __api_log_decoder_decode_batch(uint32_t handle, char* text_buffer, uint32_t text_buffer_size, uint32_t* out_text_offsets, bq::log_decode_entry_info* out_entries, uint32_t max_entry_count, uint32_t* out_entry_count)
+        {
+            return bq::appender_decoder_manager::instance().decode_batch(handle, text_buffer, text_buffer_size, out_text_offsets, out_entries, max_entry_count, *out_entry_count);
+        }
+
+        BQ_API bq::appender_decode_result __api_log_decoder_set_output_format(uint32_t handle, bq::log_decode_output_format format)
+        {
+            return bq::appender_decoder_manager::instance().set_output_format(handle, format);
+        }
+
+        BQ_API bq::appender_decode_result __api_log_decoder_seek_to_time(uint32_t handle, uint64_t epoch_ms)
+        {
+            return bq::appender_decoder_manager::instance().seek_to_time(handle, epoch_ms);
+        }
+
         BQ_API void __api_log_decoder_destroy(uint32_t handle)
         {
             bq::appender_decoder_manager::instance().destroy_decoder(handle);
@@ -495,6 +521,41 @@ namespace bq {
             log->release_snapshot_string();
         }
 
+        BQ_API bool __api_take_snapshot_binary(uint64_t log_id, const char* path_utf8)
+        {
+            bq::log_manager::instance().force_flush(log_id);
+            bq::log_imp* log = bq::log_manager::get_log_by_id(log_id);
+            if (!log || !path_utf8) {
+                return false;
+            }
+            return log->take_snapshot_binary(path_utf8);
+        }
+
+        BQ_API void __api_take_template_stats_string(uint64_t log_id, bq::_api_string_def* out_stats_string)
+        {
+            out_stats_string->str = "";
+            out_stats_string->len = 0;
+            bq::log_manager::instance().force_flush(log_id);
+            bq::log_imp* log = bq::log_manager::get_log_by_id(log_id);
+            if (!log) {
+                return;
+            }
+            const bq::string& result = log->take_template_stats_string();
+            out_stats_string->str = result.c_str();
+            out_stats_string->len = (uint32_t)result.size();
+        }
+
+        BQ_API void __api_release_template_stats_string(uint64_t log_id, bq::_api_string_def* stats_string)
+        {
+            bq::log_imp* log = bq::log_manager::get_log_by_id(log_id);
+            if (!log) {
+                return;
+            }
+            stats_string->len = 0;
+            stats_string->str = nullptr;
+            log->release_template_stats_string();
+        }
+
         BQ_API void __api_get_stack_trace(bq::_api_string_def* out_name_ptr, uint32_t skip_frame_count)
         {
             const char* str;
@@ -286,7 +286,7 @@ JNIEXPORT jlong JNICALL Java_bq_impl_log_1invoker__1_1api_1log_1decoder_1create(
     uint32_t handle = 0;
     const char* path_c_str = env->GetStringUTFChars(path, NULL);
     const char* priv_key_c_str = env->GetStringUTFChars(priv_key, NULL);
-    auto result = bq::api::__api_log_decoder_create(path_c_str, priv_key_c_str, &handle);
+    auto result = bq::api::__api_log_decoder_create(path_c_str, priv_key_c_str, nullptr, &handle);
     env->ReleaseStringUTFChars(path, path_c_str);
     env->ReleaseStringUTFChars(priv_key, priv_key_c_str);
     if (result != bq::appender_decode_result::success) {
@@ -318,6 +318,55 @@ JNIEXPORT jint JNICALL Java_bq_impl_log_1invoker__1_1api_1log_1decoder_1decode(J
     return (jint)result;
 }
 
+/*
+ * Class:     bq_impl_log_invoker
+ * Method:    __api_log_decoder_decode_batch
+ * Signature: (J[B[I[J[J[I[II)I
+ * returns the count of decoded entries, or -(appender_decode_result) on failure.
+ */
+JNIEXPORT jint JNICALL Java_bq_impl_log_1invoker__1_1api_1log_1decoder_1decode_1batch(JNIEnv* env, jclass, jlong handle, jbyteArray text_buffer, jintArray text_offsets, jlongArray epoch_ms, jlongArray thread_ids, jintArray category_indices, jintArray levels, jint max_entry_count)
+{
+    uint32_t max_count = (max_entry_count > 0) ? (uint32_t)max_entry_count : 0;
+    bq::array<uint32_t> offsets;
+    offsets.fill_uninitialized(max_count + 1);
+    bq::array<bq::log_decode_entry_info> entries;
+    entries.fill_uninitialized(max_count);
+    uint32_t entry_count = 0;
+
+    jsize text_buffer_size = env->GetArrayLength(text_buffer);
+    jbyte* text_buffer_ptr = env->GetByteArrayElements(text_buffer, NULL);
+    auto result = bq::api::__api_log_decoder_decode_batch((uint32_t)handle, (char*)text_buffer_ptr, (uint32_t)text_buffer_size, offsets.begin(), entries.begin(), max_count, &entry_count);
+    env->ReleaseByteArrayElements(text_buffer, text_buffer_ptr, (entry_count > 0) ? 0 : JNI_ABORT);
+    if (result != bq::appender_decode_result::success) {
+        return -(jint)result;
+    }
+
+    // with no entry decoded, offsets[1] is the text buffer size needed by the next entry.
+    jsize offset_count = (jsize)((entry_count > 0) ? entry_count + 1 : bq::min_value(max_count + 1, (uint32_t)2));
+    bq::array<jint> offsets_out;
+    bq::array<jlong> epoch_ms_out;
+    bq::array<jlong> thread_ids_out;
+    bq::array<jint> category_indices_out;
+    bq::array<jint> levels_out;
+    for (jsize i = 0; i < offset_count; ++i) {
+        offsets_out.push_back((jint)offsets[(size_t)i]);
+    }
+    for (uint32_t i = 0; i < entry_count; ++i) {
+        epoch_ms_out.push_back((jlong)entries[i].epoch_ms);
+        thread_ids_out.push_back((jlong)entries[i].thread_id);
+        category_indices_out.push_back((jint)entries[i].category_idx);
+        levels_out.push_back((jint)entries[i].level);
+    }
+    env->SetIntArrayRegion(text_offsets, 0, offset_count, offsets_out.begin());
+    if (entry_count > 0) {
+        env->SetLongArrayRegion(epoch_ms, 0, (jsize)entry_count, epoch_ms_out.begin());
+        env->SetLongArrayRegion(thread_ids, 0, (jsize)entry_count, thread_ids_out.begin());
+        env->SetIntArrayRegion(category_indices, 0, (jsize)entry_count, category_indices_out.begin());
+        env->SetIntArrayRegion(levels, 0, (jsize)entry_count, levels_out.begin());
+    }
+    return (jint)entry_count;
+}
+
 /*
  * Class:     bq_impl_log_invoker
  * Method:    __api_log_decoder_destroy
@@ -720,7 +720,7 @@ BQ_NAPI_DEF(log_decoder_create, napi_env, env, napi_callback_info, info)
     auto priv_key = bq::dup_string_from_napi(env, argv[1]);
 
     uint32_t handle = 0;
-    bq::appender_decode_result result = bq::api::__api_log_decoder_create(path.c_str(), priv_key.c_str(), &handle);
+    bq::appender_decode_result result = bq::api::__api_log_decoder_create(path.c_str(), priv_key.c_str(), nullptr, &handle);
 
     if (result != bq::appender_decode_result::success) {
         // negative error code in int32
@@ -777,6 +777,69 @@ BQ_NAPI_DEF(log_decoder_decode, napi_env, env, napi_callback_info, info)
     return obj;
 }
 
+// log_decoder_decode_batch(handle: number, max_entry_count: number):
+//   { code: number, texts: string[], epochs: number[], thread_ids: bigint[], category_indices: number[], levels: number[] }
+BQ_NAPI_DEF(log_decoder_decode_batch, napi_env, env, napi_callback_info, info)
+{
+    size_t argc = 2;
+    napi_value argv[2] = { 0, 0 };
+    BQ_NAPI_CALL(env, nullptr, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+    if (argc < 2) {
+        napi_throw_type_error(env, NULL, "handle and max_entry_count required");
+        return NULL;
+    }
+
+    uint32_t handle = bq::get_napi_u32(env, argv[0]);
+    uint32_t max_entry_count = bq::max_value(bq::get_napi_u32(env, argv[1]), static_cast<uint32_t>(1));
+    bq::array<char> text_buffer;
+    text_buffer.fill_uninitialized(64 * 1024);
+    bq::array<uint32_t> offsets;
+    offsets.fill_uninitialized(max_entry_count + 1);
+    bq::array<bq::log_decode_entry_info> entries;
+    entries.fill_uninitialized(max_entry_count);
+    uint32_t entry_count = 0;
+    bq::appender_decode_result result;
+    while (true) {
+        result = bq::api::__api_log_decoder_decode_batch(handle, text_buffer.begin(), static_cast<uint32_t>(text_buffer.size()), offsets.begin(), entries.begin(), max_entry_count, &entry_count);
+        if (result != bq::appender_decode_result::success || entry_count > 0) {
+            break;
+        }
+        // the next entry is larger than the text buffer.
+        text_buffer.fill_uninitialized(static_cast<size_t>(offsets[1]) - text_buffer.size());
+    }
+
+    napi_value obj = NULL;
+    napi_value texts = NULL;
+    napi_value epochs = NULL;
+    napi_value thread_ids = NULL;
+    napi_value category_indices = NULL;
+    napi_value levels = NULL;
+    napi_create_object(env, &obj);
+    napi_create_array_with_length(env, entry_count, &texts);
+    napi_create_array_with_length(env, entry_count, &epochs);
+    napi_create_array_with_length(env, entry_count, &thread_ids);
+    napi_create_array_with_length(env, entry_count, &category_indices);
+    napi_create_array_with_length(env, entry_count, &levels);
+    for (uint32_t i = 0; i < entry_count; ++i) {
+        napi_value v_text = NULL;
+        napi_value v_epoch = NULL;
+        napi_create_string_utf8(env, text_buffer.begin() + offsets[i], offsets[i + 1] - offsets[i], &v_text);
+        napi_create_double(env, static_cast<double>(entries[i].epoch_ms), &v_epoch);
+        napi_set_element(env, texts, i, v_text);
+        napi_set_element(env, epochs, i, v_epoch);
+        napi_set_element(env, thread_ids, i, bq::make_napi_u64(env, entries[i].thread_id));
+        napi_set_element(env, category_indices, i, bq::make_napi_u32(env, entries[i].category_idx));
+        napi_set_element(env, levels, i, bq::make_napi_u32(env, entries[i].level));
+    }
+    napi_set_named_property(env, obj, "code", bq::make_napi_i32(env, (int32_t)result));
+    napi_set_named_property(env, obj, "texts", texts);
+    napi_set_named_property(env, obj, "epochs", epochs);
+    napi_set_named_property(env, obj, "thread_ids", thread_ids);
+    napi_set_named_property(env, obj, "category_indices", category_indices);
+    napi_set_named_property(env, obj, "levels", levels);
+    return obj;
+}
+
 // log_decode(in_path: string, out_path: string, priv_key: string): boolean
 BQ_NAPI_DEF(log_decode, napi_env, env, napi_callback_info, info)
 {
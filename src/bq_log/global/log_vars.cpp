@@ -65,6 +65,7 @@ namespace bq {
         if (!force_flush_success) {
             bq::util::log_device_console(bq::log_level::warning, "Force flush timed out on shutdown, some buffered logs may be lost");
         }
+        file_archiver_inst_.shutdown();
     }
 
     log_global_vars::log_global_vars()
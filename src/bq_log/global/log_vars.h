@@ -20,6 +20,7 @@
 #include "bq_common/bq_common_public_include.h"
 #include "bq_log/log/log_manager.h"
 #include "bq_log/log/appender/appender_console.h"
+#include "bq_log/log/appender/file_archiver.h"
 #include "bq_log/log/decoder/appender_decoder_manager.h"
 #include "bq_log/types/buffer/miso_ring_buffer.h"
 
@@ -58,6 +59,7 @@ namespace bq {
         appender_console::console_static_misc console_static_misc_;
         appender_decoder_manager appender_decoder_manager_inst_;
         log_manager log_manager_inst_;
+        file_archiver file_archiver_inst_;
 
     private:
 #if defined(BQ_LOG_BUFFER_DEBUG)
@@ -45,6 +45,7 @@ namespace bq {
     void appender_base::clear()
     {
         time_zone_.reset();
+        layout_pattern_.clear();
         log_level_bitmap_.clear();
         parent_log_ = nullptr;
         layout_ptr_ = nullptr;
@@ -90,6 +91,29 @@ namespace bq {
         }
     }
 
+    layout::enum_layout_result appender_base::do_layout(const log_entry_handle& handle, const char*& out_str, uint32_t& out_len)
+    {
+        auto cache = parent_log_->get_layout_result_cache();
+        auto entry_seq = parent_log_->get_current_entry_seq();
+        auto pattern_id = layout_pattern_.get_id();
+        if (cache && cache->try_get(entry_seq, time_zone_, pattern_id, out_str, out_len)) {
+            return layout::enum_layout_result::finished;
+        }
+        auto layout_result = layout_ptr_->do_layout(handle, time_zone_, &parent_log_->get_categories_name(), &layout_pattern_);
+        if (layout_result != layout::enum_layout_result::finished) {
+            return layout_result;
+        }
+        if (cache) {
+            cache->set(entry_seq, time_zone_, pattern_id, layout_ptr_->get_formated_str(), layout_ptr_->get_formated_str_len());
+            layout_ptr_->tidy_memory();
+            cache->try_get(entry_seq, time_zone_, pattern_id, out_str, out_len);
+        } else {
+            out_str = layout_ptr_->get_formated_str();
+            out_len = layout_ptr_->get_formated_str_len();
+        }
+        return layout_result;
+    }
+
     void appender_base::set_basic_configs(const bq::property_value& config_obj)
     {
         const auto& levels_array = config_obj["levels"];
@@ -103,6 +127,13 @@ namespace bq {
             time_zone_.parse_by_string(time_zone_str);
         }
 
+        if (config_obj["layout_pattern"].is_string()) {
+            bq::string pattern_str = (string)config_obj["layout_pattern"];
+            if (!layout_pattern_.compile(pattern_str)) {
+                util::log_device_console(bq::log_level::warning, "bq log warning: invalid layout_pattern in appender %s, default layout is used", name_.c_str());
+            }
+        }
+
         if (config_obj["enable"].is_bool()) {
             appenders_enable = (bool)config_obj["enable"];
         }
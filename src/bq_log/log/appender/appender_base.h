@@ -72,8 +72,20 @@ namespace bq {
 
         virtual void on_log_item_new_begin(bq::log_entry_handle& read_handle) { (void)read_handle; }
 
+        /// <summary>
+        /// Format the entry with layout_ptr_, reusing the result of previous appenders of the same log
+        /// if they share the same layout settings. Call release_layout_result() after the text is consumed.
+        /// </summary>
+        layout::enum_layout_result do_layout(const log_entry_handle& handle, const char*& out_str, uint32_t& out_len);
+
+        bq_forceinline void release_layout_result()
+        {
+            layout_ptr_->tidy_memory();
+        }
+
     protected:
         time_zone time_zone_;
+        layout_pattern layout_pattern_;
         const log_imp* parent_log_;
         layout* layout_ptr_;
         appender_type type_;
@@ -20,6 +20,16 @@
 namespace bq {
     static constexpr size_t CACHE_READ_DEFAULT_SIZE = 32 * 1024;
     static constexpr size_t CACHE_WRITE_DEFAULT_SIZE = 64 * 1024;
+#ifdef BQ_UNIT_TEST
+    static bq::platform::atomic<uint64_t> write_space_appender_name_hash_for_test_(0);
+    static bq::platform::atomic<uint64_t> write_space_for_test_(UINT64_MAX);
+
+    void appender_file_base::set_write_space_for_test(const bq::string& appender_name, uint64_t bytes_left)
+    {
+        write_space_appender_name_hash_for_test_.store_seq_cst(bq::util::get_hash_64(appender_name.c_str(), appender_name.size()));
+        write_space_for_test_.store_seq_cst(bytes_left);
+    }
+#endif
 
     appender_file_base::~appender_file_base()
     {
@@ -34,18 +44,20 @@ namespace bq {
     }
 
     void appender_file_base::flush_write_cache()
+    {
+        flush_write_cache_from(cache_write_);
+    }
+
+    void appender_file_base::flush_write_cache_from(const void* data)
     {
         if (!file_) {
             return;
         }
         size_t real_write_size = 0;
         size_t need_write_size = static_cast<size_t>(cache_write_head_->cache_write_finished_cursor_);
-        int32_t error_code = bq::platform::write_file(file_.platform_handle(), (const void*)cache_write_, need_write_size, real_write_size);
-        if (real_write_size < need_write_size) {
-            memcpy(cache_write_, cache_write_ + static_cast<ptrdiff_t>(real_write_size), need_write_size - real_write_size);
-        }
-        if (cache_write_cursor_ > cache_write_head_->cache_write_finished_cursor_) {
-            memmove(cache_write_, cache_write_ + need_write_size, cache_write_cursor_ - need_write_size);
+        int32_t error_code = write_to_file(data, need_write_size, real_write_size);
+        if (real_write_size > 0 && cache_write_cursor_ > real_write_size) {
+            memmove(cache_write_, cache_write_ + static_cast<ptrdiff_t>(real_write_size), cache_write_cursor_ - real_write_size);
         }
         cache_write_head_->cache_write_finished_cursor_ -= real_write_size;
         cache_write_cursor_ -= real_write_size;
@@ -53,6 +65,60 @@ namespace bq {
         if (cache_write_entity_->size() > CACHE_WRITE_DEFAULT_SIZE && get_total_used_write_cache_size() <= (CACHE_READ_DEFAULT_SIZE >> 1)) {
             resize_cache_write_entity(CACHE_WRITE_DEFAULT_SIZE);
         }
+        on_write_file_result(error_code, real_write_size, need_write_size);
+    }
+
+    bool appender_file_base::flush_write_cache_transformed(const void* data, size_t size)
+    {
+        if (!file_) {
+            return true;
+        }
+        size_t real_write_size = 0;
+        int32_t error_code = write_to_file(data, size, real_write_size);
+        if (real_write_size < size) {
+            // data that is only partly written can't be resumed, it's written again as a whole with the pending data of the next flush.
+            if (real_write_size == 0 || file_manager::instance().truncate_file(file_, current_file_size_)) {
+                on_write_file_result(error_code, 0, size);
+                return true;
+            }
+        }
+        // the pending data is dropped even if the file could not be cut, the caller knows its end is damaged.
+        size_t flushed_size = static_cast<size_t>(cache_write_head_->cache_write_finished_cursor_);
+        if (cache_write_cursor_ > flushed_size) {
+            memmove(cache_write_, cache_write_ + flushed_size, cache_write_cursor_ - flushed_size);
+        }
+        cache_write_head_->cache_write_finished_cursor_ = 0;
+        cache_write_cursor_ -= flushed_size;
+        current_file_size_ += real_write_size;
+        if (cache_write_entity_->size() > CACHE_WRITE_DEFAULT_SIZE && get_total_used_write_cache_size() <= (CACHE_READ_DEFAULT_SIZE >> 1)) {
+            resize_cache_write_entity(CACHE_WRITE_DEFAULT_SIZE);
+        }
+        on_write_file_result(error_code, real_write_size, size);
+        return real_write_size == size;
+    }
+
+    int32_t appender_file_base::write_to_file(const void* data, size_t size, size_t& out_real_write_size)
+    {
+#ifdef BQ_UNIT_TEST
+        if (write_space_for_test_.load_seq_cst() != UINT64_MAX && write_space_appender_name_hash_for_test_.load_seq_cst() == bq::util::get_hash_64(get_name().c_str(), get_name().size())) {
+            uint64_t space = write_space_for_test_.load_seq_cst();
+            if (space < static_cast<uint64_t>(size)) {
+                bq::platform::write_file(file_.platform_handle(), data, static_cast<size_t>(space), out_real_write_size);
+                write_space_for_test_.store_seq_cst(space - static_cast<uint64_t>(out_real_write_size));
+#if defined(BQ_WIN)
+                return ERROR_DISK_FULL;
+#else
+                return ENOSPC;
+#endif
+            }
+            write_space_for_test_.store_seq_cst(space - static_cast<uint64_t>(size));
+        }
+#endif
+        return bq::platform::write_file(file_.platform_handle(), data, size, out_real_write_size);
+    }
+
+    void appender_file_base::on_write_file_result(int32_t error_code, size_t real_write_size, size_t need_write_size)
+    {
         if (error_code != 0 && error_code !=
 #if defined(BQ_WIN)
                 ERROR_DISK_FULL
@@ -121,6 +187,11 @@ namespace bq {
         (void)is_new_created;
     }
 
+    void appender_file_base::on_file_rotated(const bq::string& prev_file_abs_path)
+    {
+        (void)prev_file_abs_path;
+    }
+
     bool appender_file_base::seek_read_file_absolute(size_t pos)
     {
         bool result = file_manager::instance().seek(file_, file_manager::seek_option::begin, (int32_t)pos);
@@ -241,24 +312,6 @@ namespace bq {
         cache_write_head_->cache_write_finished_cursor_ = cache_write_cursor_;
     }
 
-    void appender_file_base::set_cache_write_padding(uint8_t new_padding)
-    {
-        if (cache_write_padding_ != new_padding) {
-            if (new_padding > cache_write_padding_) {
-                auto current_using_size = get_total_used_write_cache_size();
-                auto current_total_size = cache_write_entity_->size();
-                if (current_using_size + static_cast<size_t>(new_padding) - static_cast<size_t>(cache_write_padding_) > current_total_size) {
-                    resize_cache_write_entity(current_using_size + static_cast<size_t>(new_padding) - static_cast<size_t>(cache_write_padding_));
-                }
-            }
-            auto prev_data_ptr = cache_write_;
-            cache_write_padding_ = new_padding;
-            refresh_cache_write_ptr();
-            auto new_data_ptr = cache_write_;
-            memmove(new_data_ptr, prev_data_ptr, cache_write_cursor_);
-        }
-    }
-
     bool appender_file_base::on_appender_file_recovery_begin()
     {
         if (cache_write_entity_->size() < static_cast<size_t>(cache_write_ - static_cast<uint8_t*>(cache_write_entity_->data()))) {
@@ -495,7 +548,11 @@ namespace bq {
     void appender_file_base::open_new_indexed_file_by_name()
     {
         bool is_prev_file_exist = file_;
+        bq::string prev_file_abs_path = is_prev_file_exist ? file_.abs_file_path() : bq::string();
         file_manager::instance().close_file(file_);
+        if (is_prev_file_exist) {
+            on_file_rotated(prev_file_abs_path);
+        }
         clean_cache_write();
         clear_all_expired_files();
         clear_all_limit_files();
@@ -520,9 +577,10 @@ namespace bq {
             if (!bq::file_manager::is_file(full_name_in_absolute_path)) {
                 continue;
             }
-            if (name.begin_with(file_prefix) && name.end_with(ext_name_with_dot)) {
+            size_t matched_ext_len = match_file_ext_name(name);
+            if (name.begin_with(file_prefix) && matched_ext_len > 0) {
                 bq::string idx_str = name.substr(file_prefix.size());
-                idx_str = idx_str.substr(0, idx_str.size() - ext_name_with_dot.size());
+                idx_str = idx_str.substr(0, idx_str.size() - matched_ext_len);
                 int32_t idx = atoi(idx_str.c_str());
                 if (idx != 0 && idx > max_index) {
                     max_index = idx;
@@ -589,7 +647,7 @@ namespace bq {
             if (!bq::file_manager::is_file(full_name_in_absolute_path)) {
                 continue;
             }
-            if (!name.begin_with(file_prefix) || !name.end_with(get_file_ext_name())) {
+            if (!name.begin_with(file_prefix) || match_file_ext_name(name) == 0) {
                 continue;
             }
             uint64_t last_m_time_ms = bq::file_manager::get_file_last_modified_epoch_ms(full_name_in_absolute_path);
@@ -617,7 +675,7 @@ namespace bq {
             if (!bq::file_manager::is_file(full_name_in_absolute_path)) {
                 continue;
             }
-            if (!name.begin_with(file_prefix) || !name.end_with(get_file_ext_name())) {
+            if (!name.begin_with(file_prefix) || match_file_ext_name(name) == 0) {
                 continue;
             }
             uint64_t last_m_time_ms = bq::file_manager::get_file_last_modified_epoch_ms(full_name_in_absolute_path);
@@ -653,6 +711,39 @@ namespace bq {
         }
     }
 
+    bq::array<bq::string> appender_file_base::get_all_own_file_paths()
+    {
+        bq::array<bq::string> result;
+        auto dir_name = bq::file_manager::get_directory_from_path(config_file_name_);
+        auto file_name = bq::file_manager::get_file_name_from_path(config_file_name_);
+        bq::string file_prefix = file_name + "_";
+        bq::string path = TO_ABSOLUTE_PATH(dir_name, base_dir_type_);
+        bq::array<bq::string> exist_files = bq::file_manager::get_sub_dirs_and_files_name(path);
+        for (const bq::string& name : exist_files) {
+            if (!name.begin_with(file_prefix) || match_file_ext_name(name) == 0) {
+                continue;
+            }
+            bq::string full_name_in_absolute_path = bq::file_manager::combine_path(path, name);
+            if (bq::file_manager::is_file(full_name_in_absolute_path)) {
+                result.push_back(full_name_in_absolute_path);
+            }
+        }
+        return result;
+    }
+
+    size_t appender_file_base::match_file_ext_name(const bq::string& file_name)
+    {
+        const bq::string ext_name = get_file_ext_name();
+        if (file_name.end_with(ext_name)) {
+            return ext_name.size();
+        }
+        const bq::string archived_ext_name = get_archived_file_ext_name();
+        if (!archived_ext_name.is_empty() && file_name.end_with(archived_ext_name)) {
+            return archived_ext_name.size();
+        }
+        return 0;
+    }
+
     void appender_file_base::parse_file_context::log_parse_fail_reason(const char* msg) const
     {
         bq::util::log_device_console(log_level::info, "failed to parse log file :\"%s\" , msg: %s", file_name_.c_str(), msg);
@@ -75,6 +75,12 @@ namespace bq {
         // flush appender file to physical disk.
         void flush_write_io();
 
+#ifdef BQ_UNIT_TEST
+        // Writes of the appender named appender_name fail as if the disk is full once bytes_left more bytes are written.
+        // UINT64_MAX means no limit.
+        static void set_write_space_for_test(const bq::string& appender_name, uint64_t bytes_left);
+#endif
+
     protected:
         virtual bool init_impl(const bq::property_value& config_obj) override;
 
@@ -86,8 +92,15 @@ namespace bq {
 
         virtual bq::string get_file_ext_name() = 0;
 
+        // Extension of archived(compressed) copies of rotated files, they are also counted by index, expire time and capacity limit.
+        // Empty means this appender never archives its files.
+        virtual bq::string get_archived_file_ext_name() { return ""; }
+
         virtual void on_file_open(bool is_new_created);
 
+        // Called after the previous file is closed because a new indexed file is opened.
+        virtual void on_file_rotated(const bq::string& prev_file_abs_path);
+
         virtual bool seek_read_file_absolute(size_t pos);
 
         virtual void seek_read_file_offset(int32_t offset);
@@ -100,6 +113,9 @@ namespace bq {
 
         size_t get_current_file_size() const { return current_file_size_; }
 
+        // Absolute paths of the existing files of this appender(normal or archived), the current one included.
+        bq::array<bq::string> get_all_own_file_paths();
+
         file_handle& get_file_handle() { return file_; }
 
         // data() returned by read_with_cache_handle will be invalid after next calling of "read_with_cache"
@@ -114,9 +130,16 @@ namespace bq {
         // Low performance function, try to use write cache first
         size_t direct_write(const void* data, size_t size, bq::file_manager::seek_option seek_opt, int64_t seek_offset);
 
-        void mark_write_finished();
+        // Write data to the file instead of the pending data of the write cache, for appenders transforming it on the way to the file.
+        // Data that is only partly written is cut off the file, the pending data is kept and transformed again by the next flush.
+        // Returns false if the file could not be cut, the pending data is dropped then and the file ends with the partial data.
+        bool flush_write_cache_transformed(const void* data, size_t size);
+
+        // Same as flush_write_cache(), but data is written in place of the pending data. It must be a same sized image of it (e.g. encrypted).
+        // The pending data itself is never modified, so whatever is not written is kept for the next flush.
+        void flush_write_cache_from(const void* data);
 
-        void set_cache_write_padding(uint8_t new_padding);
+        void mark_write_finished();
 
         virtual bool on_appender_file_recovery_begin();
 
@@ -130,6 +153,11 @@ namespace bq {
 #endif
         void set_basic_configs(const bq::property_value& config_obj);
 
+        // A new indexed file is opened on write errors other than a full disk.
+        void on_write_file_result(int32_t error_code, size_t real_write_size, size_t need_write_size);
+
+        int32_t write_to_file(const void* data, size_t size, size_t& out_real_write_size);
+
         void refresh_cache_write_head_size(bool need_recovery, const bq::string& mmap_file_abs_path);
 
         bool try_recover();
@@ -142,6 +170,9 @@ namespace bq {
 
         void clear_all_limit_files(); // capacity limit
 
+        // returns length of matched extension(normal or archived), 0 if the file does not belong to this appender
+        size_t match_file_ext_name(const bq::string& file_name);
+
         void refresh_file_handle(const log_entry_handle& handle);
 
         bool open_file_with_write_exclusive(const bq::string& file_path);
@@ -13,6 +13,8 @@
 #include "bq_log/log/log_imp.h"
 
 namespace bq {
+    static constexpr size_t STAGING_CACHE_KEEP_SIZE = 256 * 1024;
+
     bool appender_file_binary::init_impl(const bq::property_value& config_obj)
     {
         if (config_obj["pub_key"].is_string()) {
@@ -24,6 +26,10 @@ namespace bq {
         } else {
             enc_type_ = appender_encryption_type::plaintext;
         }
+        set_seek_index_interval(config_obj);
+        set_sync_marker_interval(config_obj);
+        block_compression_ = parse_block_compression(config_obj);
+        block_encoder_.set_level(block_compression_ == appender_block_compression::high ? lz4::level::high : lz4::level::fast);
         if (!appender_file_base::init_impl(config_obj)) {
             return false;
         }
@@ -35,6 +41,8 @@ namespace bq {
         if (!appender_file_base::reset_impl(config_obj)) {
             return false;
         }
+        set_seek_index_interval(config_obj);
+        set_sync_marker_interval(config_obj);
         rsa::public_key prev_pub_key = rsa_pub_key_;
         auto prev_encryption_type = enc_type_;
         if (config_obj["pub_key"].is_string()) {
@@ -44,8 +52,89 @@ namespace bq {
                 return false;
             }
         }
+        // the file header tells whether blocks are used, it can't change in the middle of a file
         return (enc_type_ == prev_encryption_type)
-            && (rsa_pub_key_ == prev_pub_key);
+            && (rsa_pub_key_ == prev_pub_key)
+            && (parse_block_compression(config_obj) == block_compression_);
+    }
+
+    appender_file_binary::appender_block_compression appender_file_binary::parse_block_compression(const bq::property_value& config_obj) const
+    {
+        if (!config_obj["block_compression"].is_string()) {
+            return appender_block_compression::none;
+        }
+        bq::string level_str = ((bq::string)config_obj["block_compression"]).trim();
+        if (level_str.equals_ignore_case("fast")) {
+            return appender_block_compression::fast;
+        }
+        if (level_str.equals_ignore_case("high")) {
+            return appender_block_compression::high;
+        }
+        if (!level_str.equals_ignore_case("none")) {
+            bq::util::log_device_console(bq::log_level::warning, "appender_file_binary : invalid block_compression \"%s\", valid values are fast, high and none", level_str.c_str());
+        }
+        return appender_block_compression::none;
+    }
+
+    void appender_file_binary::set_seek_index_interval(const bq::property_value& config_obj)
+    {
+        if (config_obj["seek_index_interval"].is_integral()) {
+            seek_index_interval_ = (uint64_t)config_obj["seek_index_interval"];
+        } else {
+            seek_index_interval_ = DEFAULT_SEEK_INDEX_INTERVAL;
+        }
+    }
+
+    void appender_file_binary::set_sync_marker_interval(const bq::property_value& config_obj)
+    {
+        if (config_obj["sync_marker_interval"].is_integral()) {
+            sync_marker_interval_ = (uint64_t)config_obj["sync_marker_interval"];
+        } else {
+            sync_marker_interval_ = DEFAULT_SYNC_MARKER_INTERVAL;
+        }
+    }
+
+    const uint8_t appender_file_binary::SYNC_MARKER_MAGIC[8] = { 0xFE, 'B', 'Q', 'S', 'Y', 'N', 'C', 0xEF };
+
+    bool appender_file_binary::verify_sync_marker(const uint8_t* data)
+    {
+        appender_sync_marker marker;
+        memcpy(&marker, data, sizeof(marker));
+        return memcmp(marker.magic, SYNC_MARKER_MAGIC, sizeof(SYNC_MARKER_MAGIC)) == 0
+            && marker.checksum == bq::util::get_hash_64(&marker, offsetof(appender_sync_marker, checksum));
+    }
+
+    bool appender_file_binary::is_sync_marker_due() const
+    {
+        if (sync_marker_interval_ == 0) {
+            return false;
+        }
+        uint64_t write_pos = static_cast<uint64_t>(get_current_file_size() + get_pendding_flush_written_size());
+        return write_pos >= last_sync_marker_pos_ + sync_marker_interval_;
+    }
+
+    void appender_file_binary::seal_sync_marker(appender_sync_marker& marker)
+    {
+        memcpy(marker.magic, SYNC_MARKER_MAGIC, sizeof(SYNC_MARKER_MAGIC));
+        marker.checksum = bq::util::get_hash_64(&marker, offsetof(appender_sync_marker, checksum));
+        last_sync_marker_pos_ = static_cast<uint64_t>(get_current_file_size() + get_pendding_flush_written_size());
+    }
+
+    void appender_file_binary::log_impl(const log_entry_handle& handle)
+    {
+        appender_file_base::log_impl(handle);
+        if (seek_index_interval_ == 0 || last_seg_type_ != appender_segment_type::normal || last_seg_start_pos_ == UINT64_MAX) {
+            return;
+        }
+        uint64_t seg_size = static_cast<uint64_t>(get_current_file_size() + get_pendding_flush_written_size()) - last_seg_start_pos_;
+        if (seg_size < seek_index_interval_) {
+            return;
+        }
+        flush_write_cache();
+        if (get_pendding_flush_written_size() == 0) {
+            // no disk sync here, it would cost a sync per seek_index_interval bytes on busy logs.
+            append_new_segment(appender_segment_type::normal, false);
+        }
     }
 
     bool appender_file_binary::parse_exist_log_file(parse_file_context& context)
@@ -69,6 +158,10 @@ namespace bq {
             context.log_parse_fail_reason("format incompatible");
             return false;
         }
+        if (file_head.block_compression != appender_block_compression::none || block_compression_ != appender_block_compression::none) {
+            context.log_parse_fail_reason("block compressed files are not appended to");
+            return false;
+        }
         // parse first segment information
         cur_read_seg_.end_pos = static_cast<uint64_t>(sizeof(appender_file_header));
         if (!read_to_next_segment()) {
@@ -133,11 +226,14 @@ namespace bq {
         }
         cur_read_seg_.start_pos = static_cast<uint64_t>(sizeof(appender_file_header));
         cur_read_seg_.end_pos = get_current_file_size();
+        last_seg_start_pos_ = UINT64_MAX;
         if (is_new_created) {
             // write file header and initialize encryption information
             appender_file_header file_head;
+            memset(&file_head, 0, sizeof(file_head));
             file_head.format = get_appender_format();
             file_head.version = get_binary_format_version();
+            file_head.block_compression = block_compression_;
             direct_write(&file_head, sizeof(file_head), bq::file_manager::seek_option::end, 0);
 
             // add first appender segment
@@ -165,11 +261,18 @@ namespace bq {
             }
             mark_write_finished();
             flush_write_cache();
+        } else {
+            // appending to an existing file starts from a restart point, nothing written by previous processes is referred.
+            append_new_segment(appender_segment_type::normal);
         }
     }
 
     void appender_file_binary::flush_write_cache()
     {
+        if (block_compression_ != appender_block_compression::none && get_pendding_flush_written_size() > 0) {
+            flush_write_cache_as_block();
+            return;
+        }
         if (xor_key_blob_.is_empty() || get_pendding_flush_written_size() == 0) {
             appender_file_base::flush_write_cache();
             return;
@@ -178,23 +281,63 @@ namespace bq {
 #ifndef NDEBUG
         assert((get_xor_key_blob_size() & (get_xor_key_blob_size() - 1)) == 0 && "get_xor_key_blob_size() must be power of two");
 #endif
-        vernam::vernam_encrypt_32bytes_aligned(
+        // encrypted into staging_cache_ in one pass, what is not written stays plaintext in the write cache.
+        size_t align_offset = get_current_file_size() & (appender_file_base::DEFAULT_BUFFER_ALIGNMENT - 1);
+        staging_cache_.clear();
+        staging_cache_.fill_uninitialized(align_offset + get_pendding_flush_written_size());
+        vernam::vernam_encrypt_32bytes_aligned_copy(
+            staging_cache_.begin() + static_cast<ptrdiff_t>(align_offset),
             get_cache_write_ptr_base(),
             get_pendding_flush_written_size(),
             xor_key_blob_.begin(),
             get_xor_key_blob_size(),
             get_current_file_size());
-        appender_file_base::flush_write_cache();
-        update_write_cache_padding();
-        if (enc_type_ == appender_encryption_type::rsa_aes_xor && get_pendding_flush_written_size() > 0) {
-            // revert
+        flush_write_cache_from(staging_cache_.begin() + static_cast<ptrdiff_t>(align_offset));
+        shrink_staging_cache();
+    }
+
+    void appender_file_binary::shrink_staging_cache()
+    {
+        if (staging_cache_.capacity() > STAGING_CACHE_KEEP_SIZE) {
+            // left by an oversized flush
+            staging_cache_.clear();
+            staging_cache_.shrink();
+        }
+    }
+
+    void appender_file_binary::flush_write_cache_as_block()
+    {
+        const uint8_t* raw_data = get_cache_write_ptr_base();
+        size_t raw_size = get_pendding_flush_written_size();
+        size_t align_offset = xor_key_blob_.is_empty() ? 0 : (get_current_file_size() & (appender_file_base::DEFAULT_BUFFER_ALIGNMENT - 1));
+        size_t data_offset = align_offset + sizeof(appender_block_head);
+        staging_cache_.clear();
+        staging_cache_.fill_uninitialized(data_offset + lz4::get_max_compressed_size(raw_size));
+        size_t stored_size = block_encoder_.compress(raw_data, raw_size, staging_cache_.begin() + static_cast<ptrdiff_t>(data_offset), staging_cache_.size() - data_offset);
+        if (stored_size == 0 || stored_size >= raw_size) {
+            // incompressible data is stored as is
+            memcpy(staging_cache_.begin() + static_cast<ptrdiff_t>(data_offset), raw_data, raw_size);
+            stored_size = raw_size;
+        }
+        appender_block_head block_head;
+        block_head.raw_size = static_cast<uint32_t>(raw_size);
+        block_head.stored_size = static_cast<uint32_t>(stored_size);
+        block_head.checksum = bq::util::get_hash(staging_cache_.begin() + static_cast<ptrdiff_t>(data_offset), stored_size);
+        memcpy(staging_cache_.begin() + static_cast<ptrdiff_t>(align_offset), &block_head, sizeof(block_head));
+        size_t block_size = sizeof(appender_block_head) + stored_size;
+        if (!xor_key_blob_.is_empty()) {
             vernam::vernam_encrypt_32bytes_aligned(
-                get_cache_write_ptr_base(),
-                get_pendding_flush_written_size(),
+                staging_cache_.begin() + static_cast<ptrdiff_t>(align_offset),
+                block_size,
                 xor_key_blob_.begin(),
                 get_xor_key_blob_size(),
                 get_current_file_size());
         }
+        if (!flush_write_cache_transformed(staging_cache_.begin() + static_cast<ptrdiff_t>(align_offset), block_size)) {
+            // the block is lost and its tail is left in the file, what is written next must not refer to anything in it.
+            append_new_segment(appender_segment_type::normal);
+        }
+        shrink_staging_cache();
     }
 
     bool appender_file_binary::seek_read_file_absolute(size_t pos)
@@ -219,6 +362,7 @@ namespace bq {
         if (!appender_file_base::on_appender_file_recovery_begin()) {
             return false;
         }
+        last_seg_start_pos_ = UINT64_MAX;
         append_new_segment(appender_segment_type::recovery_by_appender);
         return true;
     }
@@ -303,17 +447,23 @@ namespace bq {
         return true;
     }
 
-    void appender_file_binary::append_new_segment(appender_file_binary::appender_segment_type type)
+    void appender_file_binary::append_new_segment(appender_file_binary::appender_segment_type type, bool sync_to_disk)
     {
         clear_read_cache();
-        cur_read_seg_.end_pos = static_cast<uint64_t>(sizeof(appender_file_header));
         bool has_segment = false;
-        while (read_to_next_segment()) {
+        if (last_seg_start_pos_ != UINT64_MAX) {
+            cur_read_seg_.start_pos = last_seg_start_pos_;
+            cur_read_seg_.end_pos = UINT64_MAX;
             has_segment = true;
-            // skip to the final_segment
+        } else {
+            cur_read_seg_.end_pos = static_cast<uint64_t>(sizeof(appender_file_header));
+            while (read_to_next_segment()) {
+                has_segment = true;
+                // skip to the final_segment
+            }
         }
+        uint64_t new_seg_start_pos = static_cast<uint64_t>(get_current_file_size());
         if (has_segment) {
-            uint64_t new_seg_start_pos = static_cast<uint64_t>(get_current_file_size());
             // record the start of current segment on prev segment's head
             direct_write(&new_seg_start_pos, sizeof(new_seg_start_pos), bq::file_manager::seek_option::begin,
                 static_cast<int64_t>(cur_read_seg_.start_pos) + static_cast<int64_t>(BQ_POD_RUNTIME_OFFSET_OF(appender_file_segment_head, next_seg_pos)));
@@ -322,6 +472,8 @@ namespace bq {
         new_segment.enc_type = enc_type_;
         new_segment.next_seg_pos = UINT64_MAX;
         new_segment.seg_type = type;
+        // the key blob is generated once per file (xor_key_blob_ is cleared in on_file_open) and carried forward,
+        // so only the first segment holds keys and periodic restart points never pay an RSA encryption.
         new_segment.has_key = (enc_type_ == appender_encryption_type::rsa_aes_xor) && xor_key_blob_.is_empty();
         direct_write(&new_segment, sizeof(new_segment), bq::file_manager::seek_option::end, 0);
         if (new_segment.has_key) {
@@ -364,21 +516,14 @@ namespace bq {
             direct_write(static_cast<const uint8_t*>(xor_key_blob_ciphertext.begin()), xor_key_blob_ciphertext.size(), bq::file_manager::seek_option::current, 0);
             xor_key_blob_ = bq::move(xor_key_blob_plaintext);
         }
-        flush_write_io();
-        update_write_cache_padding();
-    }
-
-    void appender_file_binary::update_write_cache_padding()
-    {
-        if (enc_type_ != appender_encryption_type::rsa_aes_xor || xor_key_blob_.is_empty()) {
-            set_cache_write_padding(0);
-        } else {
-            auto file_pos = get_current_file_size();
-            auto enc_start_pos = static_cast<size_t>(file_pos & (xor_key_blob_.size() - 1));
-            size_t target_align = enc_start_pos & (appender_file_base::DEFAULT_BUFFER_ALIGNMENT - static_cast<size_t>(1));
-            size_t current_align = get_cache_write_head_size() & (appender_file_base::DEFAULT_BUFFER_ALIGNMENT - static_cast<size_t>(1));
-            uint8_t target_padding = (target_align + appender_file_base::DEFAULT_BUFFER_ALIGNMENT - current_align) & (appender_file_base::DEFAULT_BUFFER_ALIGNMENT - static_cast<size_t>(1));
-            set_cache_write_padding(target_padding);
+        if (sync_to_disk) {
+            flush_write_io();
+        }
+        last_seg_start_pos_ = new_seg_start_pos;
+        last_seg_type_ = type;
+        last_sync_marker_pos_ = static_cast<uint64_t>(get_current_file_size() + get_pendding_flush_written_size());
+        if (type == appender_segment_type::normal) {
+            on_restart_point();
         }
     }
 }
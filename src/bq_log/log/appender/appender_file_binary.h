@@ -28,7 +28,8 @@
  *    ------  ----  -----------------------------------------------------------
  *    0x0000     4  uint32_t version                      (appender_file_header)
  *    0x0004     1  appender_format_type format           (1=raw, 2=compressed)
- *    0x0005     3  char padding[3]
+ *    0x0005     1  appender_block_compression block_compression (0=none, 1=fast, 2=high)
+ *    0x0006     2  char padding[2]
  *
  * 2. Segment Structure
  *    Each segment begins with a Segment Header, followed by Encryption Info (if enabled),
@@ -44,6 +45,8 @@
  *       +0x0B      1  char padding[2]
  *
  *    B. Encryption Keys (Optional, Present only if enc_type == rsa_aes_xor and only has_key is true in Segment Header)
+ *       Only the first segment of a file has them, all later segments (restart points included)
+ *       are encrypted with the same XOR key blob, which the decoder keeps while walking the chain.
  *       Offset  Size       Field
  *       ------  ---------  ---------------------------------------------------
  *       +0x00   256        RSA-2048 ciphertext of AES_256 key
@@ -73,6 +76,44 @@
  *       [Subsequent Segments Payload]
  *       Contains only Log Entries (no Metadata).
  *
+ *    D. Restart Points
+ *       Every normal segment is a restart point: nothing written in it depends on data
+ *       written before its head (e.g. compressed templates and epoch base are reset).
+ *       The writer starts a new normal segment once the current one grows beyond
+ *       "seek_index_interval" bytes, so the segment chain doubles as a sparse index
+ *       for seeking by time and for splitting a file between threads.
+ *       Recovery segments continue the state of the segment before them.
+ *
+ *    E. Sync Markers
+ *       Every "sync_marker_interval" bytes inside a segment the writer puts a sync
+ *       marker (appender_sync_marker, 32 bytes) in front of the next log entry, framed
+ *       as an item of its format. It carries the decoding state of the segment at
+ *       that point, guarded by a checksum. When a damaged item is met (a crash in the
+ *       middle of a write, a full disk), the decoder scans forward for the next marker
+ *       with a valid checksum and resumes there, or at the next segment if there is none.
+ *       Offset  Size  Field
+ *       ------  ----  -------------------------------------------------------
+ *       +0x00      8  uint8_t magic[8]
+ *       +0x08      8  uint64_t epoch_ms                    (epoch base, compressed format only)
+ *       +0x10      4  uint32_t format_template_count       (compressed format only)
+ *       +0x14      4  uint32_t thread_info_template_count  (compressed format only)
+ *       +0x18      8  uint64_t checksum                    (get_hash_64 of the fields above)
+ *
+ *    F. Block Compression
+ *       If block_compression is not none, everything the write cache flushes into a segment
+ *       payload (metadata, log items, sync markers) is framed as blocks, each one holding
+ *       whole items. Segment heads and encryption keys are not. With encryption the XOR is
+ *       applied to the blocks as they are stored in the file.
+ *       Offset  Size  Field
+ *       ------  ----  -------------------------------------------------------
+ *       +0x00      4  uint32_t raw_size                    (size of the items in it)
+ *       +0x04      4  uint32_t stored_size                 (== raw_size: stored as is, otherwise LZ4 block format)
+ *       +0x08      4  uint32_t checksum                    (bq::util::get_hash of the stored data)
+ *       +0x0C   stored_size  data
+ *       Files with block compression are never appended to, a new file is started instead.
+ *       A block is written per cache flush, so it pays off with log.thread_mode=async; in
+ *       sync mode every entry is flushed and becomes a block of its own.
+ *
  * Conventions
  * - All multi-byte integers are little-endian unless stated otherwise.
  * - All structures are packed (BQ_PACK_BEGIN/END). The explicit padding fields
@@ -80,6 +121,7 @@
  *
  */
 #include "bq_common/bq_common.h"
+#include "bq_common/compression/lz4.h"
 #include "bq_log/bq_log.h"
 #include "bq_log/log/appender/appender_file_base.h"
 #include "bq_log/log/log_types.h"
@@ -100,12 +142,18 @@ namespace bq {
             recovery_by_appender,
             recovery_by_log_buffer
         };
+        enum class appender_block_compression : uint8_t {
+            none = 0,
+            fast,
+            high
+        };
 
         BQ_PACK_BEGIN
         struct appender_file_header {
             uint32_t version;
             appender_format_type format;
-            char padding[3];
+            appender_block_compression block_compression;
+            char padding[2];
         } BQ_PACK_END static_assert(sizeof(appender_file_header) == 8, "appender_file_header size error");
 
         BQ_PACK_BEGIN
@@ -129,7 +177,23 @@ namespace bq {
             uint32_t category_count;
         } BQ_PACK_END
 
-            struct seg_info {
+        BQ_PACK_BEGIN
+        struct appender_sync_marker {
+            uint8_t magic[8];
+            uint64_t epoch_ms;
+            uint32_t format_template_count;
+            uint32_t thread_info_template_count;
+            uint64_t checksum;
+        } BQ_PACK_END static_assert(sizeof(appender_sync_marker) == 32, "appender_sync_marker size error");
+
+        BQ_PACK_BEGIN
+        struct appender_block_head {
+            uint32_t raw_size;
+            uint32_t stored_size;
+            uint32_t checksum;
+        } BQ_PACK_END static_assert(sizeof(appender_block_head) == 12, "appender_block_head size error");
+
+        struct seg_info {
             uint64_t start_pos;
             uint64_t end_pos;
             appender_encryption_type enc_type_;
@@ -148,9 +212,17 @@ namespace bq {
                 + get_xor_key_blob_size(); // size of AES-encrypted XOR key blob
         }
 
+        static constexpr uint64_t DEFAULT_SEEK_INDEX_INTERVAL = 1024 * 1024;
+        static constexpr uint64_t DEFAULT_SYNC_MARKER_INTERVAL = 64 * 1024;
+        static const uint8_t SYNC_MARKER_MAGIC[8];
+
+        // Whether data holds a sync marker with the right magic and checksum.
+        static bool verify_sync_marker(const uint8_t* data);
+
     protected:
         virtual bool init_impl(const bq::property_value& config_obj) override;
         virtual bool reset_impl(const bq::property_value& config_obj) override;
+        virtual void log_impl(const log_entry_handle& handle) override;
         virtual bool parse_exist_log_file(parse_file_context& context) override;
         virtual void on_file_open(bool is_new_created) override;
         virtual void flush_write_cache() override;
@@ -164,17 +236,40 @@ namespace bq {
         virtual void on_log_item_recovery_end() override;
         virtual void on_log_item_new_begin(bq::log_entry_handle& read_handle) override;
         virtual read_with_cache_handle read_with_cache(size_t size) override;
+        // Called after a normal segment (restart point) is appended, data written later must not refer to anything before it.
+        virtual void on_restart_point() { }
+        // Whether sync_marker_interval bytes have been written since the last sync marker or segment head,
+        // derived appenders write a sync marker in front of the next log entry then.
+        bool is_sync_marker_due() const;
+        // Fill in magic and checksum of marker, the next one is due sync_marker_interval bytes from here.
+        void seal_sync_marker(appender_sync_marker& marker);
 
     private:
+        void set_seek_index_interval(const bq::property_value& config_obj);
+        void set_sync_marker_interval(const bq::property_value& config_obj);
+        appender_block_compression parse_block_compression(const bq::property_value& config_obj) const;
+        void flush_write_cache_as_block();
+        void shrink_staging_cache();
         bool read_to_correct_segment();
         bool read_to_next_segment();
-        void append_new_segment(appender_segment_type type);
-        void update_write_cache_padding();
+        void append_new_segment(appender_segment_type type, bool sync_to_disk = true);
 
     private:
         bq::rsa::public_key rsa_pub_key_;
         seg_info cur_read_seg_;
         appender_encryption_type enc_type_;
+        uint64_t seek_index_interval_ = DEFAULT_SEEK_INDEX_INTERVAL;
+        uint64_t sync_marker_interval_ = DEFAULT_SYNC_MARKER_INTERVAL;
+        // write position of the last sync marker or segment head
+        uint64_t last_sync_marker_pos_ = 0;
+        // head of the last segment of the file being written, UINT64_MAX if the segment chain has to be walked to find it
+        uint64_t last_seg_start_pos_ = UINT64_MAX;
+        appender_segment_type last_seg_type_ = appender_segment_type::normal;
+        appender_block_compression block_compression_ = appender_block_compression::none;
+        bq::lz4 block_encoder_;
+        // encrypted or compressed data being flushed, at the same alignment as its file position if it is encrypted.
+        // the write cache itself always holds plaintext.
+        bq::array<uint8_t, bq::aligned_allocator<uint8_t, appender_file_base::DEFAULT_BUFFER_ALIGNMENT>> staging_cache_;
         bq::array<uint8_t, bq::aligned_allocator<uint8_t, appender_file_base::DEFAULT_BUFFER_ALIGNMENT>> xor_key_blob_;
     };
 }
@@ -1,4 +1,4 @@
-/*
+﻿/*
  * Copyright (C) 2025 Tencent.
  * BQLOG is licensed under the Apache License, Version 2.0.
  * You may obtain a copy of the License at
@@ -47,6 +47,15 @@ namespace bq {
 
     bool appender_file_compressed::init_impl(const bq::property_value& config_obj)
     {
+        // the dictionary is emptied by reset() at the restart point the file is opened with
+        if (config_obj["string_dictionary_capacity"].is_integral()) {
+            string_dictionary_capacity_ = bq::min_value((uint32_t)(uint64_t)config_obj["string_dictionary_capacity"], MAX_STRING_DICTIONARY_CAPACITY);
+        } else {
+            string_dictionary_capacity_ = DEFAULT_STRING_DICTIONARY_CAPACITY;
+        }
+        string_dictionary_candidates_.clear();
+        string_dictionary_candidates_.fill_uninitialized(static_cast<size_t>(string_dictionary_capacity_) * 4);
+        string_dictionary_hash_cache_.set_expand_rate(4);
         if (!appender_file_binary::init_impl(config_obj)) {
             return false;
         }
@@ -55,12 +64,10 @@ namespace bq {
         return true;
     }
 
-    void appender_file_compressed::on_file_open(bool is_new_created)
+    void appender_file_compressed::on_restart_point()
     {
-        appender_file_binary::on_file_open(is_new_created);
-        if (is_new_created) {
-            reset();
-        }
+        appender_file_binary::on_restart_point();
+        reset();
     }
 
     bq::string appender_file_compressed::get_file_ext_name()
@@ -102,6 +109,15 @@ namespace bq {
                         return false;
                     }
                     break;
+                case template_sub_type::arg_type_signature:
+                case template_sub_type::string_define:
+                    break;
+                case template_sub_type::sync_marker:
+                    if (bq::get<2>(read_result).len() != 1 + sizeof(appender_sync_marker) || !verify_sync_marker(bq::get<2>(read_result).data() + 1)) {
+                        context.log_parse_fail_reason("decode compressed log file failed, invalid sync marker");
+                        return false;
+                    }
+                    break;
                 default:
                     context.log_parse_fail_reason("decode compressed log file failed, invalid log template sub type");
                     return false;
@@ -215,6 +231,8 @@ namespace bq {
         uint64_t format_template_hash = get_format_template_hash((bq::log_level)level_byte, category_idx, fmt_str_hash);
         format_templates_hash_cache_[format_template_hash] = current_format_template_max_index_;
         ++current_format_template_max_index_;
+        // signatures of existing entries are not needed, appending starts from a restart point
+        arg_type_signature_offsets_.push_back(static_cast<uint32_t>(arg_type_signatures_.size()));
         return true;
     }
 
@@ -227,13 +245,164 @@ namespace bq {
         return true;
     }
 
+    void appender_file_compressed::write_sync_marker()
+    {
+        appender_sync_marker marker;
+        marker.epoch_ms = last_log_entry_epoch_;
+        marker.format_template_count = current_format_template_max_index_;
+        marker.thread_info_template_count = current_thread_info_max_index_;
+        seal_sync_marker(marker);
+        // the decoder may start here after damaged data, dictionary slots are defined again before they are referred to,
+        // and deltas start from 0.
+        ++string_dictionary_generation_;
+        memset(delta_bases_.begin(), 0, delta_bases_.size() * sizeof(uint64_t));
+        constexpr uint32_t body_len = static_cast<uint32_t>(1 + sizeof(appender_sync_marker));
+        static_assert(body_len < 128, "sync marker item head must be 2 bytes");
+        auto write_handle = alloc_write_cache(2 + body_len);
+        write_handle.data()[0] = (uint8_t)item_type::log_template;
+        bq::log_utils::vlq::vlq_encode(body_len, write_handle.data() + 1, 1);
+        write_handle.data()[2] = (uint8_t)template_sub_type::sync_marker;
+        memcpy(write_handle.data() + 3, &marker, sizeof(marker));
+        return_write_cache(write_handle);
+    }
+
+    void appender_file_compressed::write_arg_type_signature(uint32_t format_template_idx)
+    {
+        constexpr size_t VLQ_MAX_SIZE = bq::log_utils::vlq::vlq_max_bytes_count<uint32_t>();
+        const uint32_t signature_start = arg_type_signature_offsets_[format_template_idx];
+        const uint32_t signature_len = arg_type_signature_offsets_[format_template_idx + 1] - signature_start;
+        const uint32_t body_len = 1 + static_cast<uint32_t>(bq::log_utils::vlq::get_vlq_encode_length(static_cast<uint64_t>(format_template_idx))) + signature_len;
+        const uint32_t head_size = 1 + static_cast<uint32_t>(bq::log_utils::vlq::get_vlq_encode_length(static_cast<uint64_t>(body_len)));
+        auto write_handle = alloc_write_cache(head_size + body_len);
+        write_handle.data()[0] = (uint8_t)item_type::log_template;
+        bq::log_utils::vlq::vlq_encode(body_len, write_handle.data() + 1, VLQ_MAX_SIZE);
+        uint32_t cursor = head_size;
+        write_handle.data()[cursor++] = (uint8_t)template_sub_type::arg_type_signature;
+        cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(format_template_idx, write_handle.data() + cursor, VLQ_MAX_SIZE);
+        memcpy(write_handle.data() + cursor, arg_type_signatures_.begin() + static_cast<ptrdiff_t>(signature_start), signature_len);
+        return_write_cache(write_handle);
+    }
+
+    uint32_t appender_file_compressed::find_in_string_dictionary(bq::log_arg_type_enum type, const uint8_t* str, uint32_t len)
+    {
+        if (len < STRING_DICTIONARY_MIN_LEN || len > STRING_DICTIONARY_MAX_LEN || string_dictionary_capacity_ == 0) {
+            return UINT32_MAX;
+        }
+        const uint64_t hash = bq::util::bq_hash_only(str, len) ^ static_cast<uint64_t>(type);
+        uint32_t slot_idx = UINT32_MAX;
+        auto iter = string_dictionary_hash_cache_.find(hash);
+        if (iter != string_dictionary_hash_cache_.end()) {
+            slot_idx = iter->value();
+            string_dictionary_slot& slot = string_dictionary_[slot_idx];
+            if (slot.type != (uint8_t)type || slot.source.size() != len || memcmp(slot.source.begin(), str, len) != 0) {
+                return UINT32_MAX;
+            }
+            if (slot_idx == string_dictionary_lru_head_) {
+                slot.last_entry_serial = log_entry_serial_;
+                if (slot.generation != string_dictionary_generation_) {
+                    slot.generation = string_dictionary_generation_;
+                    pending_string_defines_.push_back(slot_idx);
+                }
+                return slot_idx;
+            }
+            // unlink, it's linked as the head below
+            string_dictionary_[slot.prev].next = slot.next;
+            if (slot.next != UINT32_MAX) {
+                string_dictionary_[slot.next].prev = slot.prev;
+            } else {
+                string_dictionary_lru_tail_ = slot.prev;
+            }
+            if (slot.generation != string_dictionary_generation_) {
+                slot.generation = string_dictionary_generation_;
+                pending_string_defines_.push_back(slot_idx);
+            }
+        } else {
+            uint64_t& candidate = string_dictionary_candidates_[static_cast<size_t>(hash % string_dictionary_candidates_.size())];
+            if (candidate != hash) {
+                candidate = hash;
+                return UINT32_MAX;
+            }
+            if (string_dictionary_.size() < string_dictionary_capacity_) {
+                slot_idx = static_cast<uint32_t>(string_dictionary_.size());
+                string_dictionary_.push_back(string_dictionary_slot());
+            } else {
+                slot_idx = string_dictionary_lru_tail_;
+                if (string_dictionary_[slot_idx].last_entry_serial == log_entry_serial_) {
+                    // more strings in this log entry than the dictionary holds
+                    return UINT32_MAX;
+                }
+                string_dictionary_hash_cache_.erase(string_dictionary_[slot_idx].hash);
+                string_dictionary_lru_tail_ = string_dictionary_[slot_idx].prev;
+                if (string_dictionary_lru_tail_ != UINT32_MAX) {
+                    string_dictionary_[string_dictionary_lru_tail_].next = UINT32_MAX;
+                } else {
+                    string_dictionary_lru_head_ = UINT32_MAX;
+                }
+            }
+            string_dictionary_slot& slot = string_dictionary_[slot_idx];
+            slot.hash = hash;
+            slot.type = (uint8_t)type;
+            slot.source.clear();
+            slot.source.insert_batch(slot.source.end(), str, len);
+            slot.generation = string_dictionary_generation_;
+            string_dictionary_hash_cache_[hash] = slot_idx;
+            pending_string_defines_.push_back(slot_idx);
+        }
+        string_dictionary_slot& slot = string_dictionary_[slot_idx];
+        slot.last_entry_serial = log_entry_serial_;
+        slot.prev = UINT32_MAX;
+        slot.next = string_dictionary_lru_head_;
+        if (string_dictionary_lru_head_ != UINT32_MAX) {
+            string_dictionary_[string_dictionary_lru_head_].prev = slot_idx;
+        } else {
+            string_dictionary_lru_tail_ = slot_idx;
+        }
+        string_dictionary_lru_head_ = slot_idx;
+        return slot_idx;
+    }
+
+    void appender_file_compressed::write_string_define(uint32_t slot_idx)
+    {
+        constexpr size_t VLQ_MAX_SIZE = bq::log_utils::vlq::vlq_max_bytes_count<uint32_t>();
+        const string_dictionary_slot& slot = string_dictionary_[slot_idx];
+        const uint8_t* str = slot.source.begin();
+        uint32_t str_len = static_cast<uint32_t>(slot.source.size());
+        if (slot.type == (uint8_t)bq::log_arg_type_enum::string_utf16_type) {
+            uint32_t max_utf_mixed_len = ((str_len * 3) >> 1) + 1;
+            string_dictionary_buffer_.clear();
+            string_dictionary_buffer_.fill_uninitialized(max_utf_mixed_len);
+            str_len = bq::util::utf16_to_utf_mixed((const char16_t*)str, str_len >> 1, (char*)(uint8_t*)string_dictionary_buffer_.begin(), max_utf_mixed_len);
+            str = string_dictionary_buffer_.begin();
+        }
+        const uint32_t body_len = 1 + static_cast<uint32_t>(bq::log_utils::vlq::get_vlq_encode_length(static_cast<uint64_t>(slot_idx))) + str_len;
+        const uint32_t head_size = 1 + static_cast<uint32_t>(bq::log_utils::vlq::get_vlq_encode_length(static_cast<uint64_t>(body_len)));
+        auto write_handle = alloc_write_cache(head_size + body_len);
+        write_handle.data()[0] = (uint8_t)item_type::log_template;
+        bq::log_utils::vlq::vlq_encode(body_len, write_handle.data() + 1, VLQ_MAX_SIZE);
+        uint32_t cursor = head_size;
+        write_handle.data()[cursor++] = (uint8_t)template_sub_type::string_define;
+        cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(slot_idx, write_handle.data() + cursor, VLQ_MAX_SIZE);
+        memcpy(write_handle.data() + cursor, str, str_len);
+        return_write_cache(write_handle);
+    }
+
     void appender_file_compressed::reset()
     {
         format_templates_hash_cache_.clear();
         thread_info_hash_cache_.clear();
         current_format_template_max_index_ = 0;
+        arg_type_signatures_.clear();
+        arg_type_signature_offsets_.clear();
+        arg_type_signature_offsets_.push_back(0U);
+        delta_bases_.clear();
         current_thread_info_max_index_ = 0;
         last_log_entry_epoch_ = 0;
+        string_dictionary_.clear();
+        string_dictionary_hash_cache_.clear();
+        string_dictionary_lru_head_ = UINT32_MAX;
+        string_dictionary_lru_tail_ = UINT32_MAX;
+        pending_string_defines_.clear();
+        memset(string_dictionary_candidates_.begin(), 0, string_dictionary_candidates_.size() * sizeof(uint64_t));
     }
 
     // Due to the use of VLQ and character encoding conversions,
@@ -245,9 +414,19 @@ namespace bq {
         return bytes_len > 1 ? (bytes_len - 1) : bytes_len;
     }
 
+    static bq_forceinline uint32_t write_delta(uint64_t value, uint64_t& base, uint8_t* dest)
+    {
+        const int64_t delta = static_cast<int64_t>(value - base);
+        base = value;
+        return (uint32_t)bq::log_utils::vlq::vlq_encode(bq::log_utils::zigzag::encode(delta), dest, bq::log_utils::vlq::vlq_max_bytes_count<uint64_t>());
+    }
+
     void appender_file_compressed::log_impl(const log_entry_handle& handle)
     {
         appender_file_binary::log_impl(handle);
+        if (is_sync_marker_due()) {
+            write_sync_marker();
+        }
 
         uint32_t format_data_len = handle.get_log_head().log_format_data_len;
         const char* format_data_ptr = handle.get_format_string_data();
@@ -262,6 +441,7 @@ namespace bq {
         uint64_t format_template_hash = get_format_template_hash(handle.get_level(), handle.get_log_head().category_idx, fmt_hash);
 
         auto format_template_iter = format_templates_hash_cache_.find(format_template_hash);
+        bool new_format_template = false;
         uint32_t format_template_idx = (uint32_t)-1;
         // write format template
         if (format_template_iter == format_templates_hash_cache_.end()) {
@@ -322,6 +502,7 @@ namespace bq {
             format_templates_hash_cache_[format_template_hash] = current_format_template_max_index_;
             format_template_idx = current_format_template_max_index_;
             ++current_format_template_max_index_;
+            new_format_template = true;
         } else {
             format_template_idx = format_template_iter->value();
         }
@@ -382,17 +563,46 @@ namespace bq {
             last_log_entry_epoch_ = log_epoch;
             uint64_t zigzag_epoch_offset = bq::log_utils::zigzag::encode(epoch_offset);
             log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(zigzag_epoch_offset, write_handle.data() + log_data_cursor, VLQ_MAX_SIZE_64);
-            log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(format_template_idx, write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+            // param types are left out if they are the same as the arg type signature of the format template,
+            // the first log entry of a format template writes them and defines the signature.
+            const uint32_t signature_start = arg_type_signature_offsets_[format_template_idx];
+            const uint32_t signature_len = new_format_template ? 0 : (arg_type_signature_offsets_[format_template_idx + 1] - signature_start);
+            bool explicit_arg_types = new_format_template;
+            uint32_t format_template_idx_cursor = log_data_cursor;
+            log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode((format_template_idx << 1) | (explicit_arg_types ? 1U : 0U), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
             log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(thread_info_idx, write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
 
             // write log params
-            {
+            const uint32_t args_start_cursor = log_data_cursor;
+            ++log_entry_serial_;
+            while (true) {
                 const uint8_t* const args_data_ptr = handle.get_log_args_data();
                 uint32_t args_data_cursor = 0;
-                while (args_data_cursor < raw_log_args_data_len) {
+                uint32_t arg_idx = 0;
+                bool signature_matched = true;
+                // numbers are written as deltas to the previous entry of the template if the signature is used,
+                // the previous values are only replaced once the params turn out to match it.
+                const bool use_delta = !explicit_arg_types;
+                if (use_delta) {
+                    delta_bases_staging_.clear();
+                    delta_bases_staging_.insert_batch(delta_bases_staging_.end(), delta_bases_.begin() + static_cast<ptrdiff_t>(signature_start), signature_len);
+                }
+                while (signature_matched && args_data_cursor < raw_log_args_data_len) {
                     uint8_t type_info_i = *(args_data_ptr + args_data_cursor);
                     bq::log_arg_type_enum type_info = (bq::log_arg_type_enum)(type_info_i);
-                    write_handle.data()[log_data_cursor++] = type_info_i;
+                    // utf16 strings are stored as utf-mixed
+                    uint8_t stored_type_i = (type_info == bq::log_arg_type_enum::string_utf16_type) ? (uint8_t)bq::log_arg_type_enum::string_utf_mixed_type : type_info_i;
+                    if (explicit_arg_types) {
+                        write_handle.data()[log_data_cursor++] = stored_type_i;
+                        if (new_format_template) {
+                            arg_type_signatures_.push_back(stored_type_i);
+                        }
+                    } else if (arg_idx >= signature_len || arg_type_signatures_[signature_start + arg_idx] != stored_type_i) {
+                        signature_matched = false;
+                        continue;
+                    }
+                    const uint32_t delta_idx = arg_idx;
+                    ++arg_idx;
                     switch (type_info) {
                     case bq::log_arg_type_enum::unsupported_type:
                         bq::util::log_device_console(bq::log_level::warning, "appender_file_compressed : non_primitivi_type is not supported yet, type:%d", (int32_t)type_info);
@@ -417,20 +627,36 @@ namespace bq {
                         break;
                     case bq::log_arg_type_enum::char16_type:
                     case bq::log_arg_type_enum::uint16_type:
-                        log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(*(const uint16_t*)(args_data_ptr + args_data_cursor + 2), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                        if (use_delta) {
+                            log_data_cursor += write_delta(static_cast<uint64_t>(*(const uint16_t*)(args_data_ptr + args_data_cursor + 2)), delta_bases_staging_[delta_idx], write_handle.data() + log_data_cursor);
+                        } else {
+                            log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(*(const uint16_t*)(args_data_ptr + args_data_cursor + 2), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                        }
                         args_data_cursor += 4;
                         break;
                     case bq::log_arg_type_enum::int16_type:
-                        log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(bq::log_utils::zigzag::encode(*(const int16_t*)(args_data_ptr + args_data_cursor + 2)), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                        if (use_delta) {
+                            log_data_cursor += write_delta(static_cast<uint64_t>(static_cast<int64_t>(*(const int16_t*)(args_data_ptr + args_data_cursor + 2))), delta_bases_staging_[delta_idx], write_handle.data() + log_data_cursor);
+                        } else {
+                            log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(bq::log_utils::zigzag::encode(*(const int16_t*)(args_data_ptr + args_data_cursor + 2)), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                        }
                         args_data_cursor += 4;
                         break;
                     case bq::log_arg_type_enum::char32_type:
                     case bq::log_arg_type_enum::uint32_type:
-                        log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(*(const uint32_t*)(args_data_ptr + args_data_cursor + 4), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                        if (use_delta) {
+                            log_data_cursor += write_delta(static_cast<uint64_t>(*(const uint32_t*)(args_data_ptr + args_data_cursor + 4)), delta_bases_staging_[delta_idx], write_handle.data() + log_data_cursor);
+                        } else {
+                            log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(*(const uint32_t*)(args_data_ptr + args_data_cursor + 4), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                        }
                         args_data_cursor += static_cast<uint32_t>(4U + sizeof(int32_t));
                         break;
                     case bq::log_arg_type_enum::int32_type:
-                        log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(bq::log_utils::zigzag::encode(*(const int32_t*)(args_data_ptr + args_data_cursor + 4)), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                        if (use_delta) {
+                            log_data_cursor += write_delta(static_cast<uint64_t>(static_cast<int64_t>(*(const int32_t*)(args_data_ptr + args_data_cursor + 4))), delta_bases_staging_[delta_idx], write_handle.data() + log_data_cursor);
+                        } else {
+                            log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(bq::log_utils::zigzag::encode(*(const int32_t*)(args_data_ptr + args_data_cursor + 4)), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                        }
                         args_data_cursor += static_cast<uint32_t>(4U + sizeof(int32_t));
                         break;
                     case bq::log_arg_type_enum::float_type:
@@ -439,14 +665,33 @@ namespace bq {
                         args_data_cursor += static_cast<uint32_t>(4U + sizeof(int32_t));
                         break;
                     case bq::log_arg_type_enum::uint64_type:
-                        log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(*(const uint64_t*)(args_data_ptr + args_data_cursor + 4), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE_64);
+                        if (use_delta) {
+                            log_data_cursor += write_delta(*(const uint64_t*)(args_data_ptr + args_data_cursor + 4), delta_bases_staging_[delta_idx], write_handle.data() + log_data_cursor);
+                        } else {
+                            log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(*(const uint64_t*)(args_data_ptr + args_data_cursor + 4), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE_64);
+                        }
                         args_data_cursor += static_cast<uint32_t>(4U + sizeof(int64_t));
                         break;
                     case bq::log_arg_type_enum::int64_type:
-                        log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(bq::log_utils::zigzag::encode(*(const int64_t*)(args_data_ptr + args_data_cursor + 4)), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE_64);
+                        if (use_delta) {
+                            log_data_cursor += write_delta(static_cast<uint64_t>(*(const int64_t*)(args_data_ptr + args_data_cursor + 4)), delta_bases_staging_[delta_idx], write_handle.data() + log_data_cursor);
+                        } else {
+                            log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(bq::log_utils::zigzag::encode(*(const int64_t*)(args_data_ptr + args_data_cursor + 4)), write_handle.data() + log_data_cursor, VLQ_MAX_SIZE_64);
+                        }
                         args_data_cursor += static_cast<uint32_t>(4U + sizeof(int64_t));
                         break;
                     case bq::log_arg_type_enum::double_type:
+                        if (use_delta) {
+                            uint64_t bits;
+                            memcpy(&bits, args_data_ptr + args_data_cursor + 4, sizeof(bits));
+                            uint64_t code = bq::log_utils::double_xor::encode(bits ^ delta_bases_staging_[delta_idx]);
+                            delta_bases_staging_[delta_idx] = bits;
+                            log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(code, write_handle.data() + log_data_cursor, VLQ_MAX_SIZE_64);
+                            if (code != bq::log_utils::double_xor::escape_code) {
+                                args_data_cursor += static_cast<uint32_t>(4 + sizeof(int64_t));
+                                break;
+                            }
+                        }
                         memcpy(write_handle.data() + log_data_cursor, args_data_ptr + args_data_cursor + 4, sizeof(int64_t));
                         log_data_cursor += static_cast<uint32_t>(sizeof(int64_t));
                         args_data_cursor += static_cast<uint32_t>(4 + sizeof(int64_t));
@@ -454,23 +699,35 @@ namespace bq {
                     case bq::log_arg_type_enum::string_utf8_type: {
                         const uint32_t* len_ptr = (const uint32_t*)(args_data_ptr + args_data_cursor + 4);
                         uint32_t str_len = *len_ptr;
-                        log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(str_len, write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
-                        memcpy(write_handle.data() + log_data_cursor, args_data_ptr + args_data_cursor + 4 + sizeof(uint32_t), str_len);
-                        log_data_cursor += str_len;
+                        const uint8_t* str = args_data_ptr + args_data_cursor + 4 + sizeof(uint32_t);
                         args_data_cursor += static_cast<uint32_t>(4U + sizeof(uint32_t) + bq::align_4(str_len));
+                        uint32_t slot_idx = find_in_string_dictionary(type_info, str, str_len);
+                        if (slot_idx != UINT32_MAX) {
+                            log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode((slot_idx << 1) | 1U, write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                            break;
+                        }
+                        log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode(str_len << 1, write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                        memcpy(write_handle.data() + log_data_cursor, str, str_len);
+                        log_data_cursor += str_len;
                     } break;
                     case bq::log_arg_type_enum::string_utf16_type: {
                         // trans to utf-mixed to get best balance of size and performance
-                        write_handle.data()[log_data_cursor - 1] = (uint8_t)bq::log_arg_type_enum::string_utf_mixed_type;
                         const uint32_t* len_ptr = (const uint32_t*)(args_data_ptr + args_data_cursor + 4);
                         uint32_t str_len = *len_ptr;
+                        const uint8_t* str = args_data_ptr + args_data_cursor + 4 + sizeof(uint32_t);
+                        uint32_t slot_idx = find_in_string_dictionary(type_info, str, str_len);
+                        if (slot_idx != UINT32_MAX) {
+                            log_data_cursor += (uint32_t)bq::log_utils::vlq::vlq_encode((slot_idx << 1) | 1U, write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                            args_data_cursor += static_cast<uint32_t>(4U + sizeof(uint32_t) + bq::align_4(str_len));
+                            break;
+                        }
 
                         uint32_t max_utf8_str_len = ((str_len * 3) >> 1) + 1;
-                        auto pre_len_size = bq::log_utils::vlq::get_vlq_encode_length((uint32_t)max_utf8_str_len);
+                        auto pre_len_size = bq::log_utils::vlq::get_vlq_encode_length((uint32_t)(max_utf8_str_len << 1));
 
-                        uint32_t utf_mixed_len = bq::util::utf16_to_utf_mixed((const char16_t*)(args_data_ptr + args_data_cursor + 4 + sizeof(uint32_t)), str_len >> 1, (char*)(write_handle.data() + log_data_cursor + pre_len_size), max_utf8_str_len);
+                        uint32_t utf_mixed_len = bq::util::utf16_to_utf_mixed((const char16_t*)str, str_len >> 1, (char*)(write_handle.data() + log_data_cursor + pre_len_size), max_utf8_str_len);
 
-                        uint32_t real_len_size = (uint32_t)bq::log_utils::vlq::vlq_encode(utf_mixed_len, write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
+                        uint32_t real_len_size = (uint32_t)bq::log_utils::vlq::vlq_encode(utf_mixed_len << 1, write_handle.data() + log_data_cursor, VLQ_MAX_SIZE);
 
                         assert((real_len_size == pre_len_size || (real_len_size + 1 == pre_len_size)) && "compressed log, utf16 arguments write error");
                         if (real_len_size + 1 == pre_len_size) {
@@ -484,6 +741,43 @@ namespace bq {
                     }
                     continue;
                 }
+                if (explicit_arg_types) {
+                    break;
+                }
+                if (signature_matched && arg_idx == signature_len) {
+                    memcpy(delta_bases_.begin() + static_cast<ptrdiff_t>(signature_start), delta_bases_staging_.begin(), signature_len * sizeof(uint64_t));
+                    break;
+                }
+                // the param types differ from the signature, write them explicitly
+                explicit_arg_types = true;
+                log_data_cursor = args_start_cursor;
+                bq::log_utils::vlq::vlq_encode((format_template_idx << 1) | 1U, write_handle.data() + format_template_idx_cursor, VLQ_MAX_SIZE);
+            }
+            if (new_format_template) {
+                for (uint32_t i = signature_start; i < static_cast<uint32_t>(arg_type_signatures_.size()); ++i) {
+                    if (arg_type_signatures_[i] == (uint8_t)bq::log_arg_type_enum::unsupported_type) {
+                        // params after it are not written, such entries never use the signature
+                        arg_type_signatures_.erase(arg_type_signatures_.begin() + static_cast<ptrdiff_t>(signature_start), arg_type_signatures_.size() - signature_start);
+                        break;
+                    }
+                }
+                arg_type_signature_offsets_.push_back(static_cast<uint32_t>(arg_type_signatures_.size()));
+                while (delta_bases_.size() < arg_type_signatures_.size()) {
+                    delta_bases_.push_back(0ULL);
+                }
+            }
+            if (!pending_string_defines_.is_empty()) {
+                // string defines must be in front of the log entry referring to them, the entry is moved behind them.
+                log_entry_buffer_.clear();
+                log_entry_buffer_.insert_batch(log_entry_buffer_.end(), write_handle.data(), log_data_cursor);
+                write_handle.reset_used_len(0);
+                return_write_cache(write_handle);
+                for (uint32_t slot_idx : pending_string_defines_) {
+                    write_string_define(slot_idx);
+                }
+                pending_string_defines_.clear();
+                write_handle = alloc_write_cache(log_data_cursor);
+                memcpy(write_handle.data(), log_entry_buffer_.begin(), log_data_cursor);
             }
             // write back head
             uint32_t real_total_len = log_data_cursor;
@@ -502,6 +796,9 @@ namespace bq {
             }
             return_write_cache(write_handle);
         }
+        if (new_format_template && arg_type_signature_offsets_[format_template_idx + 1] > arg_type_signature_offsets_[format_template_idx]) {
+            write_arg_type_signature(format_template_idx);
+        }
         mark_write_finished();
     }
 }
\ No newline at end of file
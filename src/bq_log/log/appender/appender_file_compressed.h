@@ -43,11 +43,27 @@
  * The data structures for the two types of data are:
  * 1. data(Log Template):
  *  [sub type(1 byte][sub type data(see sub types bellow)]
- *  there are two sub types of Log Template:
+ *  there are five sub types of Log Template:
  * 	1.1 Format Template: [level(1 byte), category_idx(VLQ), utf_mixed_fmt_data(str, 0 bytes or more)] (NO HASH stored!)
  * 	1.2 Thread Info Template: [thread_info_template idx(VLQ), thread_id(VLQ 64bits), thread name str utf-8]
+ * 	1.3 Sync Marker: [appender_sync_marker(32 bytes), see appender_file_binary.h], holds the epoch base and the template counts of the segment so far.
+ * 	1.4 Arg Type Signature: [formate_template idx(VLQ), param_type(1 byte) ...], the param types of the first log entry of a format template,
+ * 	    written right after that entry.
+ * 	1.5 String Define: [string dictionary slot idx(VLQ), str(utf-8 or utf-mixed, the same as the param type)], puts a string into a slot
+ * 	    of the string dictionary, written before the first log entry referring to it.
  * 2. data(Log Entry):
- * 	(epoch offset milliseconds)(VLQ), [(formate_template idx)(VLQ), (thread_info_template idx)(VLQ), [param_type(1 byte), param(same as raw data, not aligned) ...]]
+ * 	(epoch offset milliseconds)(VLQ), [(formate_template idx << 1 | explicit_param_types)(VLQ), (thread_info_template idx)(VLQ), [param_type(1 byte), param(same as raw data, not aligned) ...]]
+ * 	param_type is only present if explicit_param_types is 1, otherwise the param types are the Arg Type Signature of the format template.
+ * 	string params start with (str_len << 1)(VLQ) followed by the str, or (slot idx << 1 | 1)(VLQ) if the str is in the string dictionary.
+ * 	If explicit_param_types is 0, integer params of 16 bits or more are stored as zigzag(value - previous value)(VLQ), and double params
+ * 	as log_utils::double_xor(bits ^ previous bits)(VLQ, followed by the raw 8 bytes for escape_code). Previous values are those of
+ * 	the same param of the last log entry of the format template without explicit_param_types, 0 after a Sync Marker or a restart point.
+ *
+ * 【String Dictionary】
+ * Repeated string params (host names, error codes...) are kept in a bounded dictionary, which is emptied at every restart point.
+ * A string is put into the dictionary the second time it is seen, the least recently used one is replaced when it is full.
+ * The decoder doesn't track the usage, it only follows the String Define items. All slots are defined again on their
+ * first use after a Sync Marker, so the decoder can forget them when it resumes at a Sync Marker after damaged data.
 
  */
 #include "bq_log/log/appender/appender_file_binary.h"
@@ -62,11 +78,28 @@ namespace bq {
         enum template_sub_type : uint8_t {
             format_template_utf8 = 0,
             thread_info_template = 1,
-            format_template_utf16 = 2
+            format_template_utf16 = 2,
+            sync_marker = 3,
+            arg_type_signature = 4,
+            string_define = 5
+        };
+        struct string_dictionary_slot {
+            uint64_t hash;
+            uint64_t last_entry_serial; // log entry which used it last, it is not replaced while that entry is written
+            uint32_t generation; // string_dictionary_generation_ when it was defined last time
+            uint32_t prev; // LRU list, towards the most recently used
+            uint32_t next;
+            uint8_t type; // log_arg_type_enum of the param, utf16 strings are defined as utf-mixed
+            bq::array<uint8_t> source; // param data, to tell hash collisions apart
         };
 
     public:
-        static constexpr uint32_t format_version = 9;
+        static constexpr uint32_t format_version = 15;
+        static constexpr uint32_t DEFAULT_STRING_DICTIONARY_CAPACITY = 256;
+        static constexpr uint32_t MAX_STRING_DICTIONARY_CAPACITY = 4096;
+        // shorter strings are not smaller as references, longer ones seldom repeat
+        static constexpr uint32_t STRING_DICTIONARY_MIN_LEN = 4;
+        static constexpr uint32_t STRING_DICTIONARY_MAX_LEN = 256;
 
     protected:
         virtual bool init_impl(const bq::property_value& config_obj) override;
@@ -75,7 +108,7 @@ namespace bq {
 
         virtual bool parse_exist_log_file(parse_file_context& context) override;
 
-        virtual void on_file_open(bool is_new_created) override;
+        virtual void on_restart_point() override;
 
         virtual appender_file_binary::appender_format_type get_appender_format() const override
         {
@@ -95,13 +128,42 @@ namespace bq {
 
         bool parse_thread_info_template(parse_file_context& context, const appender_file_base::read_with_cache_handle& data_handle);
 
+        void write_sync_marker();
+
+        void write_arg_type_signature(uint32_t format_template_idx);
+
+        // Returns the dictionary slot the string param is written as, or UINT32_MAX if it's written as it is.
+        // Slots that must be defined before the log entry are added to pending_string_defines_.
+        uint32_t find_in_string_dictionary(bq::log_arg_type_enum type, const uint8_t* str, uint32_t len);
+
+        void write_string_define(uint32_t slot_idx);
+
         void reset();
 
     private:
         bq::hash_map_inline<uint64_t, uint32_t> format_templates_hash_cache_;
         uint32_t current_format_template_max_index_;
+        // param types of format template i are arg_type_signatures_[arg_type_signature_offsets_[i], arg_type_signature_offsets_[i + 1])
+        bq::array<uint8_t> arg_type_signatures_;
+        bq::array<uint32_t> arg_type_signature_offsets_;
+        // previous param values of log entries using the arg type signature, same indices as arg_type_signatures_
+        bq::array<uint64_t> delta_bases_;
+        bq::array<uint64_t> delta_bases_staging_;
         bq::hash_map_inline<uint64_t, uint32_t> thread_info_hash_cache_;
         uint32_t current_thread_info_max_index_;
         uint64_t last_log_entry_epoch_;
+
+        uint32_t string_dictionary_capacity_ = DEFAULT_STRING_DICTIONARY_CAPACITY;
+        uint32_t string_dictionary_generation_ = 0;
+        uint64_t log_entry_serial_ = 0;
+        uint32_t string_dictionary_lru_head_ = UINT32_MAX;
+        uint32_t string_dictionary_lru_tail_ = UINT32_MAX;
+        bq::array<string_dictionary_slot> string_dictionary_;
+        bq::hash_map_inline<uint64_t, uint32_t> string_dictionary_hash_cache_;
+        // hashes of strings seen once, a string is put into the dictionary when it's found here
+        bq::array<uint64_t> string_dictionary_candidates_;
+        bq::array<uint32_t> pending_string_defines_;
+        bq::array<uint8_t> string_dictionary_buffer_;
+        bq::array<uint8_t> log_entry_buffer_;
     };
 }
\ No newline at end of file
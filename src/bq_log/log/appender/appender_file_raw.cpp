@@ -14,7 +14,16 @@
 namespace bq {
     void appender_file_raw::log_impl(const log_entry_handle& handle)
     {
-        appender_file_base::log_impl(handle);
+        appender_file_binary::log_impl(handle);
+        if (is_sync_marker_due()) {
+            appender_sync_marker marker = {};
+            seal_sync_marker(marker);
+            uint32_t marker_item_size = sync_marker_item_size;
+            auto marker_handle = alloc_write_cache(sizeof(marker_item_size) + sizeof(marker));
+            memcpy(marker_handle.data(), &marker_item_size, sizeof(marker_item_size));
+            memcpy(marker_handle.data() + sizeof(marker_item_size), &marker, sizeof(marker));
+            return_write_cache(marker_handle);
+        }
         uint32_t item_size = handle.data_size();
         auto write_handle = alloc_write_cache(sizeof(item_size) + item_size);
         *(decltype(item_size)*)write_handle.data() = item_size;
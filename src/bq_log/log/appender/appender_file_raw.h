@@ -17,7 +17,9 @@ namespace bq {
         friend class appender_decoder_raw;
 
     public:
-        static constexpr uint32_t format_version = 6;
+        static constexpr uint32_t format_version = 8;
+        // Items are [item_size(uint32_t)][log entry], a sync marker is [sync_marker_item_size][appender_sync_marker].
+        static constexpr uint32_t sync_marker_item_size = UINT32_MAX;
 
     protected:
         virtual void log_impl(const log_entry_handle& handle) override;
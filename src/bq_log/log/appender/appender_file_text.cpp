@@ -12,23 +12,52 @@
 #include "bq_log/log/appender/appender_file_text.h"
 #include "bq_log/log/log_imp.h"
 #include "bq_log/global/log_vars.h"
+#include "bq_log/log/appender/file_archiver.h"
 
 namespace bq {
+    appender_file_text::appender_file_text()
+        : compress_rotated_files_(false)
+        , need_archive_left_files_(false)
+    {
+    }
+
+    bool appender_file_text::init_impl(const bq::property_value& config_obj)
+    {
+        set_text_configs(config_obj);
+        need_archive_left_files_ = compress_rotated_files_;
+        return appender_file_base::init_impl(config_obj);
+    }
+
+    bool appender_file_text::reset_impl(const bq::property_value& config_obj)
+    {
+        set_text_configs(config_obj);
+        return appender_file_base::reset_impl(config_obj);
+    }
+
+    void appender_file_text::set_text_configs(const bq::property_value& config_obj)
+    {
+        if (config_obj["compress_rotated_files"].is_bool()) {
+            compress_rotated_files_ = (bool)config_obj["compress_rotated_files"];
+        } else {
+            compress_rotated_files_ = false;
+        }
+    }
 
     void appender_file_text::log_impl(const log_entry_handle& handle)
     {
         appender_file_base::log_impl(handle);
-        auto layout_result = layout_ptr_->do_layout(handle, time_zone_, &parent_log_->get_categories_name());
+        const char* write_data = nullptr;
+        uint32_t formated_len = 0;
+        auto layout_result = do_layout(handle, write_data, formated_len);
         if (layout_result != layout::enum_layout_result::finished) {
             bq::util::log_device_console(log_level::error, "text file layout error, result:%d, format str:%s", (int32_t)layout_result, handle.get_format_string_data());
             return;
         }
-        const char* write_data = layout_ptr_->get_formated_str();
-        size_t data_len = (size_t)layout_ptr_->get_formated_str_len();
+        size_t data_len = (size_t)formated_len;
         auto write_handle = alloc_write_cache(data_len + sizeof('\n'));
         memcpy(write_handle.data(), write_data, data_len);
         write_handle.data()[data_len] = (uint8_t)'\n';
-        layout_ptr_->tidy_memory();
+        release_layout_result();
         return_write_cache(write_handle);
         mark_write_finished();
     }
@@ -42,6 +71,18 @@ namespace bq {
     void appender_file_text::on_file_open(bool is_new_created)
     {
         appender_file_base::on_file_open(is_new_created);
+        if (need_archive_left_files_) {
+            // rotated files of a previous run which were still queued or being compressed when it exited.
+            // only now the file kept being written is known.
+            need_archive_left_files_ = false;
+            const bq::string ext_name = get_file_ext_name();
+            const bq::string current_file_name = bq::file_manager::get_file_name_from_path(get_file_handle().abs_file_path());
+            for (const bq::string& path : get_all_own_file_paths()) {
+                if (path.end_with(ext_name) && bq::file_manager::get_file_name_from_path(path) != current_file_name) {
+                    file_archiver::instance().add_task(path);
+                }
+            }
+        }
     }
 
     bq::string appender_file_text::get_file_ext_name()
@@ -49,6 +90,20 @@ namespace bq {
         return ".log";
     }
 
+    bq::string appender_file_text::get_archived_file_ext_name()
+    {
+        // always recognized, so archives produced by a previous run are still managed even if compression is turned off now.
+        return get_file_ext_name() + file_archiver::ARCHIVE_EXT_NAME;
+    }
+
+    void appender_file_text::on_file_rotated(const bq::string& prev_file_abs_path)
+    {
+        appender_file_base::on_file_rotated(prev_file_abs_path);
+        if (compress_rotated_files_) {
+            file_archiver::instance().add_task(prev_file_abs_path);
+        }
+    }
+
     bool appender_file_text::on_appender_file_recovery_begin()
     {
         if (!appender_file_base::on_appender_file_recovery_begin()) {
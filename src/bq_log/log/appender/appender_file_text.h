@@ -14,14 +14,28 @@
 
 namespace bq {
     class appender_file_text : public appender_file_base {
+    public:
+        appender_file_text();
+
     protected:
+        virtual bool init_impl(const bq::property_value& config_obj) override;
+        virtual bool reset_impl(const bq::property_value& config_obj) override;
         virtual void log_impl(const log_entry_handle& handle) override;
         virtual bool parse_exist_log_file(parse_file_context& context) override;
         virtual void on_file_open(bool is_new_created) override;
         virtual bq::string get_file_ext_name() override;
+        virtual bq::string get_archived_file_ext_name() override;
+        virtual void on_file_rotated(const bq::string& prev_file_abs_path) override;
         virtual bool on_appender_file_recovery_begin() override;
         virtual void on_appender_file_recovery_end() override;
         virtual void on_log_item_recovery_begin(bq::log_entry_handle& read_handle) override;
         virtual void on_log_item_recovery_end() override;
+
+    private:
+        void set_text_configs(const bq::property_value& config_obj);
+
+    private:
+        bool compress_rotated_files_;
+        bool need_archive_left_files_;
     };
 }
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "bq_log/log/appender/file_archiver.h"
+#include "bq_common/compression/deflate.h"
+#include "bq_log/global/log_vars.h"
+
+namespace bq {
+    static constexpr size_t ARCHIVE_READ_CHUNK_SIZE = 256 * 1024;
+
+    file_archiver::file_archiver()
+        : mutex_(false)
+        , started_(false)
+        , busy_(false)
+    {
+        set_thread_name("BqLogArchiver");
+    }
+
+    file_archiver& file_archiver::instance()
+    {
+        return log_global_vars::get().file_archiver_inst_;
+    }
+
+    void file_archiver::add_task(const bq::string& file_abs_path)
+    {
+        bq::platform::scoped_mutex lock(mutex_);
+        if (tasks_.find(file_abs_path) != tasks_.end()) {
+            return;
+        }
+        tasks_.push_back(file_abs_path);
+        if (!started_) {
+            started_ = true;
+            start();
+        }
+        trigger_.notify_all();
+    }
+
+    bool file_archiver::wait_for_idle(uint64_t timeout_ms)
+    {
+        uint64_t end_epoch = bq::platform::high_performance_epoch_ms() + timeout_ms;
+        while (true) {
+            {
+                bq::platform::scoped_mutex lock(mutex_);
+                if (tasks_.is_empty() && !busy_) {
+                    return true;
+                }
+            }
+            if (bq::platform::high_performance_epoch_ms() >= end_epoch) {
+                return false;
+            }
+            bq::platform::thread::sleep(10);
+        }
+    }
+
+    void file_archiver::shutdown()
+    {
+        mutex_.lock();
+        bool need_join = started_;
+        if (need_join) {
+            cancel();
+            trigger_.notify_all();
+        }
+        mutex_.unlock();
+        if (need_join) {
+            join();
+        }
+    }
+
+    void file_archiver::run()
+    {
+        bq::platform::thread::set_current_thread_background_priority();
+        while (!is_cancelled()) {
+            bq::string task;
+            mutex_.lock();
+            if (tasks_.is_empty()) {
+                trigger_.wait_for(mutex_, 1000);
+            }
+            if (!tasks_.is_empty()) {
+                task = bq::move(tasks_[0]);
+                tasks_.erase(tasks_.begin());
+                busy_ = true;
+            }
+            mutex_.unlock();
+            if (!task.is_empty()) {
+                // a file may be queued again by a new appender while it is being compressed, it's gone after that.
+                if (bq::file_manager::is_file(task) && !compress_file(task) && !is_cancelled()) {
+                    bq::util::log_device_console(bq::log_level::warning, "file_archiver failed to compress file:%s", task.c_str());
+                }
+                mutex_.lock();
+                busy_ = false;
+                mutex_.unlock();
+            }
+        }
+    }
+
+    bool file_archiver::compress_file(const bq::string& file_abs_path)
+    {
+        auto& fm = bq::file_manager::instance();
+        auto src_file = fm.open_file(file_abs_path, file_open_mode_enum::read);
+        if (!src_file) {
+            return false;
+        }
+        const bq::string archive_path = file_abs_path + ARCHIVE_EXT_NAME;
+        auto dest_file = fm.open_file(archive_path, file_open_mode_enum::auto_create | file_open_mode_enum::write | file_open_mode_enum::exclusive);
+        if (!dest_file) {
+            fm.close_file(src_file);
+            return false;
+        }
+        fm.truncate_file(dest_file, 0);
+        fm.seek(src_file, file_manager::seek_option::begin, 0);
+
+        bq::deflate_encoder encoder(bq::deflate_encoder::container::gzip);
+        bq::array<uint8_t> read_buffer;
+        read_buffer.fill_uninitialized(ARCHIVE_READ_CHUNK_SIZE);
+        bool success = true;
+        auto drain_output = [&]() {
+            auto& output = encoder.output();
+            if (output.size() > 0) {
+                success &= (fm.write_file(dest_file, output.begin(), output.size()) == output.size());
+                output.clear();
+            }
+        };
+        while (success) {
+            if (is_cancelled()) {
+                success = false;
+                break;
+            }
+            size_t read_size = fm.read_file(src_file, read_buffer.begin(), read_buffer.size());
+            if (read_size == 0) {
+                break;
+            }
+            encoder.update(read_buffer.begin(), read_size);
+            drain_output();
+        }
+        if (success) {
+            encoder.finish();
+            drain_output();
+        }
+        if (success) {
+            success = fm.flush_file(dest_file);
+        }
+        fm.close_file(dest_file);
+        fm.close_file(src_file);
+        if (success) {
+            bq::file_manager::remove_file_or_dir(file_abs_path);
+        } else {
+            bq::file_manager::remove_file_or_dir(archive_path);
+        }
+        return success;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+//
+//  file_archiver.h
+//  Low priority background thread which compresses rotated log files to gzip,
+//  so that the logging worker thread never pays for compression.
+//
+#include "bq_common/bq_common.h"
+
+namespace bq {
+    class file_archiver : public bq::platform::thread {
+    public:
+        static constexpr const char* ARCHIVE_EXT_NAME = ".gz";
+
+    public:
+        file_archiver();
+
+        static file_archiver& instance();
+
+        /// <summary>
+        /// Queue a closed file, it will be compressed to "<file_abs_path>.gz" and removed after success.
+        /// The thread is started lazily by the first task.
+        /// </summary>
+        void add_task(const bq::string& file_abs_path);
+
+        /// <summary>
+        /// Block until all queued tasks are processed or timeout.
+        /// </summary>
+        /// <returns>true if idle</returns>
+        bool wait_for_idle(uint64_t timeout_ms);
+
+        /// Stop the thread, the file in progress and the queued ones are kept uncompressed.
+        /// They are queued again by appender_file_text when its appender is initialized next time.
+        void shutdown();
+
+    protected:
+        virtual void run() override;
+
+    private:
+        bool compress_file(const bq::string& file_abs_path);
+
+    private:
+        bq::platform::mutex mutex_;
+        bq::platform::condition_variable trigger_;
+        bq::array<bq::string> tasks_;
+        bool started_;
+        bool busy_;
+    };
+}
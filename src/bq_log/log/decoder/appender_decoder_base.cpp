@@ -16,10 +16,29 @@
 static constexpr size_t DECODER_CACHE_READ_DEFAULT_SIZE = 32 * 1024;
 
 namespace bq {
+    appender_decoder_base::~appender_decoder_base()
+    {
+        memory_map::release_memory_map(file_map_);
+    }
+
     appender_decode_result appender_decoder_base::init(const file_handle& file, const string& private_key_str)
     {
+        // init is called again when following a rotated log file
+        memory_map::release_memory_map(file_map_);
+        category_names_.clear();
+        cur_read_seg_.xor_key_blob.clear();
+        current_file_cursor_ = SIZE_MAX;
+        clear_read_cache();
+        read_end_pos_ = UINT64_MAX;
+        has_pending_entry_ = false;
+        private_key_str_ = private_key_str;
         file_ = file;
         current_file_size_ = file_manager::instance().get_file_size(file_);
+        // address space of 32 bit processes is too small to map large log files, file io is used instead.
+        if (sizeof(void*) >= 8 && memory_map::is_platform_support() && current_file_size_ > 0) {
+            file_map_ = memory_map::create_memory_map_read_only(file_, 0, current_file_size_);
+            memory_map::advise_sequential(file_map_);
+        }
         seek_read_file_absolute(0);
         uint32_t format_version = get_binary_format_version();
 
@@ -32,6 +51,8 @@ namespace bq {
             util::log_device_console(log_level::error, "decode log file failed, unsupported binary log format version, tools version:%d, log file version:%d", format_version, file_head_.version);
             return appender_decode_result::failed_decode_error;
         }
+        block_compressed_ = (file_head_.block_compression != appender_file_binary::appender_block_compression::none);
+        block_damaged_ = false;
         if (!private_key_str.trim().is_empty()) {
             if (!rsa::parse_private_key_pem(private_key_str.trim(), private_key_)) {
                 util::log_device_console(log_level::error, "decode log file failed, invalid private key");
@@ -49,6 +70,10 @@ namespace bq {
             return resut;
         }
         auto read_handle = read_with_cache(sizeof(payload_metadata_));
+        if (read_handle.len() < sizeof(payload_metadata_)) {
+            util::log_device_console(log_level::error, "decode log file failed, read payload metadata failed");
+            return appender_decode_result::failed_decode_error;
+        }
         memcpy(&payload_metadata_, read_handle.data(), sizeof(payload_metadata_));
         if (payload_metadata_.magic_number[0] != 2 || payload_metadata_.magic_number[1] != 2 || payload_metadata_.magic_number[2] != 7) {
             if (cur_read_seg_.xor_key_blob.is_empty()) {
@@ -82,40 +107,357 @@ namespace bq {
             }
             category_names_.push_back(move(name));
         }
+        first_restart_point_.seg_start_pos = cur_read_seg_.start_pos;
+        first_restart_point_.seg_end_pos = cur_read_seg_.end_pos;
+        first_restart_point_.seg_type = cur_read_seg_.seg_type;
+        first_restart_point_.enc_type = cur_read_seg_.enc_type;
+        first_restart_point_.pos = get_read_position();
+        first_restart_point_.block_offset = is_block_loaded() ? static_cast<uint32_t>(block_cursor_) : 0U;
+        refresh_filter_category_mask();
         return init_private();
     }
 
     appender_decode_result appender_decoder_base::decode()
     {
+        if (has_pending_entry_) {
+            // found by seek_to_time, decoded_text_ is kept
+            has_pending_entry_ = false;
+            return appender_decode_result::success;
+        }
         bool lose_data = false;
+        uint64_t skipped_bytes_before = skipped_bytes_;
         appender_decode_result result;
         do {
+            mark_item_start();
             result = decode_private();
-            if (appender_decode_result::success == result
-                || appender_decode_result::eof == result) {
+            if (appender_decode_result::success == result) {
+                if (last_entry_skipped_) {
+                    continue;
+                }
+                break;
+            }
+            if (follow_ && (appender_decode_result::eof == result || short_read_since_item_start_)) {
+                // the appender has not finished writing it yet, it is read again when the file grows.
+                restore_read_position(item_start_);
+                result = appender_decode_result::eof;
+                break;
+            }
+            if (appender_decode_result::eof == result) {
                 break;
             }
             lose_data = true;
-            if (appender_decode_result::success != read_to_next_segment()) {
+            if (appender_decode_result::success != resync_after_error()) {
                 break;
             }
         } while (true);
+        lose_data |= block_damaged_;
+        block_damaged_ = false;
         if (lose_data) {
             bq::string error_tips;
             error_tips += "/*********************************************************************/\n";
             error_tips += "/*       WARNING: Some log data may be lost or corrupted here        */\n";
+            char skipped_bytes_text[64];
+            snprintf(skipped_bytes_text, sizeof(skipped_bytes_text), "damaged data skipped: %" PRIu64 " bytes", skipped_bytes_ - skipped_bytes_before);
+            char skipped_tips[128];
+            snprintf(skipped_tips, sizeof(skipped_tips), "/*       %-60s*/\n", skipped_bytes_text);
+            error_tips += skipped_tips;
             error_tips += "/*********************************************************************/\n";
             decoded_text_.insert_batch(decoded_text_.begin(), error_tips.begin(), error_tips.size());
         }
         return result;
     }
 
+    appender_decode_result appender_decoder_base::seek_to_time(uint64_t epoch_ms)
+    {
+        has_pending_entry_ = false;
+        bq::array<read_position> points;
+        appender_decode_result result = collect_restart_points(points);
+        if (result != appender_decode_result::success) {
+            return result;
+        }
+        // find the last restart point whose first entry is earlier than epoch_ms,
+        // entries of the same millisecond may end the segment before.
+        size_t found_idx = 0;
+        size_t low = 1;
+        size_t high = points.size();
+        skip_before_epoch_ = UINT64_MAX;
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            reset_read_position(points[mid]);
+            result = decode_private();
+            if (result == appender_decode_result::success && last_entry_epoch_ < epoch_ms) {
+                found_idx = mid;
+                low = mid + 1;
+            } else if (result == appender_decode_result::success || result == appender_decode_result::eof) {
+                high = mid;
+            } else {
+                skip_before_epoch_ = 0;
+                return result;
+            }
+        }
+
+        reset_read_position(points[found_idx]);
+        skip_before_epoch_ = epoch_ms;
+        do {
+            result = decode_private();
+        } while (result == appender_decode_result::success && last_entry_skipped_);
+        skip_before_epoch_ = 0;
+        has_pending_entry_ = (result == appender_decode_result::success);
+        return result;
+    }
+
+    appender_decode_result appender_decoder_base::decode_follow(uint64_t timeout_ms)
+    {
+        uint64_t start_epoch_ms = bq::platform::high_performance_epoch_ms();
+        if (!follow_watching_) {
+            follow_watching_ = true;
+            follow_watcher_.watch(file_.abs_file_path());
+        }
+        follow_ = true;
+        appender_decode_result result;
+        while (true) {
+            result = decode();
+            if (result != appender_decode_result::eof) {
+                break;
+            }
+            // everything written so far is decoded
+            if (refresh_live_end()) {
+                continue;
+            }
+            result = open_next_rotated_file();
+            if (result == appender_decode_result::success) {
+                continue;
+            }
+            if (result != appender_decode_result::eof) {
+                break;
+            }
+            uint64_t elapsed_ms = bq::platform::high_performance_epoch_ms() - start_epoch_ms;
+            if (elapsed_ms >= timeout_ms) {
+                break;
+            }
+            follow_watcher_.wait(timeout_ms - elapsed_ms);
+        }
+        follow_ = false;
+        return result;
+    }
+
+    appender_decode_result appender_decoder_base::decode_batch(char* text_buffer, uint32_t text_buffer_size, uint32_t* out_text_offsets, log_decode_entry_info* out_entries, uint32_t max_entry_count, uint32_t& out_entry_count)
+    {
+        out_entry_count = 0;
+        out_text_offsets[0] = 0;
+        uint32_t text_size = 0;
+        while (out_entry_count < max_entry_count) {
+            appender_decode_result result = decode();
+            if (result != appender_decode_result::success) {
+                return out_entry_count > 0 ? appender_decode_result::success : result;
+            }
+            if (decoded_text_.size() > static_cast<size_t>(text_buffer_size - text_size)) {
+                // returned by the next decode()
+                has_pending_entry_ = true;
+                if (out_entry_count == 0) {
+                    out_text_offsets[1] = static_cast<uint32_t>(decoded_text_.size());
+                }
+                break;
+            }
+            if (!decoded_text_.is_empty()) {
+                memcpy(text_buffer + text_size, decoded_text_.c_str(), decoded_text_.size());
+            }
+            text_size += static_cast<uint32_t>(decoded_text_.size());
+            if (out_entries) {
+                out_entries[out_entry_count] = last_entry_info_;
+            }
+            out_text_offsets[++out_entry_count] = text_size;
+        }
+        return appender_decode_result::success;
+    }
+
+    bool appender_decoder_base::refresh_live_end()
+    {
+        // the size must be read before the segment head: the appender links a new segment to the head of the
+        // previous one before writing it, so data below the size can't belong to a segment not linked yet.
+        size_t new_file_size = file_manager::instance().get_file_size(file_);
+        bool changed = new_file_size > current_file_size_;
+        current_file_size_ = new_file_size;
+        if (cur_read_seg_.end_pos == UINT64_MAX) {
+            bq::appender_file_binary::appender_file_segment_head seg_head;
+            auto read_size = file_manager::instance().read_file(file_, &seg_head, sizeof(seg_head), file_manager::seek_option::begin, static_cast<int64_t>(cur_read_seg_.start_pos));
+            if (read_size == sizeof(seg_head) && seg_head.next_seg_pos != UINT64_MAX) {
+                cur_read_seg_.end_pos = seg_head.next_seg_pos;
+                changed = true;
+            }
+            if (!file_map_.has_been_mapped()) {
+                // restore the file position used by read_with_cache
+                file_manager::instance().seek(file_, file_manager::seek_option::begin, static_cast<int64_t>(current_file_cursor_));
+            }
+        }
+        return changed;
+    }
+
+    appender_decode_result appender_decoder_base::open_next_rotated_file()
+    {
+        bq::string next_path = find_next_rotated_file(file_.abs_file_path());
+        if (next_path.is_empty()) {
+            return appender_decode_result::eof;
+        }
+        // the appender closes a file before creating the next one, the current file is complete once this finds nothing new.
+        if (refresh_live_end()) {
+            return appender_decode_result::success;
+        }
+        // the next file is tried with a separate decoder first, its header may not be completely written yet.
+        bq::unique_ptr<appender_decoder_base> probe_decoder;
+        if (appender_decoder_manager::open_decoder(next_path, private_key_str_, probe_decoder) != appender_decode_result::success
+            || probe_decoder->file_head_.format != file_head_.format) {
+            return appender_decode_result::eof;
+        }
+        appender_decode_result result = init(probe_decoder->file_, private_key_str_);
+        if (result != appender_decode_result::success) {
+            return result;
+        }
+        follow_watcher_.watch(file_.abs_file_path());
+        return appender_decode_result::success;
+    }
+
+    // rotated files are named "<name>_<index>.<ext>" or "<name>_<yyyymmdd>_<index>.<ext>"
+    static bool parse_rotated_file_name(const bq::string& file_name, bq::string& out_name, bq::string& out_ext, uint64_t& out_order)
+    {
+        size_t dot_pos = file_name.find_last(".");
+        if (dot_pos == bq::string::npos) {
+            return false;
+        }
+        out_ext = file_name.substr(dot_pos);
+        bq::string stem = file_name.substr(0, dot_pos);
+        size_t index_pos = stem.find_last("_");
+        if (index_pos == bq::string::npos || index_pos + 1 >= stem.size()) {
+            return false;
+        }
+        uint64_t index = 0;
+        for (size_t i = index_pos + 1; i < stem.size(); ++i) {
+            if (stem[i] < '0' || stem[i] > '9') {
+                return false;
+            }
+            index = index * 10 + static_cast<uint64_t>(stem[i] - '0');
+        }
+        out_name = stem.substr(0, index_pos);
+        uint64_t date = 0;
+        size_t date_pos = out_name.find_last("_");
+        if (date_pos != bq::string::npos && out_name.size() - date_pos == 9) {
+            bool is_date = true;
+            for (size_t i = date_pos + 1; i < out_name.size(); ++i) {
+                is_date &= (out_name[i] >= '0' && out_name[i] <= '9');
+                date = date * 10 + static_cast<uint64_t>(out_name[i] - '0');
+            }
+            if (is_date) {
+                out_name = out_name.substr(0, date_pos);
+            } else {
+                date = 0;
+            }
+        }
+        out_order = (date << 32) | (index & 0xFFFFFFFF);
+        return true;
+    }
+
+    bq::string appender_decoder_base::find_next_rotated_file(const bq::string& file_abs_path)
+    {
+        bq::string name;
+        bq::string ext;
+        uint64_t order;
+        if (!parse_rotated_file_name(bq::file_manager::get_file_name_from_path(file_abs_path), name, ext, order)) {
+            return bq::string();
+        }
+        bq::string dir_path = bq::file_manager::get_directory_from_path(file_abs_path);
+        bq::string next_file_name;
+        uint64_t next_order = UINT64_MAX;
+        for (const bq::string& sibling_name : bq::file_manager::get_sub_dirs_and_files_name(dir_path)) {
+            bq::string sibling_base_name;
+            bq::string sibling_ext;
+            uint64_t sibling_order;
+            if (parse_rotated_file_name(sibling_name, sibling_base_name, sibling_ext, sibling_order)
+                && sibling_base_name == name && sibling_ext == ext && sibling_order > order && sibling_order < next_order) {
+                next_order = sibling_order;
+                next_file_name = sibling_name;
+            }
+        }
+        if (next_file_name.is_empty()) {
+            return next_file_name;
+        }
+        return bq::file_manager::combine_path(dir_path, next_file_name);
+    }
+
+    void appender_decoder_base::set_filter(const log_decode_filter& filter)
+    {
+        filter_level_mask_ = filter.level_mask;
+        filter_category_prefixes_ = (filter.category_prefixes ? filter.category_prefixes : "");
+        refresh_filter_category_mask();
+        filter_thread_id_ = filter.thread_id;
+        filter_begin_epoch_ = filter.begin_epoch_ms;
+        filter_end_epoch_ = filter.end_epoch_ms ? filter.end_epoch_ms : UINT64_MAX;
+        filter_format_hashes_.clear();
+        if (filter.format_hashes) {
+            for (uint32_t i = 0; i < filter.format_hash_count; ++i) {
+                filter_format_hashes_.push_back(filter.format_hashes[i]);
+            }
+        }
+        filter_enabled_ = filter_level_mask_ != 0 || !filter_category_mask_.is_empty() || filter_thread_id_ != 0
+            || filter_begin_epoch_ != 0 || filter_end_epoch_ != UINT64_MAX || !filter_format_hashes_.is_empty();
+    }
+
+    void appender_decoder_base::refresh_filter_category_mask()
+    {
+        filter_category_mask_.clear();
+        if (filter_category_prefixes_.is_empty()) {
+            return;
+        }
+        bq::array<bq::string> prefixes = filter_category_prefixes_.split(",");
+        for (const bq::string& category_name : category_names_) {
+            uint8_t mask = 0;
+            for (const bq::string& prefix : prefixes) {
+                bq::string trimmed_prefix = prefix.trim();
+                if (trimmed_prefix == "*" || category_name.begin_with(trimmed_prefix)) {
+                    mask = 1;
+                    break;
+                }
+            }
+            filter_category_mask_.push_back(mask);
+        }
+    }
+
+    bool appender_decoder_base::filter_template(bq::log_level level, uint32_t category_idx, uint64_t fmt_hash) const
+    {
+        if (filter_level_mask_ != 0 && (filter_level_mask_ & (1U << static_cast<uint32_t>(level))) == 0) {
+            return false;
+        }
+        if (!filter_category_mask_.is_empty() && (category_idx >= filter_category_mask_.size() || filter_category_mask_[category_idx] == 0)) {
+            return false;
+        }
+        if (!filter_format_hashes_.is_empty()) {
+            for (uint64_t hash : filter_format_hashes_) {
+                if (hash == fmt_hash) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        return true;
+    }
+
+    bool appender_decoder_base::filter_thread(uint64_t thread_id) const
+    {
+        return filter_thread_id_ == 0 || filter_thread_id_ == thread_id;
+    }
+
     bool appender_decoder_base::seek_read_file_absolute(size_t pos)
     {
-        if (current_file_cursor_ == pos) {
+        if (get_file_read_position() == static_cast<uint64_t>(pos)) {
+            // current_file_cursor_ alone is not the read position, the cache may still hold data before it
+            return true;
+        }
+        if (file_map_.has_been_mapped()) {
+            // reads take the position from current_file_cursor_
+            clear_read_cache();
+            current_file_cursor_ = pos;
             return true;
         }
-        bool result = file_manager::instance().seek(file_, file_manager::seek_option::begin, (int32_t)pos);
+        bool result = file_manager::instance().seek(file_, file_manager::seek_option::begin, static_cast<int64_t>(pos));
         if (result) {
             clear_read_cache();
             current_file_cursor_ = pos;
@@ -125,8 +467,17 @@ namespace bq {
 
     bool appender_decoder_base::seek_read_file_offset(int32_t offset)
     {
+        if (block_compressed_) {
+            // only inside the last block read
+            int64_t final_block_cursor = static_cast<int64_t>(block_cursor_) + offset;
+            if (final_block_cursor < 0 || final_block_cursor > static_cast<int64_t>(block_data_.size())) {
+                return false;
+            }
+            block_cursor_ = static_cast<size_t>(final_block_cursor);
+            return true;
+        }
         int64_t final_cache_cursor = static_cast<int64_t>(cache_read_cursor_) + offset;
-        if (final_cache_cursor >= 0 && final_cache_cursor <= static_cast<int64_t>(cache_read_.size())) {
+        if (final_cache_cursor >= 0 && final_cache_cursor <= static_cast<int64_t>(cache_size_)) {
             cache_read_cursor_ = static_cast<size_t>(final_cache_cursor);
             return true;
         } else {
@@ -134,6 +485,96 @@ namespace bq {
         }
     }
 
+    uint64_t appender_decoder_base::get_read_position() const
+    {
+        return is_block_loaded() ? block_start_pos_ : get_file_read_position();
+    }
+
+    uint64_t appender_decoder_base::get_file_read_position() const
+    {
+        return static_cast<uint64_t>(current_file_cursor_ - (cache_size_ - cache_read_cursor_));
+    }
+
+    void appender_decoder_base::reset_read_position(const read_position& start, uint64_t end_pos)
+    {
+        cur_read_seg_.start_pos = start.seg_start_pos;
+        cur_read_seg_.end_pos = start.seg_end_pos;
+        cur_read_seg_.seg_type = start.seg_type;
+        cur_read_seg_.enc_type = start.enc_type;
+        read_end_pos_ = end_pos;
+        clear_read_cache();
+        current_file_cursor_ = SIZE_MAX;
+        seek_read_file_absolute(static_cast<size_t>(start.pos));
+        if (start.block_offset > 0 && read_block() == appender_decode_result::success) {
+            block_cursor_ = start.block_offset;
+        }
+        on_restart_point();
+    }
+
+    void appender_decoder_base::mark_item_start()
+    {
+        item_start_.seg_start_pos = cur_read_seg_.start_pos;
+        item_start_.seg_end_pos = cur_read_seg_.end_pos;
+        item_start_.seg_type = cur_read_seg_.seg_type;
+        item_start_.enc_type = cur_read_seg_.enc_type;
+        item_start_.pos = get_read_position();
+        item_start_.block_offset = is_block_loaded() ? static_cast<uint32_t>(block_cursor_) : 0U;
+        short_read_since_item_start_ = false;
+    }
+
+    void appender_decoder_base::restore_read_position(const read_position& position)
+    {
+        cur_read_seg_.start_pos = position.seg_start_pos;
+        cur_read_seg_.end_pos = position.seg_end_pos;
+        cur_read_seg_.seg_type = position.seg_type;
+        cur_read_seg_.enc_type = position.enc_type;
+        clear_read_cache();
+        current_file_cursor_ = SIZE_MAX;
+        seek_read_file_absolute(static_cast<size_t>(position.pos));
+        if (position.block_offset > 0 && read_block() == appender_decode_result::success) {
+            block_cursor_ = position.block_offset;
+        }
+    }
+
+    appender_decode_result appender_decoder_base::collect_restart_points(bq::array<read_position>& out_points)
+    {
+        out_points.clear();
+        out_points.push_back(first_restart_point_);
+        read_position prev_seg = first_restart_point_;
+        while (prev_seg.seg_end_pos != UINT64_MAX) {
+            bq::appender_file_binary::appender_file_segment_head seg_head;
+            auto read_size = file_manager::instance().read_file(file_, &seg_head, sizeof(seg_head), file_manager::seek_option::begin, static_cast<int64_t>(prev_seg.seg_end_pos));
+            if (read_size < sizeof(seg_head)) {
+                break;
+            }
+            if (seg_head.next_seg_pos < prev_seg.seg_end_pos + sizeof(seg_head)) {
+                bq::util::log_device_console(bq::log_level::error, "file format of segment start pos: %" PRIu64 ", invalid segment end pos:%" PRIu64, prev_seg.seg_end_pos, seg_head.next_seg_pos);
+                break;
+            }
+            if (seg_head.seg_type == appender_file_binary::appender_segment_type::normal) {
+                // resume from the end of the previous segment, so the segment head is parsed by read_to_next_segment
+                prev_seg.pos = prev_seg.seg_end_pos;
+                prev_seg.block_offset = 0;
+                out_points.push_back(prev_seg);
+            }
+            prev_seg.seg_start_pos = prev_seg.seg_end_pos;
+            prev_seg.seg_end_pos = seg_head.next_seg_pos;
+            prev_seg.seg_type = seg_head.seg_type;
+            prev_seg.enc_type = seg_head.enc_type;
+        }
+        // the file cursor is moved by reading segment heads
+        current_file_cursor_ = SIZE_MAX;
+        clear_read_cache();
+        return appender_decode_result::success;
+    }
+
+    bool appender_decoder_base::skip_entry(uint64_t epoch_ms, bool matched)
+    {
+        last_entry_epoch_ = epoch_ms;
+        last_entry_skipped_ = !matched || epoch_ms < skip_before_epoch_ || epoch_ms < filter_begin_epoch_ || epoch_ms >= filter_end_epoch_;
+        return last_entry_skipped_;
+    }
+
     size_t appender_decoder_base::get_current_file_size()
     {
         return current_file_size_;
@@ -142,7 +583,71 @@ namespace bq {
     // data() returned by read_with_cache_handle will be invalid after next calling of "read_with_cache"
     appender_decoder_base::read_with_cache_handle appender_decoder_base::read_with_cache(size_t size)
     {
-        auto left_size = cache_read_.size() - cache_read_cursor_;
+        if (!block_compressed_) {
+            return read_file_with_cache(size);
+        }
+        read_with_cache_handle result;
+        if (!is_block_loaded() && read_block() != appender_decode_result::success) {
+            result.data_ = nullptr;
+            result.len_ = 0;
+            return result;
+        }
+        // items never cross blocks, a read beyond the end of the block is damaged data, not data to come.
+        result.data_ = block_data_.begin() + static_cast<ptrdiff_t>(block_cursor_);
+        result.len_ = bq::min_value(size, block_data_.size() - block_cursor_);
+        block_cursor_ += result.len_;
+        return result;
+    }
+
+    appender_decode_result appender_decoder_base::read_block()
+    {
+        while (true) {
+            auto read_handle = read_file_with_cache(sizeof(appender_file_binary::appender_block_head));
+            if (read_handle.len() == 0) {
+                return appender_decode_result::eof;
+            }
+            block_start_pos_ = get_file_read_position() - read_handle.len();
+            appender_file_binary::appender_block_head block_head = {};
+            memcpy(&block_head, read_handle.data(), read_handle.len());
+            bool incomplete = read_handle.len() < sizeof(block_head);
+            bool valid = !incomplete && block_head.raw_size > 0 && block_head.stored_size > 0 && block_head.stored_size <= block_head.raw_size;
+            if (valid) {
+                read_handle = read_file_with_cache(static_cast<size_t>(block_head.stored_size));
+                incomplete = read_handle.len() < static_cast<size_t>(block_head.stored_size);
+                valid = !incomplete && block_head.checksum == util::get_hash(read_handle.data(), read_handle.len());
+            }
+            if (valid) {
+                block_data_.clear();
+                block_data_.fill_uninitialized(static_cast<size_t>(block_head.raw_size));
+                if (block_head.stored_size == block_head.raw_size) {
+                    memcpy(block_data_.begin(), read_handle.data(), block_data_.size());
+                } else {
+                    valid = lz4::decompress(read_handle.data(), read_handle.len(), block_data_.begin(), block_data_.size()) == block_data_.size();
+                }
+            }
+            if (valid) {
+                block_cursor_ = 0;
+                return appender_decode_result::success;
+            }
+            block_data_.clear();
+            block_cursor_ = 0;
+            if (incomplete && follow_) {
+                // still being written
+                return appender_decode_result::eof;
+            }
+            uint64_t readable_end_pos = bq::min_value(cur_read_seg_.end_pos, static_cast<uint64_t>(current_file_size_));
+            util::log_device_console(log_level::warning, "decode log file: damaged block at file offset %" PRIu64 ", the rest of its segment is skipped", block_start_pos_);
+            if (readable_end_pos > block_start_pos_) {
+                skipped_bytes_ += readable_end_pos - block_start_pos_;
+            }
+            block_damaged_ = true;
+            seek_read_file_absolute(static_cast<size_t>(readable_end_pos));
+        }
+    }
+
+    appender_decoder_base::read_with_cache_handle appender_decoder_base::read_file_with_cache(size_t size)
+    {
+        auto left_size = cache_size_ - cache_read_cursor_;
         if (left_size < size) {
             if (left_size == 0) {
                 while (static_cast<uint64_t>(current_file_cursor_) == cur_read_seg_.end_pos) {
@@ -151,15 +656,38 @@ namespace bq {
                         read_with_cache_handle empty_handle;
                         empty_handle.data_ = nullptr;
                         empty_handle.len_ = 0;
+                        short_read_since_item_start_ = true;
                         return empty_handle;
                     }
                 }
             }
-            clear_read_cache();
+            clear_file_read_cache();
             if (left_size != 0) {
                 size_t adjusted_file_cursor = static_cast<size_t>(static_cast<int64_t>(current_file_cursor_) - static_cast<int64_t>(left_size));
                 seek_read_file_absolute(adjusted_file_cursor);
             }
+            // nothing beyond current_file_size_ is read, the segment end of a file being written is only known up to it (see refresh_live_end).
+            uint64_t readable_end_pos = bq::min_value(cur_read_seg_.end_pos, static_cast<uint64_t>(current_file_size_));
+            uint64_t seg_left_size = readable_end_pos > static_cast<uint64_t>(current_file_cursor_) ? readable_end_pos - static_cast<uint64_t>(current_file_cursor_) : 0;
+            if (cur_read_seg_.xor_key_blob.is_empty() && current_file_cursor_ < file_map_.get_mapped_size()
+                && static_cast<uint64_t>(file_map_.get_mapped_size() - current_file_cursor_) >= bq::min_value(static_cast<uint64_t>(size), seg_left_size)) {
+                // zero copy, the rest of the segment inside the mapping is the cache.
+                // data crossing the end of the mapping (the file has grown since) is copied below instead.
+                size_t window_size = file_map_.get_mapped_size() - current_file_cursor_;
+                if (static_cast<uint64_t>(window_size) > seg_left_size) {
+                    window_size = static_cast<size_t>(seg_left_size);
+                }
+                cache_data_ = static_cast<const uint8_t*>(file_map_.get_mapped_data()) + current_file_cursor_;
+                cache_size_ = window_size;
+                cache_read_cursor_ = 0;
+                current_file_cursor_ += window_size;
+                read_with_cache_handle result;
+                result.data_ = cache_data_;
+                result.len_ = bq::min_value(size, cache_size_);
+                cache_read_cursor_ += result.len_;
+                short_read_since_item_start_ |= (result.len_ < size);
+                return result;
+            }
             size_t read_offset = 0;
             if (!cur_read_seg_.xor_key_blob.is_empty()) {
                 size_t file_pos_alignment = current_file_cursor_ % appender_file_base::DEFAULT_BUFFER_ALIGNMENT;
@@ -169,17 +697,17 @@ namespace bq {
             cache_read_.clear();
             cache_read_.fill_uninitialized(total_size);
             auto expected_read_size = total_size - read_offset;
-            uint64_t seg_left_size = cur_read_seg_.end_pos - static_cast<uint64_t>(current_file_cursor_);
             if (static_cast<uint64_t>(expected_read_size) > seg_left_size) {
                 expected_read_size = static_cast<size_t>(seg_left_size);
             }
-            auto read_size = file_manager::instance().read_file(file_, cache_read_.begin() + static_cast<ptrdiff_t>(read_offset), expected_read_size);
-            current_file_cursor_ += read_size;
+            auto read_size = read_from_file_directly(cache_read_.begin() + static_cast<ptrdiff_t>(read_offset), expected_read_size);
             cache_read_cursor_ = read_offset;
 
             if (read_size < total_size - read_offset) {
                 cache_read_.erase(cache_read_.begin() + static_cast<ptrdiff_t>(read_offset + read_size), total_size - read_offset - read_size);
             }
+            cache_data_ = cache_read_.begin();
+            cache_size_ = cache_read_.size();
 
             if (!cur_read_seg_.xor_key_blob.is_empty() && read_size > 0) {
                 size_t file_offset_start = current_file_cursor_ - read_size;
@@ -192,22 +720,47 @@ namespace bq {
             }
         }
         read_with_cache_handle result;
-        result.data_ = cache_read_.begin() + static_cast<ptrdiff_t>(cache_read_cursor_);
-        result.len_ = bq::min_value(size, cache_read_.size() - cache_read_cursor_);
+        result.data_ = cache_data_ + cache_read_cursor_;
+        result.len_ = bq::min_value(size, cache_size_ - cache_read_cursor_);
         cache_read_cursor_ += result.len_;
+        short_read_since_item_start_ |= (result.len_ < size);
         return result;
     }
 
     size_t appender_decoder_base::read_from_file_directly(void* dst, size_t size)
     {
-        auto read_size = file_manager::instance().read_file(file_, dst, size);
-        current_file_cursor_ += read_size;
+        if (!file_map_.has_been_mapped()) {
+            auto read_size = file_manager::instance().read_file(file_, dst, size);
+            current_file_cursor_ += read_size;
+            return read_size;
+        }
+        size_t read_size = 0;
+        if (current_file_cursor_ < file_map_.get_mapped_size()) {
+            read_size = bq::min_value(size, file_map_.get_mapped_size() - current_file_cursor_);
+            memcpy(dst, static_cast<const uint8_t*>(file_map_.get_mapped_data()) + current_file_cursor_, read_size);
+            current_file_cursor_ += read_size;
+        }
+        if (read_size < size) {
+            // the file has grown since it was mapped
+            auto file_read_size = file_manager::instance().read_file(file_, static_cast<uint8_t*>(dst) + read_size, size - read_size, file_manager::seek_option::begin, static_cast<int64_t>(current_file_cursor_));
+            current_file_cursor_ += file_read_size;
+            read_size += file_read_size;
+        }
         return read_size;
     }
 
     void appender_decoder_base::clear_read_cache()
+    {
+        clear_file_read_cache();
+        block_data_.clear();
+        block_cursor_ = 0;
+    }
+
+    void appender_decoder_base::clear_file_read_cache()
     {
         cache_read_cursor_ = 0;
+        cache_data_ = nullptr;
+        cache_size_ = 0;
         cache_read_.clear();
         if (cache_read_.capacity() > DECODER_CACHE_READ_DEFAULT_SIZE) {
             cache_read_.shrink();
@@ -216,6 +769,15 @@ namespace bq {
 
     appender_decode_result appender_decoder_base::do_decode_by_log_entry_handle(const log_entry_handle& item)
     {
+        const auto& head = item.get_log_head();
+        last_entry_info_.epoch_ms = head.timestamp_epoch;
+        memcpy(&last_entry_info_.thread_id, &head.log_thread_id, sizeof(last_entry_info_.thread_id));
+        last_entry_info_.category_idx = head.category_idx;
+        last_entry_info_.level = head.level;
+        if (output_format_ != log_decode_output_format::text) {
+            exporter_.do_export(item, output_format_, head.format_hash, category_names_, decoded_text_);
+            return appender_decode_result::success;
+        }
         time_zone time_zone_tmp(payload_metadata_.use_local_time, payload_metadata_.gmt_offset_hours, payload_metadata_.gmt_offset_minutes, payload_metadata_.time_zone_diff_to_gmt_ms, payload_metadata_.time_zone_str);
         auto layout_result = layout_.do_layout(item, time_zone_tmp, &category_names_);
         if (layout_result != layout::enum_layout_result::finished) {
@@ -229,10 +791,85 @@ namespace bq {
         return appender_decode_result::success;
     }
 
+    appender_decode_result appender_decoder_base::resync_after_error()
+    {
+        if (block_compressed_) {
+            return resync_in_blocks();
+        }
+        constexpr size_t marker_size = sizeof(appender_file_binary::appender_sync_marker);
+        constexpr size_t scan_window_size = 4096;
+        restore_read_position(item_start_);
+        seek_read_file_offset(1);
+        uint64_t readable_end_pos = bq::min_value(cur_read_seg_.end_pos, static_cast<uint64_t>(current_file_size_));
+        while (get_read_position() + marker_size <= readable_end_pos) {
+            size_t window_size = static_cast<size_t>(bq::min_value(static_cast<uint64_t>(scan_window_size), readable_end_pos - get_read_position()));
+            // decrypted data if the segment is encrypted
+            auto read_handle = read_with_cache(window_size);
+            if (read_handle.len() < marker_size) {
+                break;
+            }
+            for (size_t i = 0; i + marker_size <= read_handle.len(); ++i) {
+                if (read_handle.data()[i] != appender_file_binary::SYNC_MARKER_MAGIC[0] || !appender_file_binary::verify_sync_marker(read_handle.data() + i)) {
+                    continue;
+                }
+                appender_file_binary::appender_sync_marker marker;
+                memcpy(&marker, read_handle.data() + i, marker_size);
+                seek_read_file_offset(-static_cast<int32_t>(read_handle.len() - i - marker_size));
+                skipped_bytes_ += get_read_position() - marker_size - item_start_.pos;
+                on_sync_marker(marker);
+                return appender_decode_result::success;
+            }
+            // a marker crossing the end of the window is found by the next one
+            seek_read_file_offset(-static_cast<int32_t>(marker_size - 1));
+        }
+        if (readable_end_pos > item_start_.pos) {
+            skipped_bytes_ += readable_end_pos - item_start_.pos;
+        }
+        // the tail of the segment left in the cache must not be read as the start of the next one
+        clear_read_cache();
+        return read_to_next_segment();
+    }
+
+    appender_decode_result appender_decoder_base::resync_in_blocks()
+    {
+        // same as resync_after_error, but the decompressed data of the blocks of the segment is scanned,
+        // skipped bytes are counted in it.
+        constexpr size_t marker_size = sizeof(appender_file_binary::appender_sync_marker);
+        constexpr size_t scan_window_size = 4096;
+        restore_read_position(item_start_);
+        uint64_t scanned_size = seek_read_file_offset(1) ? 1 : 0;
+        while (is_block_loaded() || get_file_read_position() < bq::min_value(cur_read_seg_.end_pos, static_cast<uint64_t>(current_file_size_))) {
+            auto read_handle = read_with_cache(scan_window_size);
+            if (read_handle.len() == 0) {
+                break;
+            }
+            for (size_t i = 0; i + marker_size <= read_handle.len(); ++i) {
+                if (read_handle.data()[i] != appender_file_binary::SYNC_MARKER_MAGIC[0] || !appender_file_binary::verify_sync_marker(read_handle.data() + i)) {
+                    continue;
+                }
+                appender_file_binary::appender_sync_marker marker;
+                memcpy(&marker, read_handle.data() + i, marker_size);
+                seek_read_file_offset(-static_cast<int32_t>(read_handle.len() - i - marker_size));
+                skipped_bytes_ += scanned_size + i;
+                on_sync_marker(marker);
+                return appender_decode_result::success;
+            }
+            scanned_size += read_handle.len();
+            // markers never cross blocks, but they may cross the end of the window
+            if (is_block_loaded() && read_handle.len() >= marker_size) {
+                seek_read_file_offset(-static_cast<int32_t>(marker_size - 1));
+                scanned_size -= marker_size - 1;
+            }
+        }
+        skipped_bytes_ += scanned_size;
+        clear_read_cache();
+        return read_to_next_segment();
+    }
+
     appender_decode_result appender_decoder_base::read_to_next_segment()
     {
         auto new_seg_start_pos = cur_read_seg_.end_pos;
-        if (new_seg_start_pos == UINT64_MAX) {
+        if (new_seg_start_pos == UINT64_MAX || new_seg_start_pos >= read_end_pos_) {
             return appender_decode_result::eof;
         }
         if (!seek_read_file_absolute(static_cast<size_t>(new_seg_start_pos))) {
@@ -283,6 +920,9 @@ namespace bq {
         cur_read_seg_.start_pos = new_seg_start_pos;
         cur_read_seg_.end_pos = seg_head.next_seg_pos;
         cur_read_seg_.seg_type = seg_head.seg_type;
+        if (cur_read_seg_.seg_type == appender_file_binary::appender_segment_type::normal) {
+            on_restart_point();
+        }
 
         bool is_last_seg_recover = (last_seg_type == appender_file_binary::appender_segment_type::recovery_by_appender
             || last_seg_type == appender_file_binary::appender_segment_type::recovery_by_log_buffer);
@@ -13,16 +13,21 @@
 #include "bq_common/bq_common.h"
 #include "bq_log/misc/bq_log_def.h"
 #include "bq_log/log/layout.h"
+#include "bq_log/log/decoder/log_entry_exporter.h"
+#include "bq_log/log/log_template_stats.h"
 #include "bq_log/log/appender/appender_file_binary.h"
+#include "bq_common/platform/io/file_watcher.h"
 
 namespace bq {
     class appender_decoder_base {
+        friend class appender_decoder_parallel;
+
     protected:
         struct read_with_cache_handle {
             friend class appender_decoder_base;
 
         private:
-            uint8_t* data_;
+            const uint8_t* data_;
             size_t len_;
 
         public:
@@ -45,18 +50,95 @@ namespace bq {
             bq::array<uint8_t, bq::aligned_allocator<uint8_t, appender_file_base::DEFAULT_BUFFER_ALIGNMENT>> xor_key_blob;
         };
 
+        // A position to start decoding from, pos lies inside the segment (or at its end).
+        // In block compressed files pos is the start of a block and block_offset the offset in its decompressed data.
+        struct read_position {
+            uint64_t seg_start_pos;
+            uint64_t seg_end_pos;
+            appender_file_binary::appender_segment_type seg_type;
+            appender_file_binary::appender_encryption_type enc_type;
+            uint64_t pos;
+            uint32_t block_offset;
+        };
+
     public:
-        virtual ~appender_decoder_base() { }
+        virtual ~appender_decoder_base();
 
         appender_decode_result init(const bq::file_handle& file, const bq::string& private_key_str);
 
         appender_decode_result decode();
 
+        /// <summary>
+        /// Move to the first log entry whose epoch is not earlier than epoch_ms, it is returned by the next call of decode().
+        /// The nearest restart point before it is found by binary search over the segment chain,
+        /// so log entries are expected to be written in time order.
+        /// </summary>
+        /// <param name="epoch_ms">epoch in milliseconds</param>
+        /// <returns>success if such an entry is found, eof if there is none</returns>
+        appender_decode_result seek_to_time(uint64_t epoch_ms);
+
+        /// <summary>
+        /// Same as decode(), but at the end of the file it waits up to timeout_ms for the file to grow.
+        /// New segments of the file are followed, and so is rotation to the next indexed file
+        /// ("name_1.ext" to "name_2.ext") once the current one gets no more data.
+        /// A log entry being written is never returned partially, it is decoded when it is complete.
+        /// </summary>
+        /// <param name="timeout_ms">how long to wait for new log entries</param>
+        /// <returns>success if a log entry is decoded, eof on timeout, otherwise the error</returns>
+        appender_decode_result decode_follow(uint64_t timeout_ms);
+
+        /// <summary>
+        /// Decode up to max_entry_count log entries into text_buffer. The text of entry i is
+        /// text_buffer[out_text_offsets[i], out_text_offsets[i + 1]), so out_text_offsets needs max_entry_count + 1 elements.
+        /// An entry not fitting into text_buffer is returned first by the next call. If not even the first one fits,
+        /// out_entry_count is 0 and out_text_offsets[1] is the text_buffer_size it needs.
+        /// </summary>
+        /// <param name="out_entries">optional, receives the fields of each entry</param>
+        /// <returns>success if any entry is decoded or the buffer is too small, otherwise the result of decode()</returns>
+        appender_decode_result decode_batch(char* text_buffer, uint32_t text_buffer_size, uint32_t* out_text_offsets, log_decode_entry_info* out_entries, uint32_t max_entry_count, uint32_t& out_entry_count);
+
+        /// <summary>
+        /// Only log entries matching filter are returned by decode() from now on,
+        /// the others are parsed but never formatted. Must be called after init().
+        /// </summary>
+        void set_filter(const log_decode_filter& filter);
+
+        /// <summary>
+        /// What decode() produces for each log entry from now on, formatted text by default.
+        /// The structured formats are written by log_entry_exporter.
+        /// </summary>
+        void set_output_format(log_decode_output_format format) { output_format_ = format; }
+
+        /// <summary>
+        /// Count the log entries matching the filter into stats instead of formatting them, nullptr goes back to decoding.
+        /// While it is set, decode() only returns at the end of the file or on error.
+        /// The stats is not owned and must stay alive until it is unset.
+        /// </summary>
+        void set_template_stats(log_template_stats* stats) { template_stats_ = stats; }
+
+        // category names of the log file, valid after init()
+        const bq::array<bq::string>& get_category_names() const
+        {
+            return category_names_;
+        }
+
         const bq::string& get_decoded_log_text() const
         {
             return decoded_text_;
         }
 
+        // epoch in milliseconds of the log entry returned by the last successful decode()
+        uint64_t get_decoded_log_epoch() const
+        {
+            return last_entry_epoch_;
+        }
+
+        // Bytes of damaged data decode() has skipped so far, including log entries whose templates were lost in it.
+        uint64_t get_skipped_bytes() const
+        {
+            return skipped_bytes_;
+        }
+
     protected:
         virtual appender_decode_result init_private() = 0;
 
@@ -64,24 +146,111 @@ namespace bq {
 
         virtual uint32_t get_binary_format_version() const = 0;
 
+        // Called when decoding reaches a restart point, all state carried from earlier items must be dropped.
+        virtual void on_restart_point() { }
+
+        // Called with a sync marker found after damaged data, decoding resumes right behind it.
+        virtual void on_sync_marker(const appender_file_binary::appender_sync_marker& marker) { (void)marker; }
+
+        // File offset of the next item to be decoded, or of the block holding it in block compressed files.
+        uint64_t get_read_position() const;
+
+        // Continue decoding at a restart point with the read cache dropped, no segment at or after end_pos is read.
+        void reset_read_position(const read_position& start, uint64_t end_pos = UINT64_MAX);
+
+        // Restart points of the file in file order, the first one is the beginning of the log items.
+        appender_decode_result collect_restart_points(bq::array<read_position>& out_points);
+
+        // Whether a log entry is only parsed and not formatted, because it lies before the time being sought,
+        // or it doesn't match the filter (matched is the result of filter_template and filter_thread).
+        bool skip_entry(uint64_t epoch_ms, bool matched);
+
+        // Level, category and format string part of the filter, decoders evaluate it once per template when they can.
+        bool filter_template(bq::log_level level, uint32_t category_idx, uint64_t fmt_hash) const;
+
+        bool filter_thread(uint64_t thread_id) const;
+
+        bool is_filter_enabled() const { return filter_enabled_; }
+
+        // Not null in stats mode, see set_template_stats.
+        log_template_stats* get_template_stats() const { return template_stats_; }
+
+        // In stats mode decoders add the entries not skipped by skip_entry() to the stats
+        // and return this instead of formatting them.
+        appender_decode_result finish_counted_entry()
+        {
+            last_entry_skipped_ = true;
+            return appender_decode_result::success;
+        }
+
+        // For items decoded by decode_private() which are not log entries, such as sync markers.
+        appender_decode_result finish_non_entry_item()
+        {
+            last_entry_skipped_ = true;
+            return appender_decode_result::success;
+        }
+
+        void add_skipped_bytes(uint64_t size) { skipped_bytes_ += size; }
+
+        // Computing the format string hash can be skipped if false.
+        bool is_format_hash_filtered() const { return !filter_format_hashes_.is_empty(); }
+
         bool seek_read_file_absolute(size_t pos);
 
         bool seek_read_file_offset(int32_t offset);
 
         size_t get_current_file_size();
 
-        // data() returned by read_with_cache_handle will be invalid after next calling of "read_with_cache"
+        // data() returned by read_with_cache_handle will be invalid after next calling of "read_with_cache".
+        // It points straight into the file mapping when the file is mapped and the segment is not encrypted.
+        // In block compressed files it reads decompressed data and never crosses the end of a block.
         read_with_cache_handle read_with_cache(size_t size);
 
         void clear_read_cache();
 
+        // In decode_follow(), decoding restarts here when the current item turns out to be incomplete,
+        // and the scan for a sync marker starts here when it turns out to be damaged.
+        // decode() marks every item, decoders reading several items in one decode_private() mark them too.
+        void mark_item_start();
+
         appender_decode_result do_decode_by_log_entry_handle(const bq::log_entry_handle& item);
 
     private:
+        // Same as reset_read_position, but keeps the decoder state of earlier items.
+        void restore_read_position(const read_position& position);
+
+        // Pick up data appended since the last call, returns true if there is any.
+        bool refresh_live_end();
+
+        // success if decoding continues at the next rotated file, eof if there is none yet.
+        appender_decode_result open_next_rotated_file();
+
+        static bq::string find_next_rotated_file(const bq::string& file_abs_path);
+
+        void refresh_filter_category_mask();
+
         appender_decode_result read_to_next_segment();
 
+        // Scan forward from the start of a damaged item for the next valid sync marker,
+        // the next segment is read if the current one has none.
+        appender_decode_result resync_after_error();
+
         size_t read_from_file_directly(void* dst, size_t size);
 
+        // read_with_cache on the data as stored in the file, decrypted.
+        read_with_cache_handle read_file_with_cache(size_t size);
+
+        void clear_file_read_cache();
+
+        uint64_t get_file_read_position() const;
+
+        bool is_block_loaded() const { return block_cursor_ < block_data_.size(); }
+
+        // Decompress the next block into block_data_, damaged blocks are skipped up to the end of their segment.
+        appender_decode_result read_block();
+
+        appender_decode_result resync_in_blocks();
+
     protected:
         bq::string decoded_text_;
         bq::layout layout_;
@@ -91,12 +260,52 @@ namespace bq {
         bq::array<bq::string> category_names_;
 
     private:
+        read_position first_restart_point_;
+        uint64_t read_end_pos_ = UINT64_MAX;
+        uint64_t skip_before_epoch_ = 0;
+        uint64_t last_entry_epoch_ = 0;
+        log_decode_entry_info last_entry_info_ = {};
+        log_decode_output_format output_format_ = log_decode_output_format::text;
+        log_entry_exporter exporter_;
+        log_template_stats* template_stats_ = nullptr;
+        uint64_t skipped_bytes_ = 0;
+        bool last_entry_skipped_ = false;
+        bool has_pending_entry_ = false;
+        bool filter_enabled_ = false;
+        uint32_t filter_level_mask_ = 0;
+        bq::string filter_category_prefixes_;
+        bq::array<uint8_t> filter_category_mask_;
+        uint64_t filter_thread_id_ = 0;
+        uint64_t filter_begin_epoch_ = 0;
+        uint64_t filter_end_epoch_ = UINT64_MAX;
+        bq::array<uint64_t> filter_format_hashes_;
         bq::file_handle file_;
         size_t current_file_size_ = 0;
         size_t current_file_cursor_ = SIZE_MAX;
         bq::rsa::private_key private_key_;
+        bq::string private_key_str_;
 
+        bool follow_ = false;
+        bool follow_watching_ = false;
+        bool short_read_since_item_start_ = false;
+        read_position item_start_;
+        bq::file_watcher follow_watcher_;
+
+        // read only mapping of the file when the platform supports it, the part of the file beyond it is read by file io.
+        bq::memory_map_handle file_map_;
+
+        // scratch buffer for file io and for decrypting mapped data.
         bq::array<uint8_t, bq::aligned_allocator<uint8_t, appender_file_base::DEFAULT_BUFFER_ALIGNMENT>> cache_read_;
-        decltype(cache_read_)::size_type cache_read_cursor_ = 0;
+        // the data being read, either cache_read_ or a window of file_map_, ends at current_file_cursor_.
+        const uint8_t* cache_data_ = nullptr;
+        size_t cache_size_ = 0;
+        size_t cache_read_cursor_ = 0;
+
+        // block compressed files only, see appender_file_binary.h
+        bool block_compressed_ = false;
+        bool block_damaged_ = false;
+        bq::array<uint8_t> block_data_;
+        size_t block_cursor_ = 0;
+        uint64_t block_start_pos_ = 0;
     };
 }
@@ -16,9 +16,28 @@
 #include "bq_log/bq_log.h"
 #include "bq_log/log/log_types.h"
 
+static bool is_delta_encoded_type(bq::log_arg_type_enum type)
+{
+    switch (type) {
+    case bq::log_arg_type_enum::char16_type:
+    case bq::log_arg_type_enum::uint16_type:
+    case bq::log_arg_type_enum::int16_type:
+    case bq::log_arg_type_enum::char32_type:
+    case bq::log_arg_type_enum::uint32_type:
+    case bq::log_arg_type_enum::int32_type:
+    case bq::log_arg_type_enum::uint64_type:
+    case bq::log_arg_type_enum::int64_type:
+    case bq::log_arg_type_enum::double_type:
+        return true;
+    default:
+        return false;
+    }
+}
+
 bq::appender_decode_result bq::appender_decoder_compressed::init_private()
 {
     log_templates_array_.clear();
+    string_dictionary_.clear();
     thread_info_templates_map_.set_expand_rate(4);
     last_log_entry_epoch_ = 0;
     return appender_decode_result::success;
@@ -29,6 +48,7 @@ bq::appender_decode_result bq::appender_decoder_compressed::decode_private()
     decoded_text_.clear();
     appender_decode_result result = appender_decode_result::success;
     while (true) {
+        mark_item_start();
         auto read_result = read_item_data();
         result = bq::get<0>(read_result);
         if (result != appender_decode_result::success) {
@@ -45,6 +65,15 @@ bq::appender_decode_result bq::appender_decoder_compressed::decode_private()
             case bq::appender_file_compressed::template_sub_type::thread_info_template:
                 result = parse_thread_info_template(bq::get<2>(read_result).offset(1));
                 break;
+            case bq::appender_file_compressed::template_sub_type::sync_marker:
+                result = parse_sync_marker(bq::get<2>(read_result).offset(1));
+                break;
+            case bq::appender_file_compressed::template_sub_type::arg_type_signature:
+                result = parse_arg_type_signature(bq::get<2>(read_result).offset(1));
+                break;
+            case bq::appender_file_compressed::template_sub_type::string_define:
+                result = parse_string_define(bq::get<2>(read_result).offset(1));
+                break;
             default:
                 bq::util::log_device_console_plain_text(bq::log_level::error, "decode compressed log file failed, invalid template sub type");
                 return appender_decode_result::failed_decode_error;
@@ -59,6 +88,9 @@ bq::appender_decode_result bq::appender_decoder_compressed::decode_private()
             return appender_decode_result::failed_io_error;
             break;
         }
+        if (result != appender_decode_result::success) {
+            return result;
+        }
         if (type == bq::appender_file_compressed::item_type::log_entry) {
             break;
         }
@@ -72,6 +104,123 @@ uint32_t bq::appender_decoder_compressed::get_binary_format_version() const
     return appender_file_compressed::format_version;
 }
 
+void bq::appender_decoder_compressed::on_restart_point()
+{
+    // templates and epoch base are written again by the appender after every restart point
+    log_templates_array_.clear();
+    thread_info_templates_map_.clear();
+    string_dictionary_.clear();
+    last_log_entry_epoch_ = 0;
+}
+
+void bq::appender_decoder_compressed::on_sync_marker(const appender_file_binary::appender_sync_marker& marker)
+{
+    last_log_entry_epoch_ = marker.epoch_ms;
+    // templates written in the skipped data are unknown, entries referring to them are skipped too.
+    if (log_templates_array_.size() > marker.format_template_count) {
+        log_templates_array_.pop_back(log_templates_array_.size() - marker.format_template_count);
+    }
+    while (log_templates_array_.size() < marker.format_template_count) {
+        log_templates_array_.push_back(decoder_log_template());
+        log_templates_array_[log_templates_array_.size() - 1].lost = true;
+    }
+    for (uint32_t i = 0; i < marker.thread_info_template_count; ++i) {
+        if (thread_info_templates_map_.find(i) == thread_info_templates_map_.end()) {
+            // the thread is unknown, its entries are still decoded
+            decoder_thread_info_template& info = thread_info_templates_map_[i];
+            info.thread_id = 0;
+            info.filter_matched = filter_thread(0);
+        }
+    }
+    // the appender defines every string again on its first use after a sync marker, and starts deltas from 0
+    for (decoder_dictionary_string& dictionary_string : string_dictionary_) {
+        dictionary_string.defined = false;
+    }
+    for (decoder_log_template& log_template : log_templates_array_) {
+        memset(log_template.delta_bases.begin(), 0, log_template.delta_bases.size() * sizeof(uint64_t));
+    }
+}
+
+bq::appender_decode_result bq::appender_decoder_compressed::parse_sync_marker(const appender_decoder_base::read_with_cache_handle& read_handle)
+{
+    if (read_handle.len() != sizeof(appender_file_binary::appender_sync_marker) || !appender_file_binary::verify_sync_marker(read_handle.data())) {
+        bq::util::log_device_console(log_level::error, "decode compressed log file failed, invalid sync marker");
+        return appender_decode_result::failed_decode_error;
+    }
+    appender_file_binary::appender_sync_marker marker;
+    memcpy(&marker, read_handle.data(), sizeof(marker));
+    on_sync_marker(marker);
+    return appender_decode_result::success;
+}
+
+bq::appender_decode_result bq::appender_decoder_compressed::parse_arg_type_signature(const appender_decoder_base::read_with_cache_handle& read_handle)
+{
+    uint32_t format_template_idx = 0;
+    const size_t idx_len = bq::log_utils::vlq::vlq_decode(format_template_idx, read_handle.data());
+    if (bq::log_utils::vlq::invalid_decode_length == idx_len || idx_len > read_handle.len() || format_template_idx >= log_templates_array_.size()) {
+        bq::util::log_device_console(log_level::error, "decode compressed log file failed, invalid arg type signature");
+        return appender_decode_result::failed_decode_error;
+    }
+    auto& arg_types = log_templates_array_[format_template_idx].arg_types;
+    arg_types.clear();
+    arg_types.insert_batch(arg_types.end(), read_handle.data() + idx_len, read_handle.len() - idx_len);
+    auto& delta_bases = log_templates_array_[format_template_idx].delta_bases;
+    delta_bases.clear();
+    delta_bases.fill_uninitialized(arg_types.size());
+    memset(delta_bases.begin(), 0, delta_bases.size() * sizeof(uint64_t));
+    return appender_decode_result::success;
+}
+
+bq::appender_decode_result bq::appender_decoder_compressed::parse_string_define(const appender_decoder_base::read_with_cache_handle& read_handle)
+{
+    uint32_t slot_idx = 0;
+    const size_t idx_len = bq::log_utils::vlq::vlq_decode(slot_idx, read_handle.data());
+    if (bq::log_utils::vlq::invalid_decode_length == idx_len || idx_len > read_handle.len() || slot_idx >= appender_file_compressed::MAX_STRING_DICTIONARY_CAPACITY) {
+        bq::util::log_device_console(log_level::error, "decode compressed log file failed, invalid string define");
+        return appender_decode_result::failed_decode_error;
+    }
+    while (string_dictionary_.size() <= slot_idx) {
+        string_dictionary_.push_back(decoder_dictionary_string());
+    }
+    decoder_dictionary_string& dictionary_string = string_dictionary_[slot_idx];
+    dictionary_string.str.clear();
+    dictionary_string.str.insert_batch(dictionary_string.str.end(), read_handle.data() + idx_len, read_handle.len() - idx_len);
+    dictionary_string.defined = true;
+    return appender_decode_result::success;
+}
+
+bq::appender_decode_result bq::appender_decoder_compressed::read_string_param(const appender_decoder_base::read_with_cache_handle& read_handle, size_t& cursor, const uint8_t*& out_str, uint32_t& out_len)
+{
+    uint32_t len_or_slot = 0;
+    size_t vlq_decode_length = bq::log_utils::vlq::vlq_decode(len_or_slot, read_handle.data() + cursor);
+    if (bq::log_utils::vlq::invalid_decode_length == vlq_decode_length) {
+        bq::util::log_device_console(bq::log_level::error, "decode compressed log file failed : param string length decode error");
+        return bq::appender_decode_result::failed_decode_error;
+    }
+    cursor += vlq_decode_length;
+    if (len_or_slot & 1) {
+        uint32_t slot_idx = len_or_slot >> 1;
+        if (slot_idx < string_dictionary_.size() && string_dictionary_[slot_idx].defined) {
+            out_str = string_dictionary_[slot_idx].str.begin();
+            out_len = static_cast<uint32_t>(string_dictionary_[slot_idx].str.size());
+        } else {
+            out_str = nullptr;
+            out_len = 0;
+        }
+        return bq::appender_decode_result::success;
+    }
+    out_len = len_or_slot >> 1;
+    if (cursor + out_len > read_handle.len()) {
+        bq::util::log_device_console(bq::log_level::error, "decode compressed log file failed : param string length overflow log entry data item length :%" PRIu32, out_len);
+        return bq::appender_decode_result::failed_decode_error;
+    }
+    // a 0 placeholder is written in front of utf-mixed strings if the estimated length size was too large
+    bool has_place_holder = out_len && !read_handle.data()[cursor];
+    out_str = has_place_holder ? (read_handle.data() + cursor + 1) : (read_handle.data() + cursor);
+    cursor += has_place_holder ? (out_len + 1) : out_len;
+    return bq::appender_decode_result::success;
+}
+
 bq::tuple<bq::appender_decode_result, bq::appender_file_compressed::item_type, bq::appender_decoder_base::read_with_cache_handle> bq::appender_decoder_compressed::read_item_data()
 {
     constexpr size_t VLQ_MAX_SIZE = bq::log_utils::vlq::vlq_max_bytes_count<uint32_t>();
@@ -83,21 +232,21 @@ bq::tuple<bq::appender_decode_result, bq::appender_file_compressed::item_type, b
         bq::util::log_device_console(log_level::error, "decode compressed log file failed, read data item head failed");
         return bq::make_tuple(bq::appender_decode_result::failed_decode_error, appender_file_compressed::item_type::log_template, read_handle);
     }
-    uint8_t& first_byte = *const_cast<uint8_t*>(read_handle.data());
-    int32_t offset = ((first_byte & 0x7F) == 0) ? 1 : 0; // 0b01111111
-    auto type = (appender_file_compressed::item_type)(first_byte & 0x80); // 0b10000000
+    // the read data may be a read only file mapping, the type bit is cleared on a copy of the head.
+    uint8_t head_data[VLQ_MAX_SIZE + 1] = {};
+    memcpy(head_data, read_handle.data(), read_handle.len());
+    int32_t offset = ((head_data[0] & 0x7F) == 0) ? 1 : 0; // 0b01111111
+    auto type = (appender_file_compressed::item_type)(head_data[0] & 0x80); // 0b10000000
     uint32_t data_size = 0;
     if (offset == 0) {
-        first_byte &= 0x7F; // 0b01111111
+        head_data[0] &= 0x7F; // 0b01111111
     }
-    size_t size_len = bq::log_utils::vlq::vlq_decode(data_size, read_handle.data() + offset);
+    size_t size_len = bq::log_utils::vlq::vlq_decode(data_size, head_data + offset);
     if (bq::log_utils::vlq::invalid_decode_length == size_len) {
         bq::util::log_device_console(log_level::error, "decode compressed log file failed, decode data size failed");
         return bq::make_tuple(bq::appender_decode_result::failed_decode_error, appender_file_compressed::item_type::log_template, read_handle);
     }
-    if (offset == 0) {
-        first_byte |= (uint8_t)type;
-    }
+    last_item_head_size_ = static_cast<uint32_t>(size_len) + static_cast<uint32_t>(offset);
     seek_read_file_offset(static_cast<int32_t>(size_len) + offset - static_cast<int32_t>(read_handle.len()));
     read_handle = read_with_cache(data_size);
     if (read_handle.len() != (size_t)data_size || data_size < 2) {
@@ -145,6 +294,16 @@ bq::appender_decode_result bq::appender_decoder_compressed::parse_formate_templa
             info.fmt_string.erase(info.fmt_string.begin() + static_cast<ptrdiff_t>(utf8_len), max_utf8_str_len - utf8_len);
         }
     }
+    // same hash as the one in the raw entry head, utf16 format strings are stored as utf-mixed.
+    // templates are parsed once per segment, so it is always computed for filters and exports.
+    {
+        const char* data_ptr = (const char*)read_handle.data() + cursor;
+        size_t data_len = (cursor < read_handle.len()) ? read_handle.len() - cursor : 0;
+        info.fmt_hash = (sub_type == appender_file_compressed::template_sub_type::format_template_utf8) ? bq::util::get_hash_64(data_ptr, data_len) : bq::util::hash_utf_mixed_as_utf16(data_ptr, data_len);
+    }
+    if (is_filter_enabled()) {
+        info.filter_matched = filter_template(info.level, info.category_idx, info.fmt_hash);
+    }
     return appender_decode_result::success;
 }
 
@@ -174,6 +333,7 @@ bq::appender_decode_result bq::appender_decoder_compressed::parse_thread_info_te
     }
     decoder_thread_info_template& info = thread_info_templates_map_[thread_info_idx];
     info.thread_id = thread_id;
+    info.filter_matched = filter_thread(thread_id);
     info.thread_name.clear();
     info.thread_name.fill_uninitialized(read_handle.len() - read_cursor);
     if (info.thread_name.size() > 0) {
@@ -208,6 +368,9 @@ bq::appender_decode_result bq::appender_decoder_compressed::parse_log_entry(cons
         return appender_decode_result::failed_decode_error;
     }
     cursor += formate_template_idx_len;
+    // the lowest bit tells whether param types are written, or taken from the arg type signature of the template
+    const bool explicit_arg_types = (formate_template_idx & 1) != 0;
+    formate_template_idx >>= 1;
     if (formate_template_idx >= log_templates_array_.size()) {
         bq::util::log_device_console(log_level::error, "decode compressed log file failed, invalid formate_template_idx: %d", formate_template_idx);
         return appender_decode_result::failed_decode_error;
@@ -234,6 +397,23 @@ bq::appender_decode_result bq::appender_decoder_compressed::parse_log_entry(cons
     }
     last_log_entry_epoch_ = static_cast<uint64_t>((static_cast<int64_t>(last_log_entry_epoch_) + epoch_offset));
     auto& format_template = log_templates_array_[formate_template_idx];
+    if (format_template.lost) {
+        add_skipped_bytes(static_cast<uint64_t>(read_handle.len()) + last_item_head_size_);
+        skip_entry(last_log_entry_epoch_, false);
+        return appender_decode_result::success;
+    }
+    // params stored as deltas are decoded even if the entry is not output, the next entries of the template depend on them.
+    const bool use_delta = !explicit_arg_types && !format_template.delta_bases.is_empty();
+    const bool entry_skipped = skip_entry(last_log_entry_epoch_, format_template.filter_matched && thread_info_iter->value().filter_matched);
+    log_template_stats* stats = entry_skipped ? nullptr : get_template_stats();
+    if (stats) {
+        // the arguments are not rebuilt, the entry is counted with its stored size including the item head.
+        stats->add(format_template.fmt_hash, format_template.level, format_template.category_idx, last_log_entry_epoch_, static_cast<uint64_t>(read_handle.len()) + last_item_head_size_,
+            format_template.fmt_string.c_str(), format_template.fmt_string.size());
+    }
+    if ((entry_skipped || stats) && !use_delta) {
+        return stats ? finish_counted_entry() : appender_decode_result::success;
+    }
 
     raw_data_.clear();
     raw_data_.fill_uninitialized(sizeof(bq::_log_entry_head_def));
@@ -244,7 +424,7 @@ bq::appender_decode_result bq::appender_decoder_compressed::parse_log_entry(cons
     head.category_idx = format_template.category_idx;
     head.timestamp_epoch = last_log_entry_epoch_;
     head.log_format_str_type = (decltype(head.log_format_str_type))log_arg_type_enum::string_utf8_type;
-    head.format_hash = 0;
+    head.format_hash = format_template.fmt_hash;
     head.log_format_data_len = (uint32_t)format_template.fmt_string.size();
     raw_cursor += static_cast<ptrdiff_t>(sizeof(bq::_log_entry_head_def));
 
@@ -253,11 +433,58 @@ bq::appender_decode_result bq::appender_decoder_compressed::parse_log_entry(cons
     memcpy(raw_data_.begin() + raw_cursor, reinterpret_cast<const uint8_t*>(static_cast<const char*>(format_template.fmt_string.c_str())), format_template.fmt_string.size());
     raw_cursor += static_cast<ptrdiff_t>(fmt_str_section_size);
 
-    while (cursor < read_handle.len()) {
-        bq::log_arg_type_enum type_info = (bq::log_arg_type_enum)read_handle.data()[cursor++];
+    const bq::array<uint8_t>& arg_types = format_template.arg_types;
+    size_t arg_idx = 0;
+    bool lost_string = false;
+    while (explicit_arg_types ? (cursor < read_handle.len()) : (arg_idx < arg_types.size())) {
+        bq::log_arg_type_enum type_info = explicit_arg_types ? (bq::log_arg_type_enum)read_handle.data()[cursor++] : (bq::log_arg_type_enum)arg_types[arg_idx];
+        ++arg_idx;
         raw_data_.fill_uninitialized(4);
         raw_data_[raw_cursor] = (uint8_t)type_info;
         size_t vlq_decode_length_tmp = 0;
+        if (use_delta && is_delta_encoded_type(type_info)) {
+            uint64_t code = 0;
+            vlq_decode_length_tmp = bq::log_utils::vlq::vlq_decode(code, read_handle.data() + cursor);
+            if (bq::log_utils::vlq::invalid_decode_length == vlq_decode_length_tmp) {
+                bq::util::log_device_console(bq::log_level::error, "decode compressed log file failed : param delta decode error");
+                return bq::appender_decode_result::failed_decode_error;
+            }
+            cursor += vlq_decode_length_tmp;
+            uint64_t& base = format_template.delta_bases[arg_idx - 1];
+            if (type_info != bq::log_arg_type_enum::double_type) {
+                base += static_cast<uint64_t>(bq::log_utils::zigzag::decode(code));
+            } else if (code != bq::log_utils::double_xor::escape_code) {
+                base ^= bq::log_utils::double_xor::decode(code);
+            } else {
+                if (cursor + sizeof(uint64_t) > read_handle.len()) {
+                    bq::util::log_device_console(bq::log_level::error, "decode compressed log file failed : param double length overflow log entry data item length");
+                    return bq::appender_decode_result::failed_decode_error;
+                }
+                memcpy(&base, read_handle.data() + cursor, sizeof(uint64_t));
+                cursor += sizeof(uint64_t);
+            }
+            switch (type_info) {
+            case bq::log_arg_type_enum::char16_type:
+            case bq::log_arg_type_enum::uint16_type:
+            case bq::log_arg_type_enum::int16_type:
+                *(uint16_t*)(&raw_data_[raw_cursor + 2]) = static_cast<uint16_t>(base);
+                raw_cursor += 4;
+                break;
+            case bq::log_arg_type_enum::char32_type:
+            case bq::log_arg_type_enum::uint32_type:
+            case bq::log_arg_type_enum::int32_type:
+                raw_data_.fill_uninitialized(sizeof(uint32_t));
+                *(uint32_t*)(&raw_data_[raw_cursor + 4]) = static_cast<uint32_t>(base);
+                raw_cursor += 4 + static_cast<ptrdiff_t>(sizeof(uint32_t));
+                break;
+            default:
+                raw_data_.fill_uninitialized(sizeof(uint64_t));
+                memcpy(raw_data_.begin() + raw_cursor + 4, &base, sizeof(uint64_t));
+                raw_cursor += 4 + static_cast<ptrdiff_t>(sizeof(uint64_t));
+                break;
+            }
+            continue;
+        }
         switch (type_info) {
         case bq::log_arg_type_enum::unsupported_type:
             bq::util::log_device_console(bq::log_level::error, "decode compressed log file failed : non_primitivi_type is not supported yet, type:%d", (int32_t)type_info);
@@ -358,15 +585,14 @@ bq::appender_decode_result bq::appender_decoder_compressed::parse_log_entry(cons
             break;
         case bq::log_arg_type_enum::string_utf8_type: {
             uint32_t len = 0;
-            vlq_decode_length_tmp = bq::log_utils::vlq::vlq_decode(len, read_handle.data() + cursor);
-            if (bq::log_utils::vlq::invalid_decode_length == vlq_decode_length_tmp) {
-                bq::util::log_device_console(bq::log_level::error, "decode compressed log file failed : param utf8 string length decode error");
-                return bq::appender_decode_result::failed_decode_error;
+            const uint8_t* str_begin_pos = nullptr;
+            auto string_result = read_string_param(read_handle, cursor, str_begin_pos, len);
+            if (string_result != bq::appender_decode_result::success) {
+                return string_result;
             }
-            cursor += vlq_decode_length_tmp;
-            if (cursor + len > read_handle.len()) {
-                bq::util::log_device_console(bq::log_level::error, "decode compressed log file failed : param utf8 string length overflow log entry data item length :%d", len);
-                return bq::appender_decode_result::failed_decode_error;
+            if (!str_begin_pos) {
+                lost_string = true;
+                break;
             }
             raw_cursor += 4;
             raw_data_.fill_uninitialized(4);
@@ -375,23 +601,19 @@ bq::appender_decode_result bq::appender_decoder_compressed::parse_log_entry(cons
 
             uint32_t string_section_len = (uint32_t)bq::align_4((size_t)len);
             raw_data_.fill_uninitialized(string_section_len);
-            bool has_place_holder = len && !read_handle.data()[cursor];
-            const uint8_t* str_begin_pos = has_place_holder ? (const uint8_t*)(read_handle.data() + cursor + 1) : (const uint8_t*)(read_handle.data() + cursor);
             memcpy((uint8_t*)(raw_data_.begin() + raw_cursor), str_begin_pos, (size_t)len);
-            cursor += has_place_holder ? (len + 1) : (len);
             raw_cursor += static_cast<ptrdiff_t>(string_section_len);
         } break;
         case bq::log_arg_type_enum::string_utf_mixed_type: {
             uint32_t mixed_len = 0;
-            vlq_decode_length_tmp = bq::log_utils::vlq::vlq_decode(mixed_len, read_handle.data() + cursor);
-            if (bq::log_utils::vlq::invalid_decode_length == vlq_decode_length_tmp) {
-                bq::util::log_device_console(bq::log_level::error, "decode compressed log file failed : param utf8 string length decode error");
-                return bq::appender_decode_result::failed_decode_error;
+            const uint8_t* str_begin_pos = nullptr;
+            auto string_result = read_string_param(read_handle, cursor, str_begin_pos, mixed_len);
+            if (string_result != bq::appender_decode_result::success) {
+                return string_result;
             }
-            cursor += vlq_decode_length_tmp;
-            if (cursor + mixed_len > read_handle.len()) {
-                bq::util::log_device_console(bq::log_level::error, "decode compressed log file failed : param utf8 string length overflow log entry data item length :%d", mixed_len);
-                return bq::appender_decode_result::failed_decode_error;
+            if (!str_begin_pos) {
+                lost_string = true;
+                break;
             }
             raw_data_[raw_cursor] = (uint8_t)bq::log_arg_type_enum::string_utf8_type;
             raw_cursor += 4;
@@ -401,8 +623,6 @@ bq::appender_decode_result bq::appender_decoder_compressed::parse_log_entry(cons
 
             size_t max_utf8_str_len = (mixed_len << 1);
             raw_data_.fill_uninitialized(max_utf8_str_len);
-            bool has_place_holder = mixed_len && !read_handle.data()[cursor];
-            const uint8_t* str_begin_pos = has_place_holder ? (const uint8_t*)(read_handle.data() + cursor + 1) : (const uint8_t*)(read_handle.data() + cursor);
             uint32_t utf8_len = bq::util::utf_mixed_to_utf8(reinterpret_cast<const char*>(str_begin_pos), static_cast<uint32_t>(mixed_len), reinterpret_cast<char*>(static_cast<uint8_t*>(raw_data_.begin())) + raw_cursor, static_cast<uint32_t>(max_utf8_str_len));
             auto aligned_utf8_len = bq::align_4(utf8_len);
             if (aligned_utf8_len < max_utf8_str_len) {
@@ -411,7 +631,6 @@ bq::appender_decode_result bq::appender_decoder_compressed::parse_log_entry(cons
                 raw_data_.fill_uninitialized(aligned_utf8_len - max_utf8_str_len);
             }
             *((uint32_t*)(uint8_t*)(raw_data_.begin() + size_raw_cursor)) = utf8_len;
-            cursor += has_place_holder ? (mixed_len + 1) : (mixed_len);
             raw_cursor += static_cast<ptrdiff_t>(bq::align_4(aligned_utf8_len));
         } break;
         default:
@@ -423,6 +642,22 @@ bq::appender_decode_result bq::appender_decoder_compressed::parse_log_entry(cons
         }
         continue;
     }
+    if (cursor != read_handle.len()) {
+        bq::util::log_device_console(bq::log_level::error, "decode compressed log file failed : params don't match the arg type signature of the format template");
+        return bq::appender_decode_result::failed_decode_error;
+    }
+    if (entry_skipped) {
+        return appender_decode_result::success;
+    }
+    if (stats) {
+        return finish_counted_entry();
+    }
+    if (lost_string) {
+        // a string of the string dictionary was defined in skipped data
+        add_skipped_bytes(static_cast<uint64_t>(read_handle.len()) + last_item_head_size_);
+        skip_entry(last_log_entry_epoch_, false);
+        return appender_decode_result::success;
+    }
     size_t ext_info_size = sizeof(_log_entry_ext_head_def) + thread_info_iter->value().thread_name.size();
     size_t ext_info_offset = bq::align_4(raw_data_.size());
     size_t fill_size = ext_info_offset - +ext_info_size + raw_data_.size();
@@ -20,10 +20,20 @@ namespace bq {
             bq::log_level level = bq::log_level::log_level_max;
             uint64_t epoch_ms = (uint64_t)(-1);
             bq::string fmt_string;
+            uint64_t fmt_hash = 0; // the same as format_hash of a raw log entry head
+            bool filter_matched = true;
+            bool lost = false; // defined in damaged data skipped by resync, its log entries can't be decoded
+            bq::array<uint8_t> arg_types; // arg type signature, for log entries without explicit param types
+            bq::array<uint64_t> delta_bases; // previous param values of log entries using the signature
+        };
+        struct decoder_dictionary_string {
+            bq::array<uint8_t> str;
+            bool defined = false; // false if the string define is in skipped data, or before the last sync marker
         };
         struct decoder_thread_info_template {
             uint64_t thread_id;
             bq::string thread_name;
+            bool filter_matched = true;
         };
 
     protected:
@@ -33,6 +43,10 @@ namespace bq {
 
         virtual uint32_t get_binary_format_version() const override;
 
+        virtual void on_restart_point() override;
+
+        virtual void on_sync_marker(const appender_file_binary::appender_sync_marker& marker) override;
+
     private:
         bq::tuple<appender_decode_result, appender_file_compressed::item_type, appender_decoder_base::read_with_cache_handle> read_item_data();
 
@@ -42,10 +56,21 @@ namespace bq {
 
         appender_decode_result parse_thread_info_template(const appender_decoder_base::read_with_cache_handle& read_handle);
 
+        appender_decode_result parse_sync_marker(const appender_decoder_base::read_with_cache_handle& read_handle);
+
+        appender_decode_result parse_arg_type_signature(const appender_decoder_base::read_with_cache_handle& read_handle);
+
+        appender_decode_result parse_string_define(const appender_decoder_base::read_with_cache_handle& read_handle);
+
+        // Reads a string param, written as it is or as a string dictionary slot. out_str is nullptr if the slot is unknown.
+        appender_decode_result read_string_param(const appender_decoder_base::read_with_cache_handle& read_handle, size_t& cursor, const uint8_t*& out_str, uint32_t& out_len);
+
     private:
         uint64_t last_log_entry_epoch_;
+        uint32_t last_item_head_size_ = 0;
         bq::array<decoder_log_template> log_templates_array_;
         bq::hash_map<uint64_t, decoder_thread_info_template> thread_info_templates_map_;
+        bq::array<decoder_dictionary_string> string_dictionary_;
         bq::array<uint8_t> raw_data_;
     };
 }
@@ -35,7 +35,36 @@ bq::appender_decoder_manager& bq::appender_decoder_manager::instance()
     return log_global_vars::get().appender_decoder_manager_inst_;
 }
 
-bq::appender_decode_result bq::appender_decoder_manager::create_decoder(const bq::string& path, const bq::string& private_key_str, uint32_t& out_handle)
+bq::appender_decode_result bq::appender_decoder_manager::create_decoder(const bq::string& path, const bq::string& private_key_str, const log_decode_filter* filter, uint32_t& out_handle)
+{
+    bq::unique_ptr<appender_decoder_base> decoder;
+    bq::appender_decode_result result = open_decoder(path, private_key_str, decoder);
+    if (result != appender_decode_result::success) {
+        return result;
+    }
+    if (filter) {
+        decoder->set_filter(*filter);
+        if (filter->begin_epoch_ms > 0) {
+            // jump over the restart points before the time range, eof just means nothing matches.
+            result = decoder->seek_to_time(filter->begin_epoch_ms);
+            if (result != appender_decode_result::success && result != appender_decode_result::eof) {
+                return result;
+            }
+            result = appender_decode_result::success;
+        }
+    }
+    auto slot = bq::make_unique<decoder_slot>();
+    slot->decoder_ = bq::move(decoder);
+    out_handle = idx_seq_.add_fetch_seq_cst(1);
+#if !defined(BQ_TOOLS)
+    bq::platform::scoped_mutex lock(mutex_);
+#endif
+    decoders_map_.add(out_handle, bq::move(slot));
+
+    return result;
+}
+
+bq::appender_decode_result bq::appender_decoder_manager::open_decoder(const bq::string& path, const bq::string& private_key_str, bq::unique_ptr<appender_decoder_base>& out_decoder)
 {
     string path_tmp = TO_ABSOLUTE_PATH(path, 1);
     auto handle = bq::file_manager::instance().open_file(path_tmp, file_open_mode_enum::read);
@@ -62,35 +91,114 @@ bq::appender_decode_result bq::appender_decoder_manager::create_decoder(const bq
     if (result != appender_decode_result::success) {
         return result;
     }
-    out_handle = idx_seq_.add_fetch_seq_cst(1);
+    out_decoder = bq::move(decoder);
+    return result;
+}
+
+bq::appender_decoder_manager::scoped_decoder::scoped_decoder(appender_decoder_manager& manager, uint32_t handle)
+    : manager_(manager)
+    , handle_(handle)
+    , slot_(nullptr)
+{
+    {
 #if !defined(BQ_TOOLS)
-    bq::platform::scoped_mutex lock(mutex_);
+        bq::platform::scoped_mutex lock(manager_.mutex_);
+#endif
+        auto iter = manager_.decoders_map_.find(handle_);
+        if (iter == manager_.decoders_map_.end() || iter->value()->destroy_pending_) {
+            return;
+        }
+        slot_ = iter->value().get();
+        ++slot_->ref_count_;
+    }
+#if !defined(BQ_TOOLS)
+    slot_->mutex_.lock();
 #endif
-    decoders_map_.add(out_handle, bq::move(decoder));
-
-    return result;
 }
 
-void bq::appender_decoder_manager::destroy_decoder(uint32_t handle)
+bq::appender_decoder_manager::scoped_decoder::~scoped_decoder()
 {
+    if (!slot_) {
+        return;
+    }
 #if !defined(BQ_TOOLS)
-    bq::platform::scoped_mutex lock(mutex_);
+    slot_->mutex_.unlock();
+    bq::platform::scoped_mutex lock(manager_.mutex_);
 #endif
-    decoders_map_.erase(handle);
+    if (--slot_->ref_count_ == 0 && slot_->destroy_pending_) {
+        manager_.decoders_map_.erase(handle_);
+    }
 }
 
-bq::appender_decode_result bq::appender_decoder_manager::decode_single_item(uint32_t handle, const bq::string*& out_decoded_log_text)
+void bq::appender_decoder_manager::destroy_decoder(uint32_t handle)
 {
 #if !defined(BQ_TOOLS)
     bq::platform::scoped_mutex lock(mutex_);
 #endif
     auto iter = decoders_map_.find(handle);
-    if (iter != decoders_map_.end()) {
-        auto result = iter->value()->decode();
-        if (result == appender_decode_result::success) {
-            out_decoded_log_text = &iter->value()->get_decoded_log_text();
-        }
-        return result;
+    if (iter == decoders_map_.end()) {
+        return;
+    }
+    if (iter->value()->ref_count_ > 0) {
+        // still used by another thread, e.g. waiting in decode_follow, the last user deletes it.
+        iter->value()->destroy_pending_ = true;
+        return;
+    }
+    decoders_map_.erase(iter);
+}
+
+bq::appender_decode_result bq::appender_decoder_manager::decode_single_item(uint32_t handle, const bq::string*& out_decoded_log_text)
+{
+    scoped_decoder decoder(*this, handle);
+    if (!decoder.get()) {
+        return appender_decode_result::failed_invalid_handle;
+    }
+    auto result = decoder.get()->decode();
+    if (result == appender_decode_result::success) {
+        out_decoded_log_text = &decoder.get()->get_decoded_log_text();
+    }
+    return result;
+}
+
+bq::appender_decode_result bq::appender_decoder_manager::decode_follow(uint32_t handle, uint64_t timeout_ms, const bq::string*& out_decoded_log_text)
+{
+    // mutex_ is not held while waiting, the other handles can be used meanwhile.
+    scoped_decoder decoder(*this, handle);
+    if (!decoder.get()) {
+        return appender_decode_result::failed_invalid_handle;
+    }
+    auto result = decoder.get()->decode_follow(timeout_ms);
+    if (result == appender_decode_result::success) {
+        out_decoded_log_text = &decoder.get()->get_decoded_log_text();
+    }
+    return result;
+}
+
+bq::appender_decode_result bq::appender_decoder_manager::decode_batch(uint32_t handle, char* text_buffer, uint32_t text_buffer_size, uint32_t* out_text_offsets, log_decode_entry_info* out_entries, uint32_t max_entry_count, uint32_t& out_entry_count)
+{
+    out_entry_count = 0;
+    scoped_decoder decoder(*this, handle);
+    if (!decoder.get()) {
+        return appender_decode_result::failed_invalid_handle;
+    }
+    return decoder.get()->decode_batch(text_buffer, text_buffer_size, out_text_offsets, out_entries, max_entry_count, out_entry_count);
+}
+
+bq::appender_decode_result bq::appender_decoder_manager::set_output_format(uint32_t handle, log_decode_output_format format)
+{
+    scoped_decoder decoder(*this, handle);
+    if (!decoder.get()) {
+        return appender_decode_result::failed_invalid_handle;
+    }
+    decoder.get()->set_output_format(format);
+    return appender_decode_result::success;
+}
+
+bq::appender_decode_result bq::appender_decoder_manager::seek_to_time(uint32_t handle, uint64_t epoch_ms)
+{
+    scoped_decoder decoder(*this, handle);
+    if (!decoder.get()) {
+        return appender_decode_result::failed_invalid_handle;
     }
-    return appender_decode_result::failed_invalid_handle;
+    return decoder.get()->seek_to_time(epoch_ms);
 }
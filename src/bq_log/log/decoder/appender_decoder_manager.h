@@ -30,9 +30,19 @@ namespace bq {
         /// </summary>
         /// <param name="path"></param>
         /// <param name="private_key"></param>
+        /// <param name="filter">optional, only matching log entries are decoded, see appender_decoder_base::set_filter</param>
         /// <param name="out_handle"></param>
         /// <returns></returns>
-        appender_decode_result create_decoder(const bq::string& path, const bq::string& private_key_str, uint32_t& out_handle);
+        appender_decode_result create_decoder(const bq::string& path, const bq::string& private_key_str, const log_decode_filter* filter, uint32_t& out_handle);
+
+        /// <summary>
+        /// open a log file and create an initialized decoder object of the matching format, without registering a handle
+        /// </summary>
+        /// <param name="path"></param>
+        /// <param name="private_key_str"></param>
+        /// <param name="out_decoder"></param>
+        /// <returns></returns>
+        static appender_decode_result open_decoder(const bq::string& path, const bq::string& private_key_str, bq::unique_ptr<appender_decoder_base>& out_decoder);
 
         /// <summary>
         /// destroy a decoder to release memory
@@ -48,12 +58,63 @@ namespace bq {
         /// <returns></returns>
         appender_decode_result decode_single_item(uint32_t handle, const bq::string*& out_decoded_log_text);
 
+        /// <summary>
+        /// move a decoder to the first log item not earlier than epoch_ms, which is returned by the next decode_single_item
+        /// </summary>
+        /// <param name="handle"></param>
+        /// <param name="epoch_ms"></param>
+        /// <returns>success if such an item exists, eof if not</returns>
+        appender_decode_result seek_to_time(uint32_t handle, uint64_t epoch_ms);
+
+        /// <summary>
+        /// decode a log item, waiting up to timeout_ms for the file to grow at its end, see appender_decoder_base::decode_follow
+        /// </summary>
+        /// <param name="handle"></param>
+        /// <param name="timeout_ms"></param>
+        /// <param name="out_decoded_log_text">same as decode_single_item</param>
+        /// <returns>success if a log item is decoded, eof on timeout</returns>
+        appender_decode_result decode_follow(uint32_t handle, uint64_t timeout_ms, const bq::string*& out_decoded_log_text);
+
+        /// <summary>
+        /// decode several log items with one call, see appender_decoder_base::decode_batch
+        /// </summary>
+        appender_decode_result decode_batch(uint32_t handle, char* text_buffer, uint32_t text_buffer_size, uint32_t* out_text_offsets, log_decode_entry_info* out_entries, uint32_t max_entry_count, uint32_t& out_entry_count);
+
+        appender_decode_result set_output_format(uint32_t handle, log_decode_output_format format);
+
+    private:
+        struct decoder_slot {
+            bq::unique_ptr<appender_decoder_base> decoder_;
+#if !defined(BQ_TOOLS)
+            // serializes the calls on one handle, so that mutex_ is not held while a decoder is working or waiting in decode_follow
+            bq::platform::mutex mutex_;
+#endif
+            // the fields below are guarded by mutex_ of appender_decoder_manager
+            int32_t ref_count_ = 0;
+            bool destroy_pending_ = false;
+        };
+
+        // Pins the decoder of a handle for the lifetime of this object, destroy_decoder defers the deletion until it is released.
+        class scoped_decoder {
+        public:
+            scoped_decoder(appender_decoder_manager& manager, uint32_t handle);
+            ~scoped_decoder();
+            scoped_decoder(const scoped_decoder&) = delete;
+            scoped_decoder& operator=(const scoped_decoder&) = delete;
+            appender_decoder_base* get() const { return slot_ ? slot_->decoder_.get() : nullptr; }
+
+        private:
+            appender_decoder_manager& manager_;
+            uint32_t handle_;
+            decoder_slot* slot_;
+        };
+
     private:
 #if !defined(BQ_TOOLS)
         // tools are running in single thread, performance will benefit from removing mutex
         bq::platform::mutex mutex_;
 #endif
         bq::platform::atomic<uint32_t> idx_seq_;
-        bq::hash_map<uint32_t, bq::unique_ptr<appender_decoder_base>> decoders_map_;
+        bq::hash_map<uint32_t, bq::unique_ptr<decoder_slot>> decoders_map_;
     };
 }
\ No newline at end of file
@@ -0,0 +1,224 @@
+﻿/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "bq_log/log/decoder/appender_decoder_merge.h"
+#include "bq_log/log/decoder/appender_decoder_manager.h"
+
+namespace bq {
+    static constexpr size_t MERGE_OUTPUT_FLUSH_SIZE = 64 * 1024;
+    // a batch is handed to the merging thread when either limit is reached
+    static constexpr size_t MERGE_BATCH_ENTRY_COUNT = 1024;
+    static constexpr size_t MERGE_BATCH_TEXT_SIZE = 256 * 1024;
+    // batches decoded ahead of the merge per file, bounds the memory held by decoded text.
+    static constexpr size_t MERGE_BATCHES_AHEAD = 2;
+
+    appender_decoder_merge::source::source(appender_decoder_merge& parent, const bq::string& path, const bq::string& tag, uint32_t index)
+        : parent_(parent)
+        , path_(path)
+        , tag_(tag)
+        , finished_(false)
+        , result_(appender_decode_result::eof)
+        , current_entry_idx_(0)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "BqMerge_%" PRIu32, index);
+        set_thread_name(name);
+    }
+
+    void appender_decoder_merge::source::run()
+    {
+        parent_.source_run(*this);
+    }
+
+    appender_decoder_merge::appender_decoder_merge()
+        : filter_(nullptr)
+        , mutex_(false)
+        , aborted_(false)
+    {
+    }
+
+    appender_decode_result appender_decoder_merge::decode(const bq::array<bq::string>& paths, const bq::array<bq::string>& tags, const bq::string& private_key_str, output_callback callback, void* user_data)
+    {
+        private_key_str_ = private_key_str;
+        sources_.clear();
+        heap_.clear();
+        aborted_ = false;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            sources_.push_back(bq::make_unique<source>(*this, paths[i], i < tags.size() ? tags[i] : paths[i], static_cast<uint32_t>(i)));
+        }
+        for (auto& src : sources_) {
+            src->start();
+        }
+
+        appender_decode_result final_result = appender_decode_result::eof;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(sources_.size()); ++i) {
+            if (next_entry(*sources_[i])) {
+                heap_.push_back(i);
+                heap_sift_up(heap_.size() - 1);
+            } else if (sources_[i]->result_ != appender_decode_result::eof) {
+                final_result = sources_[i]->result_;
+            }
+        }
+        bq::string text;
+        while (!heap_.is_empty() && final_result == appender_decode_result::eof) {
+            source& src = *sources_[heap_[0]];
+            const entry_batch& batch = src.current_batch_;
+            size_t text_begin = src.current_entry_idx_ == 0 ? 0 : batch.text_ends[src.current_entry_idx_ - 1];
+            text.push_back('[');
+            text += src.tag_;
+            text += "] ";
+            text.insert_batch(text.end(), batch.text.c_str() + text_begin, batch.text_ends[src.current_entry_idx_] - text_begin);
+            text.push_back('\n');
+            if (text.size() >= MERGE_OUTPUT_FLUSH_SIZE) {
+                callback(text.c_str(), text.size(), user_data);
+                text.clear();
+            }
+            if (!next_entry(src)) {
+                if (src.result_ != appender_decode_result::eof) {
+                    final_result = src.result_;
+                }
+                heap_[0] = heap_[heap_.size() - 1];
+                heap_.pop_back();
+            }
+            heap_sift_down(0);
+        }
+        if (!text.is_empty()) {
+            callback(text.c_str(), text.size(), user_data);
+        }
+
+        mutex_.lock();
+        aborted_ = true;
+        batch_taken_.notify_all();
+        mutex_.unlock();
+        for (auto& src : sources_) {
+            src->join();
+        }
+        sources_.clear();
+        heap_.clear();
+        return final_result;
+    }
+
+    void appender_decoder_merge::source_run(source& src)
+    {
+        bq::unique_ptr<appender_decoder_base> decoder;
+        appender_decode_result result = open_decoder(src.path_, decoder);
+        while (result == appender_decode_result::success) {
+            entry_batch batch;
+            while (batch.epochs.size() < MERGE_BATCH_ENTRY_COUNT && batch.text.size() < MERGE_BATCH_TEXT_SIZE) {
+                result = decoder->decode();
+                if (result != appender_decode_result::success) {
+                    break;
+                }
+                batch.text += decoder->get_decoded_log_text();
+                batch.text_ends.push_back(batch.text.size());
+                batch.epochs.push_back(decoder->get_decoded_log_epoch());
+            }
+            bq::platform::scoped_mutex lock(mutex_);
+            while (!aborted_ && src.ready_batches_.size() >= MERGE_BATCHES_AHEAD) {
+                batch_taken_.wait(mutex_);
+            }
+            if (aborted_) {
+                return;
+            }
+            if (!batch.epochs.is_empty()) {
+                src.ready_batches_.push_back(bq::move(batch));
+            }
+            if (result != appender_decode_result::success) {
+                break;
+            }
+            batch_ready_.notify_all();
+        }
+        bq::platform::scoped_mutex lock(mutex_);
+        src.result_ = result;
+        src.finished_ = true;
+        batch_ready_.notify_all();
+    }
+
+    appender_decode_result appender_decoder_merge::open_decoder(const bq::string& path, bq::unique_ptr<appender_decoder_base>& out_decoder) const
+    {
+        appender_decode_result result = appender_decoder_manager::open_decoder(path, private_key_str_, out_decoder);
+        if (result != appender_decode_result::success || !filter_) {
+            return result;
+        }
+        out_decoder->set_filter(*filter_);
+        if (filter_->begin_epoch_ms > 0) {
+            // eof means no log entry is inside the time range.
+            result = out_decoder->seek_to_time(filter_->begin_epoch_ms);
+        }
+        return result;
+    }
+
+    bool appender_decoder_merge::next_entry(source& src)
+    {
+        if (!src.current_batch_.epochs.is_empty() && src.current_entry_idx_ + 1 < src.current_batch_.epochs.size()) {
+            ++src.current_entry_idx_;
+            return true;
+        }
+        bq::platform::scoped_mutex lock(mutex_);
+        while (src.ready_batches_.is_empty() && !src.finished_) {
+            batch_ready_.wait(mutex_);
+        }
+        if (src.ready_batches_.is_empty()) {
+            src.current_batch_ = entry_batch();
+            return false;
+        }
+        src.current_batch_ = bq::move(src.ready_batches_[0]);
+        src.ready_batches_.erase(src.ready_batches_.begin());
+        src.current_entry_idx_ = 0;
+        batch_taken_.notify_all();
+        return true;
+    }
+
+    bool appender_decoder_merge::heap_less(uint32_t lhs, uint32_t rhs) const
+    {
+        const source& lhs_src = *sources_[lhs];
+        const source& rhs_src = *sources_[rhs];
+        uint64_t lhs_epoch = lhs_src.current_batch_.epochs[lhs_src.current_entry_idx_];
+        uint64_t rhs_epoch = rhs_src.current_batch_.epochs[rhs_src.current_entry_idx_];
+        return lhs_epoch < rhs_epoch || (lhs_epoch == rhs_epoch && lhs < rhs);
+    }
+
+    void appender_decoder_merge::heap_sift_down(size_t pos)
+    {
+        while (true) {
+            size_t smallest = pos;
+            size_t left = pos * 2 + 1;
+            size_t right = left + 1;
+            if (left < heap_.size() && heap_less(heap_[left], heap_[smallest])) {
+                smallest = left;
+            }
+            if (right < heap_.size() && heap_less(heap_[right], heap_[smallest])) {
+                smallest = right;
+            }
+            if (smallest == pos) {
+                return;
+            }
+            uint32_t tmp = heap_[pos];
+            heap_[pos] = heap_[smallest];
+            heap_[smallest] = tmp;
+            pos = smallest;
+        }
+    }
+
+    void appender_decoder_merge::heap_sift_up(size_t pos)
+    {
+        while (pos > 0) {
+            size_t parent = (pos - 1) / 2;
+            if (!heap_less(heap_[pos], heap_[parent])) {
+                return;
+            }
+            uint32_t tmp = heap_[pos];
+            heap_[pos] = heap_[parent];
+            heap_[parent] = tmp;
+            pos = parent;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+﻿#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+/*!
+ * \class appender_decoder_merge
+ *
+ * Decodes several binary log files into one timeline ordered by log entry epoch.
+ *
+ * Every file is decoded by its own read ahead thread into batches of entries, at most
+ * MERGE_BATCHES_AHEAD batches per file are kept, so memory does not grow with the size of the files.
+ * The calling thread merges the heads of all files with a binary min-heap keyed by (epoch, file index),
+ * entries of the same file keep their file order and entries of the same epoch are taken in file order.
+ * Each entry is prefixed with the tag of its file.
+ */
+#include "bq_common/bq_common.h"
+#include "bq_log/log/decoder/appender_decoder_base.h"
+
+namespace bq {
+    class appender_decoder_merge {
+    public:
+        typedef void (*output_callback)(const char* text, size_t len, void* user_data);
+
+    private:
+        // decoded entries of a file, texts are stored back to back in text.
+        struct entry_batch {
+            bq::string text;
+            bq::array<size_t> text_ends;
+            bq::array<uint64_t> epochs;
+        };
+
+        class source : public bq::platform::thread {
+        public:
+            source(appender_decoder_merge& parent, const bq::string& path, const bq::string& tag, uint32_t index);
+
+        protected:
+            virtual void run() override;
+
+        private:
+            friend class appender_decoder_merge;
+            appender_decoder_merge& parent_;
+            bq::string path_;
+            bq::string tag_;
+            // guarded by parent_.mutex_
+            bq::array<entry_batch> ready_batches_;
+            bool finished_;
+            appender_decode_result result_;
+            // only touched by the merging thread
+            entry_batch current_batch_;
+            size_t current_entry_idx_;
+        };
+
+    public:
+        appender_decoder_merge();
+
+        /// <summary>
+        /// Merge the files, every log entry is written as "[tag] text\n".
+        /// </summary>
+        /// <param name="paths">binary log file paths</param>
+        /// <param name="tags">tag of each file, the same size as paths</param>
+        /// <param name="private_key_str">RSA private key in PEM format, for encrypted logs</param>
+        /// <param name="callback">receives the merged text, called on the calling thread</param>
+        /// <param name="user_data">passed to callback</param>
+        /// <returns>eof if all the files are decoded, otherwise the first error</returns>
+        appender_decode_result decode(const bq::array<bq::string>& paths, const bq::array<bq::string>& tags, const bq::string& private_key_str, output_callback callback, void* user_data);
+
+        /// <summary>
+        /// Only merge log entries matching filter, see appender_decoder_base::set_filter.
+        /// The filter is not copied and must stay alive during decode(), pass nullptr to clear it.
+        /// </summary>
+        void set_filter(const log_decode_filter* filter) { filter_ = filter; }
+
+    private:
+        void source_run(source& src);
+
+        appender_decode_result open_decoder(const bq::string& path, bq::unique_ptr<appender_decoder_base>& out_decoder) const;
+
+        // move src to its next entry, false if it has no more entries.
+        bool next_entry(source& src);
+
+        bool heap_less(uint32_t lhs, uint32_t rhs) const;
+
+        void heap_sift_down(size_t pos);
+
+        void heap_sift_up(size_t pos);
+
+    private:
+        bq::string private_key_str_;
+        const log_decode_filter* filter_;
+        bq::array<bq::unique_ptr<source>> sources_;
+        // indices of the sources with a current entry
+        bq::array<uint32_t> heap_;
+        bq::platform::mutex mutex_;
+        bq::platform::condition_variable batch_ready_;
+        bq::platform::condition_variable batch_taken_;
+        bool aborted_;
+    };
+}
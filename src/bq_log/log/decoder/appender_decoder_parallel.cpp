@@ -0,0 +1,240 @@
+﻿/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "bq_log/log/decoder/appender_decoder_parallel.h"
+#include "bq_log/log/decoder/appender_decoder_manager.h"
+
+namespace bq {
+    static constexpr size_t SEQUENTIAL_OUTPUT_FLUSH_SIZE = 64 * 1024;
+    // how many chunks may be decoded ahead of the writer per worker, bounds the memory held by decoded text.
+    static constexpr size_t CHUNKS_AHEAD_PER_WORKER = 2;
+
+    appender_decoder_parallel::worker::worker(appender_decoder_parallel& parent, uint32_t index)
+        : parent_(parent)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "BqDecoder_%" PRIu32, index);
+        set_thread_name(name);
+    }
+
+    void appender_decoder_parallel::worker::run()
+    {
+        parent_.worker_run();
+    }
+
+    appender_decoder_parallel::appender_decoder_parallel(uint32_t thread_count, size_t chunk_size)
+        : thread_count_(bq::max_value(thread_count, static_cast<uint32_t>(1)))
+        , chunk_size_(bq::max_value(chunk_size, static_cast<size_t>(1)))
+        , filter_(nullptr)
+        , output_format_(log_decode_output_format::text)
+        , mutex_(false)
+        , next_chunk_idx_(0)
+        , written_chunk_count_(0)
+        , aborted_(false)
+    {
+    }
+
+    appender_decode_result appender_decoder_parallel::decode(const bq::string& path, const bq::string& private_key_str, output_callback callback, void* user_data)
+    {
+        path_ = path;
+        private_key_str_ = private_key_str;
+        chunks_.clear();
+        outputs_.clear();
+        next_chunk_idx_ = 0;
+        written_chunk_count_ = 0;
+        aborted_ = false;
+
+        if (thread_count_ == 1) {
+            return decode_sequential(callback, user_data);
+        }
+        appender_decode_result result = split_chunks();
+        if (result != appender_decode_result::success) {
+            return result;
+        }
+        if (chunks_.size() <= 1) {
+            chunks_.clear();
+            return decode_sequential(callback, user_data);
+        }
+
+        outputs_.set_capacity(chunks_.size());
+        for (size_t i = 0; i < chunks_.size(); ++i) {
+            outputs_.push_back(chunk_output());
+        }
+        uint32_t worker_count = static_cast<uint32_t>(bq::min_value(static_cast<size_t>(thread_count_), chunks_.size()));
+        bq::array<bq::unique_ptr<worker>> workers;
+        for (uint32_t i = 0; i < worker_count; ++i) {
+            workers.push_back(bq::make_unique<worker>(*this, i));
+            workers[i]->start();
+        }
+
+        appender_decode_result final_result = appender_decode_result::eof;
+        for (size_t i = 0; i < chunks_.size(); ++i) {
+            bq::string text;
+            appender_decode_result chunk_result;
+            mutex_.lock();
+            while (!outputs_[i].finished) {
+                chunk_finished_.wait(mutex_);
+            }
+            chunk_result = outputs_[i].result;
+            text = bq::move(outputs_[i].text);
+            mutex_.unlock();
+            if (chunk_result != appender_decode_result::success && chunk_result != appender_decode_result::eof) {
+                final_result = chunk_result;
+                break;
+            }
+            if (!text.is_empty()) {
+                callback(text.c_str(), text.size(), user_data);
+            }
+            mutex_.lock();
+            ++written_chunk_count_;
+            chunk_written_.notify_all();
+            mutex_.unlock();
+        }
+
+        mutex_.lock();
+        aborted_ = true;
+        chunk_written_.notify_all();
+        mutex_.unlock();
+        for (auto& worker_inst : workers) {
+            worker_inst->join();
+        }
+        chunks_.clear();
+        outputs_.clear();
+        return final_result;
+    }
+
+    appender_decode_result appender_decoder_parallel::split_chunks()
+    {
+        bq::unique_ptr<appender_decoder_base> decoder;
+        appender_decode_result result = appender_decoder_manager::open_decoder(path_, private_key_str_, decoder);
+        if (result != appender_decode_result::success) {
+            return result;
+        }
+        bq::array<appender_decoder_base::read_position> points;
+        result = decoder->collect_restart_points(points);
+        if (result != appender_decode_result::success) {
+            return result;
+        }
+        chunk_info chunk;
+        chunk.start = points[0];
+        chunk.end_pos = UINT64_MAX;
+        for (size_t i = 1; i < points.size(); ++i) {
+            if (points[i].pos - chunk.start.pos >= static_cast<uint64_t>(chunk_size_)) {
+                chunk.end_pos = points[i].pos;
+                chunks_.push_back(chunk);
+                chunk.start = points[i];
+                chunk.end_pos = UINT64_MAX;
+            }
+        }
+        chunks_.push_back(chunk);
+        return appender_decode_result::success;
+    }
+
+    appender_decode_result appender_decoder_parallel::decode_sequential(output_callback callback, void* user_data)
+    {
+        bq::unique_ptr<appender_decoder_base> decoder;
+        appender_decode_result result = open_decoder(decoder);
+        if (result != appender_decode_result::success) {
+            return result;
+        }
+        if (filter_ && filter_->begin_epoch_ms > 0) {
+            // eof means no log entry is inside the time range.
+            result = decoder->seek_to_time(filter_->begin_epoch_ms);
+            if (result != appender_decode_result::success) {
+                return result;
+            }
+        }
+        bq::string text;
+        while (true) {
+            result = decoder->decode();
+            if (result != appender_decode_result::success) {
+                break;
+            }
+            text += decoder->get_decoded_log_text();
+            text.push_back('\n');
+            if (text.size() >= SEQUENTIAL_OUTPUT_FLUSH_SIZE) {
+                callback(text.c_str(), text.size(), user_data);
+                text.clear();
+            }
+        }
+        if (!text.is_empty()) {
+            callback(text.c_str(), text.size(), user_data);
+        }
+        return result;
+    }
+
+    void appender_decoder_parallel::worker_run()
+    {
+        bq::unique_ptr<appender_decoder_base> decoder;
+        appender_decode_result open_result = open_decoder(decoder);
+        size_t chunk_idx;
+        while (claim_chunk(chunk_idx)) {
+            bq::string text;
+            appender_decode_result result = open_result;
+            if (result == appender_decode_result::success) {
+                result = decode_chunk(*decoder, chunks_[chunk_idx], text);
+            }
+            finish_chunk(chunk_idx, bq::move(text), result);
+        }
+    }
+
+    appender_decode_result appender_decoder_parallel::open_decoder(bq::unique_ptr<appender_decoder_base>& out_decoder) const
+    {
+        appender_decode_result result = appender_decoder_manager::open_decoder(path_, private_key_str_, out_decoder);
+        if (result == appender_decode_result::success && filter_) {
+            out_decoder->set_filter(*filter_);
+        }
+        if (result == appender_decode_result::success) {
+            out_decoder->set_output_format(output_format_);
+        }
+        return result;
+    }
+
+    appender_decode_result appender_decoder_parallel::decode_chunk(appender_decoder_base& decoder, const chunk_info& chunk, bq::string& out_text)
+    {
+        decoder.reset_read_position(chunk.start, chunk.end_pos);
+        while (true) {
+            appender_decode_result result = decoder.decode();
+            if (result == appender_decode_result::eof) {
+                return appender_decode_result::success;
+            }
+            if (result != appender_decode_result::success) {
+                return result;
+            }
+            out_text += decoder.get_decoded_log_text();
+            out_text.push_back('\n');
+        }
+    }
+
+    bool appender_decoder_parallel::claim_chunk(size_t& out_chunk_idx)
+    {
+        bq::platform::scoped_mutex lock(mutex_);
+        while (true) {
+            if (aborted_ || next_chunk_idx_ >= chunks_.size()) {
+                return false;
+            }
+            if (next_chunk_idx_ < written_chunk_count_ + static_cast<size_t>(thread_count_) * CHUNKS_AHEAD_PER_WORKER) {
+                out_chunk_idx = next_chunk_idx_++;
+                return true;
+            }
+            chunk_written_.wait(mutex_);
+        }
+    }
+
+    void appender_decoder_parallel::finish_chunk(size_t chunk_idx, bq::string&& text, appender_decode_result result)
+    {
+        bq::platform::scoped_mutex lock(mutex_);
+        outputs_[chunk_idx].text = bq::move(text);
+        outputs_[chunk_idx].result = result;
+        outputs_[chunk_idx].finished = true;
+        chunk_finished_.notify_all();
+    }
+}
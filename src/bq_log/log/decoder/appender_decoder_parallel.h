@@ -0,0 +1,113 @@
+﻿#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+/*!
+ * \class appender_decoder_parallel
+ *
+ * Decodes a whole binary log file with several worker threads.
+ *
+ * Every normal segment of a binary log is a restart point which does not depend on data
+ * before it (see appender_file_binary.h), and the appender starts one every "seek_index_interval" bytes.
+ * The restart points are collected by walking the segment heads only, then grouped into chunks of
+ * about chunk_size bytes. Worker threads each own a decoder (and so a layout) and decode disjoint chunks.
+ * Texts are handed to the output callback strictly in file order, with a bounded number of chunks
+ * decoded ahead of the writer, so the output is the same as the one produced by a single decoder.
+ */
+#include "bq_common/bq_common.h"
+#include "bq_log/log/decoder/appender_decoder_base.h"
+
+namespace bq {
+    class appender_decoder_parallel {
+    public:
+        typedef void (*output_callback)(const char* text, size_t len, void* user_data);
+
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 4 * 1024 * 1024;
+
+    private:
+        struct chunk_info {
+            appender_decoder_base::read_position start;
+            uint64_t end_pos;
+        };
+
+        struct chunk_output {
+            bq::string text;
+            appender_decode_result result = appender_decode_result::success;
+            bool finished = false;
+        };
+
+        class worker : public bq::platform::thread {
+        public:
+            worker(appender_decoder_parallel& parent, uint32_t index);
+
+        protected:
+            virtual void run() override;
+
+        private:
+            appender_decoder_parallel& parent_;
+        };
+
+    public:
+        appender_decoder_parallel(uint32_t thread_count, size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+        /// <summary>
+        /// Decode the whole file, every log entry is followed by a '\n'.
+        /// </summary>
+        /// <param name="path">binary log file path</param>
+        /// <param name="private_key_str">RSA private key in PEM format, for encrypted logs</param>
+        /// <param name="callback">receives the decoded text in file order, called on the calling thread</param>
+        /// <param name="user_data">passed to callback</param>
+        /// <returns>eof if the whole file is decoded, otherwise the error</returns>
+        appender_decode_result decode(const bq::string& path, const bq::string& private_key_str, output_callback callback, void* user_data);
+
+        /// <summary>
+        /// Only decode log entries matching filter, see appender_decoder_base::set_filter.
+        /// The filter is not copied and must stay alive during decode(), pass nullptr to clear it.
+        /// </summary>
+        void set_filter(const log_decode_filter* filter) { filter_ = filter; }
+
+        /// <summary>
+        /// See appender_decoder_base::set_output_format.
+        /// </summary>
+        void set_output_format(log_decode_output_format format) { output_format_ = format; }
+
+    private:
+        appender_decode_result split_chunks();
+
+        appender_decode_result decode_sequential(output_callback callback, void* user_data);
+
+        void worker_run();
+
+        appender_decode_result open_decoder(bq::unique_ptr<appender_decoder_base>& out_decoder) const;
+
+        appender_decode_result decode_chunk(appender_decoder_base& decoder, const chunk_info& chunk, bq::string& out_text);
+
+        bool claim_chunk(size_t& out_chunk_idx);
+
+        void finish_chunk(size_t chunk_idx, bq::string&& text, appender_decode_result result);
+
+    private:
+        uint32_t thread_count_;
+        size_t chunk_size_;
+        bq::string path_;
+        bq::string private_key_str_;
+        const log_decode_filter* filter_;
+        log_decode_output_format output_format_;
+        bq::array<chunk_info> chunks_;
+        bq::array<chunk_output> outputs_;
+        bq::platform::mutex mutex_;
+        bq::platform::condition_variable chunk_finished_;
+        bq::platform::condition_variable chunk_written_;
+        size_t next_chunk_idx_;
+        size_t written_chunk_count_;
+        bool aborted_;
+    };
+}
@@ -29,12 +29,49 @@ bq::appender_decode_result bq::appender_decoder_raw::decode_private()
         return appender_decode_result::failed_io_error;
     }
     uint32_t item_size = *(const uint32_t*)read_handle.data();
+    if (item_size == appender_file_raw::sync_marker_item_size) {
+        read_handle = read_with_cache(sizeof(appender_file_binary::appender_sync_marker));
+        if (read_handle.len() < sizeof(appender_file_binary::appender_sync_marker) || !appender_file_binary::verify_sync_marker(read_handle.data())) {
+            bq::util::log_device_console(log_level::error, "decode raw log file failed, invalid sync marker");
+            return appender_decode_result::failed_decode_error;
+        }
+        return finish_non_entry_item();
+    }
+    if (item_size < sizeof(bq::_log_entry_head_def)) {
+        bq::util::log_device_console(log_level::error, "decode raw log file failed, invalid item size:%" PRIu32, item_size);
+        return appender_decode_result::failed_decode_error;
+    }
     read_handle = read_with_cache(item_size);
     if (read_handle.len() < (size_t)item_size) {
         bq::util::log_device_console(log_level::error, "decode raw log file failed, read item failed, need read size:%d", item_size);
         return appender_decode_result::failed_io_error;
     }
     bq::log_entry_handle item(read_handle.data(), item_size);
+    const auto& head = item.get_log_head();
+    // a damaged item is found here instead of by the layout, so decoding resyncs at the next sync marker
+    if (head.level > static_cast<decltype(head.level)>(bq::log_level::fatal) || head.category_idx >= category_names_.size()
+        || static_cast<uint64_t>(head.log_format_data_len) + sizeof(bq::_log_entry_head_def) > item_size
+        || static_cast<uint64_t>(head.ext_info_offset) + sizeof(bq::_log_entry_ext_head_def) > item_size) {
+        bq::util::log_device_console(log_level::error, "decode raw log file failed, invalid log entry head");
+        return appender_decode_result::failed_decode_error;
+    }
+    bool matched = true;
+    if (is_filter_enabled()) {
+        uint64_t log_thread_id;
+        memcpy(&log_thread_id, &head.log_thread_id, sizeof(log_thread_id));
+        uint64_t fmt_hash = 0;
+        if (is_format_hash_filtered()) {
+            fmt_hash = head.format_hash ? head.format_hash : bq::util::get_hash_64(item.get_format_string_data(), static_cast<size_t>(head.log_format_data_len));
+        }
+        matched = filter_thread(log_thread_id) && filter_template(static_cast<bq::log_level>(head.level), head.category_idx, fmt_hash);
+    }
+    if (skip_entry(head.timestamp_epoch, matched)) {
+        return appender_decode_result::success;
+    }
+    if (log_template_stats* stats = get_template_stats()) {
+        stats->add(item, static_cast<uint64_t>(item_size) + sizeof(uint32_t));
+        return finish_counted_entry();
+    }
     return do_decode_by_log_entry_handle(item);
 }
 
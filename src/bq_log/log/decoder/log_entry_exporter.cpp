@@ -0,0 +1,660 @@
+﻿/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "bq_log/log/decoder/log_entry_exporter.h"
+#include "bq_log/utils/float_to_string.h"
+#include "bq_log/utils/integer_to_string.h"
+#include "bq_log/utils/log_utils.h"
+
+namespace bq {
+    // -------------------------------------------------------------------------------------------------
+    // find_json_escape
+    // Returns the count of leading bytes which can be copied into a json string as they are,
+    // the byte after them (if any) is '"', '\\' or a control character.
+    // -------------------------------------------------------------------------------------------------
+    bq_forceinline bool _impl_need_json_escape(char c)
+    {
+        return c == '"' || c == '\\' || static_cast<uint8_t>(c) < 0x20;
+    }
+
+    bq_forceinline size_t _impl_find_json_escape_sw(const char* src, size_t len)
+    {
+        for (size_t i = 0; i < len; ++i) {
+            if (_impl_need_json_escape(src[i])) {
+                return i;
+            }
+        }
+        return len;
+    }
+
+#if defined(BQ_X86)
+    BQ_SIMD_HW_INLINE BQ_HW_SIMD_TARGET size_t _impl_find_json_escape_avx2(const char* src, size_t len)
+    {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i control_max = _mm256_set1_epi8(0x1F);
+        size_t i = 0;
+        while (i + 32 <= len) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i is_control = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control_max), control_max);
+            __m256i mask_v = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)), is_control);
+            int32_t mask = _mm256_movemask_epi8(mask_v);
+            if (mask != 0) {
+#if defined(BQ_MSVC)
+                unsigned long index;
+                _BitScanForward(&index, static_cast<unsigned long>(mask));
+                return i + static_cast<size_t>(index);
+#else
+                return i + static_cast<size_t>(__builtin_ctz(static_cast<uint32_t>(mask)));
+#endif
+            }
+            i += 32;
+        }
+        return i + _impl_find_json_escape_sw(src + i, len - i);
+    }
+
+    BQ_SIMD_HW_INLINE BQ_HW_SIMD_SSE_TARGET size_t _impl_find_json_escape_sse(const char* src, size_t len)
+    {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control_max = _mm_set1_epi8(0x1F);
+        size_t i = 0;
+        while (i + 16 <= len) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i is_control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, control_max), control_max);
+            __m128i mask_v = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)), is_control);
+            int32_t mask = _mm_movemask_epi8(mask_v);
+            if (mask != 0) {
+#if defined(BQ_MSVC)
+                unsigned long index;
+                _BitScanForward(&index, static_cast<unsigned long>(mask));
+                return i + static_cast<size_t>(index);
+#else
+                return i + static_cast<size_t>(__builtin_ctz(static_cast<uint32_t>(mask)));
+#endif
+            }
+            i += 16;
+        }
+        return i + _impl_find_json_escape_sw(src + i, len - i);
+    }
+#elif defined(BQ_ARM_NEON)
+    BQ_SIMD_HW_INLINE BQ_HW_SIMD_TARGET size_t _impl_find_json_escape_neon(const char* src, size_t len)
+    {
+        const uint8x16_t quote = vdupq_n_u8('"');
+        const uint8x16_t backslash = vdupq_n_u8('\\');
+        const uint8x16_t control_end = vdupq_n_u8(0x20);
+        size_t i = 0;
+        while (i + 16 <= len) {
+            uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+            uint8x16_t mask_v = vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)), vcltq_u8(chunk, control_end));
+            if (bq_vmaxvq_u8(mask_v) != 0) {
+                break;
+            }
+            i += 16;
+        }
+        return i + _impl_find_json_escape_sw(src + i, len - i);
+    }
+#endif
+
+    bq_forceinline size_t find_json_escape(const char* src, size_t len)
+    {
+#if defined(BQ_X86)
+        if (_bq_avx2_supported_) {
+            return _impl_find_json_escape_avx2(src, len);
+        } else {
+            return _impl_find_json_escape_sse(src, len);
+        }
+#elif defined(BQ_ARM_NEON)
+        return _impl_find_json_escape_neon(src, len);
+#else
+        return _impl_find_json_escape_sw(src, len);
+#endif
+    }
+
+    void log_entry_exporter::do_export(const bq::log_entry_handle& log_entry, log_decode_output_format format, uint64_t format_hash, const bq::array<bq::string>& categories_name, bq::string& out_text)
+    {
+        cursor_ = 0;
+        if (format_hash == 0) {
+            format_hash = bq::util::get_hash_64(log_entry.get_format_string_data(), static_cast<size_t>(log_entry.get_log_head().log_format_data_len));
+        }
+        if (format == log_decode_output_format::csv) {
+            write_csv_record(log_entry, format_hash, categories_name);
+        } else {
+            write_json_record(log_entry, format_hash, categories_name);
+        }
+        out_text.insert_batch(out_text.end(), buffer_.begin(), cursor_);
+        if (buffer_.size() > 64 * 1024) {
+            buffer_.clear();
+            buffer_.set_capacity(1024, true);
+        }
+    }
+
+    void log_entry_exporter::write_json_record(const bq::log_entry_handle& log_entry, uint64_t format_hash, const bq::array<bq::string>& categories_name)
+    {
+        const auto& head = log_entry.get_log_head();
+        uint64_t thread_id;
+        memcpy(&thread_id, &head.log_thread_id, sizeof(thread_id));
+        const auto& ext_head = log_entry.get_ext_head();
+        const char* thread_name = reinterpret_cast<const char*>(&ext_head) + sizeof(_log_entry_ext_head_def);
+
+        write_raw("{\"epoch_ms\":", 12);
+        write_uint64(head.timestamp_epoch);
+        write_raw(",\"level\":\"", 10);
+        const char* level_name = log_utils::get_level_name(static_cast<bq::log_level>(head.level));
+        write_raw(level_name, strlen(level_name));
+        write_raw("\",\"category\":", 13);
+        if (head.category_idx < categories_name.size()) {
+            write_json_string(categories_name[head.category_idx].c_str(), categories_name[head.category_idx].size());
+        } else {
+            write_raw("null", 4);
+        }
+        write_raw(",\"thread_id\":", 13);
+        write_uint64(thread_id);
+        write_raw(",\"thread_name\":", 15);
+        write_json_string(thread_name, ext_head.thread_name_len_);
+        write_raw(",\"format_hash\":\"0x", 18);
+        write_hex64(format_hash);
+        write_raw("\",\"format\":\"", 12);
+        write_format_string(log_entry);
+        write_raw("\",\"args\":", 9);
+        write_args(log_entry);
+        write_raw("}", 1);
+    }
+
+    void log_entry_exporter::write_csv_record(const bq::log_entry_handle& log_entry, uint64_t format_hash, const bq::array<bq::string>& categories_name)
+    {
+        const auto& head = log_entry.get_log_head();
+        uint64_t thread_id;
+        memcpy(&thread_id, &head.log_thread_id, sizeof(thread_id));
+        const auto& ext_head = log_entry.get_ext_head();
+        const char* thread_name = reinterpret_cast<const char*>(&ext_head) + sizeof(_log_entry_ext_head_def);
+
+        write_uint64(head.timestamp_epoch);
+        write_raw(",", 1);
+        const char* level_name = log_utils::get_level_name(static_cast<bq::log_level>(head.level));
+        write_raw(level_name, strlen(level_name));
+        write_raw(",", 1);
+        size_t field_begin = cursor_;
+        if (head.category_idx < categories_name.size()) {
+            write_raw(categories_name[head.category_idx].c_str(), categories_name[head.category_idx].size());
+        }
+        quote_csv_field(field_begin);
+        write_raw(",", 1);
+        write_uint64(thread_id);
+        write_raw(",", 1);
+        field_begin = cursor_;
+        write_raw(thread_name, ext_head.thread_name_len_);
+        quote_csv_field(field_begin);
+        write_raw(",0x", 3);
+        write_hex64(format_hash);
+        write_raw(",", 1);
+        // the format string as a json string body, so that line breaks and control characters stay on one line
+        field_begin = cursor_;
+        write_format_string(log_entry);
+        quote_csv_field(field_begin);
+        write_raw(",", 1);
+        field_begin = cursor_;
+        write_args(log_entry);
+        quote_csv_field(field_begin);
+    }
+
+    void log_entry_exporter::write_format_string(const bq::log_entry_handle& log_entry)
+    {
+        const auto& head = log_entry.get_log_head();
+        if (head.log_format_str_type == static_cast<uint8_t>(log_arg_type_enum::string_utf16_type)) {
+            write_json_string_utf16(log_entry.get_format_string_data(), head.log_format_data_len);
+        } else {
+            write_json_escaped(log_entry.get_format_string_data(), head.log_format_data_len);
+        }
+    }
+
+    void log_entry_exporter::write_args(const bq::log_entry_handle& log_entry)
+    {
+        const uint8_t* args_data_ptr = log_entry.get_log_args_data();
+        const uint32_t args_data_len = log_entry.get_log_args_data_size();
+        uint32_t cursor = 0;
+        bool first = true;
+        write_raw("[", 1);
+        // every argument starts with its type at a 4 bytes aligned offset, the same layout layout::python_style_format_content reads
+        while (cursor + 4 <= args_data_len) {
+            const uint8_t* arg_ptr = args_data_ptr + cursor;
+            auto type_info = static_cast<bq::log_arg_type_enum>(*arg_ptr);
+            const char* type_name = nullptr;
+            switch (type_info) {
+            case bq::log_arg_type_enum::null_type:
+                type_name = "null";
+                break;
+            case bq::log_arg_type_enum::pointer_type:
+                type_name = "pointer";
+                break;
+            case bq::log_arg_type_enum::bool_type:
+                type_name = "bool";
+                break;
+            case bq::log_arg_type_enum::char_type:
+                type_name = "char";
+                break;
+            case bq::log_arg_type_enum::char16_type:
+                type_name = "char16";
+                break;
+            case bq::log_arg_type_enum::char32_type:
+                type_name = "char32";
+                break;
+            case bq::log_arg_type_enum::int8_type:
+                type_name = "int8";
+                break;
+            case bq::log_arg_type_enum::uint8_type:
+                type_name = "uint8";
+                break;
+            case bq::log_arg_type_enum::int16_type:
+                type_name = "int16";
+                break;
+            case bq::log_arg_type_enum::uint16_type:
+                type_name = "uint16";
+                break;
+            case bq::log_arg_type_enum::int32_type:
+                type_name = "int32";
+                break;
+            case bq::log_arg_type_enum::uint32_type:
+                type_name = "uint32";
+                break;
+            case bq::log_arg_type_enum::int64_type:
+                type_name = "int64";
+                break;
+            case bq::log_arg_type_enum::uint64_type:
+                type_name = "uint64";
+                break;
+            case bq::log_arg_type_enum::float_type:
+                type_name = "float";
+                break;
+            case bq::log_arg_type_enum::double_type:
+                type_name = "double";
+                break;
+            case bq::log_arg_type_enum::string_utf8_type:
+            case bq::log_arg_type_enum::string_utf16_type:
+                type_name = "string";
+                break;
+            default:
+                break;
+            }
+            if (!type_name) {
+                // unknown data, the size of the argument can't be known either
+                bq::util::log_device_console(bq::log_level::warning, "export log entry: unsupported argument type:%d", static_cast<int32_t>(type_info));
+                break;
+            }
+            if (!first) {
+                write_raw(",", 1);
+            }
+            first = false;
+            write_raw("{\"type\":\"", 9);
+            write_raw(type_name, strlen(type_name));
+            write_raw("\",\"value\":", 10);
+            switch (type_info) {
+            case bq::log_arg_type_enum::null_type:
+                write_raw("null", 4);
+                cursor += 4;
+                break;
+            case bq::log_arg_type_enum::pointer_type: {
+                uint64_t value;
+                memcpy(&value, arg_ptr + 4, sizeof(value));
+                write_raw("\"0x", 3);
+                write_hex64(value);
+                write_raw("\"", 1);
+                cursor += static_cast<uint32_t>(4 + sizeof(uint64_t));
+            } break;
+            case bq::log_arg_type_enum::bool_type:
+                if (*reinterpret_cast<const bool*>(arg_ptr + 2)) {
+                    write_raw("true", 4);
+                } else {
+                    write_raw("false", 5);
+                }
+                cursor += 4;
+                break;
+            case bq::log_arg_type_enum::char_type:
+                write_raw("\"", 1);
+                write_char32(static_cast<char32_t>(*reinterpret_cast<const uint8_t*>(arg_ptr + 2)));
+                write_raw("\"", 1);
+                cursor += 4;
+                break;
+            case bq::log_arg_type_enum::char16_type: {
+                char16_t value;
+                memcpy(&value, arg_ptr + 2, sizeof(value));
+                write_raw("\"", 1);
+                write_char32(static_cast<char32_t>(value));
+                write_raw("\"", 1);
+                cursor += 4;
+            } break;
+            case bq::log_arg_type_enum::char32_type: {
+                char32_t value;
+                memcpy(&value, arg_ptr + 4, sizeof(value));
+                write_raw("\"", 1);
+                write_char32(value);
+                write_raw("\"", 1);
+                cursor += 8;
+            } break;
+            case bq::log_arg_type_enum::int8_type:
+                write_int64(*reinterpret_cast<const int8_t*>(arg_ptr + 2));
+                cursor += 4;
+                break;
+            case bq::log_arg_type_enum::uint8_type:
+                write_uint64(*reinterpret_cast<const uint8_t*>(arg_ptr + 2));
+                cursor += 4;
+                break;
+            case bq::log_arg_type_enum::int16_type: {
+                int16_t value;
+                memcpy(&value, arg_ptr + 2, sizeof(value));
+                write_int64(value);
+                cursor += 4;
+            } break;
+            case bq::log_arg_type_enum::uint16_type: {
+                uint16_t value;
+                memcpy(&value, arg_ptr + 2, sizeof(value));
+                write_uint64(value);
+                cursor += 4;
+            } break;
+            case bq::log_arg_type_enum::int32_type: {
+                int32_t value;
+                memcpy(&value, arg_ptr + 4, sizeof(value));
+                write_int64(value);
+                cursor += 8;
+            } break;
+            case bq::log_arg_type_enum::uint32_type: {
+                uint32_t value;
+                memcpy(&value, arg_ptr + 4, sizeof(value));
+                write_uint64(value);
+                cursor += 8;
+            } break;
+            case bq::log_arg_type_enum::int64_type: {
+                int64_t value;
+                memcpy(&value, arg_ptr + 4, sizeof(value));
+                write_int64(value);
+                cursor += 12;
+            } break;
+            case bq::log_arg_type_enum::uint64_type: {
+                uint64_t value;
+                memcpy(&value, arg_ptr + 4, sizeof(value));
+                write_uint64(value);
+                cursor += 12;
+            } break;
+            case bq::log_arg_type_enum::float_type: {
+                float value;
+                memcpy(&value, arg_ptr + 4, sizeof(value));
+                write_decimal(value);
+                cursor += static_cast<uint32_t>(4 + sizeof(float));
+            } break;
+            case bq::log_arg_type_enum::double_type: {
+                double value;
+                memcpy(&value, arg_ptr + 4, sizeof(value));
+                write_decimal(value);
+                cursor += static_cast<uint32_t>(4 + sizeof(double));
+            } break;
+            case bq::log_arg_type_enum::string_utf8_type:
+            case bq::log_arg_type_enum::string_utf16_type: {
+                uint32_t str_len;
+                memcpy(&str_len, arg_ptr + 4, sizeof(str_len));
+                const char* str = reinterpret_cast<const char*>(arg_ptr + 4 + sizeof(uint32_t));
+                if (type_info == bq::log_arg_type_enum::string_utf8_type) {
+                    write_json_string(str, str_len);
+                } else {
+                    write_raw("\"", 1);
+                    write_json_string_utf16(str, str_len);
+                    write_raw("\"", 1);
+                }
+                cursor += static_cast<uint32_t>(4U + sizeof(uint32_t) + bq::align_4(str_len));
+            } break;
+            default:
+                break;
+            }
+            write_raw("}", 1);
+        }
+        write_raw("]", 1);
+    }
+
+    bq_forceinline char* log_entry_exporter::reserve(size_t size)
+    {
+        if (cursor_ + size > buffer_.size()) {
+            buffer_.fill_uninitialized(bq::max_value(cursor_ + size - buffer_.size(), buffer_.size()));
+        }
+        return buffer_.begin() + static_cast<ptrdiff_t>(cursor_);
+    }
+
+    bq_forceinline void log_entry_exporter::write_raw(const char* str, size_t len)
+    {
+        memcpy(reserve(len), str, len);
+        cursor_ += len;
+    }
+
+    void log_entry_exporter::write_json_escaped(const char* str, size_t len)
+    {
+        static const char hex_digits[] = "0123456789abcdef";
+        // escaping makes a byte 6 bytes long at most
+        reserve(len * 6);
+        while (len > 0) {
+            size_t plain_len = find_json_escape(str, len);
+            memcpy(buffer_.begin() + static_cast<ptrdiff_t>(cursor_), str, plain_len);
+            cursor_ += plain_len;
+            if (plain_len == len) {
+                break;
+            }
+            char c = str[plain_len];
+            char* dst = buffer_.begin() + static_cast<ptrdiff_t>(cursor_);
+            dst[0] = '\\';
+            switch (c) {
+            case '"':
+            case '\\':
+                dst[1] = c;
+                cursor_ += 2;
+                break;
+            case '\n':
+                dst[1] = 'n';
+                cursor_ += 2;
+                break;
+            case '\r':
+                dst[1] = 'r';
+                cursor_ += 2;
+                break;
+            case '\t':
+                dst[1] = 't';
+                cursor_ += 2;
+                break;
+            default:
+                dst[1] = 'u';
+                dst[2] = '0';
+                dst[3] = '0';
+                dst[4] = hex_digits[(static_cast<uint8_t>(c) >> 4) & 0xF];
+                dst[5] = hex_digits[static_cast<uint8_t>(c) & 0xF];
+                cursor_ += 6;
+                break;
+            }
+            str += plain_len + 1;
+            len -= plain_len + 1;
+        }
+    }
+
+    void log_entry_exporter::write_json_string(const char* str, size_t len)
+    {
+        write_raw("\"", 1);
+        write_json_escaped(str, len);
+        write_raw("\"", 1);
+    }
+
+    void log_entry_exporter::write_json_string_utf16(const char* str, size_t byte_len)
+    {
+        uint32_t char_count = static_cast<uint32_t>(byte_len / sizeof(char16_t));
+        utf8_tmp_.clear();
+        utf8_tmp_.fill_uninitialized(static_cast<size_t>(char_count) * 3 + 1);
+        // the string may not be aligned in the entry
+        bq::array<char16_t> utf16_tmp;
+        utf16_tmp.fill_uninitialized(char_count);
+        if (char_count > 0) {
+            memcpy(utf16_tmp.begin(), str, static_cast<size_t>(char_count) * sizeof(char16_t));
+        }
+        uint32_t utf8_len = bq::util::utf16_to_utf8(utf16_tmp.begin(), char_count, utf8_tmp_.begin(), static_cast<uint32_t>(utf8_tmp_.size()));
+        write_json_escaped(utf8_tmp_.begin(), utf8_len);
+    }
+
+    void log_entry_exporter::write_char32(char32_t value)
+    {
+        char utf8[4];
+        size_t len;
+        uint32_t code = static_cast<uint32_t>(value);
+        if (code < 0x80) {
+            utf8[0] = static_cast<char>(code);
+            len = 1;
+        } else if (code < 0x800) {
+            utf8[0] = static_cast<char>(0xC0 | (code >> 6));
+            utf8[1] = static_cast<char>(0x80 | (code & 0x3F));
+            len = 2;
+        } else if (code < 0x10000) {
+            utf8[0] = static_cast<char>(0xE0 | (code >> 12));
+            utf8[1] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            utf8[2] = static_cast<char>(0x80 | (code & 0x3F));
+            len = 3;
+        } else {
+            utf8[0] = static_cast<char>(0xF0 | ((code >> 18) & 0x07));
+            utf8[1] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            utf8[2] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            utf8[3] = static_cast<char>(0x80 | (code & 0x3F));
+            len = 4;
+        }
+        write_json_escaped(utf8, len);
+    }
+
+    void log_entry_exporter::write_uint64(uint64_t value)
+    {
+        const uint32_t len = integer_to_string::count_decimal_digits(value);
+        char* dst = reserve(len);
+        integer_to_string::write_decimal_digits(dst + len, value);
+        cursor_ += len;
+    }
+
+    void log_entry_exporter::write_int64(int64_t value)
+    {
+        if (value < 0) {
+            write_raw("-", 1);
+            write_uint64(static_cast<uint64_t>(0) - static_cast<uint64_t>(value));
+        } else {
+            write_uint64(static_cast<uint64_t>(value));
+        }
+    }
+
+    void log_entry_exporter::write_hex64(uint64_t value)
+    {
+        static const char hex_digits[] = "0123456789abcdef";
+        char* dst = reserve(16);
+        for (int32_t i = 15; i >= 0; --i) {
+            dst[i] = hex_digits[value & 0xF];
+            value >>= 4;
+        }
+        cursor_ += 16;
+    }
+
+    template <typename FLOAT_TYPE>
+    void log_entry_exporter::write_decimal_impl(FLOAT_TYPE value)
+    {
+        // json has no literal for them
+        if (value != value) {
+            write_raw("\"nan\"", 5);
+            return;
+        }
+        if (value - value != value - value) {
+            if (value < 0) {
+                write_raw("\"-inf\"", 6);
+            } else {
+                write_raw("\"inf\"", 5);
+            }
+            return;
+        }
+        if (value == static_cast<FLOAT_TYPE>(0)) {
+            write_raw("0", 1);
+            return;
+        }
+        if (value < 0) {
+            write_raw("-", 1);
+            value = -value;
+        }
+        char digits[float_to_string::MAX_SHORTEST_DIGITS];
+        int32_t point_pos = 0;
+        uint32_t digits_count = float_to_string::shortest(value, digits, point_pos);
+        // shortest digits, plain notation unless the exponent is large
+        char* dst = reserve(digits_count + 32);
+        size_t len = 0;
+        if (point_pos > 0 && point_pos <= 21) {
+            for (int32_t i = 0; i < point_pos; ++i) {
+                dst[len++] = (static_cast<uint32_t>(i) < digits_count) ? digits[i] : '0';
+            }
+            if (static_cast<uint32_t>(point_pos) < digits_count) {
+                dst[len++] = '.';
+                for (uint32_t i = static_cast<uint32_t>(point_pos); i < digits_count; ++i) {
+                    dst[len++] = digits[i];
+                }
+            }
+        } else if (point_pos <= 0 && point_pos > -6) {
+            dst[len++] = '0';
+            dst[len++] = '.';
+            for (int32_t i = point_pos; i < 0; ++i) {
+                dst[len++] = '0';
+            }
+            for (uint32_t i = 0; i < digits_count; ++i) {
+                dst[len++] = digits[i];
+            }
+        } else {
+            dst[len++] = digits[0];
+            if (digits_count > 1) {
+                dst[len++] = '.';
+                for (uint32_t i = 1; i < digits_count; ++i) {
+                    dst[len++] = digits[i];
+                }
+            }
+            len += static_cast<size_t>(snprintf(dst + len, 16, "e%" PRId32, point_pos - 1));
+        }
+        cursor_ += len;
+    }
+
+    void log_entry_exporter::write_decimal(float value)
+    {
+        write_decimal_impl(value);
+    }
+
+    void log_entry_exporter::write_decimal(double value)
+    {
+        write_decimal_impl(value);
+    }
+
+    void log_entry_exporter::quote_csv_field(size_t begin)
+    {
+        size_t len = cursor_ - begin;
+        size_t quote_count = 0;
+        const char* scan = buffer_.begin() + static_cast<ptrdiff_t>(begin);
+        const char* scan_end = scan + len;
+        while ((scan = static_cast<const char*>(memchr(scan, '"', static_cast<size_t>(scan_end - scan)))) != nullptr) {
+            ++quote_count;
+            ++scan;
+        }
+        reserve(quote_count + 2);
+        char* field = buffer_.begin() + static_cast<ptrdiff_t>(begin);
+        if (quote_count == 0) {
+            memmove(field + 1, field, len);
+        } else {
+            // from the end, so nothing is overwritten before it is moved
+            char* dst = field + len + quote_count;
+            for (size_t i = len; i > 0; --i) {
+                char c = field[i - 1];
+                *dst-- = c;
+                if (c == '"') {
+                    *dst-- = '"';
+                }
+            }
+        }
+        field[0] = '"';
+        field[len + quote_count + 1] = '"';
+        cursor_ += quote_count + 2;
+    }
+}
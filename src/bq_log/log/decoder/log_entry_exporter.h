@@ -0,0 +1,89 @@
+﻿#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+/*!
+ * \class log_entry_exporter
+ *
+ * Writes a decoded log entry as a structured record instead of formatted text,
+ * so the arguments keep the types they were serialized with (log_arg_type_enum).
+ *
+ * json_lines, one object per line:
+ *   {"epoch_ms":1735689600123,"level":"info","category":"ModuleA","thread_id":1234,"thread_name":"main",
+ *    "format_hash":"0x9f0c...","format":"value {} of {}","args":[{"type":"int32","value":3},{"type":"string","value":"x"}]}
+ * csv, one row per line with the columns of CSV_HEADER, "args" holds the same json array.
+ *
+ * format_hash is the one accepted by log_decode_filter::format_hashes.
+ */
+#include "bq_common/bq_common.h"
+#include "bq_log/misc/bq_log_def.h"
+#include "bq_log/log/log_types.h"
+
+namespace bq {
+    class log_entry_exporter {
+    public:
+        // column names of the csv format, without line break
+        static constexpr const char* CSV_HEADER = "epoch_ms,level,category,thread_id,thread_name,format_hash,format,args";
+
+    public:
+        /// <summary>
+        /// Append the record of log_entry to out_text, without line break.
+        /// </summary>
+        /// <param name="format">json_lines or csv</param>
+        /// <param name="format_hash">hash of the format string, computed from the entry if 0</param>
+        void do_export(const bq::log_entry_handle& log_entry, log_decode_output_format format, uint64_t format_hash, const bq::array<bq::string>& categories_name, bq::string& out_text);
+
+    private:
+        void write_json_record(const bq::log_entry_handle& log_entry, uint64_t format_hash, const bq::array<bq::string>& categories_name);
+
+        void write_csv_record(const bq::log_entry_handle& log_entry, uint64_t format_hash, const bq::array<bq::string>& categories_name);
+
+        // the json array of the arguments
+        void write_args(const bq::log_entry_handle& log_entry);
+
+        void write_format_string(const bq::log_entry_handle& log_entry);
+
+        bq_forceinline char* reserve(size_t size);
+
+        bq_forceinline void write_raw(const char* str, size_t len);
+
+        // without quotes
+        void write_json_escaped(const char* str, size_t len);
+
+        void write_json_string(const char* str, size_t len);
+
+        void write_json_string_utf16(const char* str, size_t byte_len);
+
+        void write_char32(char32_t value);
+
+        void write_uint64(uint64_t value);
+
+        void write_int64(int64_t value);
+
+        void write_hex64(uint64_t value);
+
+        // shortest digits which round trip
+        void write_decimal(float value);
+
+        void write_decimal(double value);
+
+        template <typename FLOAT_TYPE>
+        void write_decimal_impl(FLOAT_TYPE value);
+
+        // quotes buffer_[begin, cursor_) as a csv field, doubling the quotes in it
+        void quote_csv_field(size_t begin);
+
+    private:
+        bq::array<char> buffer_;
+        size_t cursor_ = 0;
+        bq::array<char> utf8_tmp_;
+    };
+}
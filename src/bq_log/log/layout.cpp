@@ -1,4 +1,4 @@
-/*
+﻿/*
  * Copyright (C) 2025 Tencent.
  * BQLOG is licensed under the Apache License, Version 2.0.
  * You may obtain a copy of the License at
@@ -15,6 +15,8 @@
 
 #include "bq_log/global/log_vars.h"
 #include "bq_log/utils/log_utils.h"
+#include "bq_log/utils/float_to_string.h"
+#include "bq_log/utils/integer_to_string.h"
 
 namespace bq {
 
@@ -316,6 +318,159 @@ namespace bq {
 #endif
     }
 
+    // -------------------------------------------------------------------------------------------------
+    // Integer digits
+    // Decimal digits come from integer_to_string. Hex digits of a whole uint64 are produced at once by
+    // splitting bytes into nibbles and looking them up with a byte shuffle (pshufb / tbl).
+    // -------------------------------------------------------------------------------------------------
+    static constexpr char HEX_DIGITS_LOWER[] = "0123456789abcdef";
+    static constexpr char HEX_DIGITS_UPPER[] = "0123456789ABCDEF";
+
+    bq_forceinline uint32_t _impl_count_hex_digits(uint64_t value)
+    {
+        uint32_t count = 1;
+        while (count < 16 && (value >> (count * 4)) != 0) {
+            ++count;
+        }
+        return count;
+    }
+
+    // all 16 hex digits of value, most significant first
+    bq_forceinline void _impl_write_hex_16_sw(uint64_t value, const char* table, char* dst)
+    {
+        for (int32_t i = 15; i >= 0; --i) {
+            dst[i] = table[value & 0xF];
+            value >>= 4;
+        }
+    }
+
+#if defined(BQ_X86)
+    BQ_SIMD_HW_INLINE BQ_HW_SIMD_SSE_TARGET void _impl_write_hex_16_sse(uint64_t value, const char* table, char* dst)
+    {
+        // reverse the bytes so the most significant one comes first (x86 is little endian)
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&value));
+        bytes = _mm_shuffle_epi8(bytes, _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, -1, -1, -1, -1, -1, -1, -1, -1));
+        const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+        const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask);
+        const __m128i low = _mm_and_si128(bytes, nibble_mask);
+        const __m128i nibbles = _mm_unpacklo_epi8(high, low);
+        const __m128i digits = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table)), nibbles);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), digits);
+    }
+#elif defined(BQ_ARM_NEON) && defined(BQ_ARM_64)
+    BQ_SIMD_HW_INLINE BQ_HW_SIMD_TARGET void _impl_write_hex_16_neon(uint64_t value, const char* table, char* dst)
+    {
+        uint8x8_t bytes = vrev64_u8(vcreate_u8(value));
+        const uint8x8_t high = vshr_n_u8(bytes, 4);
+        const uint8x8_t low = vand_u8(bytes, vdup_n_u8(0x0F));
+        const uint8x8x2_t zipped = vzip_u8(high, low);
+        const uint8x16_t nibbles = vcombine_u8(zipped.val[0], zipped.val[1]);
+        const uint8x16_t digits = vqtbl1q_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(table)), nibbles);
+        vst1q_u8(reinterpret_cast<uint8_t*>(dst), digits);
+    }
+#endif
+
+    bq_forceinline void write_hex_16(uint64_t value, const char* table, char* dst)
+    {
+#if defined(BQ_X86)
+        _impl_write_hex_16_sse(value, table, dst);
+#elif defined(BQ_ARM_NEON) && defined(BQ_ARM_64)
+        _impl_write_hex_16_neon(value, table, dst);
+#else
+        _impl_write_hex_16_sw(value, table, dst);
+#endif
+    }
+
+    layout_pattern::layout_pattern()
+        : id_(0)
+    {
+    }
+
+    void layout_pattern::clear()
+    {
+        ops_.clear();
+        literals_.clear();
+        id_ = 0;
+    }
+
+    bool layout_pattern::compile(const bq::string& pattern_str)
+    {
+        clear();
+        bool has_message = false;
+        auto add_literal = [this](const char* str, uint32_t len) {
+            // adjacent literals are merged, so the output loop never handles two in a row
+            if (!ops_.is_empty() && ops_[ops_.size() - 1].type == op_type::literal) {
+                ops_[ops_.size() - 1].literal_len += len;
+            } else {
+                op literal_op = { op_type::literal, static_cast<uint32_t>(literals_.size()), len };
+                ops_.push_back(literal_op);
+            }
+            literals_.insert_batch(literals_.end(), str, len);
+        };
+        for (size_t i = 0; i < pattern_str.size(); ++i) {
+            char c = pattern_str[i];
+            if (c != '%') {
+                add_literal(&c, 1);
+                continue;
+            }
+            if (i + 1 >= pattern_str.size()) {
+                bq::util::log_device_console(log_level::error, "layout_pattern \"%s\" ends with a single '%%'", pattern_str.c_str());
+                clear();
+                return false;
+            }
+            op_type type = op_type::literal;
+            switch (pattern_str[++i]) {
+            case '%':
+                add_literal("%", 1);
+                continue;
+            case 'Z':
+                type = op_type::time_zone;
+                break;
+            case 'D':
+                type = op_type::date;
+                break;
+            case 'T':
+                type = op_type::time_of_day;
+                break;
+            case 'u':
+                type = op_type::millisecond;
+                break;
+            case 'E':
+                type = op_type::epoch_ms;
+                break;
+            case 'L':
+                type = op_type::level;
+                break;
+            case 't':
+                type = op_type::thread_id;
+                break;
+            case 'n':
+                type = op_type::thread_name;
+                break;
+            case 'c':
+                type = op_type::category;
+                break;
+            case 'm':
+                type = op_type::message;
+                has_message = true;
+                break;
+            default:
+                bq::util::log_device_console(log_level::error, "layout_pattern \"%s\" has unknown specifier \"%%%c\"", pattern_str.c_str(), pattern_str[i]);
+                clear();
+                return false;
+            }
+            op field_op = { type, 0, 0 };
+            ops_.push_back(field_op);
+        }
+        if (!has_message) {
+            op message_op = { op_type::message, 0, 0 };
+            ops_.push_back(message_op);
+        }
+        id_ = bq::util::get_hash_64(pattern_str.c_str(), pattern_str.size());
+        id_ = (id_ == 0) ? 1 : id_;
+        return true;
+    }
+
     layout::layout()
         : time_zone_ptr_(nullptr)
         , categories_name_array_ptr_(nullptr)
@@ -324,12 +479,15 @@ namespace bq {
         thread_names_cache_.set_expand_rate(4);
     }
 
-    layout::enum_layout_result layout::do_layout(const bq::log_entry_handle& log_entry, time_zone& input_time_zone, const bq::array<bq::string>* categories_name_array_ptr)
+    layout::enum_layout_result layout::do_layout(const bq::log_entry_handle& log_entry, time_zone& input_time_zone, const bq::array<bq::string>* categories_name_array_ptr, const layout_pattern* pattern /* = nullptr */)
     {
         time_zone_ptr_ = &input_time_zone;
         categories_name_array_ptr_ = categories_name_array_ptr;
         format_content_cursor = 0;
         expand_format_content_buff_size(1024);
+        if (pattern && !pattern->is_empty()) {
+            return layout_by_pattern(log_entry, *pattern);
+        }
         auto result = layout_prefix(log_entry);
         if (result != enum_layout_result::finished) {
             return result;
@@ -393,6 +551,67 @@ namespace bq {
         return enum_layout_result::finished;
     }
 
+    layout::enum_layout_result layout::layout_by_pattern(const bq::log_entry_handle& log_entry, const layout_pattern& pattern)
+    {
+        const auto& head = log_entry.get_log_head();
+        auto level = log_entry.get_level();
+        if (level < log_level::verbose || level > log_level::fatal) {
+            bq::util::log_device_console(log_level::error, "layout_by_pattern error, log_level %" PRId32 ", maybe header file or struct mismatch in include", static_cast<int32_t>(level));
+            return enum_layout_result::parse_error;
+        }
+        if (head.category_idx >= categories_name_array_ptr_->size()) {
+            bq::util::log_device_console(log_level::error, "layout_by_pattern error, category %d, maybe header file or struct mismatch in include", head.category_idx);
+            return enum_layout_result::parse_error;
+        }
+        const uint64_t epoch_ms = head.timestamp_epoch;
+        time_zone_ptr_->refresh_time_string_cache(epoch_ms);
+
+        for (const auto& op : pattern.get_ops()) {
+            switch (op.type) {
+            case layout_pattern::op_type::literal:
+                insert_str_utf8(pattern.get_literal(op), op.literal_len);
+                break;
+            case layout_pattern::op_type::time_zone:
+                insert_str_utf8(time_zone_ptr_->get_time_zone_str().c_str(), static_cast<uint32_t>(time_zone_ptr_->get_time_zone_str().size()));
+                break;
+            case layout_pattern::op_type::date:
+                insert_str_utf8(time_zone_ptr_->get_date_string_cache(), static_cast<uint32_t>(time_zone_ptr_->get_date_string_cache_len()));
+                break;
+            case layout_pattern::op_type::time_of_day:
+                insert_str_utf8(time_zone_ptr_->get_time_of_day_string_cache(), time_zone::TIME_OF_DAY_STR_LEN);
+                break;
+            case layout_pattern::op_type::millisecond:
+                insert_str_utf8(&log_global_vars::get().digit3_array[(epoch_ms % 1000) * 3], 3);
+                break;
+            case layout_pattern::op_type::epoch_ms:
+            case layout_pattern::op_type::thread_id: {
+                const uint64_t value = (op.type == layout_pattern::op_type::epoch_ms) ? epoch_ms : head.log_thread_id;
+                const uint32_t digits_count = integer_to_string::count_decimal_digits(value);
+                expand_format_content_buff_size(format_content_cursor + digits_count);
+                integer_to_string::write_decimal_digits(&format_content[format_content_cursor] + digits_count, value);
+                format_content_cursor += digits_count;
+            } break;
+            case layout_pattern::op_type::level:
+                insert_char(log_global_vars::get().log_level_str_[static_cast<int32_t>(level)][1]);
+                break;
+            case layout_pattern::op_type::thread_name: {
+                const auto& ext_info = log_entry.get_ext_head();
+                insert_str_utf8((const char*)&ext_info + sizeof(_log_entry_ext_head_def), ext_info.thread_name_len_);
+            } break;
+            case layout_pattern::op_type::category: {
+                const bq::string& category_str = (*categories_name_array_ptr_)[head.category_idx];
+                insert_str_utf8(category_str.c_str(), static_cast<uint32_t>(category_str.size()));
+            } break;
+            case layout_pattern::op_type::message:
+                python_style_format_content(log_entry);
+                break;
+            }
+        }
+        expand_format_content_buff_size(format_content_cursor + 1);
+        format_content[format_content_cursor] = '\0';
+        return enum_layout_result::finished;
+    }
+
     bq::layout::enum_layout_result layout::insert_thread_info(const bq::log_entry_handle& log_entry)
     {
         const auto& ext_info = log_entry.get_ext_head();
@@ -1136,7 +1355,14 @@ namespace bq {
             expand_format_content_buff_size(format_content_cursor + len);
             memcpy(&format_content[format_content_cursor], "0x", len);
             format_content_cursor += len;
-            insert_integral_unsigned((uint64_t)ptr, 16);
+            // never padded on its own, the whole "0x..." is aligned by fill_and_alignment
+            const uint64_t value = (uint64_t)ptr;
+            const uint32_t digits_count = _impl_count_hex_digits(value);
+            char hex[16];
+            write_hex_16(value, format_info_.upper ? HEX_DIGITS_UPPER : HEX_DIGITS_LOWER, hex);
+            expand_format_content_buff_size(format_content_cursor + digits_count);
+            memcpy(&format_content[format_content_cursor], hex + 16 - digits_count, digits_count);
+            format_content_cursor += digits_count;
         } else {
             uint32_t len = (uint32_t)sizeof("null") - 1;
             expand_format_content_buff_size(format_content_cursor + len);
@@ -1186,6 +1412,19 @@ namespace bq {
     }
 
     uint32_t layout::insert_integral_unsigned(uint64_t value, uint32_t base /* = 10 */)
+    {
+        const char sign_char = (value > 0 && format_info_.sign == '+') ? '+' : '\0';
+        return insert_integral(value, sign_char, base);
+    }
+
+    uint32_t layout::insert_integral_signed(int64_t value, uint32_t base /* = 10 */)
+    {
+        const uint64_t abs_value = (value < 0) ? (0 - static_cast<uint64_t>(value)) : static_cast<uint64_t>(value);
+        const char sign_char = (value < 0) ? '-' : (format_info_.sign == '+' ? '+' : '\0');
+        return insert_integral(abs_value, sign_char, base);
+    }
+
+    uint32_t layout::insert_integral(uint64_t abs_value, char sign_char, uint32_t base)
     {
         uint32_t width = format_content_cursor;
         assert(base <= 32 && "base is a number belongs to [2, 32]");
@@ -1196,122 +1435,88 @@ namespace bq {
         } else if (format_info_.type == 'o') {
             base = 8;
         }
-        // uint64_t max = 18,446,744,073,709,551,615
-        if (base >= 16) {
-            expand_format_content_buff_size(format_content_cursor + 16);
-        } else if (base >= 10) {
-            expand_format_content_buff_size(format_content_cursor + 20);
-        } else {
-            expand_format_content_buff_size(format_content_cursor + 64);
-        }
-        if (value > 0) {
-            if (format_info_.sign == '+') {
-                format_content[format_content_cursor++] = '+';
-            }
-        }
-
+        char prefix_char = '\0';
         if (format_info_.prefix == '#') {
             if (format_info_.type == 'b') {
-                format_content[format_content_cursor++] = '0';
-                if (format_info_.upper)
-                    format_content[format_content_cursor++] = 'B';
-                else
-                    format_content[format_content_cursor++] = 'b';
+                prefix_char = format_info_.upper ? 'B' : 'b';
             } else if (format_info_.type == 'x') {
-                format_content[format_content_cursor++] = '0';
-                if (format_info_.upper)
-                    format_content[format_content_cursor++] = 'X';
-                else
-                    format_content[format_content_cursor++] = 'x';
+                prefix_char = format_info_.upper ? 'X' : 'x';
             }
         }
 
-        auto begin_cursor = format_content_cursor;
-        uint32_t e_count = 0;
-        do {
-            int32_t digit = static_cast<int32_t>(value % base);
-            if (digit < 0xA) {
-                format_content[format_content_cursor] = static_cast<char>('0' + digit);
-            } else {
-                if (format_info_.upper)
-                    format_content[format_content_cursor] = static_cast<char>('A' + digit - 0xA);
-                else
-                    format_content[format_content_cursor] = static_cast<char>('a' + digit - 0xA);
-            }
-            value /= base;
-            ++format_content_cursor;
-            if (value > base)
-                e_count++;
-        } while (value != 0);
-
-        if (format_info_.type == 'e') {
-            // 0000001 -> 000000.1
-            format_content[format_content_cursor] = format_content[format_content_cursor - 1];
-            format_content[format_content_cursor - 1] = '.';
-            ++format_content_cursor;
+        if (format_info_.type == 'e' || (base != 10 && base != 16)) {
+            insert_integral_generic(abs_value, sign_char, prefix_char, base);
+            return format_content_cursor - width;
+        }
 
-            // 000000.1 -> 1.000000
-            reverse(begin_cursor, format_content_cursor - 1);
+        const uint32_t digits_count = (base == 10) ? integer_to_string::count_decimal_digits(abs_value) : _impl_count_hex_digits(abs_value);
+        const uint32_t sign_len = (sign_char != '\0') ? 1 : 0;
+        const uint32_t prefix_len = (prefix_char != '\0') ? 2 : 0;
+        const uint32_t content_len = sign_len + prefix_len + digits_count;
+
+        // right aligned padding is written in place with the same placement as fill_and_alignment:
+        // a non-space fill goes after the sign, a '0' fill also goes after the "0x" prefix.
+        uint32_t pad_count = (format_info_.align == '>' && format_info_.width > content_len) ? format_info_.width - content_len : 0;
+        const bool pad_after_sign = (format_info_.fill != ' ');
+        const bool pad_after_prefix = (format_info_.fill == '0' && prefix_len > 0);
+        if (pad_after_prefix && sign_len > 0) {
+            pad_count = 0; // rare, left to fill_and_alignment
+        }
 
-            fill_e_style(e_count, begin_cursor);
-        } else
-            reverse(begin_cursor, format_content_cursor - 1);
+        expand_format_content_buff_size(format_content_cursor + content_len + pad_count);
+        char* dst = &format_content[format_content_cursor];
+        if (!pad_after_sign) {
+            memset(dst, format_info_.fill, pad_count);
+            dst += pad_count;
+        }
+        if (sign_len > 0) {
+            *dst++ = sign_char;
+        }
+        if (pad_after_sign && !pad_after_prefix) {
+            memset(dst, format_info_.fill, pad_count);
+            dst += pad_count;
+        }
+        if (prefix_len > 0) {
+            *dst++ = '0';
+            *dst++ = prefix_char;
+        }
+        if (pad_after_prefix) {
+            memset(dst, format_info_.fill, pad_count);
+            dst += pad_count;
+        }
+        if (base == 10) {
+            integer_to_string::write_decimal_digits(dst + digits_count, abs_value);
+        } else {
+            char hex[16];
+            write_hex_16(abs_value, format_info_.upper ? HEX_DIGITS_UPPER : HEX_DIGITS_LOWER, hex);
+            memcpy(dst, hex + 16 - digits_count, digits_count);
+        }
+        format_content_cursor += content_len + pad_count;
         return format_content_cursor - width;
     }
 
-    uint32_t layout::insert_integral_signed(int64_t value, uint32_t base /* = 10 */)
+    void layout::insert_integral_generic(uint64_t abs_value, char sign_char, char prefix_char, uint32_t base)
     {
-        uint32_t width = format_content_cursor;
-        assert(base <= 32 && "base is a number belongs to [2, 32]");
-        // Hex check
-        if (format_info_.type == 'b') {
-            base = 2;
-        } else if (format_info_.type == 'x') {
-            base = 16;
-        } else if (format_info_.type == 'o') {
-            base = 8;
-        }
-
-        // Length expansion
         // uint64_t max = 18,446,744,073,709,551,615
         if (base >= 16) {
-            expand_format_content_buff_size(format_content_cursor + 16);
+            expand_format_content_buff_size(format_content_cursor + 24);
         } else if (base >= 10) {
-            expand_format_content_buff_size(format_content_cursor + 20);
+            expand_format_content_buff_size(format_content_cursor + 28);
         } else {
-            expand_format_content_buff_size(format_content_cursor + 64);
+            expand_format_content_buff_size(format_content_cursor + 72);
         }
-        //+-
-        if (value < 0) {
-            format_content[format_content_cursor++] = '-';
-        } else {
-            if (format_info_.sign == '+') {
-                format_content[format_content_cursor++] = '+';
-            }
+        if (sign_char != '\0') {
+            format_content[format_content_cursor++] = sign_char;
         }
-
-        // Default character padding
-        if (format_info_.prefix == '#') {
-            if (format_info_.type == 'b') {
-                format_content[format_content_cursor++] = '0';
-                if (format_info_.upper)
-                    format_content[format_content_cursor++] = 'B';
-                else
-                    format_content[format_content_cursor++] = 'b';
-            } else if (format_info_.type == 'x') {
-                format_content[format_content_cursor++] = '0';
-                if (format_info_.upper)
-                    format_content[format_content_cursor++] = 'X';
-                else
-                    format_content[format_content_cursor++] = 'x';
-            }
+        if (prefix_char != '\0') {
+            format_content[format_content_cursor++] = '0';
+            format_content[format_content_cursor++] = prefix_char;
         }
 
         auto begin_cursor = format_content_cursor;
-        // Scientific Counting Check
         uint32_t e_count = 0;
         do {
-            char digit = static_cast<char>(abs(static_cast<int32_t>(value % static_cast<int32_t>(base))));
+            int32_t digit = static_cast<int32_t>(abs_value % base);
             if (digit < 0xA) {
                 format_content[format_content_cursor] = static_cast<char>('0' + digit);
             } else {
@@ -1320,11 +1525,12 @@ namespace bq {
                 else
                     format_content[format_content_cursor] = static_cast<char>('a' + digit - 0xA);
             }
-            value /= base;
-            if (value > base)
-                e_count++; // Counting
+            abs_value /= base;
             ++format_content_cursor;
-        } while (value != 0);
+            if (abs_value > base)
+                e_count++;
+        } while (abs_value != 0);
+
         if (format_info_.type == 'e') {
             // 0000001 -> 000000.1
             format_content[format_content_cursor] = format_content[format_content_cursor - 1];
@@ -1337,120 +1543,134 @@ namespace bq {
             fill_e_style(e_count, begin_cursor);
         } else
             reverse(begin_cursor, format_content_cursor - 1);
-        return format_content_cursor - width;
     }
 
-    void layout::insert_decimal(float value)
+    // fixed-point and exponent output of float_to_string digits, value == digits * 10^(point_pos - digits_count)
+    template <typename FLOAT_TYPE>
+    void layout::insert_decimal_impl(FLOAT_TYPE value)
     {
-        if (format_info_.type == 'e')
-            format_info_.type = 'Z';
-        uint32_t int_width = 0;
-        auto precision = (int32_t)((format_info_.precision != 0xFFFFFFFF) ? format_info_.precision : 7);
-        auto begin_cursor = format_content_cursor;
-        if (value >= 0) {
-            uint64_t i_part = static_cast<uint64_t>(value);
-            int_width = insert_integral_unsigned(i_part, 10);
-            value -= static_cast<float>(i_part);
-        } else {
-            int64_t i_part = static_cast<int64_t>(value);
-            int_width = insert_integral_signed(i_part, 10);
-            value -= static_cast<float>(i_part);
+        const bool is_negative = signbit(value);
+        const bool is_e_style = (format_info_.type == 'e');
+        const bool upper = is_e_style && format_info_.upper;
+        const bool has_precision = (format_info_.precision != 0xFFFFFFFF);
+        const uint32_t precision = has_precision ? bq::min_value(format_info_.precision, MAX_DECIMAL_PRECISION) : 0;
+
+        expand_format_content_buff_size(format_content_cursor + 5);
+        if (is_negative) {
+            format_content[format_content_cursor++] = '-';
+        } else if (format_info_.sign == '+') {
+            format_content[format_content_cursor++] = '+';
         }
-        if (format_info_.width > 0 && format_info_.width < static_cast<uint32_t>(precision) + 1 + int_width) {
-            precision = static_cast<int32_t>(format_info_.width - int_width - 1);
+        if (isnan(value) || isinf(value)) {
+            const char* str = isnan(value) ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf");
+            memcpy(&format_content[format_content_cursor], str, 3);
+            format_content_cursor += 3;
+            return;
         }
 
-        value = fabsf(value);
-        expand_format_content_buff_size(format_content_cursor + static_cast<uint32_t>(precision) + 5); // more 5 maybe use in e style
-        uint32_t point_index = 0;
-        if (precision > 0 || (format_info_.type == 'Z' && int_width > 1)) {
-            point_index = format_content_cursor;
-            format_content[format_content_cursor++] = '.';
+        const FLOAT_TYPE abs_value = is_negative ? -value : value;
+        char digits[MAX_DECIMAL_PRECISION + 24]; // integral part of uint64 + precision + carry
+        uint32_t digits_count = 0;
+        int32_t point_pos = 1;
+        bool use_e_style = is_e_style;
+        if (!has_precision) {
+            if (abs_value != 0) {
+                digits_count = float_to_string::shortest(abs_value, digits, point_pos);
+            }
+            // same thresholds as Python repr, very large or very small values are more readable in e-style
+            if (format_info_.type != 'f' && (point_pos - 1 < -4 || point_pos - 1 >= 16)) {
+                use_e_style = true;
+            } else if (format_info_.width > 0) {
+                // without precision the width also bounds the fractional digits, e.g. "{:12}" never exceeds 12 chars because of them
+                const int32_t sign_len = (is_negative || format_info_.sign == '+') ? 1 : 0;
+                const int32_t int_len = point_pos > 0 ? point_pos : 1;
+                const int32_t frac_limit = bq::max_value(static_cast<int32_t>(format_info_.width) - sign_len - int_len - 1, 1);
+                float_to_string::round_digits(digits, digits_count, point_pos, point_pos + frac_limit);
+            }
+        } else if (!is_e_style) {
+            if (!float_to_string::fixed_exact(static_cast<double>(abs_value), precision, digits, digits_count, point_pos)) {
+                digits_count = float_to_string::shortest(abs_value, digits, point_pos);
+                float_to_string::round_digits(digits, digits_count, point_pos, point_pos + static_cast<int32_t>(precision));
+            }
+        } else if (abs_value != 0) {
+            digits_count = float_to_string::shortest(abs_value, digits, point_pos);
+            const int32_t frac_count = static_cast<int32_t>(precision) + 1 - point_pos;
+            if (frac_count >= 0 && float_to_string::fixed_exact(static_cast<double>(abs_value), static_cast<uint32_t>(frac_count), digits, digits_count, point_pos)) {
+                uint32_t leading_zeros = 0;
+                while (leading_zeros < digits_count && digits[leading_zeros] == '0') {
+                    ++leading_zeros;
+                }
+                memmove(digits, digits + leading_zeros, digits_count - leading_zeros);
+                digits_count -= leading_zeros;
+                point_pos -= static_cast<int32_t>(leading_zeros);
+                digits_count = bq::min_value(digits_count, precision + 1); // a carry only appends '0'
+            } else {
+                float_to_string::round_digits(digits, digits_count, point_pos, static_cast<int32_t>(precision) + 1);
+            }
         }
-        while (precision > 0) {
-            value *= 10;
-            int32_t digit = static_cast<int32_t>(value);
-            value -= static_cast<float>(digit);
-            --precision;
-            format_content[format_content_cursor++] = static_cast<char>('0' + digit);
+        if (digits_count == 0) {
+            point_pos = 1;
         }
-
-        if (format_info_.type == 'Z') {
-            format_info_.type = 'e';
-            uint32_t moves = int_width - 1;
-            if (point_index != 0) {
-                while (moves > 0) {
-                    auto temp = format_content[point_index];
-                    format_content[point_index] = format_content[point_index - 1];
-                    format_content[point_index - 1] = temp;
-                    --point_index;
-                    --moves;
+        auto digit_at = [&](int32_t index) -> char {
+            return (index >= 0 && index < static_cast<int32_t>(digits_count)) ? digits[index] : '0';
+        };
+
+        if (use_e_style) {
+            // d.ddde+XX
+            const uint32_t frac_count = has_precision ? precision : (digits_count > 1 ? digits_count - 1 : 0);
+            expand_format_content_buff_size(format_content_cursor + frac_count + 8);
+            format_content[format_content_cursor++] = digit_at(0);
+            if (frac_count > 0) {
+                format_content[format_content_cursor++] = '.';
+                for (uint32_t i = 1; i <= frac_count; ++i) {
+                    format_content[format_content_cursor++] = digit_at(static_cast<int32_t>(i));
                 }
             }
-
-            moves = int_width - 1;
-            if (format_info_.precision > 0 && format_info_.precision < format_content_cursor - begin_cursor)
-                format_content_cursor = point_index + format_info_.precision + 1;
-            fill_e_style(moves, begin_cursor);
+            int32_t exponent = point_pos - 1;
+            format_content[format_content_cursor++] = upper ? 'E' : 'e';
+            format_content[format_content_cursor++] = exponent < 0 ? '-' : '+';
+            exponent = exponent < 0 ? -exponent : exponent;
+            if (exponent >= 100) {
+                format_content[format_content_cursor++] = static_cast<char>('0' + exponent / 100);
+                exponent %= 100;
+            }
+            format_content[format_content_cursor++] = static_cast<char>('0' + exponent / 10);
+            format_content[format_content_cursor++] = static_cast<char>('0' + exponent % 10);
+            return;
         }
-    }
 
-    void layout::insert_decimal(double value)
-    {
-        if (format_info_.type == 'e')
-            format_info_.type = 'Z';
-        uint32_t int_width = 0;
-        auto precision = (int32_t)((format_info_.precision != 0xFFFFFFFF) ? format_info_.precision : 15);
-        auto begin_cursor = format_content_cursor;
-        if (value >= 0) {
-            uint64_t i_part = static_cast<uint64_t>(value);
-            int_width = insert_integral_unsigned(i_part, 10);
-            value -= static_cast<double>(i_part);
-        } else {
-            int64_t i_part = static_cast<int64_t>(value);
-            int_width = insert_integral_signed(i_part, 10);
-            value -= static_cast<double>(i_part);
+        // fixed, shortest output keeps at least one fractional digit so it still reads as a decimal
+        uint32_t frac_count = precision;
+        if (!has_precision) {
+            frac_count = static_cast<int32_t>(digits_count) > point_pos ? static_cast<uint32_t>(static_cast<int32_t>(digits_count) - point_pos) : 1;
         }
-        if (format_info_.width > 0 && format_info_.width < static_cast<uint32_t>(precision) + 1 + int_width) {
-            precision = (static_cast<int32_t>(format_info_.width) - static_cast<int32_t>(int_width) - 1);
-            if (precision < 0)
-                precision = 0;
+        const uint32_t int_count = point_pos > 0 ? static_cast<uint32_t>(point_pos) : 1;
+        expand_format_content_buff_size(format_content_cursor + int_count + frac_count + 1);
+        if (point_pos <= 0) {
+            format_content[format_content_cursor++] = '0';
+        } else {
+            for (int32_t i = 0; i < point_pos; ++i) {
+                format_content[format_content_cursor++] = digit_at(i);
+            }
         }
-
-        value = fabs(value);
-        expand_format_content_buff_size(format_content_cursor + static_cast<uint32_t>(precision) + 5); // more 5 maybe use for e-style
-        uint32_t point_index = 0;
-        if (precision > 0 || (format_info_.type == 'Z' && int_width > 1)) {
-            point_index = format_content_cursor;
+        if (frac_count > 0) {
             format_content[format_content_cursor++] = '.';
-        }
-        auto temp_precision = precision;
-        while (temp_precision > 0) {
-            value *= 10;
-            int32_t digit = static_cast<int32_t>(value);
-            value -= static_cast<double>(digit);
-            --temp_precision;
-            format_content[format_content_cursor++] = static_cast<char>('0' + digit);
-        }
-        if (format_info_.type == 'Z') {
-            format_info_.type = 'e';
-            uint32_t moves = int_width - 1;
-            if (point_index != 0) {
-                while (moves > 0) {
-                    auto temp = format_content[point_index];
-                    format_content[point_index] = format_content[point_index - 1];
-                    format_content[point_index - 1] = temp;
-                    --point_index;
-                    --moves;
-                }
+            for (uint32_t i = 0; i < frac_count; ++i) {
+                format_content[format_content_cursor++] = digit_at(point_pos + static_cast<int32_t>(i));
             }
-            moves = int_width - 1;
-            if (format_info_.precision > 0 && format_info_.precision < format_content_cursor - begin_cursor)
-                format_content_cursor = point_index + format_info_.precision + 1;
-            fill_e_style(moves, begin_cursor);
         }
     }
 
+    void layout::insert_decimal(float value)
+    {
+        insert_decimal_impl(value);
+    }
+
+    void layout::insert_decimal(double value)
+    {
+        insert_decimal_impl(value);
+    }
+
     void layout::reverse(uint32_t begin_cursor, uint32_t end_cursor)
     {
         while (begin_cursor < end_cursor) {
@@ -1463,6 +1683,14 @@ namespace bq {
     }
 
 #ifdef BQ_UNIT_TEST
+    void layout::test_write_hex_16_sw(uint64_t value, bool upper, char* dst)
+    {
+        _impl_write_hex_16_sw(value, upper ? HEX_DIGITS_UPPER : HEX_DIGITS_LOWER, dst);
+    }
+    void layout::test_write_hex_16(uint64_t value, bool upper, char* dst)
+    {
+        write_hex_16(value, upper ? HEX_DIGITS_UPPER : HEX_DIGITS_LOWER, dst);
+    }
     uint32_t layout::test_find_brace_and_copy_sw(const char* src, uint32_t len, char* dst, bool& found_brace)
     {
         return _impl_find_brace_and_copy_sw(src, len, dst, found_brace);
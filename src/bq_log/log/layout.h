@@ -25,6 +25,58 @@
 #include "bq_log/utils/time_zone.h"
 
 namespace bq {
+    /// <summary>
+    /// Compiled "layout_pattern" appender config, replaces the default text prefix
+    /// "<time zone> <date> <time>.<ms>[tid-<id> <name>]\t[<level>]\t[<category>]\t".
+    /// %Z time zone, %D date, %T time of day, %u milliseconds(3 digits), %E epoch milliseconds,
+    /// %L level letter, %t thread id, %n thread name, %c category name, %m message, %% '%'.
+    /// Everything else is copied as is, the message is appended at the end if %m is absent.
+    /// e.g. "%D %T.%u %L [%t] %c: %m"
+    /// </summary>
+    class layout_pattern {
+    public:
+        enum class op_type : uint8_t {
+            literal,
+            time_zone,
+            date,
+            time_of_day,
+            millisecond,
+            epoch_ms,
+            level,
+            thread_id,
+            thread_name,
+            category,
+            message
+        };
+        struct op {
+            op_type type;
+            uint32_t literal_offset;
+            uint32_t literal_len;
+        };
+
+    public:
+        layout_pattern();
+
+        void clear();
+
+        /// <returns>false if the pattern has an unknown specifier, the pattern stays empty then</returns>
+        bool compile(const bq::string& pattern_str);
+
+        bq_forceinline bool is_empty() const { return ops_.is_empty(); }
+
+        /// identifies the output format of the pattern, 0 if empty
+        bq_forceinline uint64_t get_id() const { return id_; }
+
+        bq_forceinline const bq::array<op>& get_ops() const { return ops_; }
+
+        bq_forceinline const char* get_literal(const op& literal_op) const { return literals_.c_str() + literal_op.literal_offset; }
+
+    private:
+        bq::array<op> ops_;
+        bq::string literals_;
+        uint64_t id_;
+    };
+
     class layout {
         struct format_info {
             bool used = false;
@@ -62,7 +114,7 @@ namespace bq {
     public:
         layout();
 
-        enum_layout_result do_layout(const bq::log_entry_handle& log_entry, time_zone& input_time_zone, const bq::array<bq::string>* categories_name_array_ptr);
+        enum_layout_result do_layout(const bq::log_entry_handle& log_entry, time_zone& input_time_zone, const bq::array<bq::string>* categories_name_array_ptr, const layout_pattern* pattern = nullptr);
 
         inline const char* get_formated_str()
         {
@@ -87,10 +139,15 @@ namespace bq {
         }
 
     private:
+        // upper bound of "{:.Nf}" and "{:.Ne}", larger precision is clamped
+        static constexpr uint32_t MAX_DECIMAL_PRECISION = 64;
+
         enum_layout_result layout_prefix(const bq::log_entry_handle& log_entry);
 
         enum_layout_result insert_time(const bq::log_entry_handle& log_entry);
 
+        enum_layout_result layout_by_pattern(const bq::log_entry_handle& log_entry, const layout_pattern& pattern);
+
         enum_layout_result insert_thread_info(const bq::log_entry_handle& log_entry);
 
         /// <summary>
@@ -131,10 +188,18 @@ namespace bq {
 
         uint32_t insert_integral_signed(int64_t value, uint32_t base = 10);
 
+        uint32_t insert_integral(uint64_t abs_value, char sign_char, uint32_t base);
+
+        // binary, octal and integral e-style
+        void insert_integral_generic(uint64_t abs_value, char sign_char, char prefix_char, uint32_t base);
+
         void insert_decimal(float value);
 
         void insert_decimal(double value);
 
+        template <typename FLOAT_TYPE>
+        void insert_decimal_impl(FLOAT_TYPE value);
+
         void reverse(uint32_t begin_cursor, uint32_t end_cursor);
         //------------------------- insert functions end ----------------------//
 
@@ -142,6 +207,8 @@ namespace bq {
     public:
         static uint32_t test_find_brace_and_copy_sw(const char* src, uint32_t len, char* dst, bool& found_brace);
         static uint32_t test_find_brace_and_convert_u16_sw(const char16_t* src, uint32_t len, char* dst, bool& found_brace, bool& non_ascii);
+        static void test_write_hex_16_sw(uint64_t value, bool upper, char* dst);
+        static void test_write_hex_16(uint64_t value, bool upper, char* dst);
 
         // Throughput test wrappers
         void test_python_style_format_content_legacy(const bq::log_entry_handle& log_entry);
@@ -173,4 +240,71 @@ namespace bq {
         bq::hash_map<uint64_t, bq::string> thread_names_cache_;
         format_info format_info_;
     };
+
+    /// <summary>
+    /// Formatted text of the entry currently being dispatched by a log_imp.
+    /// The first layout based appender (console / text file) fills it, the following ones
+    /// with identical layout settings reuse the bytes instead of formatting the entry again.
+    /// </summary>
+    class layout_result_cache {
+    public:
+        layout_result_cache()
+            : entry_seq_(0)
+            , valid_(false)
+            , use_local_time_(false)
+            , gmt_offset_minutes_(0)
+            , pattern_id_(0)
+        {
+        }
+
+        bq_forceinline void invalidate()
+        {
+            valid_ = false;
+        }
+
+        bq_forceinline bool try_get(uint64_t entry_seq, const time_zone& input_time_zone, uint64_t pattern_id, const char*& out_str, uint32_t& out_len) const
+        {
+            if (!valid_ || entry_seq != entry_seq_ || pattern_id != pattern_id_ || !is_same_time_zone(input_time_zone)) {
+                return false;
+            }
+            out_str = content_.is_empty() ? "" : content_.begin();
+            out_len = static_cast<uint32_t>(content_.size());
+            return true;
+        }
+
+        void set(uint64_t entry_seq, const time_zone& input_time_zone, uint64_t pattern_id, const char* str, uint32_t len)
+        {
+            entry_seq_ = entry_seq;
+            pattern_id_ = pattern_id;
+            use_local_time_ = input_time_zone.is_use_local_time();
+            gmt_offset_minutes_ = input_time_zone.get_gmt_offset_hours() * 60 + input_time_zone.get_gmt_offset_minutes();
+            content_.clear();
+            content_.insert_batch(content_.end(), str, len);
+            valid_ = true;
+        }
+
+        bq_forceinline void tidy_memory()
+        {
+            if (content_.capacity() > 1024) {
+                content_.clear();
+                content_.set_capacity(1024, true);
+                valid_ = false;
+            }
+        }
+
+    private:
+        bq_forceinline bool is_same_time_zone(const time_zone& input_time_zone) const
+        {
+            return use_local_time_ == input_time_zone.is_use_local_time()
+                && (use_local_time_ || gmt_offset_minutes_ == input_time_zone.get_gmt_offset_hours() * 60 + input_time_zone.get_gmt_offset_minutes());
+        }
+
+    private:
+        bq::array<char> content_;
+        uint64_t entry_seq_;
+        bool valid_;
+        bool use_local_time_;
+        int32_t gmt_offset_minutes_;
+        uint64_t pattern_id_;
+    };
 }
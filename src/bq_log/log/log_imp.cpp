@@ -113,9 +113,12 @@ namespace bq {
         , thread_mode_(log_thread_mode::async)
         , buffer_(nullptr)
         , snapshot_(nullptr)
+        , layout_result_cache_enabled_(false)
+        , current_entry_seq_(0)
         , last_log_entry_epoch_ms_(0)
         , last_flush_io_epoch_ms_(0)
         , recover_status_(recover_status_enum::not_started)
+        , template_stats_enabled_(false)
     {
     }
 
@@ -159,6 +162,8 @@ namespace bq {
             bq::log_utils::get_log_level_bitmap_by_config(log_config["print_stack_levels"], print_stack_level_bitmap_);
         }
 
+        refresh_template_stats_state(log_config);
+
         {
             log_buffer_config buffer_config;
             buffer_config.log_name = name_;
@@ -201,6 +206,7 @@ namespace bq {
                 add_appender(name_key, all_apenders_config[name_key]);
             }
             refresh_merged_log_level_bitmap();
+            refresh_layout_result_cache_state();
         }
 
         // init snapshot
@@ -256,12 +262,15 @@ namespace bq {
                 add_appender(name, all_apenders_config[name]);
             }
             refresh_merged_log_level_bitmap();
+            refresh_layout_result_cache_state();
         }
         // init categories mask
         {
             bq::log_utils::get_categories_mask_by_config(categories_name_array_, log_config["categories_mask"], categories_mask_array_);
         }
 
+        refresh_template_stats_state(log_config);
+
         // init snapshot
         {
             const auto& snapshot_config = config["snapshot"];
@@ -376,9 +385,17 @@ namespace bq {
         if (categories_mask_array_.size() <= category_idx || categories_mask_array_[category_idx] == 0) {
             return;
         }
+        ++current_entry_seq_;
         for (decltype(appenders_list_)::size_type i = 0; i < appenders_list_.size(); i++) {
             appenders_list_[i]->log(handle);
         }
+        if (layout_result_cache_enabled_) {
+            layout_result_cache_.tidy_memory();
+        }
+        if (template_stats_enabled_) {
+            bq::platform::scoped_spin_lock lock(template_stats_lock_);
+            template_stats_.add(handle, handle.data_size());
+        }
         if (snapshot_->is_enable()) {
             snapshot_->write_data(handle);
         }
@@ -394,6 +411,30 @@ namespace bq {
         snapshot_->release_snapshot_string();
     }
 
+    bool log_imp::take_snapshot_binary(const bq::string& path)
+    {
+        return snapshot_->take_snapshot_binary(path);
+    }
+
+    const bq::string& log_imp::take_template_stats_string()
+    {
+        template_stats_lock_.lock();
+        template_stats_text_.clear();
+        if (!template_stats_enabled_) {
+#ifndef BQ_UNIT_TEST
+            bq::util::log_device_console_plain_text(log_level::warning, "calling take_template_stats without enable log.template_stats");
+#endif
+            return template_stats_text_;
+        }
+        template_stats_.make_report(categories_name_array_, template_stats_text_);
+        return template_stats_text_;
+    }
+
+    void log_imp::release_template_stats_string()
+    {
+        template_stats_lock_.unlock();
+    }
+
     const bq::string& log_imp::get_name() const
     {
         return name_;
@@ -411,6 +452,31 @@ namespace bq {
         merged_log_level_bitmap_ = tmp;
     }
 
+    void log_imp::refresh_layout_result_cache_state()
+    {
+        // the cache costs one extra copy, it only pays off when the same entry is formatted more than once.
+        uint32_t layout_appender_count = 0;
+        for (decltype(appenders_list_)::size_type i = 0; i < appenders_list_.size(); ++i) {
+            auto type = appenders_list_[i]->get_type();
+            if (type == appender_base::appender_type::console || type == appender_base::appender_type::text_file) {
+                ++layout_appender_count;
+            }
+        }
+        layout_result_cache_.invalidate();
+        layout_result_cache_enabled_ = layout_appender_count > 1;
+    }
+
+    void log_imp::refresh_template_stats_state(const bq::property_value& log_config)
+    {
+        bool enable = log_config["template_stats"].is_bool() && (bool)log_config["template_stats"];
+        bq::platform::scoped_spin_lock lock(template_stats_lock_);
+        if (!enable) {
+            // counting starts over when it is enabled again
+            template_stats_.clear();
+        }
+        template_stats_enabled_ = enable;
+    }
+
     void log_imp::process(bool is_force_flush)
     {
         constexpr uint64_t flush_io_min_interval_ms = 100;
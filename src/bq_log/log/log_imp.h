@@ -14,6 +14,7 @@
 #include "bq_log/log/appender/appender_base.h"
 #include "bq_log/log/log_types.h"
 #include "bq_log/log/log_level_bitmap.h"
+#include "bq_log/log/log_template_stats.h"
 #include "bq_log/log/log_worker.h"
 #include "bq_log/types/buffer/log_buffer.h"
 
@@ -34,6 +35,11 @@ namespace bq {
 
         const bq::string& take_snapshot_string(const bq::string& time_zone_config);
         void release_snapshot_string();
+        bool take_snapshot_binary(const bq::string& path);
+
+        // take_template_stats_string and release_template_stats_string must be called in pair, or the lock will not be released
+        const bq::string& take_template_stats_string();
+        void release_template_stats_string();
 
         const bq::string& get_name() const;
         uint32_t get_categories_count() const;
@@ -91,6 +97,20 @@ namespace bq {
 
         const layout& get_layout() const;
 
+        /// <summary>
+        /// Shared formatted text of the entry being dispatched, null if this log has less than two layout based appenders.
+        /// </summary>
+        bq_forceinline layout_result_cache* get_layout_result_cache() const
+        {
+            return layout_result_cache_enabled_ ? &layout_result_cache_ : nullptr;
+        }
+
+        /// Sequence number of the entry being dispatched to appenders, used as key of layout result cache.
+        bq_forceinline uint64_t get_current_entry_seq() const
+        {
+            return current_entry_seq_;
+        }
+
         bq_forceinline bool is_enable_for(uint32_t category_index, bq::log_level level) const
         {
             return merged_log_level_bitmap_.have_level(level) && categories_mask_array_[category_index];
@@ -104,6 +124,8 @@ namespace bq {
     private:
         bool add_appender(const string& name, const bq::property_value& jobj);
         void refresh_merged_log_level_bitmap();
+        void refresh_layout_result_cache_state();
+        void refresh_template_stats_state(const bq::property_value& log_config);
         void flush_appenders_cache();
         void flush_appenders_io();
         void clear();
@@ -127,6 +149,9 @@ namespace bq {
         log_level_bitmap print_stack_level_bitmap_;
         log_buffer* buffer_;
         class log_snapshot* snapshot_;
+        mutable layout_result_cache layout_result_cache_;
+        bool layout_result_cache_enabled_;
+        uint64_t current_entry_seq_;
         uint64_t last_log_entry_epoch_ms_;
         uint64_t last_flush_io_epoch_ms_;
         recover_status_enum recover_status_;
@@ -134,6 +159,12 @@ namespace bq {
         bq::array<bq::string> categories_name_array_;
         bq::array_inline<uint8_t> categories_mask_array_;
 
+        // "log.template_stats", counted on the worker side when entries are dispatched to appenders
+        bool template_stats_enabled_;
+        log_template_stats template_stats_;
+        bq::string template_stats_text_;
+        bq::platform::spin_lock template_stats_lock_;
+
         bq::string last_config_;
     };
 }
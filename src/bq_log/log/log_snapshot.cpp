@@ -11,6 +11,7 @@
  */
 #include "bq_log/log/log_snapshot.h"
 #include "bq_log/log/log_imp.h"
+#include "bq_log/log/appender/appender_file_raw.h"
 #include "bq_log/utils/log_utils.h"
 #include "bq_log/utils/time_zone.h"
 
@@ -18,11 +19,10 @@ namespace bq {
 
     log_snapshot::log_snapshot(class log_imp* parent_log, const bq::property_value& snapshot_config)
         : buffer_size_(0)
-        , snapshot_buffer_(nullptr)
-        , buffer_data_(nullptr)
-        , snapshot_text_ { "", "" }
-        , snapshot_text_index_(0)
-        , snapshot_text_continuous_(false)
+        , snapshot_buffers_ { nullptr, nullptr, nullptr }
+        , buffer_datas_ { nullptr, nullptr, nullptr }
+        , active_generation_(INVALID_GENERATION)
+        , writing_generation_(INVALID_GENERATION)
         , parent_log_(parent_log)
     {
         reset_config(snapshot_config);
@@ -31,16 +31,99 @@ namespace bq {
     log_snapshot::~log_snapshot()
     {
         bq::platform::scoped_spin_lock scoped_lock(lock_);
-        if (snapshot_buffer_) {
-            delete snapshot_buffer_;
-            snapshot_buffer_ = nullptr;
+        disable_writing();
+        destroy_buffers();
+    }
+
+    void log_snapshot::create_buffers()
+    {
+        for (uint32_t i = 0; i <= HISTORY_BUFFER_INDEX; ++i) {
+            buffer_datas_[i] = (uint8_t*)bq::platform::aligned_alloc(BQ_CACHE_LINE_SIZE, (size_t)siso_ring_buffer::calculate_min_size_of_memory(buffer_size_));
+            snapshot_buffers_[i] = new siso_ring_buffer(buffer_datas_[i], (size_t)buffer_size_, false);
+            snapshot_buffers_[i]->set_thread_check_enable(false);
         }
-        if (buffer_data_) {
-            bq::platform::aligned_free(buffer_data_);
-            snapshot_buffer_ = nullptr;
+    }
+
+    void log_snapshot::destroy_buffers()
+    {
+        for (uint32_t i = 0; i <= HISTORY_BUFFER_INDEX; ++i) {
+            if (snapshot_buffers_[i]) {
+                delete snapshot_buffers_[i];
+                snapshot_buffers_[i] = nullptr;
+            }
+            if (buffer_datas_[i]) {
+                bq::platform::aligned_free(buffer_datas_[i]);
+                buffer_datas_[i] = nullptr;
+            }
         }
     }
 
+    void log_snapshot::push_entry(uint32_t buffer_index, const uint8_t* data, uint32_t size)
+    {
+        siso_ring_buffer*& buffer = snapshot_buffers_[buffer_index];
+        while (true) {
+            auto write_handle = buffer->alloc_write_chunk(size);
+            scoped_log_buffer_handle<siso_ring_buffer> scoped_write_handle(*buffer, write_handle);
+            if (write_handle.result == enum_buffer_result_code::success) {
+                memcpy(write_handle.data_addr, data, (size_t)size);
+                break;
+            } else if (write_handle.result == enum_buffer_result_code::err_not_enough_space) {
+                // Since siso_buffer requires contiguous data, you can end up in a situation where the buffer is apparently empty,
+                //  but because the cursor is in the middle, there isn’t enough contiguous space left.
+                //  In such cases, we need to apply a correction.
+                // Warning: the current snapshot does not support temporarily oversized data; such data should be discarded.
+                auto discard_handle = buffer->read_chunk();
+                bool is_already_empty = discard_handle.result == enum_buffer_result_code::err_empty_log_buffer;
+                buffer->return_read_chunk(discard_handle);
+                if (is_already_empty) {
+                    delete buffer;
+                    buffer = new siso_ring_buffer(buffer_datas_[buffer_index], (size_t)buffer_size_, false);
+                    buffer->set_thread_check_enable(false);
+                }
+            } else {
+                break;
+            }
+        }
+    }
+
+    // Stop write_data() from using the generation buffers, returns the generation which was active.
+    uint32_t log_snapshot::disable_writing()
+    {
+        uint32_t generation = active_generation_.exchange(INVALID_GENERATION, bq::platform::memory_order::seq_cst);
+        while (writing_generation_.load_seq_cst() != INVALID_GENERATION) {
+            bq::platform::thread::yield();
+        }
+        return generation;
+    }
+
+    // Move the entries of a generation buffer which is not written any more to the history buffer.
+    void log_snapshot::collect_generation(uint32_t generation)
+    {
+        auto& generation_buffer = *snapshot_buffers_[generation];
+        while (true) {
+            auto read_handle = generation_buffer.read_chunk();
+            scoped_log_buffer_handle<siso_ring_buffer> scoped_read_handle(generation_buffer, read_handle);
+            if (read_handle.result != enum_buffer_result_code::success) {
+                break;
+            }
+            push_entry(HISTORY_BUFFER_INDEX, read_handle.data_addr, read_handle.data_size);
+        }
+    }
+
+    void log_snapshot::rotate_generation()
+    {
+        uint32_t generation = active_generation_.load_relaxed(); // only changed under lock_
+        if (generation == INVALID_GENERATION) {
+            return;
+        }
+        // The next generation was emptied by the previous rotation.
+        active_generation_.store_seq_cst((generation + 1) % GENERATION_COUNT);
+        while (writing_generation_.load_seq_cst() == generation) {
+            bq::platform::thread::yield();
+        }
+        collect_generation(generation);
+    }
+
     void log_snapshot::reset_config(const bq::property_value& snapshot_config)
     {
         uint32_t new_buffer_size = 0;
@@ -48,71 +131,42 @@ namespace bq {
             new_buffer_size = static_cast<uint32_t>(static_cast<int64_t>(snapshot_config["buffer_size"]));
         }
         bq::platform::scoped_spin_lock scoped_lock(lock_);
-        buffer_size_ = new_buffer_size;
-        if (buffer_size_ != 0) {
-            if (snapshot_buffer_) {
-                auto current_usable_buffer_size = (uint32_t)(snapshot_buffer_->get_block_size() * snapshot_buffer_->get_total_blocks_count());
-                if (abs(static_cast<int32_t>(current_usable_buffer_size) - static_cast<int32_t>(buffer_size_)) > static_cast<int32_t>(BQ_CACHE_LINE_SIZE) * 2) {
-                    decltype(buffer_data_) new_data = (decltype(buffer_data_))bq::platform::aligned_alloc(BQ_CACHE_LINE_SIZE, (size_t)siso_ring_buffer::calculate_min_size_of_memory(buffer_size_));
-                    // create a new snapshot_buffer_ and backup log data.
-                    auto* new_buffer = new siso_ring_buffer(new_data, static_cast<size_t>(buffer_size_), false);
-                    new_buffer->set_thread_check_enable(false);
+        // Entries processed while the config is being reset are not recorded.
+        uint32_t prev_generation = disable_writing();
+        if (prev_generation != INVALID_GENERATION) {
+            collect_generation(prev_generation);
+        }
+        if (new_buffer_size != 0) {
+            if (snapshot_buffers_[HISTORY_BUFFER_INDEX]) {
+                auto current_usable_buffer_size = (uint32_t)(snapshot_buffers_[HISTORY_BUFFER_INDEX]->get_block_size() * snapshot_buffers_[HISTORY_BUFFER_INDEX]->get_total_blocks_count());
+                if (abs(static_cast<int32_t>(current_usable_buffer_size) - static_cast<int32_t>(new_buffer_size)) > static_cast<int32_t>(BQ_CACHE_LINE_SIZE) * 2) {
+                    // create new buffers and backup log data.
+                    siso_ring_buffer* prev_history_buffer = snapshot_buffers_[HISTORY_BUFFER_INDEX];
+                    uint8_t* prev_history_data = buffer_datas_[HISTORY_BUFFER_INDEX];
+                    snapshot_buffers_[HISTORY_BUFFER_INDEX] = nullptr;
+                    buffer_datas_[HISTORY_BUFFER_INDEX] = nullptr;
+                    destroy_buffers();
+                    buffer_size_ = new_buffer_size;
+                    create_buffers();
                     while (true) {
-                        auto backup_read_handle = snapshot_buffer_->read_chunk();
-                        scoped_log_buffer_handle<siso_ring_buffer> scoped_backup_read_handle(*snapshot_buffer_, backup_read_handle);
+                        auto backup_read_handle = prev_history_buffer->read_chunk();
+                        scoped_log_buffer_handle<siso_ring_buffer> scoped_backup_read_handle(*prev_history_buffer, backup_read_handle);
                         if (backup_read_handle.result != enum_buffer_result_code::success) {
                             break;
                         }
-                        while (true) {
-                            auto write_handle = new_buffer->alloc_write_chunk(backup_read_handle.data_size);
-                            scoped_log_buffer_handle<siso_ring_buffer> scoped_write_handle(*new_buffer, write_handle);
-                            if (write_handle.result == enum_buffer_result_code::success) {
-                                memcpy(write_handle.data_addr, backup_read_handle.data_addr, (size_t)backup_read_handle.data_size);
-                                break;
-                            } else if (write_handle.result == enum_buffer_result_code::err_not_enough_space) {
-                                // Since siso_buffer requires contiguous data, you can end up in a situation where the buffer is apparently empty,
-                                // but because the cursor is in the middle, there isn’t enough contiguous space left.
-                                // In such cases, we need to apply a correction.
-                                // TODO: the current snapshot does not support temporarily oversized data; such data should be discarded.
-                                auto discard_handle = new_buffer->read_chunk();
-                                bool is_already_empty = discard_handle.result == enum_buffer_result_code::err_empty_log_buffer;
-                                new_buffer->return_read_chunk(discard_handle);
-                                if (is_already_empty) {
-                                    delete new_buffer;
-                                    new_buffer = new siso_ring_buffer(buffer_data_, (size_t)buffer_size_, false);
-                                    new_buffer->set_thread_check_enable(false);
-                                }
-                                snapshot_text_continuous_ = false;
-                            } else {
-                                break;
-                            }
-                        }
+                        push_entry(HISTORY_BUFFER_INDEX, backup_read_handle.data_addr, backup_read_handle.data_size);
                     }
-                    delete snapshot_buffer_;
-                    snapshot_buffer_ = new_buffer;
-                    if (buffer_data_) {
-                        bq::platform::aligned_free(buffer_data_);
-                    }
-                    buffer_data_ = new_data;
+                    delete prev_history_buffer;
+                    bq::platform::aligned_free(prev_history_data);
                 }
             } else {
-                buffer_data_ = (decltype(buffer_data_))bq::platform::aligned_alloc(BQ_CACHE_LINE_SIZE, (size_t)siso_ring_buffer::calculate_min_size_of_memory(buffer_size_));
-                snapshot_buffer_ = new siso_ring_buffer(buffer_data_, (size_t)buffer_size_, false);
-                snapshot_buffer_->set_thread_check_enable(false);
+                buffer_size_ = new_buffer_size;
+                create_buffers();
             }
         } else {
-            if (snapshot_buffer_) {
-                delete snapshot_buffer_;
-                snapshot_buffer_ = nullptr;
-            }
-            if (buffer_data_) {
-                bq::platform::aligned_free(buffer_data_);
-                buffer_data_ = nullptr;
-            }
-            snapshot_text_[0].clear();
-            snapshot_text_[1].clear();
-            snapshot_text_index_ = 0;
-            snapshot_text_continuous_ = false;
+            buffer_size_ = 0;
+            destroy_buffers();
+            snapshot_text_.clear();
         }
 
         const auto& levels_array = snapshot_config["levels"];
@@ -125,94 +179,60 @@ namespace bq {
             categories_mask_array_.fill_uninitialized(parent_log_->get_categories_name().size());
         }
         bq::log_utils::get_categories_mask_by_config(parent_log_->get_categories_name(), snapshot_config["categories_mask"], categories_mask_array_);
+        if (buffer_size_ != 0) {
+            active_generation_.store_seq_cst(0);
+        }
     }
 
     void log_snapshot::write_data(const bq::log_entry_handle& log_entry)
     {
-        if (snapshot_buffer_) {
-            if (log_level_bitmap_.have_level(log_entry.get_level()) && categories_mask_array_[log_entry.get_category_idx()]) {
-                bq::platform::scoped_spin_lock scoped_lock(lock_);
-                if (snapshot_buffer_) {
-                    while (true) {
-                        auto snapshot_write_handle = snapshot_buffer_->alloc_write_chunk(log_entry.data_size());
-                        scoped_log_buffer_handle<siso_ring_buffer> scoped_snapshot_write_handle(*snapshot_buffer_, snapshot_write_handle);
-                        if (snapshot_write_handle.result == enum_buffer_result_code::success) {
-                            memcpy(snapshot_write_handle.data_addr, log_entry.data(), log_entry.data_size());
-                            break;
-                        } else if (snapshot_write_handle.result == enum_buffer_result_code::err_not_enough_space) {
-                            // Since siso_buffer requires contiguous data, you can end up in a situation where the buffer is apparently empty,
-                            //  but because the cursor is in the middle, there isn’t enough contiguous space left.
-                            //  In such cases, we need to apply a correction.
-                            // Warning: the current snapshot does not support temporarily oversized data; such data should be discarded.
-                            auto discard_handle = snapshot_buffer_->read_chunk();
-                            bool is_already_empty = discard_handle.result == enum_buffer_result_code::err_empty_log_buffer;
-                            snapshot_buffer_->return_read_chunk(discard_handle);
-                            if (is_already_empty) {
-                                delete snapshot_buffer_;
-                                snapshot_buffer_ = new siso_ring_buffer(buffer_data_, (size_t)buffer_size_, false);
-                                snapshot_buffer_->set_thread_check_enable(false);
-                            }
-                            snapshot_text_continuous_ = false;
-                        } else {
-                            break;
-                        }
-                    }
-                }
-            } else {
-                snapshot_text_continuous_ = false;
+        // Publish the generation being written before using it, a snapshot switching the active generation
+        // waits for it, so the buffer is never accessed by both sides at the same time.
+        // The filters are checked after that for the same reason, reset_config() may be changing them.
+        uint32_t generation;
+        while (true) {
+            generation = active_generation_.load_acquire();
+            if (generation == INVALID_GENERATION) {
+                return;
+            }
+            writing_generation_.store_seq_cst(generation);
+            if (active_generation_.load_seq_cst() == generation) {
+                break;
             }
+            writing_generation_.store_release(INVALID_GENERATION);
         }
+        if (log_level_bitmap_.have_level(log_entry.get_level()) && categories_mask_array_[log_entry.get_category_idx()]) {
+            push_entry(generation, log_entry.data(), log_entry.data_size());
+        }
+        writing_generation_.store_release(INVALID_GENERATION);
     }
 
     const bq::string& log_snapshot::take_snapshot_string(const bq::string& time_zone_config)
     {
         lock_.lock();
-        snapshot_text_index_ = (snapshot_text_index_ + 1) & 0x01;
-        bq::string& text = snapshot_text_[snapshot_text_index_];
-        text.clear();
-        if (!snapshot_buffer_) {
+        snapshot_text_.clear();
+        if (!snapshot_buffers_[HISTORY_BUFFER_INDEX]) {
 #ifndef BQ_UNIT_TEST
             bq::util::log_device_console_plain_text(log_level::warning, "calling take_snapshot without enable snapshot");
 #endif
-            return snapshot_text_[snapshot_text_index_];
+            return snapshot_text_;
         }
+        rotate_generation();
         time_zone time_zone_tmp(time_zone_config);
-        while (true) {
-            auto snapshot_read_handle = snapshot_buffer_->read_chunk();
-            scoped_log_buffer_handle<siso_ring_buffer> scoped_snapshot_read_handle(*snapshot_buffer_, snapshot_read_handle);
-            if (snapshot_read_handle.result != enum_buffer_result_code::success) {
-                break;
-            }
-            bq::log_entry_handle item(snapshot_read_handle.data_addr, snapshot_read_handle.data_size);
-            snapshot_layout_.do_layout(item, time_zone_tmp, &parent_log_->get_categories_name());
-            text.insert_batch(text.end(), snapshot_layout_.get_formated_str(), snapshot_layout_.get_formated_str_len());
-            text.insert(text.end(), '\n');
-            snapshot_layout_.tidy_memory();
-        }
-
-        if (snapshot_text_continuous_) {
-            if (text.size() < buffer_size_) {
-                size_t left_size = buffer_size_ - text.size();
-                bq::string& last_text = snapshot_text_[(snapshot_text_index_ + 1) & 0x01];
-                left_size = bq::min_value(left_size, last_text.size());
-                size_t offset = 0;
-                size_t start_pos = last_text.size() - left_size;
-                for (offset = 0; offset < 4 && offset < left_size; ++offset) {
-                    // find the start of multi-bytes character.
-                    char c = last_text[start_pos + offset];
-                    if ((c & 0x80) == 0) {
-                        // Single-byte character (ASCII), boundary found.
-                        break;
-                    } else if ((c & 0xC0) == 0xC0) {
-                        // Multi-byte character start found.
-                        break;
-                    }
-                }
-                text.insert_batch(text.begin(), last_text.begin() + static_cast<ptrdiff_t>(start_pos + offset), left_size - offset);
-            }
-        }
-        snapshot_text_continuous_ = true;
-        return text;
+        struct format_context {
+            log_snapshot* snapshot;
+            time_zone* tz;
+        } context { this, &time_zone_tmp };
+        snapshot_buffers_[HISTORY_BUFFER_INDEX]->data_traverse([](uint8_t* data, uint32_t size, void* user_data) {
+            auto& ctx = *static_cast<format_context*>(user_data);
+            bq::log_entry_handle item(data, size);
+            ctx.snapshot->snapshot_layout_.do_layout(item, *ctx.tz, &ctx.snapshot->parent_log_->get_categories_name());
+            ctx.snapshot->snapshot_text_.insert_batch(ctx.snapshot->snapshot_text_.end(), ctx.snapshot->snapshot_layout_.get_formated_str(), ctx.snapshot->snapshot_layout_.get_formated_str_len());
+            ctx.snapshot->snapshot_text_.insert(ctx.snapshot->snapshot_text_.end(), '\n');
+            ctx.snapshot->snapshot_layout_.tidy_memory();
+        },
+            &context);
+        return snapshot_text_;
     }
 
     void log_snapshot::release_snapshot_string()
@@ -220,4 +240,78 @@ namespace bq {
         lock_.unlock();
     }
 
-}
\ No newline at end of file
+    bool log_snapshot::take_snapshot_binary(const bq::string& path)
+    {
+        // Same layout as a new file written by appender_file_raw: file header, one plaintext segment,
+        // the metadata of the first segment and then [item_size][log entry] items.
+        bq::array<uint8_t> content;
+        {
+            bq::platform::scoped_spin_lock scoped_lock(lock_);
+            if (!snapshot_buffers_[HISTORY_BUFFER_INDEX]) {
+#ifndef BQ_UNIT_TEST
+                bq::util::log_device_console_plain_text(log_level::warning, "calling take_snapshot_binary without enable snapshot");
+#endif
+                return false;
+            }
+            rotate_generation();
+
+            appender_file_binary::appender_file_header file_head;
+            memset(&file_head, 0, sizeof(file_head));
+            file_head.version = appender_file_raw::format_version;
+            file_head.format = appender_file_binary::appender_format_type::raw;
+            file_head.block_compression = appender_file_binary::appender_block_compression::none;
+            content.insert_batch(content.end(), reinterpret_cast<const uint8_t*>(&file_head), sizeof(file_head));
+
+            appender_file_binary::appender_file_segment_head segment_head;
+            memset(&segment_head, 0, sizeof(segment_head));
+            segment_head.next_seg_pos = UINT64_MAX;
+            segment_head.seg_type = appender_file_binary::appender_segment_type::normal;
+            segment_head.enc_type = appender_file_binary::appender_encryption_type::plaintext;
+            segment_head.has_key = false;
+            content.insert_batch(content.end(), reinterpret_cast<const uint8_t*>(&segment_head), sizeof(segment_head));
+
+            time_zone local_time_zone;
+            appender_file_binary::appender_payload_metadata payload_metadata;
+            memset(&payload_metadata, 0, sizeof(payload_metadata));
+            payload_metadata.magic_number[0] = 2;
+            payload_metadata.magic_number[1] = 2;
+            payload_metadata.magic_number[2] = 7;
+            payload_metadata.use_local_time = local_time_zone.is_use_local_time();
+            payload_metadata.gmt_offset_hours = local_time_zone.get_gmt_offset_hours();
+            payload_metadata.gmt_offset_minutes = local_time_zone.get_gmt_offset_minutes();
+            payload_metadata.time_zone_diff_to_gmt_ms = local_time_zone.get_time_zone_diff_to_gmt_ms();
+            snprintf(payload_metadata.time_zone_str, sizeof(payload_metadata.time_zone_str), "%s", local_time_zone.get_time_zone_str().c_str());
+            payload_metadata.category_count = parent_log_->get_categories_count();
+            content.insert_batch(content.end(), reinterpret_cast<const uint8_t*>(&payload_metadata), sizeof(payload_metadata));
+            for (uint32_t i = 0; i < payload_metadata.category_count; ++i) {
+                const bq::string& category_name = parent_log_->get_categories_name()[i];
+                uint32_t name_len = (uint32_t)category_name.size();
+                content.insert_batch(content.end(), reinterpret_cast<const uint8_t*>(&name_len), sizeof(name_len));
+                content.insert_batch(content.end(), reinterpret_cast<const uint8_t*>(category_name.c_str()), static_cast<size_t>(name_len));
+            }
+
+            snapshot_buffers_[HISTORY_BUFFER_INDEX]->data_traverse([](uint8_t* data, uint32_t size, void* user_data) {
+                auto& out = *static_cast<bq::array<uint8_t>*>(user_data);
+                out.insert_batch(out.end(), reinterpret_cast<const uint8_t*>(&size), sizeof(size));
+                out.insert_batch(out.end(), data, static_cast<size_t>(size));
+            },
+                &content);
+        }
+
+        // file io is done out of the lock.
+        bq::string abs_path = TO_ABSOLUTE_PATH(path, 0);
+        bq::file_manager::create_directory(bq::file_manager::get_directory_from_path(abs_path));
+        auto& fm = bq::file_manager::instance();
+        auto file = fm.open_file(abs_path, file_open_mode_enum::auto_create | file_open_mode_enum::write | file_open_mode_enum::exclusive);
+        if (!file) {
+            bq::util::log_device_console(bq::log_level::error, "take_snapshot_binary failed to open file:%s", abs_path.c_str());
+            return false;
+        }
+        fm.truncate_file(file, 0);
+        bool success = (fm.write_file(file, content.begin(), content.size()) == content.size());
+        success = success && fm.flush_file(file);
+        fm.close_file(file);
+        return success;
+    }
+
+}
@@ -11,8 +11,11 @@
  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  */
 
-// this class is not thread safe.
-// write_data() and take_snapshot() can not be called in the same time
+// write_data() is called by the log processing thread and never takes a lock: entries go to the
+// active one of two generation buffers. Taking a snapshot switches the active generation, waits for
+// a write in progress on the previous one to finish, and moves its entries to the history buffer,
+// which keeps the latest entries (up to buffer_size bytes) for the snapshots.
+// take_snapshot_xxx() and reset_config() are serialized by lock_.
 #include "bq_common/bq_common.h"
 #include "bq_log/misc/bq_log_def.h"
 #include "bq_log/types/buffer/siso_ring_buffer.h"
@@ -22,6 +25,11 @@
 
 namespace bq {
     class log_snapshot {
+    private:
+        static constexpr uint32_t GENERATION_COUNT = 2;
+        static constexpr uint32_t HISTORY_BUFFER_INDEX = GENERATION_COUNT;
+        static constexpr uint32_t INVALID_GENERATION = UINT32_MAX;
+
     public:
         log_snapshot(class log_imp* parent_log, const bq::property_value& snapshot_config);
 
@@ -38,18 +46,31 @@ namespace bq {
         // take_snapshot_string and release_snapshot_string must be called in pair, or the lock will not be released
         void release_snapshot_string();
 
+        // Dump the snapshot entries to a raw binary log file (the .lograw format) without formatting them,
+        // it can be decoded offline by the log decoders.
+        bool take_snapshot_binary(const bq::string& path);
+
         bq_forceinline bool is_enable() const
         {
-            return (bool)snapshot_buffer_;
+            return active_generation_.load_relaxed() != INVALID_GENERATION;
         }
 
+    private:
+        void create_buffers();
+        void destroy_buffers();
+        void push_entry(uint32_t buffer_index, const uint8_t* data, uint32_t size);
+        uint32_t disable_writing();
+        void collect_generation(uint32_t generation);
+        void rotate_generation();
+
     private:
         uint32_t buffer_size_;
-        siso_ring_buffer* snapshot_buffer_;
-        uint8_t* buffer_data_;
-        bq::string snapshot_text_[2];
-        uint32_t snapshot_text_index_;
-        bool snapshot_text_continuous_;
+        // GENERATION_COUNT generation buffers for write_data(), followed by the history buffer.
+        siso_ring_buffer* snapshot_buffers_[GENERATION_COUNT + 1];
+        uint8_t* buffer_datas_[GENERATION_COUNT + 1];
+        bq::platform::atomic<uint32_t> active_generation_;
+        bq::platform::atomic<uint32_t> writing_generation_;
+        bq::string snapshot_text_;
 
         bq::platform::spin_lock lock_;
 
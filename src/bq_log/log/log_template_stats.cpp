@@ -0,0 +1,179 @@
+﻿/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "bq_log/log/log_template_stats.h"
+#include "bq_log/utils/log_utils.h"
+
+namespace bq {
+    static constexpr uint32_t INVALID_TEMPLATE_INDEX = UINT32_MAX;
+
+    uint32_t log_template_stats::find(uint64_t format_hash, bq::log_level level, uint32_t category_idx, uint32_t& out_chain_tail) const
+    {
+        out_chain_tail = INVALID_TEMPLATE_INDEX;
+        auto iter = first_index_by_hash_.find(format_hash);
+        if (iter == first_index_by_hash_.end()) {
+            return INVALID_TEMPLATE_INDEX;
+        }
+        for (uint32_t index = iter->value(); index != INVALID_TEMPLATE_INDEX; index = next_same_hash_[index]) {
+            const template_info& info = templates_[index];
+            if (info.level == level && info.category_idx == category_idx) {
+                return index;
+            }
+            out_chain_tail = index;
+        }
+        return INVALID_TEMPLATE_INDEX;
+    }
+
+    log_template_stats::template_info& log_template_stats::find_or_add(uint64_t format_hash, bq::log_level level, uint32_t category_idx, bool& out_is_new)
+    {
+        uint32_t prev_index;
+        uint32_t found_index = find(format_hash, level, category_idx, prev_index);
+        if (found_index != INVALID_TEMPLATE_INDEX) {
+            out_is_new = false;
+            return templates_[found_index];
+        }
+        uint32_t new_index = static_cast<uint32_t>(templates_.size());
+        templates_.push_back(template_info());
+        next_same_hash_.push_back(INVALID_TEMPLATE_INDEX);
+        if (prev_index == INVALID_TEMPLATE_INDEX) {
+            first_index_by_hash_[format_hash] = new_index;
+        } else {
+            next_same_hash_[prev_index] = new_index;
+        }
+        template_info& info = templates_[new_index];
+        info.format_hash = format_hash;
+        info.level = level;
+        info.category_idx = category_idx;
+        out_is_new = true;
+        return info;
+    }
+
+    void log_template_stats::add(uint64_t format_hash, bq::log_level level, uint32_t category_idx, uint64_t epoch_ms, uint64_t bytes, const char* format_utf8, size_t format_len)
+    {
+        bool is_new;
+        template_info& info = find_or_add(format_hash, level, category_idx, is_new);
+        if (is_new && format_len > 0) {
+            info.format.insert_batch(info.format.end(), format_utf8, format_len);
+        }
+        ++info.count;
+        info.total_bytes += bytes;
+        info.first_epoch_ms = bq::min_value(info.first_epoch_ms, epoch_ms);
+        info.last_epoch_ms = bq::max_value(info.last_epoch_ms, epoch_ms);
+        ++total_count_;
+        total_bytes_ += bytes;
+        first_epoch_ms_ = bq::min_value(first_epoch_ms_, epoch_ms);
+        last_epoch_ms_ = bq::max_value(last_epoch_ms_, epoch_ms);
+    }
+
+    void log_template_stats::add(const bq::log_entry_handle& log_entry, uint64_t bytes)
+    {
+        const auto& head = log_entry.get_log_head();
+        const char* format_data = log_entry.get_format_string_data();
+        size_t format_data_len = static_cast<size_t>(head.log_format_data_len);
+        uint64_t format_hash = head.format_hash ? head.format_hash : bq::util::get_hash_64(format_data, format_data_len);
+        if (head.log_format_str_type != static_cast<uint8_t>(log_arg_type_enum::string_utf16_type)) {
+            add(format_hash, static_cast<bq::log_level>(head.level), head.category_idx, head.timestamp_epoch, bytes, format_data, format_data_len);
+            return;
+        }
+        // the format is only kept by a new template, a utf16 one is not converted for every entry.
+        const char* format_utf8 = nullptr;
+        size_t format_utf8_len = 0;
+        uint32_t chain_tail;
+        if (format_data_len > 0 && find(format_hash, static_cast<bq::log_level>(head.level), head.category_idx, chain_tail) == INVALID_TEMPLATE_INDEX) {
+            uint32_t char_count = static_cast<uint32_t>(format_data_len / sizeof(char16_t));
+            // the format string data is 4 bytes aligned in the entry, but may be in a file mapping when decoding
+            utf16_tmp_.clear();
+            utf16_tmp_.fill_uninitialized(char_count);
+            memcpy(utf16_tmp_.begin(), format_data, static_cast<size_t>(char_count) * sizeof(char16_t));
+            utf8_tmp_.clear();
+            utf8_tmp_.fill_uninitialized(static_cast<size_t>(char_count) * 3 + 1);
+            format_utf8_len = static_cast<size_t>(bq::util::utf16_to_utf8(utf16_tmp_.begin(), char_count, utf8_tmp_.begin(), static_cast<uint32_t>(utf8_tmp_.size())));
+            format_utf8 = utf8_tmp_.begin();
+        }
+        add(format_hash, static_cast<bq::log_level>(head.level), head.category_idx, head.timestamp_epoch, bytes, format_utf8, format_utf8_len);
+    }
+
+    void log_template_stats::clear()
+    {
+        templates_.clear();
+        next_same_hash_.clear();
+        first_index_by_hash_.clear();
+        total_count_ = 0;
+        total_bytes_ = 0;
+        first_epoch_ms_ = UINT64_MAX;
+        last_epoch_ms_ = 0;
+    }
+
+    void log_template_stats::make_report(const bq::array<bq::string>& categories_name, bq::string& out_text) const
+    {
+        // the span of a single millisecond still gives a rate.
+        double span_seconds = static_cast<double>(bq::max_value(last_epoch_ms_ > first_epoch_ms_ ? last_epoch_ms_ - first_epoch_ms_ : 0, static_cast<uint64_t>(1))) / 1000.0;
+        char line[512];
+        snprintf(line, sizeof(line), "templates: %" PRIu64 ", entries: %" PRIu64 ", bytes: %" PRIu64 ", time span: %.3f s\n",
+            static_cast<uint64_t>(templates_.size()), total_count_, total_bytes_, total_count_ > 0 ? span_seconds : 0.0);
+        out_text += line;
+        snprintf(line, sizeof(line), "%12s %14s %7s %12s %14s  %-7s  %-16s  %-18s  %s\n", "count", "bytes", "bytes%", "count/s", "bytes/s", "level", "category", "format_hash", "format");
+        out_text += line;
+
+        struct sort_item {
+            uint64_t total_bytes;
+            uint32_t index;
+        };
+        bq::array<sort_item> sorted;
+        sorted.set_capacity(templates_.size());
+        for (size_t i = 0; i < templates_.size(); ++i) {
+            sorted.push_back(sort_item { templates_[i].total_bytes, static_cast<uint32_t>(i) });
+        }
+        if (sorted.size() > 0) {
+            qsort(&sorted[0], sorted.size(), sizeof(sort_item), [](void const* v1, void const* v2) {
+                const sort_item* item1 = static_cast<const sort_item*>(v1);
+                const sort_item* item2 = static_cast<const sort_item*>(v2);
+                if (item1->total_bytes != item2->total_bytes) {
+                    return item1->total_bytes > item2->total_bytes ? -1 : 1;
+                }
+                return item1->index < item2->index ? -1 : 1;
+            });
+        }
+        for (const sort_item& item : sorted) {
+            const template_info& info = templates_[item.index];
+            char category_tmp[16];
+            const char* category_name = category_tmp;
+            if (info.category_idx < categories_name.size()) {
+                category_name = categories_name[info.category_idx].is_empty() ? "\"\"" : categories_name[info.category_idx].c_str();
+            } else {
+                snprintf(category_tmp, sizeof(category_tmp), "#%" PRIu32, info.category_idx);
+            }
+            double bytes_percent = total_bytes_ > 0 ? static_cast<double>(info.total_bytes) * 100.0 / static_cast<double>(total_bytes_) : 0.0;
+            snprintf(line, sizeof(line), "%12" PRIu64 " %14" PRIu64 " %6.2f%% %12.1f %14.1f  %-7s  %-16s  0x%016" PRIx64 "  ",
+                info.count, info.total_bytes, bytes_percent, static_cast<double>(info.count) / span_seconds, static_cast<double>(info.total_bytes) / span_seconds,
+                log_utils::get_level_name(info.level), category_name, info.format_hash);
+            out_text += line;
+            // one line per template
+            for (char c : info.format) {
+                switch (c) {
+                case '\n':
+                    out_text += "\\n";
+                    break;
+                case '\r':
+                    out_text += "\\r";
+                    break;
+                case '\t':
+                    out_text += "\\t";
+                    break;
+                default:
+                    out_text.push_back(c);
+                    break;
+                }
+            }
+            out_text.push_back('\n');
+        }
+    }
+}
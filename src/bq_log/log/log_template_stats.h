@@ -0,0 +1,90 @@
+﻿#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+/*!
+ * \class log_template_stats
+ *
+ * Log volume per format template: how many entries each call site produced and how many bytes they took,
+ * so noisy call sites can be found without formatting any entry.
+ * A template is a format string hash (the same as log_decode_filter::format_hashes) with a level and a category,
+ * which is also how appender_file_compressed groups log entries.
+ *
+ * Used by the decoders (see appender_decoder_base::set_template_stats) and by log_imp when "log.template_stats" is enabled.
+ * This class is not thread safe.
+ */
+#include "bq_common/bq_common.h"
+#include "bq_log/misc/bq_log_def.h"
+#include "bq_log/log/log_types.h"
+
+namespace bq {
+    class log_template_stats {
+    public:
+        struct template_info {
+            uint64_t format_hash = 0;
+            bq::log_level level = bq::log_level::log_level_max;
+            uint32_t category_idx = 0;
+            uint64_t count = 0;
+            uint64_t total_bytes = 0;
+            uint64_t first_epoch_ms = UINT64_MAX;
+            uint64_t last_epoch_ms = 0;
+            bq::string format; // utf8
+        };
+
+    public:
+        /// <summary>
+        /// Count a log entry, format_utf8 is only copied the first time the template is seen.
+        /// </summary>
+        /// <param name="bytes">size of the entry as it is stored</param>
+        void add(uint64_t format_hash, bq::log_level level, uint32_t category_idx, uint64_t epoch_ms, uint64_t bytes, const char* format_utf8, size_t format_len);
+
+        /// <summary>
+        /// Same as above, with the fields and the format string (utf8 or utf16) read from log_entry.
+        /// The format hash is computed from the format string data if the entry head doesn't have one.
+        /// </summary>
+        void add(const bq::log_entry_handle& log_entry, uint64_t bytes);
+
+        void clear();
+
+        bool is_empty() const { return templates_.is_empty(); }
+
+        // in the order they were first seen
+        const bq::array<template_info>& get_templates() const { return templates_; }
+
+        uint64_t get_total_count() const { return total_count_; }
+
+        uint64_t get_total_bytes() const { return total_bytes_; }
+
+        /// <summary>
+        /// Append a text table to out_text, one line per template sorted by total bytes, the largest first.
+        /// Rates are per second over the time span of all the counted entries.
+        /// </summary>
+        void make_report(const bq::array<bq::string>& categories_name, bq::string& out_text) const;
+
+    private:
+        template_info& find_or_add(uint64_t format_hash, bq::log_level level, uint32_t category_idx, bool& out_is_new);
+
+        // returns UINT32_MAX if not found, out_chain_tail is the last template with the same hash then(UINT32_MAX if none).
+        uint32_t find(uint64_t format_hash, bq::log_level level, uint32_t category_idx, uint32_t& out_chain_tail) const;
+
+    private:
+        bq::array<template_info> templates_;
+        // templates sharing a format hash (same format string at other levels or categories) are chained by index.
+        bq::array<uint32_t> next_same_hash_;
+        bq::hash_map<uint64_t, uint32_t> first_index_by_hash_;
+        bq::array<char16_t> utf16_tmp_;
+        bq::array<char> utf8_tmp_;
+        uint64_t total_count_ = 0;
+        uint64_t total_bytes_ = 0;
+        uint64_t first_epoch_ms_ = UINT64_MAX;
+        uint64_t last_epoch_ms_ = 0;
+    };
+}
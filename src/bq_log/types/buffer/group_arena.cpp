@@ -0,0 +1,105 @@
+﻿/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+/*!
+ * \class bq::group_arena
+ *
+ * One memory mapped file holding the recoverable memory of all the group_node instances of a log_buffer.
+ */
+
+#include "bq_log/types/buffer/group_arena.h"
+
+namespace bq {
+    static size_t get_arena_head_size()
+    {
+        constexpr size_t raw_size = sizeof(uint64_t) * 3 + sizeof(uint64_t) * group_arena::SLOT_COUNT;
+        return (raw_size + BQ_CACHE_LINE_SIZE - 1) / BQ_CACHE_LINE_SIZE * BQ_CACHE_LINE_SIZE;
+    }
+
+    group_arena::group_arena(const bq::string& mmap_file_abs_path, size_t group_size)
+        : slot_size_((group_size + BQ_CACHE_LINE_SIZE - 1) / BQ_CACHE_LINE_SIZE * BQ_CACHE_LINE_SIZE)
+        , slot_count_(static_cast<uint32_t>(bq::min_value(static_cast<size_t>(SLOT_COUNT), MAX_ARENA_SIZE / slot_size_)))
+    {
+        static_assert(sizeof(arena_head) == sizeof(uint64_t) * 3 + sizeof(uint64_t) * SLOT_COUNT, "invalid arena_head size");
+        if (slot_count_ < 2) {
+            // One group per file is what group_node does without an arena.
+            return;
+        }
+        const size_t head_size = get_arena_head_size();
+        buffer_entity_ = bq::make_unique<normal_buffer>(head_size + slot_size_ * slot_count_, mmap_file_abs_path, true);
+        if (!buffer_entity_->is_memory_mapped()) {
+            // Heap memory can't be recovered, let every group_node decide by itself.
+            buffer_entity_.reset();
+            return;
+        }
+        head_ = static_cast<arena_head*>(buffer_entity_->data());
+        slots_addr_ = static_cast<uint8_t*>(buffer_entity_->data()) + head_size;
+        if (buffer_entity_->get_mmap_result() != create_memory_map_result::use_existed
+            || head_->magic_ != ARENA_MAGIC
+            || head_->slot_size_ != slot_size_
+            || head_->slot_count_ != slot_count_) {
+            init_head();
+        }
+    }
+
+    void group_arena::init_head()
+    {
+        memset(head_, 0, sizeof(arena_head));
+        head_->slot_size_ = slot_size_;
+        head_->slot_count_ = slot_count_;
+        head_->magic_ = ARENA_MAGIC;
+    }
+
+    uint8_t* group_arena::find_slot(uint64_t group_index)
+    {
+        bq::platform::scoped_spin_lock lock(lock_);
+        for (uint32_t i = 0; i < slot_count_; ++i) {
+            if (head_->group_indices_[i] == group_index) {
+                return slots_addr_ + slot_size_ * i;
+            }
+        }
+        return nullptr;
+    }
+
+    uint8_t* group_arena::alloc_slot(uint64_t group_index)
+    {
+        assert(group_index != INVALID_GROUP_INDEX && "invalid group index");
+        bq::platform::scoped_spin_lock lock(lock_);
+        for (uint32_t i = 0; i < slot_count_; ++i) {
+            if (head_->group_indices_[i] == INVALID_GROUP_INDEX) {
+                head_->group_indices_[i] = group_index;
+                return slots_addr_ + slot_size_ * i;
+            }
+        }
+        return nullptr;
+    }
+
+    void group_arena::free_slot(const uint8_t* slot)
+    {
+        size_t slot_idx = static_cast<size_t>(slot - slots_addr_) / slot_size_;
+        assert(slot_idx < slot_count_ && slots_addr_ + slot_size_ * slot_idx == slot && "invalid arena slot");
+        bq::platform::scoped_spin_lock lock(lock_);
+        head_->group_indices_[slot_idx] = INVALID_GROUP_INDEX;
+    }
+
+    bq::array<uint64_t> group_arena::get_saved_group_indices()
+    {
+        bq::array<uint64_t> result;
+        bq::platform::scoped_spin_lock lock(lock_);
+        for (uint32_t i = 0; i < slot_count_; ++i) {
+            const uint64_t group_index = head_->group_indices_[i];
+            if (group_index != INVALID_GROUP_INDEX) {
+                result.push_back(group_index);
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,88 @@
+﻿#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+/*!
+ * \class bq::group_arena
+ *
+ * One memory mapped file holding the recoverable memory of all the group_node instances of a log_buffer,
+ * instead of one file per group index.
+ * The file is sized once for up to SLOT_COUNT groups (the pages of unused slots are never touched, so on most file systems
+ * they take no disk space) and mapped only once. A header table records which group index lives in each slot,
+ * recovery is a single pass over that table.
+ * Every group of a log has the same size, so slots are fixed-size and allocation is a lookup in the table.
+ * When all the slots are in use, group_node falls back to its own memory mapped file.
+ */
+#include "bq_common/bq_common.h"
+#include "bq_log/types/buffer/normal_buffer.h"
+
+namespace bq {
+    class group_arena {
+    public:
+#if defined(BQ_MOBILE_PLATFORM)
+        static constexpr uint32_t SLOT_COUNT = 16;
+#else
+        static constexpr uint32_t SLOT_COUNT = 64;
+#endif
+        // Caps the address space reserved by the arena when groups are large (big "buffer_size" configs).
+        static constexpr size_t MAX_ARENA_SIZE = (sizeof(void*) == 8) ? (size_t)256 * 1024 * 1024 : (size_t)32 * 1024 * 1024;
+        static constexpr uint64_t INVALID_GROUP_INDEX = 0; // group indices allocated by group_list start from 1.
+        static constexpr uint64_t ARENA_MAGIC = 0x414E455241475142ULL; // "BQGARENA"
+
+    private:
+        BQ_PACK_BEGIN
+        struct alignas(8) arena_head {
+            uint64_t magic_;
+            uint64_t slot_size_;
+            uint32_t slot_count_;
+            uint32_t reserved_;
+            uint64_t group_indices_[SLOT_COUNT]; // group index stored in each slot, INVALID_GROUP_INDEX means free.
+        } BQ_PACK_END
+
+    public:
+        group_arena(const bq::string& mmap_file_abs_path, size_t group_size);
+
+        /// <summary>
+        /// False if the arena could not be backed by a memory mapped file, it must not be used then.
+        /// </summary>
+        bq_forceinline bool is_valid() const { return head_ != nullptr; }
+
+        bq_forceinline size_t get_slot_size() const { return slot_size_; }
+
+        /// <summary>
+        /// Slot of a group saved by the previous run, nullptr if group_index is not in the arena.
+        /// </summary>
+        uint8_t* find_slot(uint64_t group_index);
+
+        /// <summary>
+        /// Takes a free slot for group_index, nullptr if the arena is full.
+        /// </summary>
+        uint8_t* alloc_slot(uint64_t group_index);
+
+        /// <summary>
+        /// Gives the slot back, its content will not be recovered any more.
+        /// </summary>
+        void free_slot(const uint8_t* slot);
+
+        bq::array<uint64_t> get_saved_group_indices();
+
+    private:
+        void init_head();
+
+    private:
+        bq::unique_ptr<normal_buffer> buffer_entity_;
+        arena_head* head_ = nullptr;
+        uint8_t* slots_addr_ = nullptr;
+        size_t slot_size_;
+        uint32_t slot_count_;
+        bq::platform::spin_lock lock_;
+    };
+}
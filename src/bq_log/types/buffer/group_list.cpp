@@ -96,16 +96,38 @@ namespace bq {
         size_t meta_size = get_group_meta_size(config);
         size_t data_size = get_group_data_size(config, max_block_count_per_group);
         size_t desired_size = meta_size + data_size;
+        // A group saved in its own file by an older version or by an overflowed arena keeps using that file.
+        group_arena* arena = parent_list_->get_arena();
+        if (arena && !bq::file_manager::is_file(path)) {
+            arena_slot_ = arena->find_slot(index);
+            if (arena_slot_) {
+                return create_memory_map_result::use_existed;
+            }
+            arena_slot_ = arena->alloc_slot(index);
+            if (arena_slot_) {
+                return create_memory_map_result::new_created;
+            }
+        }
         buffer_entity_ = bq::make_unique<normal_buffer>(desired_size, config.need_recovery ? path : "", true);
         return buffer_entity_->get_mmap_result();
     }
 
+    uint8_t* group_node::get_memory_addr()
+    {
+        return arena_slot_ ? arena_slot_ : static_cast<uint8_t*>(buffer_entity_->data());
+    }
+
+    size_t group_node::get_memory_size() const
+    {
+        return arena_slot_ ? parent_list_->get_arena()->get_slot_size() : buffer_entity_->size();
+    }
+
     bool group_node::try_recover_from_memory_map(const log_buffer_config& config, uint16_t max_block_count_per_group)
     {
         size_t meta_size = get_group_meta_size(config);
         size_t data_size = get_group_data_size(config, max_block_count_per_group);
 
-        auto mapped_data_addr = static_cast<uint8_t*>(buffer_entity_->data());
+        auto mapped_data_addr = get_memory_addr();
         if (*(uint64_t*)mapped_data_addr != config.calculate_check_sum()) {
             bq::util::log_device_console(bq::log_level::warning, "recover from memory map verify failed, create new memory map, log_name:%s", config.log_name.c_str());
             return false;
@@ -121,8 +143,8 @@ namespace bq {
     {
         size_t meta_size = get_group_meta_size(config);
         size_t data_size = get_group_data_size(config, max_block_count_per_group);
-        memset(buffer_entity_->data(), 0, buffer_entity_->size());
-        auto mapped_data_addr = static_cast<uint8_t*>(buffer_entity_->data());
+        auto mapped_data_addr = get_memory_addr();
+        memset(mapped_data_addr, 0, get_memory_size());
         *(uint64_t*)mapped_data_addr = config.calculate_check_sum();
         new ((void*)(mapped_data_addr + meta_size), bq::enum_new_dummy::dummy) group_data_head(
             max_block_count_per_group, mapped_data_addr + meta_size + sizeof(group_data_head), data_size - sizeof(group_data_head), config.need_recovery);
@@ -139,10 +161,14 @@ namespace bq {
     group_node::group_node(class group_list* parent_list, uint16_t max_block_count_per_group, uint64_t index)
     {
         parent_list_ = parent_list;
+#if defined(BQ_UNIT_TEST)
+        index_ = index;
+#endif
         // This high-frequency memory should be kept from being swapped to the swap partition or LLC as much as possible,
         // so having a memory map as a backing mechanism is a relatively cost-effective solution.
         const auto& config = parent_list->get_config();
         auto mmap_create_result = create_memory_map(config, max_block_count_per_group, index);
+        mmap_result_ = mmap_create_result;
         if (create_memory_map_result::failed == mmap_create_result) {
             init_memory(config, max_block_count_per_group);
         } else if (mmap_create_result == create_memory_map_result::new_created) {
@@ -159,6 +185,16 @@ namespace bq {
         head_ptr_ = nullptr;
     }
 
+    void group_node::discard_memory_map()
+    {
+        if (arena_slot_) {
+            parent_list_->get_arena()->free_slot(arena_slot_);
+            arena_slot_ = nullptr;
+        } else if (buffer_entity_->is_memory_mapped()) {
+            buffer_entity_->set_delete_mmap_when_destruct(true);
+        }
+    }
+
     group_list::group_list(const log_buffer_config& config, uint16_t max_block_count_per_group)
         : config_(config)
         , max_block_count_per_group_(max_block_count_per_group)
@@ -176,8 +212,18 @@ namespace bq {
         if (!bq::file_manager::is_dir(memory_map_folder)) {
             bq::file_manager::create_directory(memory_map_folder);
         }
+        const bq::string arena_file_name = config_.log_name + ".arena";
+        size_t group_size = group_node::get_group_meta_size(config_) + group_node::get_group_data_size(config_, max_block_count_per_group_);
+        arena_ = bq::make_unique<group_arena>(bq::file_manager::combine_path(memory_map_folder, arena_file_name), group_size);
+        if (!arena_->is_valid()) {
+            arena_.reset();
+        }
+        bq::array<uint64_t> recovery_indices;
         bq::array<bq::string> sub_names = bq::file_manager::get_sub_dirs_and_files_name(memory_map_folder);
         for (const bq::string& file_name : sub_names) {
+            if (file_name == arena_file_name) {
+                continue;
+            }
             bq::string full_path = bq::file_manager::combine_path(memory_map_folder, file_name);
             if (!file_name.end_with(".mmap") || !file_name.begin_with(config_.log_name + "_")) {
                 bq::util::log_device_console(bq::log_level::warning, "remove invalid mmap file:%s", full_path.c_str());
@@ -197,7 +243,77 @@ namespace bq {
             if (u64_value > current_group_index_.load(bq::platform::memory_order::relaxed)) {
                 current_group_index_.store(u64_value, bq::platform::memory_order::seq_cst);
             }
-            auto* new_node = bq::util::aligned_new<group_node>(BQ_CACHE_LINE_SIZE, this, max_block_count_per_group_, u64_value);
+            recovery_indices.push_back(u64_value);
+        }
+        if (arena_) {
+            for (uint64_t saved_index : arena_->get_saved_group_indices()) {
+                if (recovery_indices.find(saved_index) != recovery_indices.end()) {
+                    // A group file always wins in group_node::create_memory_map, release the stale slot.
+                    arena_->free_slot(arena_->find_slot(saved_index));
+                    continue;
+                }
+                if (saved_index > current_group_index_.load(bq::platform::memory_order::relaxed)) {
+                    current_group_index_.store(saved_index, bq::platform::memory_order::seq_cst);
+                }
+                recovery_indices.push_back(saved_index);
+            }
+        }
+        recover_group_nodes(recovery_indices);
+    }
+
+    group_list::recovery_worker::recovery_worker(group_list& parent)
+        : parent_(parent)
+    {
+        set_thread_name("BqGrpRecovery");
+    }
+
+    void group_list::recovery_worker::run()
+    {
+        parent_.recovery_worker_run();
+    }
+
+    void group_list::recovery_worker_run()
+    {
+        while (true) {
+            size_t idx = recovery_next_idx_.fetch_add(1, bq::platform::memory_order::relaxed);
+            if (idx >= recovery_indices_->size()) {
+                break;
+            }
+            recovery_nodes_[idx] = bq::util::aligned_new<group_node>(BQ_CACHE_LINE_SIZE, this, max_block_count_per_group_, (*recovery_indices_)[idx]);
+        }
+    }
+
+    /**
+     * Mapping a group file and validating its block lists touches every page of it, with many groups left by a crash
+     * this dominates the startup time. The files are independent, so they are processed by several threads, then
+     * linked in the original order on this thread. Streaming the recovered entries to appenders is done later by
+     * the consumer of log_buffer, while new entries are already being written.
+     */
+    void group_list::recover_group_nodes(const bq::array<uint64_t>& indices)
+    {
+        if (indices.is_empty()) {
+            return;
+        }
+        recovery_indices_ = &indices;
+#if defined(BQ_UNIT_TEST)
+        recovered_group_indices_ = indices;
+#endif
+        recovery_nodes_.clear();
+        recovery_nodes_.fill_uninitialized(indices.size());
+        recovery_next_idx_.store(0, bq::platform::memory_order::relaxed);
+        const size_t worker_count = bq::min_value(static_cast<size_t>(MAX_RECOVERY_THREADS), indices.size()) - 1;
+        bq::array<bq::unique_ptr<recovery_worker>> workers;
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers.push_back(bq::make_unique<recovery_worker>(*this));
+            workers[i]->start();
+        }
+        // The constructing thread is one of the workers.
+        recovery_worker_run();
+        for (auto& worker : workers) {
+            worker->join();
+        }
+
+        for (group_node* new_node : recovery_nodes_) {
             if (new_node) {
                 new_node->get_next_ptr().node_ = head_.node_;
             } else {
@@ -208,8 +324,24 @@ namespace bq {
             groups_count_.fetch_add_seq_cst(1);
 #endif
         }
+        recovery_nodes_.clear();
+        recovery_nodes_.shrink();
+        recovery_indices_ = nullptr;
     }
 
+#if defined(BQ_UNIT_TEST)
+    bq::array<uint64_t> group_list::get_group_indices()
+    {
+        bq::array<uint64_t> result;
+        auto iter = first(lock_type::read_lock);
+        while (iter) {
+            result.push_back(iter.value().get_index());
+            iter = next(iter, lock_type::read_lock);
+        }
+        return result;
+    }
+#endif
+
     group_list::~group_list()
     {
         while (auto iter = first(group_list::lock_type::write_lock)) {
@@ -298,6 +430,7 @@ namespace bq {
             },
                 &current_epoch_ms);
             if (candidiate) {
+                candidiate->discard_memory_map();
                 bq::util::aligned_delete(candidiate);
             } else {
                 break;
@@ -30,6 +30,7 @@
 #include "bq_log/types/buffer/block_list.h"
 #include "bq_log/types/buffer/memory_pool.h"
 #include "bq_log/types/buffer/normal_buffer.h"
+#include "bq_log/types/buffer/group_arena.h"
 
 namespace bq {
     BQ_PACK_BEGIN
@@ -49,25 +50,37 @@ namespace bq {
             bq_forceinline bool is_empty() const { return node_ == nullptr; }
         };
 
+    public:
+        static size_t get_group_meta_size(const log_buffer_config& config);
+        static size_t get_group_data_size(const log_buffer_config& config, uint16_t max_block_count_per_group);
+
     private:
-        size_t get_group_meta_size(const log_buffer_config& config);
-        size_t get_group_data_size(const log_buffer_config& config, uint16_t max_block_count_per_group);
         create_memory_map_result create_memory_map(const log_buffer_config& config, uint16_t max_block_count_per_group, uint64_t index);
         bool try_recover_from_memory_map(const log_buffer_config& config, uint16_t max_block_count_per_group);
         void init_memory_map(const log_buffer_config& config, uint16_t max_block_count_per_group);
         void init_memory(const log_buffer_config& config, uint16_t max_block_count_per_group);
+        uint8_t* get_memory_addr();
+        size_t get_memory_size() const;
 
     private:
         pointer_type next_;
-        bq::unique_ptr<bq::normal_buffer> buffer_entity_;
+        bq::unique_ptr<bq::normal_buffer> buffer_entity_; // nullptr when the memory is a slot of the arena of parent_list_.
+        uint8_t* arena_slot_ = nullptr;
+        create_memory_map_result mmap_result_ = create_memory_map_result::failed;
         group_data_head* head_ptr_ = nullptr;
         uint64_t in_pool_epoch_ms_ = 0;
         class group_list* parent_list_ = nullptr;
+#if defined(BQ_UNIT_TEST)
+        uint64_t index_ = 0;
+#endif
 
     public:
         group_node(class group_list* parent_list, uint16_t max_block_count_per_group, uint64_t index);
         ~group_node();
 
+        // Called before a group is garbage collected, its memory map data will not be recovered any more.
+        void discard_memory_map();
+
         bq_forceinline pointer_type& get_next_ptr() { return next_; }
         bq_forceinline group_data_head& get_data_head()
         {
@@ -87,8 +100,9 @@ namespace bq {
 #if defined(BQ_UNIT_TEST)
         bq_forceinline create_memory_map_result get_memory_map_status() const
         {
-            return buffer_entity_->get_mmap_result();
+            return mmap_result_;
         }
+        bq_forceinline uint64_t get_index() const { return index_; }
 #endif
     };
 
@@ -121,6 +135,21 @@ namespace bq {
             bq_forceinline bool operator!=(const group_list::iterator& rhs) const { return value_ != rhs.value_; }
         };
         static constexpr uint64_t GROUP_NODE_GC_LIFE_TIME_MS = 1000; // If a group node has not been used for 1 seconds, it will be deleted. Otherwise it can stay in the memory pool.
+        static constexpr uint32_t MAX_RECOVERY_THREADS = 4; // Upper bound of threads mapping and validating group files in parallel during recovery.
+
+    private:
+        // Maps and validates the recovered group files claimed from recovery_indices_, one group_node per file.
+        class recovery_worker : public bq::platform::thread {
+        public:
+            recovery_worker(group_list& parent);
+
+        protected:
+            virtual void run() override;
+
+        private:
+            group_list& parent_;
+        };
+
     public:
         group_list(const log_buffer_config& config, uint16_t max_block_count_per_group);
 
@@ -134,6 +163,10 @@ namespace bq {
 
 #if defined(BQ_UNIT_TEST)
         bq_forceinline int32_t get_groups_count() const { return groups_count_.load_seq_cst(); }
+        // Group indices from the head of the list to its tail.
+        bq::array<uint64_t> get_group_indices();
+        // Group indices passed to recover_group_nodes by the constructor, in their original order.
+        bq_forceinline const bq::array<uint64_t>& get_recovered_group_indices() const { return recovered_group_indices_; }
 #endif
 
         void garbage_collect();
@@ -254,15 +287,28 @@ namespace bq {
 
         bq_forceinline const log_buffer_config& get_config() const { return config_; }
 
+        // nullptr if recovery is disabled or the arena file is not available.
+        bq_forceinline group_arena* get_arena() { return arena_.get(); }
+
+    private:
+        void recover_group_nodes(const bq::array<uint64_t>& indices);
+        void recovery_worker_run();
+
     private:
         const log_buffer_config& config_;
         uint16_t max_block_count_per_group_;
 #if defined(BQ_UNIT_TEST)
         bq::platform::atomic<int32_t> groups_count_ = 0;
+        bq::array<uint64_t> recovered_group_indices_;
 #endif
         alignas(BQ_CACHE_LINE_SIZE) bq::platform::atomic<uint64_t> current_group_index_;
         alignas(BQ_CACHE_LINE_SIZE) group_node::pointer_type head_;
         alignas(BQ_CACHE_LINE_SIZE) memory_pool<group_node> pool_;
+        bq::unique_ptr<group_arena> arena_;
+        // Only used while constructing, see recover_group_nodes.
+        const bq::array<uint64_t>* recovery_indices_ = nullptr;
+        bq::array<group_node*> recovery_nodes_;
+        bq::platform::atomic<size_t> recovery_next_idx_ = 0;
     };
 
 }
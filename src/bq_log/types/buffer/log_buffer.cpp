@@ -133,6 +133,7 @@ namespace bq {
         , version_(config_.need_recovery ? ++lp_buffer_.get_mmap_misc_data<lp_buffer_head_misc>().saved_version_ : 0)
         , destruction_mark_(bq::make_shared<destruction_mark>())
         , current_oversize_buffer_index_(0)
+        , pooled_oversize_buffer_count_(0)
     {
         static bq::platform::atomic<uint64_t> id_generator(0);
         id_ = id_generator.add_fetch_relaxed(1);
@@ -156,6 +157,13 @@ namespace bq {
     {
         bq::platform::scoped_spin_lock lock(destruction_mark_->lock_);
         destruction_mark_->is_destructed_ = true;
+        for (auto& pool : oversize_buffer_pools_) {
+            while (auto* pooled_buffer = pool.pop()) {
+                // pooled buffers are always empty, there is nothing to recover from their mmap files.
+                pooled_buffer->buffer_.set_delete_mmap_when_destruct(true);
+                bq::unique_ptr<oversize_buffer_obj_def> deleter(pooled_buffer);
+            }
+        }
     }
 
     log_buffer_write_handle log_buffer::alloc_write_chunk(uint32_t size, uint64_t current_epoch_ms)
@@ -888,18 +896,31 @@ namespace bq {
                 over_size_buffer->buffer_lock_.read_unlock();
             }
         }
-        // try to alloc a new oversize buffer
+        // try to reuse a pooled oversize buffer of the same size class, or alloc a new one.
         if (enum_buffer_result_code::success != over_size_handle.result) {
-            uint32_t default_buffer_size = (size < (UINT32_MAX >> 1)) ? (size << 1) : UINT32_MAX;
-            bq::string abs_recovery_file_path;
-            if (config_.need_recovery) {
-                auto new_index = current_oversize_buffer_index_.add_fetch(1, bq::platform::memory_order::relaxed);
-                char tmp[32];
-                snprintf(tmp, sizeof(tmp), "_%" PRIu64 "", new_index);
-                abs_recovery_file_path = TO_ABSOLUTE_PATH("bqlog_mmap/mmap_" + config_.log_name + "/os/" + config_.log_name + tmp + ".mmap", 0);
+            uint32_t default_buffer_size = get_oversize_buffer_size(size);
+            uint8_t pool_class = get_oversize_pool_class(default_buffer_size);
+            bq::unique_ptr<oversize_buffer_obj_def> buffer_to_add;
+            if (pool_class < OVERSIZE_BUFFER_POOL_CLASS_COUNT) {
+                if (auto* pooled_buffer = oversize_buffer_pools_[pool_class].pop()) {
+                    pooled_oversize_buffer_count_.fetch_sub(1, bq::platform::memory_order::relaxed);
+                    pooled_buffer->is_thread_finished_ = false;
+                    pooled_buffer->buffer_.renew();
+                    buffer_to_add = bq::unique_ptr<oversize_buffer_obj_def>(pooled_buffer);
+                }
+            }
+            if (!buffer_to_add) {
+                bq::string abs_recovery_file_path;
+                if (config_.need_recovery) {
+                    auto new_index = current_oversize_buffer_index_.add_fetch(1, bq::platform::memory_order::relaxed);
+                    char tmp[32];
+                    snprintf(tmp, sizeof(tmp), "_%" PRIu64 "", new_index);
+                    abs_recovery_file_path = TO_ABSOLUTE_PATH("bqlog_mmap/mmap_" + config_.log_name + "/os/" + config_.log_name + tmp + ".mmap", 0);
+                }
+                buffer_to_add = bq::make_unique<oversize_buffer_obj_def>(default_buffer_size, abs_recovery_file_path, true);
             }
             bq::platform::scoped_spin_lock_write_crazy w_lock(temprorary_oversize_buffer_.array_lock_);
-            temprorary_oversize_buffer_.buffers_array_.emplace_back(bq::make_unique<oversize_buffer_obj_def>(default_buffer_size, abs_recovery_file_path, true));
+            temprorary_oversize_buffer_.buffers_array_.emplace_back(bq::move(buffer_to_add));
             auto& new_buffer = *(temprorary_oversize_buffer_.buffers_array_.end() - 1);
             new_buffer->buffer_lock_.read_lock();
             auto& oversize_buffer_context = new_buffer->buffer_.get_misc_data<context_head>();
@@ -991,11 +1012,13 @@ namespace bq {
 
     void log_buffer::rt_recycle_oversize_buffers()
     {
-        BQ_LIKELY_IF(temprorary_oversize_buffer_.buffers_array_.is_empty())
+        BQ_LIKELY_IF(temprorary_oversize_buffer_.buffers_array_.is_empty()
+            && pooled_oversize_buffer_count_.load(bq::platform::memory_order::relaxed) == 0)
         {
             return;
         }
         auto current_epoch_ms = bq::platform::high_performance_epoch_ms();
+        rt_evict_pooled_oversize_buffers(current_epoch_ms);
         bool need_recycle = false;
         {
             bq::platform::scoped_try_spin_lock_read_crazy array_read_try_lock(temprorary_oversize_buffer_.array_lock_);
@@ -1020,6 +1043,10 @@ namespace bq {
                         continue;
                     }
                     auto& oversize_buffer = *temprorary_oversize_buffer_.buffers_array_[index];
+                    // Buffers still in use keep their thread affinity, only idle ones go back to the pools.
+                    if (current_epoch_ms < oversize_buffer.last_used_epoch_ms_ + OVERSIZE_BUFFER_RECYCLE_INTERVAL_MS) {
+                        continue;
+                    }
                     bool is_empty = false;
                     {
                         bq::platform::scoped_try_spin_lock_write_crazy buffer_write_try_lock(oversize_buffer.buffer_lock_);
@@ -1059,17 +1086,64 @@ namespace bq {
                         }
                     }
                     if (is_empty) {
-                        bq::string abs_mmap_file_path = temprorary_oversize_buffer_.buffers_array_[index]->buffer_.get_mmap_file_path();
-                        temprorary_oversize_buffer_.buffers_array_.erase_replace(temprorary_oversize_buffer_.buffers_array_.begin() + static_cast<ptrdiff_t>(index));
-                        if (bq::file_manager::is_file(abs_mmap_file_path)) {
-                            bq::file_manager::remove_file_or_dir(abs_mmap_file_path);
+                        auto& buffer_ptr = temprorary_oversize_buffer_.buffers_array_[index];
+                        uint8_t pool_class = buffer_ptr->pool_class_;
+                        if (pool_class < OVERSIZE_BUFFER_POOL_CLASS_COUNT) {
+                            auto* pooled_buffer = buffer_ptr.release();
+                            pooled_buffer->last_used_epoch_ms_ = current_epoch_ms;
+                            oversize_buffer_pools_[pool_class].push(pooled_buffer);
+                            pooled_oversize_buffer_count_.fetch_add(1, bq::platform::memory_order::relaxed);
+                        } else {
+                            buffer_ptr->buffer_.set_delete_mmap_when_destruct(true);
                         }
+                        temprorary_oversize_buffer_.buffers_array_.erase_replace(temprorary_oversize_buffer_.buffers_array_.begin() + static_cast<ptrdiff_t>(index));
                     }
                 }
             }
         }
     }
 
+    void log_buffer::rt_evict_pooled_oversize_buffers(uint64_t current_epoch_ms)
+    {
+        if (pooled_oversize_buffer_count_.load(bq::platform::memory_order::relaxed) == 0) {
+            return;
+        }
+        for (auto& pool : oversize_buffer_pools_) {
+            while (auto* candidate = pool.evict([](const oversize_buffer_obj_def* buffer, void* user_data) {
+                uint64_t current_epoch_ms_local = *(uint64_t*)user_data;
+                return current_epoch_ms_local >= buffer->last_used_epoch_ms_ + OVERSIZE_BUFFER_POOL_LIFE_TIME_MS;
+            },
+                       &current_epoch_ms)) {
+                pooled_oversize_buffer_count_.fetch_sub(1, bq::platform::memory_order::relaxed);
+                candidate->buffer_.set_delete_mmap_when_destruct(true);
+                bq::unique_ptr<oversize_buffer_obj_def> deleter(candidate);
+            }
+        }
+    }
+
+    uint32_t log_buffer::get_oversize_buffer_size(uint32_t size)
+    {
+        // Round up to a power of two only once, after adding the context head and the chunk head,
+        // so that buffers can be shared between entries of similar sizes and can be recognized by their file size when recovering.
+        if (size > (static_cast<uint32_t>(1) << 30)) {
+            return UINT32_MAX;
+        }
+        return siso_ring_buffer::calculate_buffer_size_for_chunk(size + static_cast<uint32_t>(sizeof(context_head)));
+    }
+
+    uint8_t log_buffer::get_oversize_pool_class(uint32_t buffer_size)
+    {
+        if (buffer_size == 0 || (buffer_size & (buffer_size - 1)) != 0) {
+            return OVERSIZE_BUFFER_POOL_CLASS_COUNT;
+        }
+        uint8_t pool_class = 0;
+        while (buffer_size > 1) {
+            buffer_size >>= 1;
+            ++pool_class;
+        }
+        return pool_class;
+    }
+
 #if defined(BQ_UNIT_TEST)
     const log_buffer::log_tls_buffer_info& log_buffer::get_buffer_info_for_this_thread() const
     {
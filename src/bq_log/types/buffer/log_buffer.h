@@ -28,6 +28,7 @@
 #include "bq_log/types/buffer/miso_ring_buffer.h"
 #include "bq_log/types/buffer/group_list.h"
 #include "bq_log/types/buffer/oversize_buffer.h"
+#include "bq_log/types/buffer/memory_pool.h"
 
 namespace bq {
     class alignas(BQ_CACHE_LINE_SIZE) log_buffer {
@@ -44,6 +45,8 @@ namespace bq {
 #endif
         static constexpr uint64_t HP_BUFFER_CALL_FREQUENCY_CHECK_INTERVAL = 1000;
         static constexpr uint64_t OVERSIZE_BUFFER_RECYCLE_INTERVAL_MS = 1000;
+        static constexpr uint64_t OVERSIZE_BUFFER_POOL_LIFE_TIME_MS = 10000; // Idle oversize buffers stay in the size-class pools for 10 seconds before being deleted.
+        static constexpr uint8_t OVERSIZE_BUFFER_POOL_CLASS_COUNT = 32; // One pool per power-of-two buffer size.
 
     public:
         BQ_PACK_BEGIN
@@ -56,15 +59,17 @@ namespace bq {
             bool is_destructed_ = false;
         };
 
-        struct oversize_buffer_obj_def {
+        struct oversize_buffer_obj_def : public memory_pool_obj_base<oversize_buffer_obj_def, false> {
             bq::oversize_buffer buffer_;
             bq::platform::spin_lock_rw_crazy buffer_lock_;
             uint64_t last_used_epoch_ms_;
             bool is_thread_finished_;
+            uint8_t pool_class_; // OVERSIZE_BUFFER_POOL_CLASS_COUNT means this buffer can not be pooled.
             oversize_buffer_obj_def(uint32_t size, const bq::string& mmap_file_abs_path, bool auto_create)
                 : buffer_(size, mmap_file_abs_path, auto_create)
                 , last_used_epoch_ms_(0)
                 , is_thread_finished_(false)
+                , pool_class_(get_oversize_pool_class(size))
             {
             }
         };
@@ -198,8 +203,16 @@ namespace bq {
         const log_tls_buffer_info& get_buffer_info_for_this_thread() const;
 
         int32_t get_groups_count() const { return hp_buffer_.get_groups_count(); }
+        bq::array<uint64_t> get_group_indices() { return hp_buffer_.get_group_indices(); }
+        const bq::array<uint64_t>& get_recovered_group_indices() const { return hp_buffer_.get_recovered_group_indices(); }
         void garbage_collect() { hp_buffer_.garbage_collect(); }
         size_t get_garbage_count() { return hp_buffer_.get_garbage_count(); }
+        size_t get_oversize_buffer_count()
+        {
+            bq::platform::scoped_spin_lock_read_crazy r_lock(temprorary_oversize_buffer_.array_lock_);
+            return temprorary_oversize_buffer_.buffers_array_.size();
+        }
+        uint32_t get_pooled_oversize_buffer_count() { return pooled_oversize_buffer_count_.load(bq::platform::memory_order::relaxed); }
 #endif
     private:
         bq::block_node_head* alloc_new_hp_block();
@@ -244,6 +257,9 @@ namespace bq {
         bool rt_read_oversize_chunk(const log_buffer_read_handle& parent_handle, log_buffer_read_handle& out_oversize_handle);
         void rt_return_oversize_read_chunk(const log_buffer_read_handle& oversize_handle);
         void rt_recycle_oversize_buffers();
+        void rt_evict_pooled_oversize_buffers(uint64_t current_epoch_ms);
+        static uint32_t get_oversize_buffer_size(uint32_t size);
+        static uint8_t get_oversize_pool_class(uint32_t buffer_size);
 
     private:
         friend struct log_tls_info;
@@ -263,6 +279,10 @@ namespace bq {
 #endif
         } temprorary_oversize_buffer_; // used when allocating a large chunk of data that exceeds the size of lp_buffer or hp_buffer.
         bq::platform::atomic<uint64_t> current_oversize_buffer_index_;
+        // Empty oversize buffers recycled by the reading thread, grouped by buffer size, so that large entries
+        // reuse an already mapped buffer instead of creating a new one (and its mmap file) for each burst.
+        memory_pool<oversize_buffer_obj_def> oversize_buffer_pools_[OVERSIZE_BUFFER_POOL_CLASS_COUNT];
+        bq::platform::atomic<uint32_t> pooled_oversize_buffer_count_;
 
         struct alignas(BQ_CACHE_LINE_SIZE) {
             struct {
@@ -99,6 +99,12 @@ namespace bq {
             return get_buffer().get_total_blocks_count();
         }
 
+        // Rewinds an empty buffer, so that a chunk as large as the whole buffer fits again.
+        bq_forceinline void renew()
+        {
+            get_buffer().renew();
+        }
+
     private:
         bq_forceinline siso_ring_buffer& get_buffer() { return *(siso_ring_buffer*)siso_buffer_obj_; }
 
@@ -361,6 +361,14 @@ namespace bq {
         return expected_buffer_size + (uint32_t)(sizeof(head) + BQ_CACHE_LINE_SIZE);
     }
 
+    uint32_t siso_ring_buffer::calculate_buffer_size_for_chunk(uint32_t chunk_size)
+    {
+        size_t size_required = static_cast<size_t>(chunk_size) + BQ_POD_RUNTIME_OFFSET_OF(chunk_head_def, data);
+        size_required = (size_required + (BLOCK_SIZE - 1)) & ~(BLOCK_SIZE - 1);
+        size_required = bq::max_value(size_required, sizeof(block) * 4);
+        return bq::roundup_pow_of_two(static_cast<uint32_t>(size_required));
+    }
+
     bool siso_ring_buffer::is_thread_check_enable() const
     {
 #if defined(BQ_LOG_BUFFER_DEBUG)
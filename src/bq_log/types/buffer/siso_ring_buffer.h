@@ -258,6 +258,14 @@ namespace bq {
         /// <returns>The minimum buffer size required</returns>
         static uint32_t calculate_min_size_of_memory(uint32_t expected_buffer_size);
 
+        /// <summary>
+        /// Calculates the smallest power-of-two buffer size that can hold a single chunk
+        /// of chunk_size bytes, including its chunk head and block alignment.
+        /// </summary>
+        /// <param name="chunk_size">The size of the chunk which will be allocated by alloc_write_chunk</param>
+        /// <returns>The buffer size to be passed to calculate_min_size_of_memory</returns>
+        static uint32_t calculate_buffer_size_for_chunk(uint32_t chunk_size);
+
         /// <summary>
         /// Warning:ring buffer can only be read from one thread at same time.
         /// This option is only work in Debug build and will be ignored in Release build.
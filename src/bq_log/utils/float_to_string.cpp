@@ -0,0 +1,654 @@
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "bq_log/utils/float_to_string.h"
+#include "bq_common/bq_common.h"
+
+namespace bq {
+    namespace {
+        // "do it yourself floating point": f * 2^e
+        struct diy_fp {
+            uint64_t f;
+            int32_t e;
+
+            constexpr diy_fp(uint64_t f_, int32_t e_)
+                : f(f_)
+                , e(e_)
+            {
+            }
+
+            static diy_fp sub(const diy_fp& x, const diy_fp& y)
+            {
+                assert(x.e == y.e && x.f >= y.f);
+                return diy_fp(x.f - y.f, x.e);
+            }
+
+            // upper 64 bits of the 128 bits product, rounded
+            static diy_fp mul(const diy_fp& x, const diy_fp& y)
+            {
+                const uint64_t u_lo = x.f & 0xFFFFFFFFu;
+                const uint64_t u_hi = x.f >> 32u;
+                const uint64_t v_lo = y.f & 0xFFFFFFFFu;
+                const uint64_t v_hi = y.f >> 32u;
+
+                const uint64_t p0 = u_lo * v_lo;
+                const uint64_t p1 = u_lo * v_hi;
+                const uint64_t p2 = u_hi * v_lo;
+                const uint64_t p3 = u_hi * v_hi;
+
+                uint64_t q = (p0 >> 32u) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+                q += static_cast<uint64_t>(1) << 31u;
+                const uint64_t h = p3 + (p2 >> 32u) + (p1 >> 32u) + (q >> 32u);
+                return diy_fp(h, x.e + y.e + 64);
+            }
+
+            static diy_fp normalize(diy_fp x)
+            {
+                assert(x.f != 0);
+                while ((x.f >> 63u) == 0) {
+                    x.f <<= 1u;
+                    x.e--;
+                }
+                return x;
+            }
+
+            static diy_fp normalize_to(const diy_fp& x, int32_t target_exponent)
+            {
+                const int32_t delta = x.e - target_exponent;
+                assert(delta >= 0 && ((x.f << static_cast<uint32_t>(delta)) >> static_cast<uint32_t>(delta)) == x.f);
+                return diy_fp(x.f << static_cast<uint32_t>(delta), target_exponent);
+            }
+        };
+
+        struct boundaries {
+            diy_fp w;
+            diy_fp minus;
+            diy_fp plus;
+            // value == mantissa * 2^exponent, kept for the exact fallback
+            uint64_t mantissa;
+            int32_t exponent;
+            bool lower_boundary_is_closer;
+        };
+
+        // value and its normalized neighbor boundaries (m- and m+), in the precision of FLOAT_TYPE itself,
+        // so floats get the shortest digits for float instead of for double.
+        template <typename FLOAT_TYPE, typename BITS_TYPE, int32_t PRECISION, int32_t EXPONENT_BIAS>
+        boundaries compute_boundaries(FLOAT_TYPE value)
+        {
+            constexpr int32_t min_exp = 1 - EXPONENT_BIAS;
+            constexpr uint64_t hidden_bit = static_cast<uint64_t>(1) << (PRECISION - 1);
+
+            BITS_TYPE bits;
+            memcpy(&bits, &value, sizeof(bits));
+            const uint64_t biased_e = static_cast<uint64_t>(bits) >> (PRECISION - 1);
+            const uint64_t frac = static_cast<uint64_t>(bits) & (hidden_bit - 1);
+
+            const bool is_denormal = (biased_e == 0);
+            const diy_fp v = is_denormal ? diy_fp(frac, min_exp) : diy_fp(frac + hidden_bit, static_cast<int32_t>(biased_e) - EXPONENT_BIAS);
+
+            // the gap to the lower neighbor is half as large when value is a power of 2 (except the smallest normal)
+            const bool lower_boundary_is_closer = (frac == 0 && biased_e > 1);
+            const diy_fp m_plus = diy_fp(2 * v.f + 1, v.e - 1);
+            const diy_fp m_minus = lower_boundary_is_closer ? diy_fp(4 * v.f - 1, v.e - 2) : diy_fp(2 * v.f - 1, v.e - 1);
+
+            const diy_fp w_plus = diy_fp::normalize(m_plus);
+            const diy_fp w_minus = diy_fp::normalize_to(m_minus, w_plus.e);
+            return { diy_fp::normalize(v), w_minus, w_plus, v.f, v.e, lower_boundary_is_closer };
+        }
+
+        struct cached_power {
+            uint64_t f;
+            int32_t e;
+            int32_t k;
+        };
+
+        // normalized 10^k for k = -300, -292, ..., 324
+        static constexpr cached_power cached_powers[] = {
+            { 0xAB70FE17C79AC6CA, -1060, -300 },
+            { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+            { 0xBE5691EF416BD60C, -1007, -284 },
+            { 0x8DD01FAD907FFC3C, -980, -276 },
+            { 0xD3515C2831559A83, -954, -268 },
+            { 0x9D71AC8FADA6C9B5, -927, -260 },
+            { 0xEA9C227723EE8BCB, -901, -252 },
+            { 0xAECC49914078536D, -874, -244 },
+            { 0x823C12795DB6CE57, -847, -236 },
+            { 0xC21094364DFB5637, -821, -228 },
+            { 0x9096EA6F3848984F, -794, -220 },
+            { 0xD77485CB25823AC7, -768, -212 },
+            { 0xA086CFCD97BF97F4, -741, -204 },
+            { 0xEF340A98172AACE5, -715, -196 },
+            { 0xB23867FB2A35B28E, -688, -188 },
+            { 0x84C8D4DFD2C63F3B, -661, -180 },
+            { 0xC5DD44271AD3CDBA, -635, -172 },
+            { 0x936B9FCEBB25C996, -608, -164 },
+            { 0xDBAC6C247D62A584, -582, -156 },
+            { 0xA3AB66580D5FDAF6, -555, -148 },
+            { 0xF3E2F893DEC3F126, -529, -140 },
+            { 0xB5B5ADA8AAFF80B8, -502, -132 },
+            { 0x87625F056C7C4A8B, -475, -124 },
+            { 0xC9BCFF6034C13053, -449, -116 },
+            { 0x964E858C91BA2655, -422, -108 },
+            { 0xDFF9772470297EBD, -396, -100 },
+            { 0xA6DFBD9FB8E5B88F, -369, -92 },
+            { 0xF8A95FCF88747D94, -343, -84 },
+            { 0xB94470938FA89BCF, -316, -76 },
+            { 0x8A08F0F8BF0F156B, -289, -68 },
+            { 0xCDB02555653131B6, -263, -60 },
+            { 0x993FE2C6D07B7FAC, -236, -52 },
+            { 0xE45C10C42A2B3B06, -210, -44 },
+            { 0xAA242499697392D3, -183, -36 },
+            { 0xFD87B5F28300CA0E, -157, -28 },
+            { 0xBCE5086492111AEB, -130, -20 },
+            { 0x8CBCCC096F5088CC, -103, -12 },
+            { 0xD1B71758E219652C, -77, -4 },
+            { 0x9C40000000000000, -50, 4 },
+            { 0xE8D4A51000000000, -24, 12 },
+            { 0xAD78EBC5AC620000, 3, 20 },
+            { 0x813F3978F8940984, 30, 28 },
+            { 0xC097CE7BC90715B3, 56, 36 },
+            { 0x8F7E32CE7BEA5C70, 83, 44 },
+            { 0xD5D238A4ABE98068, 109, 52 },
+            { 0x9F4F2726179A2245, 136, 60 },
+            { 0xED63A231D4C4FB27, 162, 68 },
+            { 0xB0DE65388CC8ADA8, 189, 76 },
+            { 0x83C7088E1AAB65DB, 216, 84 },
+            { 0xC45D1DF942711D9A, 242, 92 },
+            { 0x924D692CA61BE758, 269, 100 },
+            { 0xDA01EE641A708DEA, 295, 108 },
+            { 0xA26DA3999AEF774A, 322, 116 },
+            { 0xF209787BB47D6B85, 348, 124 },
+            { 0xB454E4A179DD1877, 375, 132 },
+            { 0x865B86925B9BC5C2, 402, 140 },
+            { 0xC83553C5C8965D3D, 428, 148 },
+            { 0x952AB45CFA97A0B3, 455, 156 },
+            { 0xDE469FBD99A05FE3, 481, 164 },
+            { 0xA59BC234DB398C25, 508, 172 },
+            { 0xF6C69A72A3989F5C, 534, 180 },
+            { 0xB7DCBF5354E9BECE, 561, 188 },
+            { 0x88FCF317F22241E2, 588, 196 },
+            { 0xCC20CE9BD35C78A5, 614, 204 },
+            { 0x98165AF37B2153DF, 641, 212 },
+            { 0xE2A0B5DC971F303A, 667, 220 },
+            { 0xA8D9D1535CE3B396, 694, 228 },
+            { 0xFB9B7CD9A4A7443C, 720, 236 },
+            { 0xBB764C4CA7A44410, 747, 244 },
+            { 0x8BAB8EEFB6409C1A, 774, 252 },
+            { 0xD01FEF10A657842C, 800, 260 },
+            { 0x9B10A4E5E9913129, 827, 268 },
+            { 0xE7109BFBA19C0C9D, 853, 276 },
+            { 0xAC2820D9623BF429, 880, 284 },
+            { 0x80444B5E7AA7CF85, 907, 292 },
+            { 0xBF21E44003ACDD2D, 933, 300 },
+            { 0x8E679C2F5E44FF8F, 960, 308 },
+            { 0xD433179D9C8CB841, 986, 316 },
+            { 0x9E19DB92B4E31BA9, 1013, 324 },
+        };
+        static constexpr int32_t cached_powers_min_dec_exp = -300;
+        static constexpr int32_t cached_powers_dec_step = 8;
+
+        // keep the exponent of the scaled boundaries within [alpha, gamma], so the integral part fits in 32 bits.
+        static constexpr int32_t grisu_alpha = -60;
+        static constexpr int32_t grisu_gamma = -32;
+
+        cached_power get_cached_power_for_binary_exponent(int32_t e)
+        {
+            const int32_t f = grisu_alpha - e - 1;
+            // ceil(f * log10(2))
+            const int32_t k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+            const int32_t index = (-cached_powers_min_dec_exp + k + (cached_powers_dec_step - 1)) / cached_powers_dec_step;
+            assert(index >= 0 && static_cast<size_t>(index) < sizeof(cached_powers) / sizeof(cached_powers[0]));
+            const cached_power cached = cached_powers[index];
+            assert(grisu_alpha <= cached.e + e + 64 && grisu_gamma >= cached.e + e + 64);
+            return cached;
+        }
+
+        // number of decimal digits of n, and 10^(digits - 1)
+        bq_forceinline int32_t find_largest_pow10(uint32_t n, uint32_t& pow10)
+        {
+            if (n >= 1000000000) {
+                pow10 = 1000000000;
+                return 10;
+            }
+            if (n >= 100000000) {
+                pow10 = 100000000;
+                return 9;
+            }
+            if (n >= 10000000) {
+                pow10 = 10000000;
+                return 8;
+            }
+            if (n >= 1000000) {
+                pow10 = 1000000;
+                return 7;
+            }
+            if (n >= 100000) {
+                pow10 = 100000;
+                return 6;
+            }
+            if (n >= 10000) {
+                pow10 = 10000;
+                return 5;
+            }
+            if (n >= 1000) {
+                pow10 = 1000;
+                return 4;
+            }
+            if (n >= 100) {
+                pow10 = 100;
+                return 3;
+            }
+            if (n >= 10) {
+                pow10 = 10;
+                return 2;
+            }
+            pow10 = 1;
+            return 1;
+        }
+
+        // Grisu3 rounding: move the last digit towards w as long as the result stays inside the boundaries,
+        // returns false if the imprecision of the scaled values (unit) makes it impossible to prove the result is the shortest and closest one.
+        bool grisu3_round_weed(char* buf, int32_t len, uint64_t distance_too_high_w, uint64_t unsafe_interval, uint64_t rest, uint64_t ten_kappa, uint64_t unit)
+        {
+            const uint64_t small_distance = distance_too_high_w - unit;
+            const uint64_t big_distance = distance_too_high_w + unit;
+            while (rest < small_distance && unsafe_interval - rest >= ten_kappa
+                && (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance)) {
+                buf[len - 1]--;
+                rest += ten_kappa;
+            }
+            // the digit closest to w is ambiguous within the error range
+            if (rest < big_distance && unsafe_interval - rest >= ten_kappa
+                && (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance)) {
+                return false;
+            }
+            // the result must be safely inside the boundaries
+            return (2 * unit <= rest) && (rest <= unsafe_interval - 4 * unit);
+        }
+
+        bool grisu3_digit_gen(const diy_fp& low, const diy_fp& w, const diy_fp& high, char* buffer, int32_t& length, int32_t& kappa)
+        {
+            assert(low.e == w.e && w.e == high.e);
+            // low, w and high are imprecise by up to 1 unit, digits are generated for the widened (unsafe) interval and verified in grisu3_round_weed
+            uint64_t unit = 1;
+            const diy_fp too_low(low.f - unit, low.e);
+            const diy_fp too_high(high.f + unit, high.e);
+            uint64_t unsafe_interval = diy_fp::sub(too_high, too_low).f;
+            const uint32_t shift = static_cast<uint32_t>(-w.e);
+            const diy_fp one(static_cast<uint64_t>(1) << shift, w.e);
+            uint32_t integrals = static_cast<uint32_t>(too_high.f >> shift);
+            uint64_t fractionals = too_high.f & (one.f - 1);
+
+            uint32_t divisor = 0;
+            kappa = find_largest_pow10(integrals, divisor);
+            length = 0;
+            while (kappa > 0) {
+                buffer[length++] = static_cast<char>('0' + integrals / divisor);
+                integrals %= divisor;
+                kappa--;
+                const uint64_t rest = (static_cast<uint64_t>(integrals) << shift) + fractionals;
+                if (rest < unsafe_interval) {
+                    return grisu3_round_weed(buffer, length, diy_fp::sub(too_high, w).f, unsafe_interval, rest, static_cast<uint64_t>(divisor) << shift, unit);
+                }
+                divisor /= 10;
+            }
+
+            while (true) {
+                fractionals *= 10;
+                unit *= 10;
+                unsafe_interval *= 10;
+                buffer[length++] = static_cast<char>('0' + (fractionals >> shift));
+                fractionals &= one.f - 1;
+                kappa--;
+                if (fractionals < unsafe_interval) {
+                    return grisu3_round_weed(buffer, length, diy_fp::sub(too_high, w).f * unit, unsafe_interval, fractionals, one.f, unit);
+                }
+            }
+        }
+
+        bool grisu3(const boundaries& b, char* digits, uint32_t& digits_count, int32_t& point_pos)
+        {
+            const cached_power cached = get_cached_power_for_binary_exponent(b.plus.e);
+            const diy_fp c_minus_k(cached.f, cached.e);
+
+            const diy_fp w = diy_fp::mul(b.w, c_minus_k);
+            const diy_fp w_minus = diy_fp::mul(b.minus, c_minus_k);
+            const diy_fp w_plus = diy_fp::mul(b.plus, c_minus_k);
+
+            int32_t length = 0;
+            int32_t kappa = 0;
+            if (!grisu3_digit_gen(w_minus, w, w_plus, digits, length, kappa)) {
+                return false;
+            }
+            digits_count = static_cast<uint32_t>(length);
+            point_pos = length + kappa - cached.k;
+            return true;
+        }
+
+        // Fixed size unsigned integer for the exact fallback, big enough for the scaled values of any double (about 2^1100).
+        class big_uint {
+        public:
+            explicit big_uint(uint64_t value)
+                : size_(0)
+            {
+                while (value != 0) {
+                    limbs_[size_++] = static_cast<uint32_t>(value);
+                    value >>= 32u;
+                }
+            }
+
+            void mul_small(uint32_t factor)
+            {
+                uint64_t carry = 0;
+                for (uint32_t i = 0; i < size_; ++i) {
+                    const uint64_t product = static_cast<uint64_t>(limbs_[i]) * factor + carry;
+                    limbs_[i] = static_cast<uint32_t>(product);
+                    carry = product >> 32u;
+                }
+                if (carry != 0) {
+                    assert(size_ < MAX_LIMBS);
+                    limbs_[size_++] = static_cast<uint32_t>(carry);
+                }
+            }
+
+            void mul_pow10(int32_t exponent)
+            {
+                for (; exponent >= 9; exponent -= 9) {
+                    mul_small(1000000000u);
+                }
+                static constexpr uint32_t small_pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+                mul_small(small_pow10[exponent]);
+            }
+
+            void mul_pow2(uint32_t exponent)
+            {
+                for (; exponent >= 31; exponent -= 31) {
+                    mul_small(static_cast<uint32_t>(1) << 31u);
+                }
+                mul_small(static_cast<uint32_t>(1) << exponent);
+            }
+
+            void add(const big_uint& rhs)
+            {
+                uint64_t carry = 0;
+                const uint32_t max_size = bq::max_value(size_, rhs.size_);
+                for (uint32_t i = 0; i < max_size; ++i) {
+                    const uint64_t sum = static_cast<uint64_t>(i < size_ ? limbs_[i] : 0) + (i < rhs.size_ ? rhs.limbs_[i] : 0) + carry;
+                    limbs_[i] = static_cast<uint32_t>(sum);
+                    carry = sum >> 32u;
+                }
+                size_ = max_size;
+                if (carry != 0) {
+                    assert(size_ < MAX_LIMBS);
+                    limbs_[size_++] = static_cast<uint32_t>(carry);
+                }
+            }
+
+            // requires *this >= rhs
+            void sub(const big_uint& rhs)
+            {
+                uint64_t borrow = 0;
+                for (uint32_t i = 0; i < size_; ++i) {
+                    const uint64_t subtrahend = static_cast<uint64_t>(i < rhs.size_ ? rhs.limbs_[i] : 0) + borrow;
+                    borrow = (limbs_[i] < subtrahend) ? 1 : 0;
+                    limbs_[i] = static_cast<uint32_t>((static_cast<uint64_t>(limbs_[i]) + (borrow << 32u)) - subtrahend);
+                }
+                assert(borrow == 0);
+                while (size_ > 0 && limbs_[size_ - 1] == 0) {
+                    --size_;
+                }
+            }
+
+            static int32_t compare(const big_uint& lhs, const big_uint& rhs)
+            {
+                if (lhs.size_ != rhs.size_) {
+                    return lhs.size_ < rhs.size_ ? -1 : 1;
+                }
+                for (uint32_t i = lhs.size_; i > 0; --i) {
+                    if (lhs.limbs_[i - 1] != rhs.limbs_[i - 1]) {
+                        return lhs.limbs_[i - 1] < rhs.limbs_[i - 1] ? -1 : 1;
+                    }
+                }
+                return 0;
+            }
+
+            static int32_t compare_sum(const big_uint& lhs_a, const big_uint& lhs_b, const big_uint& rhs)
+            {
+                big_uint sum = lhs_a;
+                sum.add(lhs_b);
+                return compare(sum, rhs);
+            }
+
+        private:
+            static constexpr uint32_t MAX_LIMBS = 40;
+            uint32_t limbs_[MAX_LIMBS];
+            uint32_t size_;
+        };
+
+        // floor(e * log10(2))
+        int32_t floor_log10_pow2(int32_t e)
+        {
+            return e >= 0 ? (e * 78913) >> 18 : -(((-e) * 78913 + (1 << 18) - 1) >> 18);
+        }
+
+        // Exact shortest and closest digits (Burger and Dybvig, "Printing Floating-Point Numbers Quickly and Accurately"),
+        // only used when grisu3 can not verify its result, which happens for well under 1% of the values.
+        uint32_t exact_shortest(const boundaries& b, char* digits, int32_t& point_pos)
+        {
+            // value == r / s, and the values in (r - m_minus, r + m_plus) / s read back as value.
+            // strtod rounds ties to even, so the boundaries themselves are included for even mantissas.
+            const bool include_boundaries = (b.mantissa & 1) == 0;
+            const uint32_t low_shift = b.lower_boundary_is_closer ? 1 : 0;
+            big_uint r(b.mantissa);
+            big_uint s(1);
+            big_uint m_plus(1);
+            big_uint m_minus(1);
+            r.mul_pow2(1 + low_shift);
+            if (b.exponent >= 0) {
+                r.mul_pow2(static_cast<uint32_t>(b.exponent));
+                s.mul_pow2(1 + low_shift);
+                m_plus.mul_pow2(static_cast<uint32_t>(b.exponent) + low_shift);
+                m_minus.mul_pow2(static_cast<uint32_t>(b.exponent));
+            } else {
+                s.mul_pow2(static_cast<uint32_t>(-b.exponent) + 1 + low_shift);
+                m_plus.mul_pow2(low_shift);
+            }
+
+            uint32_t mantissa_bits = 0;
+            for (uint64_t m = b.mantissa; m != 0; m >>= 1u) {
+                ++mantissa_bits;
+            }
+            // underestimates the decimal exponent by up to 2, corrected below
+            int32_t k = floor_log10_pow2(b.exponent + static_cast<int32_t>(mantissa_bits) - 1);
+            if (k >= 0) {
+                s.mul_pow10(k);
+            } else {
+                r.mul_pow10(-k);
+                m_plus.mul_pow10(-k);
+                m_minus.mul_pow10(-k);
+            }
+            while (true) {
+                const int32_t high_cmp = big_uint::compare_sum(r, m_plus, s);
+                if (include_boundaries ? high_cmp < 0 : high_cmp <= 0) {
+                    break;
+                }
+                s.mul_small(10);
+                ++k;
+            }
+
+            uint32_t length = 0;
+            while (true) {
+                r.mul_small(10);
+                m_plus.mul_small(10);
+                m_minus.mul_small(10);
+                uint32_t digit = 0;
+                while (big_uint::compare(r, s) >= 0) {
+                    r.sub(s);
+                    ++digit;
+                }
+                const int32_t low_cmp = big_uint::compare(r, m_minus);
+                const int32_t high_cmp = big_uint::compare_sum(r, m_plus, s);
+                const bool low_ok = include_boundaries ? low_cmp <= 0 : low_cmp < 0;
+                const bool high_ok = include_boundaries ? high_cmp >= 0 : high_cmp > 0;
+                if (!low_ok && !high_ok) {
+                    digits[length++] = static_cast<char>('0' + digit);
+                    continue;
+                }
+                if (low_ok && high_ok) {
+                    // both digit and digit + 1 read back as value, take the closer one, the even one on a tie
+                    const int32_t half_cmp = big_uint::compare_sum(r, r, s);
+                    if (half_cmp > 0 || (half_cmp == 0 && (digit & 1) != 0)) {
+                        ++digit;
+                    }
+                } else if (high_ok) {
+                    ++digit;
+                }
+                assert(digit < 10);
+                digits[length++] = static_cast<char>('0' + digit);
+                break;
+            }
+            point_pos = k;
+            return length;
+        }
+
+        uint32_t shortest_digits(const boundaries& b, char* digits, int32_t& point_pos)
+        {
+            uint32_t digits_count = 0;
+            if (grisu3(b, digits, digits_count, point_pos)) {
+                return digits_count;
+            }
+            return exact_shortest(b, digits, point_pos);
+        }
+    }
+
+    uint32_t float_to_string::shortest(double value, char* digits, int32_t& point_pos)
+    {
+        assert(value > 0);
+        return shortest_digits(compute_boundaries<double, uint64_t, 53, 1075>(value), digits, point_pos);
+    }
+
+    uint32_t float_to_string::shortest(float value, char* digits, int32_t& point_pos)
+    {
+        assert(value > 0);
+        return shortest_digits(compute_boundaries<float, uint32_t, 24, 150>(value), digits, point_pos);
+    }
+
+    bool float_to_string::fixed_exact(double value, uint32_t frac_count, char* digits, uint32_t& digits_count, int32_t& point_pos)
+    {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        const uint64_t biased_e = bits >> 52u;
+        const uint64_t mantissa = (bits & ((static_cast<uint64_t>(1) << 52u) - 1)) | (biased_e == 0 ? 0 : (static_cast<uint64_t>(1) << 52u));
+        const int32_t e2 = (biased_e == 0 ? 1 : static_cast<int32_t>(biased_e)) - 1075;
+
+        uint64_t int_part = 0;
+        uint64_t frac = 0;
+        uint32_t frac_bits = 0;
+        if (e2 >= 0) {
+            if (e2 > 11) {
+                return false;
+            }
+            int_part = mantissa << static_cast<uint32_t>(e2);
+        } else {
+            frac_bits = static_cast<uint32_t>(-e2);
+            if (frac_bits > 60) {
+                return false;
+            }
+            int_part = mantissa >> frac_bits;
+            frac = mantissa & ((static_cast<uint64_t>(1) << frac_bits) - 1);
+        }
+
+        // integral digits
+        char int_digits[20];
+        uint32_t int_len = 0;
+        while (int_part != 0) {
+            int_digits[int_len++] = static_cast<char>('0' + int_part % 10);
+            int_part /= 10;
+        }
+        digits_count = 0;
+        for (uint32_t i = int_len; i > 0; --i) {
+            digits[digits_count++] = int_digits[i - 1];
+        }
+        point_pos = static_cast<int32_t>(int_len);
+
+        // fractional digits, exact since frac * 10 never exceeds 64 bits
+        if (frac_bits == 0) {
+            for (uint32_t i = 0; i < frac_count; ++i) {
+                digits[digits_count++] = '0';
+            }
+            return true;
+        }
+        const uint64_t frac_mask = (static_cast<uint64_t>(1) << frac_bits) - 1;
+        for (uint32_t i = 0; i < frac_count; ++i) {
+            frac *= 10;
+            digits[digits_count++] = static_cast<char>('0' + (frac >> frac_bits));
+            frac &= frac_mask;
+        }
+        const uint64_t half = static_cast<uint64_t>(1) << (frac_bits - 1);
+        const bool last_is_odd = digits_count > 0 && ((digits[digits_count - 1] - '0') & 1) != 0;
+        if (frac > half || (frac == half && last_is_odd)) {
+            int32_t idx = static_cast<int32_t>(digits_count) - 1;
+            while (idx >= 0 && digits[idx] == '9') {
+                digits[idx--] = '0';
+            }
+            if (idx >= 0) {
+                digits[idx]++;
+            } else {
+                memmove(digits + 1, digits, digits_count);
+                digits[0] = '1';
+                ++digits_count;
+                ++point_pos;
+            }
+        }
+        return true;
+    }
+
+    void float_to_string::round_digits(char* digits, uint32_t& digits_count, int32_t& point_pos, int32_t keep_count)
+    {
+        if (keep_count >= static_cast<int32_t>(digits_count)) {
+            return;
+        }
+        if (keep_count < 0) {
+            digits_count = 0;
+            return;
+        }
+        const uint32_t keep = static_cast<uint32_t>(keep_count);
+        bool round_up = false;
+        if (digits[keep] > '5') {
+            round_up = true;
+        } else if (digits[keep] == '5') {
+            bool has_tail = false;
+            for (uint32_t i = keep + 1; i < digits_count; ++i) {
+                if (digits[i] != '0') {
+                    has_tail = true;
+                    break;
+                }
+            }
+            round_up = has_tail || (keep > 0 && ((digits[keep - 1] - '0') & 1) != 0);
+        }
+        digits_count = keep;
+        if (!round_up) {
+            return;
+        }
+        int32_t idx = static_cast<int32_t>(digits_count) - 1;
+        while (idx >= 0 && digits[idx] == '9') {
+            digits[idx--] = '0';
+        }
+        if (idx >= 0) {
+            digits[idx]++;
+        } else {
+            memmove(digits + 1, digits, digits_count);
+            digits[0] = '1';
+            ++digits_count;
+            ++point_pos;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+/*!
+ * \file float_to_string.h
+ *
+ * Decimal digit generation for float and double used by layout.
+ * Shortest digits are produced by Grisu3 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers"),
+ * with an exact big integer fallback for the few values Grisu3 can not verify, so the result is always the shortest digits which
+ * convert back to the same binary value, and the closest one to it among those.
+ * All functions only work on finite positive values, sign, NaN and Inf are handled by the caller.
+ */
+
+#include "bq_common/bq_common_public_include.h"
+
+namespace bq {
+    class float_to_string {
+    public:
+        static constexpr uint32_t MAX_SHORTEST_DIGITS = 17;
+
+        /// <summary>
+        /// Shortest digits which round trip, the closest one to value if there are several.
+        /// value == digits * 10^(point_pos - digits_count), e.g. 3.25 -> "325", point_pos = 1
+        /// </summary>
+        /// <param name="value">finite and greater than 0</param>
+        /// <param name="digits">at least MAX_SHORTEST_DIGITS bytes, no terminator</param>
+        /// <param name="point_pos">out: count of digits before the decimal point, may be negative or larger than the digits count</param>
+        /// <returns>digits count</returns>
+        static uint32_t shortest(double value, char* digits, int32_t& point_pos);
+        static uint32_t shortest(float value, char* digits, int32_t& point_pos);
+
+        /// <summary>
+        /// Exact digits of value rounded (half to even) to frac_count fractional digits.
+        /// Only works if the integer part fits in 64 bits and the binary fraction has no more than 60 bits,
+        /// which covers everything a log usually prints with an explicit precision.
+        /// </summary>
+        /// <param name="digits">at least 20 + frac_count + 1 bytes</param>
+        /// <returns>false if value is out of the supported range, nothing is written</returns>
+        static bool fixed_exact(double value, uint32_t frac_count, char* digits, uint32_t& digits_count, int32_t& point_pos);
+
+        /// <summary>
+        /// Round decimal digits in place to keep_count leading digits (half to even).
+        /// keep_count may be 0 or negative, digits_count and point_pos are updated, the result may become "0" digits count 0.
+        /// digits must have one more byte of space in case of carry ("999" -> "1000").
+        /// </summary>
+        static void round_digits(char* digits, uint32_t& digits_count, int32_t& point_pos, int32_t keep_count);
+    };
+}
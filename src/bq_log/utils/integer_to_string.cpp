@@ -0,0 +1,25 @@
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "bq_log/utils/integer_to_string.h"
+
+namespace bq {
+    const char integer_to_string::DECIMAL_DIGITS_PAIRS[201] = "00010203040506070809"
+                                                              "10111213141516171819"
+                                                              "20212223242526272829"
+                                                              "30313233343536373839"
+                                                              "40414243444546474849"
+                                                              "50515253545556575859"
+                                                              "60616263646566676869"
+                                                              "70717273747576777879"
+                                                              "80818283848586878889"
+                                                              "90919293949596979899";
+}
@@ -0,0 +1,81 @@
+#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+/*!
+ * \file integer_to_string.h
+ *
+ * Decimal digits of unsigned integers used by layout and the log entry exporter.
+ * Digits are written back to front two at a time from a "00".."99" table, the digit count is
+ * known up front so there is no reverse pass.
+ */
+
+#include "bq_common/bq_common_public_include.h"
+
+namespace bq {
+    class integer_to_string {
+    public:
+        static constexpr uint32_t MAX_DECIMAL_DIGITS = 20;
+
+        /// <summary>
+        /// Count of decimal digits of value, 1 for 0.
+        /// </summary>
+        static bq_forceinline uint32_t count_decimal_digits(uint64_t value)
+        {
+            uint32_t count = 1;
+            while (true) {
+                if (value < 10)
+                    return count;
+                if (value < 100)
+                    return count + 1;
+                if (value < 1000)
+                    return count + 2;
+                if (value < 10000)
+                    return count + 3;
+                value /= 10000;
+                count += 4;
+            }
+        }
+
+        /// <summary>
+        /// Write the decimal digits of value ending right before dst_end,
+        /// exactly count_decimal_digits(value) bytes are written, no terminator.
+        /// </summary>
+        static bq_forceinline void write_decimal_digits(char* dst_end, uint64_t value)
+        {
+            while (value > 0xFFFFFFFFu) {
+                const uint32_t pair = static_cast<uint32_t>(value % 100) * 2;
+                value /= 100;
+                dst_end -= 2;
+                dst_end[0] = DECIMAL_DIGITS_PAIRS[pair];
+                dst_end[1] = DECIMAL_DIGITS_PAIRS[pair + 1];
+            }
+            uint32_t value_32 = static_cast<uint32_t>(value);
+            while (value_32 >= 100) {
+                const uint32_t pair = (value_32 % 100) * 2;
+                value_32 /= 100;
+                dst_end -= 2;
+                dst_end[0] = DECIMAL_DIGITS_PAIRS[pair];
+                dst_end[1] = DECIMAL_DIGITS_PAIRS[pair + 1];
+            }
+            if (value_32 >= 10) {
+                dst_end -= 2;
+                dst_end[0] = DECIMAL_DIGITS_PAIRS[value_32 * 2];
+                dst_end[1] = DECIMAL_DIGITS_PAIRS[value_32 * 2 + 1];
+            } else {
+                *--dst_end = static_cast<char>('0' + value_32);
+            }
+        }
+
+    private:
+        static const char DECIMAL_DIGITS_PAIRS[201];
+    };
+}
@@ -76,4 +76,10 @@ namespace bq {
         return true;
     }
 
+    const char* log_utils::get_level_name(bq::log_level level)
+    {
+        static const char* level_names[] = { "verbose", "debug", "info", "warning", "error", "fatal" };
+        return (static_cast<uint32_t>(level) < sizeof(level_names) / sizeof(level_names[0])) ? level_names[static_cast<uint32_t>(level)] : "unknown";
+    }
+
 }
@@ -69,6 +69,32 @@ namespace bq {
             }
         };
 
+        // XOR of the bits of a double with the previous value, repeated values and values with few mantissa bits give small codes:
+        // up to 6 trailing zero bytes are shifted out and their count is kept in the lowest 3 bits.
+        // escape_code means the XOR doesn't fit, it's stored as it is.
+        class double_xor {
+        public:
+            static constexpr uint64_t escape_code = 7;
+
+            bq_forceinline static uint64_t encode(uint64_t xor_bits)
+            {
+                uint64_t shift_bytes = 0;
+                while (xor_bits && shift_bytes < 6 && (xor_bits & 0xFF) == 0) {
+                    xor_bits >>= 8;
+                    ++shift_bytes;
+                }
+                if (xor_bits >> 61) {
+                    return escape_code;
+                }
+                return (xor_bits << 3) | shift_bytes;
+            }
+
+            bq_forceinline static uint64_t decode(uint64_t code)
+            {
+                return (code >> 3) << ((code & 7) * 8);
+            }
+        };
+
         class vlq {
         private:
             template <uint32_t LENGTH>
@@ -126,6 +152,9 @@ namespace bq {
         static bool get_categories_mask_by_config(const bq::array<bq::string> categories_name, const bq::property_value& categories_mask_config, bq::array_inline<uint8_t>& out_categories_mask);
 
         static bool get_log_level_bitmap_by_config(const bq::property_value& log_level_bitmap_config, bq::log_level_bitmap& out_level_bitmap);
+
+        // lower case full name, "unknown" for invalid values read from damaged data.
+        static const char* get_level_name(bq::log_level level);
     };
 
     template <>
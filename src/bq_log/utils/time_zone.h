@@ -66,12 +66,17 @@ namespace bq {
         }
         bq_forceinline const char* get_time_string_cache() const { return time_cache_; }
         bq_forceinline size_t get_time_string_cache_len() const { return time_cache_len_; }
+        // pieces of the time string cache "<time zone> <date> <hh:mm:ss>."
+        bq_forceinline const char* get_date_string_cache() const { return time_cache_ + time_zone_str_.size() + 1; }
+        bq_forceinline size_t get_date_string_cache_len() const { return time_cache_len_ - time_zone_str_.size() - 1 - TIME_OF_DAY_STR_LEN - 2; }
+        bq_forceinline const char* get_time_of_day_string_cache() const { return time_cache_ + time_cache_len_ - TIME_OF_DAY_STR_LEN - 1; }
 
     private:
         void inner_refresh_time_string_cache(uint64_t epoch_ms);
 
     public:
         static constexpr uint32_t MAX_TIME_STR_LEN = 128;
+        static constexpr uint32_t TIME_OF_DAY_STR_LEN = 8;
 
     private:
         bool use_local_time_;
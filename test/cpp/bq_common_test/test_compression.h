@@ -0,0 +1,356 @@
+#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include <string.h>
+#include "test_base.h"
+#include "bq_common/compression/deflate.h"
+#include "bq_common/compression/lz4.h"
+
+namespace bq {
+    namespace test {
+
+        // Minimal reference inflater (RFC 1951), only used to verify the encoder output.
+        class test_inflater {
+        public:
+            test_inflater(const uint8_t* data, size_t len)
+                : data_(data)
+                , len_(len)
+                , pos_(0)
+                , bit_buf_(0)
+                , bit_count_(0)
+                , error_(false)
+            {
+            }
+
+            bool inflate(bq::array<uint8_t>& out)
+            {
+                bool is_final = false;
+                while (!is_final && !error_) {
+                    is_final = bits(1) != 0;
+                    uint32_t type = bits(2);
+                    if (type == 0) {
+                        bit_buf_ = 0;
+                        bit_count_ = 0;
+                        if (pos_ + 4 > len_) {
+                            return false;
+                        }
+                        uint32_t block_len = static_cast<uint32_t>(data_[pos_]) | (static_cast<uint32_t>(data_[pos_ + 1]) << 8);
+                        pos_ += 4;
+                        if (pos_ + block_len > len_) {
+                            return false;
+                        }
+                        out.insert_batch(out.end(), data_ + pos_, block_len);
+                        pos_ += block_len;
+                    } else if (type == 1) {
+                        uint8_t lengths[288 + 32];
+                        memset(lengths, 8, 144);
+                        memset(lengths + 144, 9, 112);
+                        memset(lengths + 256, 7, 24);
+                        memset(lengths + 280, 8, 8);
+                        memset(lengths + 288, 5, 32);
+                        huffman lit, dist;
+                        build(lit, lengths, 288);
+                        build(dist, lengths + 288, 32);
+                        inflate_block(out, lit, dist);
+                    } else if (type == 2) {
+                        uint32_t hlit = bits(5) + 257;
+                        uint32_t hdist = bits(5) + 1;
+                        uint32_t hclen = bits(4) + 4;
+                        static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+                        uint8_t cl_lengths[19] = { 0 };
+                        for (uint32_t i = 0; i < hclen; ++i) {
+                            cl_lengths[order[i]] = static_cast<uint8_t>(bits(3));
+                        }
+                        huffman cl;
+                        build(cl, cl_lengths, 19);
+                        uint8_t lengths[288 + 32] = { 0 };
+                        uint32_t n = 0;
+                        while (n < hlit + hdist && !error_) {
+                            uint32_t sym = decode(cl);
+                            if (sym < 16) {
+                                lengths[n++] = static_cast<uint8_t>(sym);
+                                continue;
+                            }
+                            uint8_t value = 0;
+                            uint32_t repeat = 0;
+                            if (sym == 16) {
+                                if (n == 0) {
+                                    return false;
+                                }
+                                value = lengths[n - 1];
+                                repeat = 3 + bits(2);
+                            } else if (sym == 17) {
+                                repeat = 3 + bits(3);
+                            } else {
+                                repeat = 11 + bits(7);
+                            }
+                            if (n + repeat > hlit + hdist) {
+                                return false;
+                            }
+                            while (repeat-- > 0) {
+                                lengths[n++] = value;
+                            }
+                        }
+                        huffman lit, dist;
+                        build(lit, lengths, hlit);
+                        build(dist, lengths + hlit, hdist);
+                        inflate_block(out, lit, dist);
+                    } else {
+                        return false;
+                    }
+                }
+                return !error_;
+            }
+
+            size_t consumed_bytes() const { return pos_; }
+
+        private:
+            struct huffman {
+                uint16_t counts[16];
+                uint16_t symbols[288];
+            };
+
+            uint32_t bits(uint32_t count)
+            {
+                while (bit_count_ < count) {
+                    if (pos_ >= len_) {
+                        error_ = true;
+                        return 0;
+                    }
+                    bit_buf_ |= static_cast<uint32_t>(data_[pos_++]) << bit_count_;
+                    bit_count_ += 8;
+                }
+                uint32_t value = bit_buf_ & ((1u << count) - 1);
+                bit_buf_ >>= count;
+                bit_count_ -= count;
+                return value;
+            }
+
+            void build(huffman& h, const uint8_t* lengths, uint32_t n)
+            {
+                memset(&h, 0, sizeof(h));
+                for (uint32_t i = 0; i < n; ++i) {
+                    h.counts[lengths[i]]++;
+                }
+                h.counts[0] = 0;
+                uint16_t offsets[16] = { 0 };
+                for (uint32_t i = 1; i < 16; ++i) {
+                    offsets[i] = static_cast<uint16_t>(offsets[i - 1] + h.counts[i - 1]);
+                }
+                for (uint32_t i = 0; i < n; ++i) {
+                    if (lengths[i] != 0) {
+                        h.symbols[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+                    }
+                }
+            }
+
+            uint32_t decode(const huffman& h)
+            {
+                int32_t code = 0;
+                int32_t first = 0;
+                int32_t index = 0;
+                for (uint32_t len = 1; len < 16; ++len) {
+                    code |= static_cast<int32_t>(bits(1));
+                    int32_t count = h.counts[len];
+                    if (code - count < first) {
+                        return h.symbols[index + (code - first)];
+                    }
+                    index += count;
+                    first += count;
+                    first <<= 1;
+                    code <<= 1;
+                }
+                error_ = true;
+                return 0;
+            }
+
+            void inflate_block(bq::array<uint8_t>& out, const huffman& lit, const huffman& dist)
+            {
+                static const uint16_t len_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+                static const uint8_t len_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+                static const uint16_t dist_base[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+                static const uint8_t dist_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+                while (!error_) {
+                    uint32_t sym = decode(lit);
+                    if (sym < 256) {
+                        out.push_back(static_cast<uint8_t>(sym));
+                    } else if (sym == 256) {
+                        return;
+                    } else {
+                        sym -= 257;
+                        if (sym >= 29) {
+                            error_ = true;
+                            return;
+                        }
+                        size_t length = len_base[sym] + bits(len_extra[sym]);
+                        uint32_t dist_sym = decode(dist);
+                        if (dist_sym >= 30) {
+                            error_ = true;
+                            return;
+                        }
+                        size_t distance = dist_base[dist_sym] + bits(dist_extra[dist_sym]);
+                        if (distance > out.size()) {
+                            error_ = true;
+                            return;
+                        }
+                        for (size_t i = 0; i < length; ++i) {
+                            uint8_t value = out[out.size() - distance]; // copy first, push_back may reallocate
+                            out.push_back(value);
+                        }
+                    }
+                }
+            }
+
+        private:
+            const uint8_t* data_;
+            size_t len_;
+            size_t pos_;
+            uint32_t bit_buf_;
+            uint32_t bit_count_;
+            bool error_;
+        };
+
+        class test_compression : public test_base {
+        public:
+            static bool gunzip(const bq::array<uint8_t>& gz, bq::array<uint8_t>& out)
+            {
+                if (gz.size() < 18 || gz[0] != 0x1F || gz[1] != 0x8B || gz[2] != 8) {
+                    return false;
+                }
+                test_inflater inflater(gz.begin() + 10, gz.size() - 18);
+                if (!inflater.inflate(out)) {
+                    return false;
+                }
+                const uint8_t* gz_data = gz.begin();
+                const uint8_t* trailer = gz_data + gz.size() - 8;
+                uint32_t crc = static_cast<uint32_t>(trailer[0]) | (static_cast<uint32_t>(trailer[1]) << 8) | (static_cast<uint32_t>(trailer[2]) << 16) | (static_cast<uint32_t>(trailer[3]) << 24);
+                uint32_t isize = static_cast<uint32_t>(trailer[4]) | (static_cast<uint32_t>(trailer[5]) << 8) | (static_cast<uint32_t>(trailer[6]) << 16) | (static_cast<uint32_t>(trailer[7]) << 24);
+                return crc == bq::deflate_encoder::crc32(0, out.begin(), out.size()) && isize == static_cast<uint32_t>(out.size());
+            }
+
+        private:
+            void test_round_trip(test_result& result, const char* case_name, const bq::array<uint8_t>& src, size_t feed_step)
+            {
+                bq::deflate_encoder encoder;
+                bq::array<uint8_t> gz;
+                const uint8_t* src_data = src.begin();
+                for (size_t offset = 0; offset < src.size(); offset += feed_step) {
+                    encoder.update(src_data + offset, bq::min_value(feed_step, src.size() - offset));
+                    gz.insert_batch(gz.end(), encoder.output().begin(), encoder.output().size());
+                    encoder.output().clear();
+                }
+                encoder.finish();
+                gz.insert_batch(gz.end(), encoder.output().begin(), encoder.output().size());
+                bq::array<uint8_t> decoded;
+                bool success = gunzip(gz, decoded);
+                result.add_result(success && decoded == src, "deflate round trip test, case:%s, src size:%" PRIu64 ", compressed size:%" PRIu64, case_name, static_cast<uint64_t>(src.size()), static_cast<uint64_t>(gz.size()));
+            }
+
+            void test_lz4_round_trip(test_result& result, const char* case_name, const bq::array<uint8_t>& src)
+            {
+                bq::lz4::level levels[] = { bq::lz4::level::fast, bq::lz4::level::high };
+                for (bq::lz4::level level : levels) {
+                    const char* level_name = (level == bq::lz4::level::fast) ? "fast" : "high";
+                    bq::lz4 codec(level);
+                    bq::array<uint8_t> compressed;
+                    compressed.fill_uninitialized(bq::lz4::get_max_compressed_size(src.size()));
+                    size_t compressed_size = codec.compress(src.begin(), src.size(), compressed.begin(), compressed.size());
+                    bq::array<uint8_t> decoded;
+                    decoded.fill_uninitialized(src.size());
+                    size_t decoded_size = bq::lz4::decompress(compressed.begin(), compressed_size, decoded.begin(), decoded.size());
+                    result.add_result(compressed_size > 0 && decoded_size == src.size() && decoded == src, "lz4 round trip test, case:%s, level:%s, src size:%" PRIu64 ", compressed size:%" PRIu64, case_name, level_name, static_cast<uint64_t>(src.size()), static_cast<uint64_t>(compressed_size));
+                    if (src.size() < 64) {
+                        continue;
+                    }
+                    // damaged data must be rejected or decoded to anything, but never read or written out of range
+                    bq::array<uint8_t> damaged;
+                    damaged.insert_batch(damaged.end(), compressed.begin(), compressed_size);
+                    for (size_t i = 0; i < damaged.size(); i += 1 + damaged.size() / 16) {
+                        damaged[i] = static_cast<uint8_t>(damaged[i] ^ 0x5A);
+                    }
+                    decoded_size = bq::lz4::decompress(damaged.begin(), damaged.size(), decoded.begin(), decoded.size());
+                    result.add_result(decoded_size == SIZE_MAX || decoded_size <= decoded.size(), "lz4 damaged data test, case:%s, level:%s", case_name, level_name);
+                    result.add_result(bq::lz4::decompress(compressed.begin(), compressed_size / 2, decoded.begin(), decoded.size()) != src.size(), "lz4 truncated data test, case:%s, level:%s", case_name, level_name);
+                    result.add_result(bq::lz4::decompress(compressed.begin(), compressed_size, decoded.begin(), decoded.size() - 1) == SIZE_MAX, "lz4 small output test, case:%s, level:%s", case_name, level_name);
+                }
+            }
+
+        public:
+            virtual test_result test() override
+            {
+                test_result result;
+                const char* crc_check = "123456789";
+                result.add_result(bq::deflate_encoder::crc32(0, crc_check, strlen(crc_check)) == 0xCBF43926, "crc32 check value test");
+
+                bq::array<uint8_t> src;
+                test_round_trip(result, "empty", src, 1);
+                src.push_back(static_cast<uint8_t>('a'));
+                test_round_trip(result, "single byte", src, 1);
+
+                src.clear();
+                for (uint32_t i = 0; i < 200000; ++i) {
+                    src.push_back(static_cast<uint8_t>(i % 2 == 0 ? 'a' : 'b'));
+                }
+                test_round_trip(result, "repeated pattern", src, 4096);
+
+                src.clear();
+                bq::util::srand(12345);
+                for (uint32_t i = 0; i < 300000; ++i) {
+                    src.push_back(static_cast<uint8_t>(bq::util::rand() & 0xFF));
+                }
+                test_round_trip(result, "random bytes", src, 65536);
+
+                src.clear();
+                const char* levels[] = { "info", "warning", "error", "debug" };
+                char line[256];
+                for (uint32_t i = 0; i < 40000; ++i) {
+                    int32_t len = snprintf(line, sizeof(line), "[2025-01-02 12:34:%02u.%03u][%s][tid-%u] request %u finished, cost %u ms\n", i % 60, i % 1000, levels[bq::util::rand() % 4], bq::util::rand() % 8, i, bq::util::rand() % 500);
+                    src.insert_batch(src.end(), reinterpret_cast<const uint8_t*>(line), static_cast<size_t>(len));
+                }
+                test_round_trip(result, "text log", src, 100000);
+                test_round_trip(result, "text log(small feeds)", src, 77);
+
+                src.clear();
+                test_lz4_round_trip(result, "empty", src);
+                for (uint32_t i = 0; i < 13; ++i) {
+                    src.push_back(static_cast<uint8_t>('a' + i % 3));
+                }
+                test_lz4_round_trip(result, "shorter than a match", src);
+                src.clear();
+                for (uint32_t i = 0; i < 200000; ++i) {
+                    src.push_back(static_cast<uint8_t>(i % 2 == 0 ? 'a' : 'b'));
+                }
+                test_lz4_round_trip(result, "repeated pattern", src);
+                src.clear();
+                for (uint32_t i = 0; i < 300000; ++i) {
+                    src.push_back(static_cast<uint8_t>(bq::util::rand() & 0xFF));
+                }
+                test_lz4_round_trip(result, "random bytes", src);
+                src.clear();
+                for (uint32_t i = 0; i < 40000; ++i) {
+                    int32_t len = snprintf(line, sizeof(line), "[2025-01-02 12:34:%02u.%03u][%s][tid-%u] request %u finished, cost %u ms\n", i % 60, i % 1000, levels[bq::util::rand() % 4], bq::util::rand() % 8, i, bq::util::rand() % 500);
+                    src.insert_batch(src.end(), reinterpret_cast<const uint8_t*>(line), static_cast<size_t>(len));
+                }
+                test_lz4_round_trip(result, "text log", src);
+                bq::array<uint8_t> compressed;
+                compressed.fill_uninitialized(bq::lz4::get_max_compressed_size(src.size()));
+                bq::lz4 fast_codec(bq::lz4::level::fast);
+                bq::lz4 high_codec(bq::lz4::level::high);
+                size_t fast_size = fast_codec.compress(src.begin(), src.size(), compressed.begin(), compressed.size());
+                size_t high_size = high_codec.compress(src.begin(), src.size(), compressed.begin(), compressed.size());
+                result.add_result(high_size <= fast_size && fast_size * 2 < src.size(), "lz4 ratio test, src size:%" PRIu64 ", fast:%" PRIu64 ", high:%" PRIu64, static_cast<uint64_t>(src.size()), static_cast<uint64_t>(fast_size), static_cast<uint64_t>(high_size));
+                result.add_result(fast_codec.compress(src.begin(), src.size(), compressed.begin(), bq::lz4::get_max_compressed_size(src.size()) - 1) == 0, "lz4 small output capacity test");
+                return result;
+            }
+        };
+    }
+}
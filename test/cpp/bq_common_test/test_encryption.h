@@ -80,6 +80,25 @@ namespace bq {
                     compare_result2 = memcmp(src, tar, buff_size);
                     result.add_result(compare_result2 == 0, "[with hardware acceleration]vernam enc test 2 for key size:%" PRIu32 ", data size:%" PRIu32 ", offset:%" PRIu32, static_cast<uint32_t>(key_size), static_cast<uint32_t>(buff_size), static_cast<uint32_t>(offset));
 
+                    // the single pass copy variant gives the same result with any source alignment and leaves the source untouched
+                    size_t src_shift = i % 7;
+                    uint8_t* copy_src = static_cast<uint8_t*>(bq::platform::aligned_alloc(vernam::DEFAULT_BUFFER_ALIGNMENT, buff_size + src_shift));
+                    uint8_t* copy_tar = static_cast<uint8_t*>(bq::platform::aligned_alloc(vernam::DEFAULT_BUFFER_ALIGNMENT, buff_size));
+                    memcpy(copy_src + src_shift, src, buff_size);
+                    bq::vernam::vernam_encrypt_32bytes_aligned(tar + offset, buff_size - offset, key, key_size, offset);
+                    const bq::vernam::mode copy_modes[] = { bq::vernam::mode::scalar, bq::vernam::mode::sse, bq::vernam::mode::avx2, bq::vernam::mode::auto_detect };
+                    for (bq::vernam::mode copy_mode : copy_modes) {
+                        bq::vernam::set_hardware_acceleration_mode(copy_mode);
+                        memset(copy_tar, 0, buff_size);
+                        bq::vernam::vernam_encrypt_32bytes_aligned_copy(copy_tar + offset, copy_src + src_shift + offset, buff_size - offset, key, key_size, offset);
+                        result.add_result(memcmp(copy_tar + offset, tar + offset, buff_size - offset) == 0 && memcmp(copy_src + src_shift, src, buff_size) == 0,
+                            "vernam copy enc test for mode:%" PRId32 ", key size:%" PRIu32 ", data size:%" PRIu32 ", offset:%" PRIu32 ", src shift:%" PRIu32,
+                            static_cast<int32_t>(copy_mode), static_cast<uint32_t>(key_size), static_cast<uint32_t>(buff_size), static_cast<uint32_t>(offset), static_cast<uint32_t>(src_shift));
+                    }
+                    bq::vernam::set_hardware_acceleration_mode(bq::vernam::mode::auto_detect);
+
+                    bq::platform::aligned_free(copy_src);
+                    bq::platform::aligned_free(copy_tar);
                     bq::platform::aligned_free(key);
                     bq::platform::aligned_free(src);
                     bq::platform::aligned_free(tar);
@@ -438,11 +457,48 @@ rJjndnUwweqNEHGPf1PuBCvmXa5GPzla03pN44/YhywCWtxsrAGF9ayamEOG
                 }
             }
 
+            // Every acceleration level must produce byte identical CBC output, including sizes that leave a tail after the 4 and 8 block loops.
+            void test_aes_hardware_modes(test_result& result, aes::enum_key_bits key_bits)
+            {
+                const bq::aes::acceleration_mode modes[] = { bq::aes::acceleration_mode::aes_ni, bq::aes::acceleration_mode::vaes, bq::aes::acceleration_mode::auto_detect };
+                const uint32_t block_counts[] = { 1, 3, 4, 5, 8, 9, 15, 16, 17, 2048 + 7 };
+                bq::aes aes(bq::aes::enum_cipher_mode::AES_CBC, key_bits);
+                bq::array<uint8_t> plaintext;
+                bq::array<uint8_t> ref_ciphertext;
+                bq::array<uint8_t> ciphertext;
+                bq::array<uint8_t> decrypted_text;
+                for (uint32_t block_count : block_counts) {
+                    const size_t size = static_cast<size_t>(block_count) * 16;
+                    plaintext.clear();
+                    plaintext.fill_uninitialized(size);
+                    for (size_t j = 0; j < size; ++j) {
+                        plaintext[j] = static_cast<uint8_t>(bq::util::rand());
+                    }
+                    auto key = aes.generate_key();
+                    auto iv = aes.generate_iv();
+                    bq::aes::set_hardware_acceleration_mode(bq::aes::acceleration_mode::software);
+                    aes.encrypt(key, iv, plaintext, ref_ciphertext);
+                    for (auto m : modes) {
+                        bq::aes::set_hardware_acceleration_mode(m);
+                        bool enc_match = aes.encrypt(key, iv, plaintext, ciphertext) && ciphertext.size() == size
+                            && memcmp((const uint8_t*)ciphertext.begin(), (const uint8_t*)ref_ciphertext.begin(), size) == 0;
+                        result.add_result(enc_match, "AES_%" PRId32 " mode %" PRId32 " encryption mismatch with software, blocks:%" PRIu32, static_cast<int32_t>(key_bits), static_cast<int32_t>(m), block_count);
+                        bool dec_match = aes.decrypt(key, iv, ref_ciphertext, decrypted_text) && decrypted_text.size() == size
+                            && memcmp((const uint8_t*)decrypted_text.begin(), (const uint8_t*)plaintext.begin(), size) == 0;
+                        result.add_result(dec_match, "AES_%" PRId32 " mode %" PRId32 " decryption mismatch, blocks:%" PRIu32, static_cast<int32_t>(key_bits), static_cast<int32_t>(m), block_count);
+                    }
+                }
+                bq::aes::set_hardware_acceleration_mode(bq::aes::acceleration_mode::auto_detect);
+            }
+
         public:
             virtual test_result test() override
             {
                 test_result result;
                 test_vernam(result);
+                test_aes_hardware_modes(result, bq::aes::enum_key_bits::AES_128);
+                test_aes_hardware_modes(result, bq::aes::enum_key_bits::AES_192);
+                test_aes_hardware_modes(result, bq::aes::enum_key_bits::AES_256);
 
                 constexpr uint32_t thread_count = 2;
                 test_output(bq::log_level::info, "RSA test begin...");
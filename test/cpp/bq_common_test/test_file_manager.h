@@ -173,6 +173,24 @@ namespace bq {
                     memory_map::flush_memory_map(mmp_handle_tar);
                     memory_map::release_memory_map(mmp_handle_tar);
                     file_manager.close_file(mmf_handle_tar);
+
+                    // read only mapping with an unaligned offset, the file is opened for reading only
+                    constexpr size_t read_only_offset = 1000;
+                    constexpr size_t read_only_size = memory_map_file_size - read_only_offset - 7;
+                    auto mmf_handle_read_only = file_manager.open_file(TO_ABSOLUTE_PATH("cc/mm_map_src.mmp", true), file_open_mode_enum::read);
+                    auto mmp_handle_read_only = memory_map::create_memory_map_read_only(mmf_handle_read_only, read_only_offset, read_only_size);
+                    result.add_result(mmp_handle_read_only.has_been_mapped(), "read only memory map file");
+                    memory_map::advise_sequential(mmp_handle_read_only);
+                    check_result = mmp_handle_read_only.get_mapped_size() == read_only_size;
+                    for (size_t i = 0; check_result && i < read_only_size; ++i) {
+                        if (((const uint8_t*)mmp_handle_read_only.get_mapped_data())[i] != (uint8_t)((i + read_only_offset) % 255)) {
+                            check_result = false;
+                        }
+                    }
+                    result.add_result(check_result, "read only memory map check result");
+                    memory_map::release_memory_map(mmp_handle_read_only);
+                    result.add_result(file_manager.get_file_size(mmf_handle_read_only) == memory_map_file_size, "read only memory map file size");
+                    file_manager.close_file(mmf_handle_read_only);
                 }
 
                 result.add_result(file_manager.remove_file_or_dir(TO_ABSOLUTE_PATH("cc/../cc/bb/aa/dd/", base_dir_type)), "check remove directory 0");
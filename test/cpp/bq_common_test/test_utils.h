@@ -535,6 +535,65 @@ namespace bq {
                     result.add_result(all_pass, "Comprehensive Optimistic & UTF-Mixed Tests (1-4096 bytes)");
                 }
 
+                // 1.x Every hardware acceleration level must produce the same output as the legacy converters
+                {
+                    const bq::util::utf_acceleration_mode modes[] = { bq::util::utf_acceleration_mode::scalar, bq::util::utf_acceleration_mode::sse, bq::util::utf_acceleration_mode::avx2, bq::util::utf_acceleration_mode::avx512, bq::util::utf_acceleration_mode::auto_detect };
+                    const char* mode_names[] = { "scalar", "sse", "avx2", "avx512", "auto_detect" };
+                    std::vector<char16_t> src_16;
+                    std::vector<char> ref_8;
+                    std::vector<char16_t> ref_16;
+                    std::vector<char> dst_8;
+                    std::vector<char16_t> dst_16;
+                    bool all_pass = true;
+                    for (size_t t_len = 1; t_len <= 520 && all_pass; ++t_len) {
+                        // lower non-ASCII ratio on odd lengths so that long ASCII runs reach the optimistic paths
+                        const uint32_t non_ascii_ratio = (t_len % 2 == 0) ? 3 : 40;
+                        src_16.clear();
+                        while (src_16.size() < t_len) {
+                            const uint32_t r = bq::util::rand();
+                            if (r % non_ascii_ratio != 0) {
+                                src_16.push_back(static_cast<char16_t>((r >> 8) % 127 + 1));
+                                continue;
+                            }
+                            switch ((r >> 8) % 3) {
+                            case 0:
+                                src_16.push_back(static_cast<char16_t>(0x80 + (r >> 12) % 0x780));
+                                break;
+                            case 1:
+                                src_16.push_back(static_cast<char16_t>(0x4E00 + (r >> 12) % 0x5000));
+                                break;
+                            default:
+                                if (src_16.size() + 2 <= t_len) {
+                                    src_16.push_back(static_cast<char16_t>(0xD800 + (r >> 12) % 0x400));
+                                    src_16.push_back(static_cast<char16_t>(0xDC00 + (r >> 22) % 0x400));
+                                } else {
+                                    src_16.push_back(u'A');
+                                }
+                                break;
+                            }
+                        }
+                        ref_8.assign(t_len * 3 + 4, 0);
+                        const uint32_t ref_8_len = bq::util::utf16_to_utf8_legacy(src_16.data(), (uint32_t)t_len, ref_8.data(), (uint32_t)ref_8.size());
+                        ref_16.assign(t_len + 4, 0);
+                        const uint32_t ref_16_len = bq::util::utf8_to_utf16_legacy(ref_8.data(), ref_8_len, ref_16.data(), (uint32_t)ref_16.size());
+                        for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+                            bq::util::set_utf_hardware_acceleration_mode(modes[m]);
+                            dst_8.assign(ref_8.size(), 0);
+                            const uint32_t len_8 = bq::util::utf16_to_utf8(src_16.data(), (uint32_t)t_len, dst_8.data(), (uint32_t)dst_8.size());
+                            dst_16.assign(ref_16.size(), 0);
+                            const uint32_t len_16 = bq::util::utf8_to_utf16(ref_8.data(), ref_8_len, dst_16.data(), (uint32_t)dst_16.size());
+                            if (len_8 != ref_8_len || memcmp(dst_8.data(), ref_8.data(), ref_8_len) != 0
+                                || len_16 != ref_16_len || memcmp(dst_16.data(), ref_16.data(), ref_16_len * sizeof(char16_t)) != 0) {
+                                result.add_result(false, "UTF acceleration mode %s mismatch with legacy. len=%" PRIu64, mode_names[m], static_cast<uint64_t>(t_len));
+                                all_pass = false;
+                                break;
+                            }
+                        }
+                    }
+                    bq::util::set_utf_hardware_acceleration_mode(bq::util::utf_acceleration_mode::auto_detect);
+                    result.add_result(all_pass, "UTF acceleration modes match legacy converters (1-520 chars)");
+                }
+
                 // 2. Performance Benchmark
                 size_t bench_size = 64 * 1024 * 1024; // 64MB
                 struct TestCase {
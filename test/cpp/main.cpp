@@ -19,12 +19,14 @@
 #include "bq_common_test/test_property.h"
 #include "bq_common_test/test_thread_atomic.h"
 #include "bq_common_test/test_encryption.h"
+#include "bq_common_test/test_compression.h"
 #include "test_miso_ring_buffer.h"
 #include "test_siso_ring_buffer.h"
 #include "test_log_buffer.h"
 #include "test_log_appender.h"
 #include "test_log.h"
 #include "test_layout.h"
+#include "test_log_decoder.h"
 #include <locale.h>
 #if defined(BQ_WIN)
 #include <windows.h>
@@ -101,6 +103,7 @@ int32_t main_logic()
     TEST_GROUP(Bq_Common_Test, bq::test, test_file_manager);
     TEST_GROUP(Bq_Common_Test, bq::test, test_thread_atomic);
     TEST_GROUP(Bq_Common_Test, bq::test, test_encryption);
+    TEST_GROUP(Bq_Common_Test, bq::test, test_compression);
     TEST_GROUP_END(Bq_Common_Test);
 
     TEST_GROUP_BEGIN(Bq_Log_Test);
@@ -111,6 +114,7 @@ int32_t main_logic()
     TEST_GROUP(Bq_Log_Test, bq::test, test_miso_ring_buffer);
     TEST_GROUP(Bq_Log_Test, bq::test, test_log);
     TEST_GROUP(Bq_Log_Test, bq::test, test_layout);
+    TEST_GROUP(Bq_Log_Test, bq::test, test_log_decoder);
     TEST_GROUP_END(Bq_Log_Test);
 
     bool test_result = TEST_GROUP_RESULT(Bq_Common_Test) && TEST_GROUP_RESULT(Bq_Log_Test);
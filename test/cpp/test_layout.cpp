@@ -12,11 +12,14 @@
 
 #include "test_layout.h"
 #include "bq_log/log/layout.h"
+#include "bq_log/utils/float_to_string.h"
 #include "bq_common/bq_common.h"
+#include "bq_log/bq_log.h"
 #include <vector>
 #include <string>
 #include <cstring>
 #include <random>
+#include <limits>
 
 namespace bq {
     namespace test {
@@ -28,10 +31,397 @@ namespace bq {
             result = result + test_find_brace_and_copy();
             result = result + test_find_brace_and_convert_u16();
             result = result + test_throughput();
+            result = result + test_result_cache();
+            result = result + test_decimal_format();
+            result = result + test_integral_format();
+            result = result + test_layout_pattern();
 
             return result;
         }
 
+        test_result test_layout::test_result_cache()
+        {
+            test_result result;
+            bq::time_zone gmt("gmt");
+            bq::time_zone utc8("utc+8");
+            bq::time_zone local("localtime");
+            bq::layout_result_cache cache;
+            const char* str = nullptr;
+            uint32_t len = 0;
+            result.add_result(!cache.try_get(1, gmt, 0, str, len), "layout result cache empty test");
+            cache.set(1, gmt, 0, "hello", 5);
+            result.add_result(cache.try_get(1, gmt, 0, str, len) && len == 5 && memcmp(str, "hello", 5) == 0, "layout result cache hit test");
+            result.add_result(!cache.try_get(2, gmt, 0, str, len), "layout result cache entry miss test");
+            result.add_result(!cache.try_get(1, gmt, 1, str, len), "layout result cache pattern miss test");
+            result.add_result(!cache.try_get(1, utc8, 0, str, len), "layout result cache time zone miss test");
+            result.add_result(!cache.try_get(1, local, 0, str, len), "layout result cache local time miss test");
+            cache.invalidate();
+            result.add_result(!cache.try_get(1, gmt, 0, str, len), "layout result cache invalidate test");
+
+            // appenders sharing the cached text must produce exactly what they would produce alone.
+            bq::file_manager::remove_file_or_dir(TO_ABSOLUTE_PATH("layout_cache_test", 0));
+            auto log_inst = bq::log::create_log("layout_cache_test", R"(
+                        appenders_config.TextA.type=text_file
+                        appenders_config.TextA.file_name=layout_cache_test/text_a
+                        appenders_config.TextA.time_zone=gmt
+                        appenders_config.TextA.enable_rolling_log_file=false
+                        appenders_config.TextB.type=text_file
+                        appenders_config.TextB.file_name=layout_cache_test/text_b
+                        appenders_config.TextB.time_zone=gmt
+                        appenders_config.TextB.enable_rolling_log_file=false
+                        appenders_config.TextC.type=text_file
+                        appenders_config.TextC.file_name=layout_cache_test/text_c
+                        appenders_config.TextC.time_zone=utc+8
+                        appenders_config.TextC.levels=[warning,error]
+                        appenders_config.TextC.enable_rolling_log_file=false
+                        log.thread_mode=sync
+                    )");
+            for (int32_t i = 0; i < 1000; ++i) {
+                log_inst.info("layout cache test {}, {}", i, "abcdefg");
+                log_inst.warning("layout cache test warning {}", i);
+            }
+            log_inst.force_flush();
+            bq::string text_a = bq::file_manager::read_all_text(TO_ABSOLUTE_PATH("layout_cache_test/text_a_1.log", 0));
+            bq::string text_b = bq::file_manager::read_all_text(TO_ABSOLUTE_PATH("layout_cache_test/text_b_1.log", 0));
+            bq::string text_c = bq::file_manager::read_all_text(TO_ABSOLUTE_PATH("layout_cache_test/text_c_1.log", 0));
+            result.add_result(!text_a.is_empty() && text_a == text_b, "layout result cache shared text test");
+            auto split_lines = [](const bq::string& text) {
+                bq::array<bq::string> lines;
+                bq::string::size_type begin = 0;
+                for (bq::string::size_type i = 0; i < text.size(); ++i) {
+                    if (text[i] == '\n') {
+                        lines.push_back(text.substr(begin, i - begin));
+                        begin = i + 1;
+                    }
+                }
+                return lines;
+            };
+            auto lines_a = split_lines(text_a);
+            auto lines_c = split_lines(text_c);
+            result.add_result(lines_a.size() == 2000 && lines_c.size() == 1000, "layout result cache line count test, a:%" PRIu64 ", c:%" PRIu64, static_cast<uint64_t>(lines_a.size()), static_cast<uint64_t>(lines_c.size()));
+            if (lines_a.size() == 2000 && lines_c.size() == 1000) {
+                // same entry, different time zone, must not be served from the cache.
+                result.add_result(lines_a[1] != lines_c[0] && lines_c[0].end_with("layout cache test warning 0"), "layout result cache time zone test");
+            }
+            return result;
+        }
+
+        template <typename T>
+        static std::string format_arg_for_test(bq::layout& l, const std::string& fmt, log_arg_type_enum arg_type, T value)
+        {
+            size_t head_size = sizeof(_log_entry_head_def);
+            size_t args_offset = head_size + bq::align_4(static_cast<uint32_t>(fmt.size()));
+            std::vector<uint8_t> buffer(args_offset + 4 + sizeof(T), 0);
+            _log_entry_head_def* head = (_log_entry_head_def*)buffer.data();
+            head->log_format_str_type = (uint8_t)log_arg_type_enum::string_utf8_type;
+            head->log_format_data_len = (uint32_t)fmt.size();
+            memcpy(buffer.data() + head_size, fmt.c_str(), fmt.size());
+            buffer[args_offset] = (uint8_t)arg_type;
+            memcpy(buffer.data() + args_offset + 4, &value, sizeof(T));
+            log_entry_handle handle(buffer.data(), (uint32_t)buffer.size());
+            l.test_python_style_format_content_sw(handle);
+            return std::string(l.get_formated_str(), l.get_formated_str_len());
+        }
+
+        template <typename T>
+        static std::string format_decimal_for_test(bq::layout& l, const std::string& fmt, T value)
+        {
+            return format_arg_for_test(l, fmt, sizeof(T) == sizeof(float) ? log_arg_type_enum::float_type : log_arg_type_enum::double_type, value);
+        }
+
+        template <typename T>
+        static T parse_decimal_for_test(const char* str)
+        {
+            return sizeof(T) == sizeof(float) ? static_cast<T>(strtof(str, nullptr)) : static_cast<T>(strtod(str, nullptr));
+        }
+
+        // fewest "%.{n}e" digits which parse back to value (correctly rounded by the C library), trailing zeros removed
+        template <typename T>
+        static std::string reference_shortest_for_test(T value, int32_t& point_pos)
+        {
+            char buffer[64];
+            for (int32_t digits = 1; digits <= 17; ++digits) {
+                snprintf(buffer, sizeof(buffer), "%.*e", digits - 1, static_cast<double>(value));
+                if (parse_decimal_for_test<T>(buffer) == value) {
+                    break;
+                }
+            }
+            std::string digits;
+            const char* c = buffer;
+            for (; *c != 'e'; ++c) {
+                if (*c != '.') {
+                    digits += *c;
+                }
+            }
+            point_pos = atoi(c + 1) + 1;
+            while (digits.size() > 1 && digits.back() == '0') {
+                digits.pop_back();
+            }
+            return digits;
+        }
+
+        // float_to_string::shortest must round trip, be no longer than the reference and equal to it for the same length (closest)
+        template <typename T>
+        static bool check_shortest_for_test(T value, std::string& real, std::string& expected)
+        {
+            char digits[bq::float_to_string::MAX_SHORTEST_DIGITS];
+            int32_t point_pos = 0;
+            const uint32_t digits_count = bq::float_to_string::shortest(value, digits, point_pos);
+            int32_t expected_point_pos = 0;
+            expected = reference_shortest_for_test(value, expected_point_pos);
+            real = "0." + std::string(digits, digits_count) + "e" + std::to_string(point_pos);
+            if (parse_decimal_for_test<T>(real.c_str()) != value || digits_count == 0 || digits[digits_count - 1] == '0') {
+                return false;
+            }
+            if (digits_count != expected.size()) {
+                return digits_count < expected.size();
+            }
+            expected = "0." + expected + "e" + std::to_string(expected_point_pos);
+            return real == expected;
+        }
+
+        test_result test_layout::test_integral_format()
+        {
+            test_result result;
+            bq::layout l;
+            struct integral_case {
+                const char* fmt;
+                const char* printf_fmt;
+            };
+            const integral_case signed_cases[] = {
+                { "{}", "%" PRId64 },
+                { "{:d}", "%" PRId64 },
+                { "{:+d}", "%+" PRId64 },
+                { "{:12d}", "%12" PRId64 },
+                { "{:012d}", "%012" PRId64 },
+                { "{:+012d}", "%+012" PRId64 },
+                { "{:<12d}", "%-12" PRId64 },
+            };
+            const integral_case unsigned_cases[] = {
+                { "{}", "%" PRIu64 },
+                { "{:21d}", "%21" PRIu64 },
+                { "{:x}", "%" PRIx64 },
+                { "{:X}", "%" PRIX64 },
+                { "{:#x}", "%#" PRIx64 },
+                { "{:#X}", "%#" PRIX64 },
+                { "{:20x}", "%20" PRIx64 },
+                { "{:020x}", "%020" PRIx64 },
+                { "{:#020x}", "%#020" PRIx64 },
+                { "{:o}", "%" PRIo64 },
+            };
+            std::mt19937_64 rng(20250102);
+            char expected[128];
+            for (int32_t i = 0; i < 20000; ++i) {
+                // cover every digit count, not only huge values
+                uint64_t value = rng() >> (rng() % 64);
+                if (value == 0) {
+                    continue; // printf drops "0x" of zero
+                }
+                int64_t signed_value = (i % 2 == 0) ? static_cast<int64_t>(value) : -static_cast<int64_t>(value >> 1);
+                for (const auto& c : signed_cases) {
+                    snprintf(expected, sizeof(expected), c.printf_fmt, signed_value);
+                    std::string str = format_arg_for_test(l, c.fmt, log_arg_type_enum::int64_type, signed_value);
+                    result.add_result(str == expected, "layout int64 format test, fmt:%s, expected:%s, real:%s", c.fmt, expected, str.c_str());
+                }
+                for (const auto& c : unsigned_cases) {
+                    snprintf(expected, sizeof(expected), c.printf_fmt, value);
+                    std::string str = format_arg_for_test(l, c.fmt, log_arg_type_enum::uint64_type, value);
+                    result.add_result(str == expected, "layout uint64 format test, fmt:%s, expected:%s, real:%s", c.fmt, expected, str.c_str());
+                }
+                int32_t value_32 = static_cast<int32_t>(signed_value);
+                snprintf(expected, sizeof(expected), "%" PRId32, value_32);
+                result.add_result(format_arg_for_test(l, "{}", log_arg_type_enum::int32_type, value_32) == expected, "layout int32 format test, expected:%s", expected);
+
+                char hex_sw[16];
+                char hex[16];
+                layout::test_write_hex_16_sw(value, (i % 2) == 0, hex_sw);
+                layout::test_write_hex_16(value, (i % 2) == 0, hex);
+                result.add_result(memcmp(hex_sw, hex, sizeof(hex)) == 0, "layout hex digits test, value:%" PRIu64, value);
+            }
+            result.add_result(format_arg_for_test(l, "{}", log_arg_type_enum::int64_type, INT64_MIN) == "-9223372036854775808", "layout int64 min format test");
+            result.add_result(format_arg_for_test(l, "{}", log_arg_type_enum::uint64_type, UINT64_MAX) == "18446744073709551615", "layout uint64 max format test");
+            result.add_result(format_arg_for_test(l, "{:#06x}", log_arg_type_enum::int32_type, 11) == "0x000b", "layout hex digit b with prefix format test");
+            result.add_result(format_arg_for_test(l, "{:*>6d}", log_arg_type_enum::int32_type, -12) == "-***12", "layout custom fill format test");
+            result.add_result(format_arg_for_test(l, "{:^6d}", log_arg_type_enum::int32_type, 12) == "  12  ", "layout center format test");
+            return result;
+        }
+
+        test_result test_layout::test_decimal_format()
+        {
+            test_result result;
+            bq::layout l;
+            struct double_case {
+                const char* fmt;
+                double value;
+                const char* expected;
+            };
+            const double_case double_cases[] = {
+                { "{}", 3.5, "3.5" },
+                { "{}", 0.1, "0.1" },
+                { "{}", 0.3, "0.3" },
+                { "{}", 3.0, "3.0" },
+                { "{}", -0.0, "-0.0" },
+                { "{}", 0.0, "0.0" },
+                { "{}", 324248284.8, "324248284.8" },
+                { "{}", 1.7976931348623157e308, "1.7976931348623157e+308" },
+                { "{}", 5e-324, "5e-324" },
+                { "{}", 0.0001, "0.0001" },
+                { "{}", 0.00001, "1e-05" },
+                { "{}", 1e16, "1e+16" },
+                { "{}", 123456789012345.6, "123456789012345.6" },
+                { "{:.2f}", 2.675, "2.67" },
+                { "{:.2f}", 0.125, "0.12" },
+                { "{:.0f}", 2.5, "2" },
+                { "{:.2f}", 999.999, "1000.00" },
+                { "{:.3f}", -1.0005, "-1.000" },
+                { "{:.2f}", 0.001, "0.00" },
+                { "{:.1f}", 1e20, "100000000000000000000.0" },
+                { "{:e}", 1234.5, "1.2345e+03" },
+                { "{:.2e}", 1234.5, "1.23e+03" },
+                { "{:.2e}", 9.999, "1.00e+01" },
+                { "{:.3e}", 0.00012345, "1.234e-04" },
+                { "{:E}", 0.5, "5E-01" },
+                { "{:+}", 1.5, "+1.5" },
+                { "{:8.2f}", 3.14159, "    3.14" },
+                { "{:<8}", 2.5, "2.5     " },
+                { "{:12}", 3.14159265758 / 2.3, "1.3659098511" },
+                { "{:6}", 2.0 / 3.0, "0.6667" },
+                { "{:12.3}", 3.14159265758 / 2.3, "       1.366" },
+                { "{:08.3f}", -2.5, "-002.500" },
+                { "{}", 8.4816206987030405e18, "8.48162069870304e+18" },
+                { "{}", 1316436775194682.2, "1316436775194682.2" },
+                { "{}", 5e-324, "5e-324" },
+                { "{}", 1.7976931348623157e308, "1.7976931348623157e+308" },
+            };
+            for (const auto& c : double_cases) {
+                std::string str = format_decimal_for_test(l, c.fmt, c.value);
+                result.add_result(str == c.expected, "layout double format test, fmt:%s, expected:%s, real:%s", c.fmt, c.expected, str.c_str());
+            }
+            struct float_case {
+                const char* fmt;
+                float value;
+                const char* expected;
+            };
+            const float_case float_cases[] = {
+                { "{}", 3.5f, "3.5" },
+                { "{}", 0.1f, "0.1" },
+                { "{}", -484323233.323234f, "-484323230.0" },
+                { "{}", 3.4028235e38f, "3.4028235e+38" },
+                { "{}", 1e-45f, "1e-45" },
+                { "{}", 770290432.f, "770290400.0" },
+                { "{:.3f}", 0.1f, "0.100" },
+                { "{:.10f}", 0.1f, "0.1000000015" },
+            };
+            for (const auto& c : float_cases) {
+                std::string str = format_decimal_for_test(l, c.fmt, c.value);
+                result.add_result(str == c.expected, "layout float format test, fmt:%s, expected:%s, real:%s", c.fmt, c.expected, str.c_str());
+            }
+            result.add_result(format_decimal_for_test(l, "{}", std::numeric_limits<double>::infinity()) == "inf", "layout double inf format test");
+            result.add_result(format_decimal_for_test(l, "{}", -std::numeric_limits<double>::infinity()) == "-inf", "layout double -inf format test");
+            result.add_result(format_decimal_for_test(l, "{}", std::numeric_limits<float>::quiet_NaN()) == "nan", "layout float nan format test");
+
+            // every printed value must parse back to the same binary value, and its digits must be the shortest and closest ones
+            std::mt19937_64 rng(20250101);
+            bool round_trip = true;
+            bool shortest = true;
+            std::string shortest_real;
+            std::string shortest_expected;
+            for (int32_t i = 0; i < 100000 && round_trip && shortest; ++i) {
+                uint64_t bits = rng();
+                double value;
+                memcpy(&value, &bits, sizeof(value));
+                if (value != value || value - value != 0) {
+                    continue;
+                }
+                std::string str = format_decimal_for_test(l, "{}", value);
+                round_trip = (strtod(str.c_str(), nullptr) == value);
+                result.add_result(round_trip, "layout double round trip test, bits:%" PRIu64 ", real:%s", bits, str.c_str());
+                shortest = value == 0 || check_shortest_for_test(value < 0 ? -value : value, shortest_real, shortest_expected);
+                result.add_result(shortest, "double shortest digits test, bits:%" PRIu64 ", expected:%s, real:%s", bits, shortest_expected.c_str(), shortest_real.c_str());
+
+                uint32_t float_bits = static_cast<uint32_t>(bits >> 32);
+                float float_value;
+                memcpy(&float_value, &float_bits, sizeof(float_value));
+                if (float_value != float_value || float_value - float_value != 0) {
+                    continue;
+                }
+                str = format_decimal_for_test(l, "{}", float_value);
+                round_trip = (strtof(str.c_str(), nullptr) == float_value);
+                result.add_result(round_trip, "layout float round trip test, bits:%" PRIu32 ", real:%s", float_bits, str.c_str());
+                shortest = float_value == 0 || check_shortest_for_test(float_value < 0 ? -float_value : float_value, shortest_real, shortest_expected);
+                result.add_result(shortest, "float shortest digits test, bits:%" PRIu32 ", expected:%s, real:%s", float_bits, shortest_expected.c_str(), shortest_real.c_str());
+            }
+            return result;
+        }
+
+        test_result test_layout::test_layout_pattern()
+        {
+            test_result result;
+            bq::layout_pattern pattern;
+            result.add_result(pattern.compile("%D %T.%u %L [%t %n] %c: %m") && pattern.get_ops().size() == 15, "layout pattern compile test");
+            result.add_result(pattern.get_id() != 0, "layout pattern id test");
+            result.add_result(pattern.compile("100%% %L") && pattern.get_ops().size() == 3 && pattern.get_ops()[2].type == bq::layout_pattern::op_type::message, "layout pattern implicit message test");
+            result.add_result(!pattern.compile("%L %q %m") && pattern.is_empty(), "layout pattern unknown specifier test");
+            result.add_result(!pattern.compile("%m %") && pattern.is_empty(), "layout pattern trailing percent test");
+
+            bq::file_manager::remove_file_or_dir(TO_ABSOLUTE_PATH("layout_pattern_test", 0));
+            auto log_inst = bq::log::create_log("layout_pattern_test", R"(
+                        appenders_config.Default.type=text_file
+                        appenders_config.Default.file_name=layout_pattern_test/default
+                        appenders_config.Default.time_zone=gmt
+                        appenders_config.Default.enable_rolling_log_file=false
+                        appenders_config.PatternA.type=text_file
+                        appenders_config.PatternA.file_name=layout_pattern_test/pattern_a
+                        appenders_config.PatternA.time_zone=gmt
+                        appenders_config.PatternA.layout_pattern=[%Z] %D %T.%u %L|%c|%m|%%
+                        appenders_config.PatternA.enable_rolling_log_file=false
+                        appenders_config.PatternB.type=text_file
+                        appenders_config.PatternB.file_name=layout_pattern_test/pattern_b
+                        appenders_config.PatternB.time_zone=gmt
+                        appenders_config.PatternB.layout_pattern=[%Z] %D %T.%u %L|%c|%m|%%
+                        appenders_config.PatternB.enable_rolling_log_file=false
+                        appenders_config.Epoch.type=text_file
+                        appenders_config.Epoch.file_name=layout_pattern_test/epoch
+                        appenders_config.Epoch.layout_pattern=%E %t %L
+                        appenders_config.Epoch.enable_rolling_log_file=false
+                        appenders_config.Invalid.type=text_file
+                        appenders_config.Invalid.file_name=layout_pattern_test/invalid
+                        appenders_config.Invalid.time_zone=gmt
+                        appenders_config.Invalid.layout_pattern=%L %q
+                        appenders_config.Invalid.enable_rolling_log_file=false
+                        log.thread_mode=sync
+                    )");
+            uint64_t epoch_begin = bq::platform::high_performance_epoch_ms();
+            log_inst.info("pattern test {}", 1);
+            log_inst.error("pattern test {}", 2.5f);
+            uint64_t epoch_end = bq::platform::high_performance_epoch_ms();
+            log_inst.force_flush();
+            bq::string text_default = bq::file_manager::read_all_text(TO_ABSOLUTE_PATH("layout_pattern_test/default_1.log", 0));
+            bq::string text_a = bq::file_manager::read_all_text(TO_ABSOLUTE_PATH("layout_pattern_test/pattern_a_1.log", 0));
+            bq::string text_b = bq::file_manager::read_all_text(TO_ABSOLUTE_PATH("layout_pattern_test/pattern_b_1.log", 0));
+            bq::string text_epoch = bq::file_manager::read_all_text(TO_ABSOLUTE_PATH("layout_pattern_test/epoch_1.log", 0));
+            bq::string text_invalid = bq::file_manager::read_all_text(TO_ABSOLUTE_PATH("layout_pattern_test/invalid_1.log", 0));
+            result.add_result(!text_a.is_empty() && text_a == text_b, "layout pattern shared cache test");
+            result.add_result(text_invalid == text_default, "layout pattern invalid fallback test");
+
+            auto lines_default = text_default.split("\n");
+            auto lines_a = text_a.split("\n");
+            auto lines_epoch = text_epoch.split("\n");
+            result.add_result(lines_default.size() == 2 && lines_a.size() == 2 && lines_epoch.size() == 2, "layout pattern line count test");
+            if (lines_default.size() == 2 && lines_a.size() == 2) {
+                // default: "UTC0 2025-01-02 12:34:56.789[tid-...", pattern: "[UTC0] 2025-01-02 12:34:56.789 I|..."
+                const bq::string default_time = lines_default[0].substr(5, 23);
+                result.add_result(lines_a[0] == "[UTC0] " + default_time + " I||pattern test 1|%", "layout pattern content test 1, real:%s", lines_a[0].c_str());
+                result.add_result(lines_a[1].end_with(" E||pattern test 2.5|%"), "layout pattern content test 2, real:%s", lines_a[1].c_str());
+            }
+            if (lines_epoch.size() == 2) {
+                auto fields = lines_epoch[0].split(" ");
+                uint64_t epoch = fields.size() == 5 ? static_cast<uint64_t>(strtoull(fields[0].c_str(), nullptr, 10)) : 0;
+                result.add_result(fields.size() == 5 && epoch >= epoch_begin && epoch <= epoch_end && fields[1].size() > 0 && fields[2] == "Ipattern", "layout pattern epoch test, real:%s", lines_epoch[0].c_str());
+            }
+            return result;
+        }
+
         test_result test_layout::test_find_brace_and_copy()
         {
             test_result result;
@@ -22,6 +22,10 @@ namespace bq {
             test_result test_find_brace_and_copy();
             test_result test_find_brace_and_convert_u16();
             test_result test_throughput();
+            test_result test_result_cache();
+            test_result test_decimal_format();
+            test_result test_integral_format();
+            test_result test_layout_pattern();
         };
     }
 }
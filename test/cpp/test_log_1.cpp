@@ -189,15 +189,15 @@ namespace bq {
 
                 log_inst.verbose(log_inst.cat.ModuleA.SystemA, TEST_STR("This is a Test Log, param {0}, param {2}, param \'{3}\', string param:{4}"), 3.5f, 4542232, TEST_CHAR('a'), TEST_STR("real_value"));
 
-                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\tThis is a Test Log, param 3.5000000, param 4542232, param \'a\', string param:real_value"), "%s, Log Test 5", str_type);
+                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\tThis is a Test Log, param 3.5, param 4542232, param \'a\', string param:real_value"), "%s, Log Test 5", str_type);
 
                 log_inst.verbose(log_inst.cat.ModuleA.SystemA, TEST_STR("测试, param {0}, param {2}, param \'{3}\', string param:{4}"), 3.5f, 4542232, TEST_CHAR('a'), TEST_STR("字符串"));
 
-                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5000000, param 4542232, param \'a\', string param:字符串"), "%s, Log Test 6", str_type);
+                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5, param 4542232, param \'a\', string param:字符串"), "%s, Log Test 6", str_type);
 
                 log_inst.verbose(log_inst.cat.ModuleA.SystemA, TEST_STR("测试, param {0}, param {2}, string \"{3}\", string param:{4}, string param:{5}"), 3.5f, 4542232, UTF8_STR("utf-8字符串"), UTF16_STR(u"utf-16字符串"), UTF32_STR(U"utf-32字符串"));
 
-                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5000000, param 4542232, string \"utf-8字符串\", string param:utf-16字符串, string param:utf-32字符串"), "%s, Log Test 7", str_type);
+                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5, param 4542232, string \"utf-8字符串\", string param:utf-16字符串, string param:utf-32字符串"), "%s, Log Test 7", str_type);
             }
 
             {
@@ -260,15 +260,15 @@ namespace bq {
 
                 log_inst.verbose(log_inst.cat.ModuleA.SystemA, TEST_STR(u"This is a Test Log, param {0}, param {2}, param \'{3}\', string param:{4}"), 3.5f, 4542232, TEST_CHAR('a'), "real_value");
 
-                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\tThis is a Test Log, param 3.5000000, param 4542232, param \'a\', string param:real_value"), "%s, Log Test 5", str_type);
+                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\tThis is a Test Log, param 3.5, param 4542232, param \'a\', string param:real_value"), "%s, Log Test 5", str_type);
 
                 log_inst.verbose(log_inst.cat.ModuleA.SystemA, TEST_STR(u"测试, param {0}, param {2}, param \'{3}\', string param:{4}"), 3.5f, 4542232, 'a', TEST_STR(u"字符串"));
 
-                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5000000, param 4542232, param \'a\', string param:字符串"), "%s, Log Test 6", str_type);
+                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5, param 4542232, param \'a\', string param:字符串"), "%s, Log Test 6", str_type);
 
                 log_inst.verbose(log_inst.cat.ModuleA.SystemA, TEST_STR(u"测试, param {0}, param {2}, string \"{3}\", string param:{4}, string param:{5}"), 3.5f, 4542232, UTF8_STR("utf-8字符串"), UTF16_STR(u"utf-16字符串"), UTF32_STR(U"utf-32字符串"));
 
-                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5000000, param 4542232, string \"utf-8字符串\", string param:utf-16字符串, string param:utf-32字符串"), "%s, Log Test 7", str_type);
+                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5, param 4542232, string \"utf-8字符串\", string param:utf-16字符串, string param:utf-32字符串"), "%s, Log Test 7", str_type);
             }
 
 #undef TEST_STR
@@ -303,15 +303,15 @@ namespace bq {
 
                 log_inst.verbose(log_inst.cat.ModuleA.SystemA, TEST_STR(U"This is a Test Log, param {0}, param {2}, param \'{3}\', string param:{4}"), 3.5f, 4542232, TEST_CHAR('a'), "real_value");
 
-                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\tThis is a Test Log, param 3.5000000, param 4542232, param \'a\', string param:real_value"), "%s, Log Test 5", str_type);
+                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\tThis is a Test Log, param 3.5, param 4542232, param \'a\', string param:real_value"), "%s, Log Test 5", str_type);
 
                 log_inst.verbose(log_inst.cat.ModuleA.SystemA, TEST_STR(U"测试, param {0}, param {2}, param \'{3}\', string param:{4}"), 3.5f, 4542232, 'a', TEST_STR(U"字符串"));
 
-                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5000000, param 4542232, param \'a\', string param:字符串"), "%s, Log Test 6", str_type);
+                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5, param 4542232, param \'a\', string param:字符串"), "%s, Log Test 6", str_type);
 
                 log_inst.verbose(log_inst.cat.ModuleA.SystemA, TEST_STR(U"测试, param {0}, param {2}, string \"{3}\", string param:{4}, string param:{5}"), 3.5f, 4542232, UTF8_STR("utf-8字符串"), UTF16_STR(u"utf-16字符串"), UTF32_STR(U"utf-32字符串"));
 
-                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5000000, param 4542232, string \"utf-8字符串\", string param:utf-16字符串, string param:utf-32字符串"), "%s, Log Test 7", str_type);
+                result.add_result(log_str.end_with("[V]\t[ModuleA.SystemA]\t测试, param 3.5, param 4542232, string \"utf-8字符串\", string param:utf-16字符串, string param:utf-32字符串"), "%s, Log Test 7", str_type);
             }
         }
     }
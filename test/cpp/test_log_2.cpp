@@ -132,13 +132,13 @@ namespace bq {
                 result.add_result(log_str.end_with("[E]\t[ModuleB]\t|0X000C|"), "layout format");
                 double dd { 3.14159265758 / 2.3 };
                 log_inst.error(log_inst.cat.ModuleB, "|{:12.3e}|", dd);
-                result.add_result(log_str.end_with("[E]\t[ModuleB]\t|   1.365e+00|"), "layout format");
+                result.add_result(log_str.end_with("[E]\t[ModuleB]\t|   1.366e+00|"), "layout format");
                 log_inst.error(log_inst.cat.ModuleB, "|{:12.3e}|", 103.1234);
                 result.add_result(log_str.end_with("[E]\t[ModuleB]\t|   1.031e+02|"), "layout format");
                 log_inst.error(log_inst.cat.ModuleB, "|{:12d}|", dd);
                 result.add_result(log_str.end_with("[E]\t[ModuleB]\t|1.3659098511|"), "layout format");
                 log_inst.error(log_inst.cat.ModuleB, "|{:12.3}|", dd);
-                result.add_result(log_str.end_with("[E]\t[ModuleB]\t|       1.365|"), "layout format");
+                result.add_result(log_str.end_with("[E]\t[ModuleB]\t|       1.366|"), "layout format");
                 log_inst.error(log_inst.cat.ModuleB, "|{:12e}|", 10000000000000);
                 result.add_result(log_str.end_with("[E]\t[ModuleB]\t|1.000000e+11|"), "layout format");
                 log_inst.error(log_inst.cat.ModuleB, "|{:12E}|", (uint64_t)10000000000000);
@@ -184,13 +184,13 @@ namespace bq {
                 log_inst.error(log_inst.cat.ModuleB, "|{:#06X}|", i);
                 result.add_result(log_str.end_with("[E]\t[ModuleB]\t|0X3B03AD8AD|"), "layout format");
                 log_inst.error(log_inst.cat.ModuleB, "|{:12.3e}|", dd);
-                result.add_result(log_str.end_with("[E]\t[ModuleB]\t|   1.365e+00|"), "layout format");
+                result.add_result(log_str.end_with("[E]\t[ModuleB]\t|   1.366e+00|"), "layout format");
                 log_inst.error(log_inst.cat.ModuleB, "|{:12.3e}|", 103.1234);
                 result.add_result(log_str.end_with("[E]\t[ModuleB]\t|   1.031e+02|"), "layout format");
                 log_inst.error(log_inst.cat.ModuleB, "|{:12d}|", 100);
                 result.add_result(log_str.end_with("[E]\t[ModuleB]\t|         100|"), "layout format");
                 log_inst.error(log_inst.cat.ModuleB, "|{:12.3}|", dd);
-                result.add_result(log_str.end_with("[E]\t[ModuleB]\t|       1.365|"), "layout format");
+                result.add_result(log_str.end_with("[E]\t[ModuleB]\t|       1.366|"), "layout format");
                 log_inst.error(log_inst.cat.ModuleB, "|{:12.3e}|", 10000000000000.0);
                 result.add_result(log_str.end_with("[E]\t[ModuleB]\t|   1.000e+13|"), "layout format");
                 log_inst.error(log_inst.cat.ModuleB, "|{:12.3E}|", 10000000000000.0);
@@ -341,6 +341,21 @@ namespace bq {
                 result.add_result(new_snapshot2.begin_with(new_snapshot1), "snapshot test 4");
                 result.add_result(new_snapshot2.find("BBBB") != bq::string::npos, "snapshot test 5");
                 result.add_result(new_snapshot2.find("CCCC") > new_snapshot2.find("BBBB"), "snapshot test 6");
+
+                // binary snapshot, decoded offline to the same text
+                bq::string snapshot_binary_path = TO_ABSOLUTE_PATH("snapshot_test/snapshot_log.lograw", 0);
+                result.add_result(snapshot_log2.take_snapshot_binary(snapshot_binary_path), "snapshot binary test 1");
+                bq::string decoded_snapshot;
+                {
+                    bq::tools::log_decoder decoder(snapshot_binary_path);
+                    while (decoder.decode() == bq::appender_decode_result::success) {
+                        decoded_snapshot += decoder.get_last_decoded_log_entry();
+                        decoded_snapshot.push_back('\n');
+                    }
+                }
+                result.add_result(decoded_snapshot == snapshot_log2.take_snapshot("localtime"), "snapshot binary test 2");
+                result.add_result(decoded_snapshot.find("BBBB") != bq::string::npos && decoded_snapshot.find("CCCC") > decoded_snapshot.find("BBBB"), "snapshot binary test 3");
+                bq::file_manager::remove_file_or_dir(snapshot_binary_path);
             }
         }
     }
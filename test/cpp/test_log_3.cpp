@@ -432,53 +432,69 @@ namespace bq {
                 (void)value;
                 return "custom_type5";
             }
-            static bq::string trans(float value)
+            // reference of the layout decimal output: shortest round trip digits from the C runtime,
+            // fixed notation with at least one fractional digit, e-style out of [1e-4, 1e16)
+            template <typename T>
+            static bq::string trans_decimal(T value, int32_t max_digits)
             {
+                char buf[64];
+                for (int32_t digits = 1; digits <= max_digits; ++digits) {
+                    snprintf(buf, sizeof(buf), "%.*e", digits - 1, static_cast<double>(value));
+                    T parsed = (sizeof(T) == sizeof(float)) ? static_cast<T>(strtof(buf, nullptr)) : static_cast<T>(strtod(buf, nullptr));
+                    if (parsed == value) {
+                        break;
+                    }
+                }
                 bq::string result;
-                int32_t precision = 7;
-                if (value >= 0) {
-                    uint64_t i_part = static_cast<uint64_t>(value);
-                    result = trans(i_part);
-                    value -= static_cast<float>(i_part);
-                } else {
-                    int64_t i_part = static_cast<int64_t>(value);
-                    result = trans(i_part);
-                    value -= static_cast<float>(i_part);
+                const char* cursor = buf;
+                if (*cursor == '-') {
+                    result += "-";
+                    ++cursor;
+                }
+                bq::string mantissa;
+                for (; *cursor != 'e'; ++cursor) {
+                    if (*cursor != '.') {
+                        mantissa.push_back(*cursor);
+                    }
+                }
+                int32_t exponent = atoi(cursor + 1);
+                if (exponent < -4 || exponent >= 16) {
+                    result.push_back(mantissa[0]);
+                    if (mantissa.size() > 1) {
+                        result += ".";
+                        result += mantissa.substr(1, mantissa.size() - 1);
+                    }
+                    snprintf(buf, sizeof(buf), "e%c%02d", exponent < 0 ? '-' : '+', exponent < 0 ? -exponent : exponent);
+                    result += buf;
+                    return result;
+                }
+                int32_t point_pos = exponent + 1;
+                if (point_pos <= 0) {
+                    result += "0.";
+                    for (int32_t i = point_pos; i < 0; ++i) {
+                        result += "0";
+                    }
+                    result += mantissa;
+                    return result;
+                }
+                for (int32_t i = 0; i < point_pos; ++i) {
+                    result.push_back(i < static_cast<int32_t>(mantissa.size()) ? mantissa[static_cast<size_t>(i)] : '0');
                 }
-                value = fabsf(value);
                 result += ".";
-                while (precision > 0) {
-                    value *= 10;
-                    int32_t digit = (int32_t)value;
-                    value -= (float)(digit);
-                    --precision;
-                    result.push_back((char)('0' + (char)digit));
+                if (static_cast<int32_t>(mantissa.size()) > point_pos) {
+                    result += mantissa.substr(static_cast<size_t>(point_pos), mantissa.size() - static_cast<size_t>(point_pos));
+                } else {
+                    result += "0";
                 }
                 return result;
             }
+            static bq::string trans(float value)
+            {
+                return trans_decimal(value, 9);
+            }
             static bq::string trans(double value)
             {
-                bq::string result;
-                int32_t precision = 15;
-                if (value >= 0) {
-                    uint64_t i_part = static_cast<uint64_t>(value);
-                    result = trans(i_part);
-                    value -= static_cast<double>(i_part);
-                } else {
-                    int64_t i_part = static_cast<int64_t>(value);
-                    result = trans(i_part);
-                    value -= static_cast<double>(i_part);
-                }
-                value = fabs(value);
-                result += ".";
-                while (precision > 0) {
-                    value *= 10;
-                    int32_t digit = (int32_t)value;
-                    value -= (double)(digit);
-                    --precision;
-                    result.push_back((char)('0' + (char)digit));
-                }
-                return result;
+                return trans_decimal(value, 17);
             }
             template <size_t N>
             static bq::string trans_utf8_char_array_impl(const char (&value)[N])
@@ -12,10 +12,13 @@
  */
 #include <random>
 #include "test_base.h"
+#include "bq_common_test/test_compression.h"
 #include "bq_log/log/log_imp.h"
 #include "bq_log/log/appender/appender_console.h"
 #include "bq_log/log/appender/appender_file_base.h"
 #include "bq_log/log/appender/appender_file_binary.h"
+#include "bq_log/log/appender/appender_file_text.h"
+#include "bq_log/log/appender/file_archiver.h"
 #include "bq_log/log/decoder/appender_decoder_base.h"
 
 namespace bq {
@@ -54,6 +57,23 @@ namespace bq {
                 seek_read_file_absolute(static_cast<size_t>(0));
             }
         };
+        class appender_file_text_for_test : public appender_file_text {
+        public:
+            // plain bytes instead of formatted entries, so the archives can be compared with what was written.
+            void write_and_rotate(const bq::string& content)
+            {
+                if (!get_file_handle()) {
+                    open_new_indexed_file_by_name();
+                }
+                auto handle = alloc_write_cache(content.size());
+                memcpy(handle.data(), content.c_str(), content.size());
+                return_write_cache(handle);
+                mark_write_finished();
+                flush_write_cache();
+                flush_write_io();
+                open_new_indexed_file_by_name();
+            }
+        };
         class appender_file_binary_for_test : public appender_file_binary {
             template <typename AppenderType>
             friend void do_appender_test(test_result& result, const bq::string test_name, bool use_decoder, const bq::string& pub_key, const bq::string& private_key);
@@ -280,6 +300,69 @@ namespace bq {
             {
                 do_appender_test<appender_file_base_for_test>(result, "appender_file_base_test", false, "", "");
             }
+            static bq::string make_archive_test_content(const char* tag, size_t size)
+            {
+                bq::string line = bq::string("bqlog archive test line of ") + tag + "\n";
+                bq::string content;
+                while (content.size() + line.size() <= size) {
+                    content += line;
+                }
+                return content;
+            }
+            void do_file_appender_archive_test(test_result& result)
+            {
+                test_output_dynamic(bq::log_level::info, "appender file archive test begin, please wait...                \r");
+                clear_appender_file_base_test_folder();
+                log_imp log_obj;
+                bq::array<bq::string> categories;
+                categories.push_back("");
+                log_obj.init("archive_test", bq::property_value::create_from_string("appenders_config.appender_0.type=console"), categories);
+                bq::property_value appender_config = bq::property_value::create_from_string(R"(
+                        type=text_file
+                        levels=[all]
+                        file_name=appender_test/archive_test
+                        base_dir_type=0
+                        enable_rolling_log_file=false
+                        compress_rotated_files=true
+                        )");
+                // left by a previous run exited before they were compressed, the last one is reused as the current file.
+                bq::string expected_contents[3];
+                expected_contents[0] = make_archive_test_content("left file", 256 * 1024);
+                expected_contents[1] = make_archive_test_content("reused file", 64 * 1024);
+                bq::file_manager::create_directory(TO_ABSOLUTE_PATH("appender_test", 0));
+                bq::file_manager::write_all_text(TO_ABSOLUTE_PATH("appender_test/archive_test_1.log", 0), expected_contents[0]);
+                bq::file_manager::write_all_text(TO_ABSOLUTE_PATH("appender_test/archive_test_2.log", 0), expected_contents[1]);
+                {
+                    appender_file_text_for_test appender;
+                    appender.init("test_appender", appender_config, &log_obj);
+                    bq::string content = make_archive_test_content("file 2", 192 * 1024);
+                    expected_contents[1] += content;
+                    appender.write_and_rotate(content);
+                    expected_contents[2] = make_archive_test_content("file 3", 256 * 1024);
+                    appender.write_and_rotate(expected_contents[2]);
+                }
+                result.add_result(file_archiver::instance().wait_for_idle(30000), "file archiver wait for idle test");
+                for (int32_t idx = 1; idx <= 3; ++idx) {
+                    char idx_str[32];
+                    snprintf(idx_str, sizeof(idx_str), "%" PRId32, idx);
+                    bq::string file_path = TO_ABSOLUTE_PATH(bq::string("appender_test/archive_test_") + idx_str + ".log", 0);
+                    bq::string archive_path = file_path + file_archiver::ARCHIVE_EXT_NAME;
+                    result.add_result(!bq::file_manager::is_file(file_path), "rotated file removed after archive test, idx:%" PRId32, idx);
+                    result.add_result(bq::file_manager::is_file(archive_path), "rotated file archived test, idx:%" PRId32, idx);
+                    bq::string archive_content = bq::file_manager::read_all_text(archive_path);
+                    result.add_result(archive_content.size() < expected_contents[idx - 1].size() / 8, "rotated file archive size test, idx:%" PRId32, idx);
+                    bq::array<uint8_t> gz;
+                    gz.insert_batch(gz.end(), reinterpret_cast<const uint8_t*>(archive_content.c_str()), archive_content.size());
+                    bq::array<uint8_t> decompressed;
+                    bool gunzip_success = test_compression::gunzip(gz, decompressed);
+                    result.add_result(gunzip_success && decompressed.size() == expected_contents[idx - 1].size()
+                            && memcmp(decompressed.begin(), expected_contents[idx - 1].c_str(), decompressed.size()) == 0,
+                        "rotated file archive content test, idx:%" PRId32, idx);
+                }
+                // archived files must be counted when picking the next index, otherwise they would be overwritten.
+                result.add_result(bq::file_manager::is_file(TO_ABSOLUTE_PATH("appender_test/archive_test_4.log", 0)), "next index after archived files test");
+                test_output_dynamic(bq::log_level::info, "                                                                              \r");
+            }
             void do_binary_appender_test(test_result& result)
             {
                 do_appender_test<appender_file_binary_for_test>(result, "appender_file_binary_test", false, "", "");
@@ -340,6 +423,7 @@ namespace bq {
                 for (int32_t i = 0; i < loop_count; ++i) {
                     do_file_appender_test(result);
                 }
+                do_file_appender_archive_test(result);
                 for (int32_t i = 0; i < loop_count; ++i) {
                     do_binary_appender_test(result);
                 }
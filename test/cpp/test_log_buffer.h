@@ -607,6 +607,8 @@ namespace bq {
                     bq::scoped_log_buffer_handle<log_buffer> scoped_final_handle(test_buffer, final_handle);
                     result.add_result(final_handle.result == bq::enum_buffer_result_code::err_empty_log_buffer, "final read test");
                 }
+                // every idle oversize buffer except the last read one should have been moved to the pools by now.
+                result.add_result(test_buffer.get_oversize_buffer_count() <= 1, "oversize buffer pool test, left active oversize buffers:%" PRIu64 ", pooled:%" PRIu32, static_cast<uint64_t>(test_buffer.get_oversize_buffer_count()), test_buffer.get_pooled_oversize_buffer_count());
 #if !defined(BQ_WIN) || !defined(BQ_GCC) // MinGW with GCC has bug on thread_local, so the log buffer recycle may not work properly.
                 result.add_result(test_buffer.get_groups_count() == 0, "group recycle test, expected left group:0, but: %" PRIu32 "", test_buffer.get_groups_count());
 #endif
@@ -617,6 +619,86 @@ namespace bq {
                 test_output_dynamic(bq::log_level::info, "[log buffer] done.\n");
             }
 
+            void do_oversize_pool_test(test_result& result)
+            {
+                test_output_dynamic(bq::log_level::info, "[log buffer] do oversize buffer pool test begin...\n");
+                log_buffer_config config;
+                config.log_name = "log_buffer_oversize_pool_test";
+                config.log_categories_name = { "_default" };
+                config.need_recovery = bq::memory_map::is_platform_support();
+                config.policy = log_memory_policy::auto_expand_when_full;
+                config.high_frequency_threshold_per_second = UINT64_MAX;
+                bq::string mmap_folder = TO_ABSOLUTE_PATH("bqlog_mmap/mmap_log_buffer_oversize_pool_test", 0);
+                if (bq::file_manager::is_dir(mmap_folder)) {
+                    bq::file_manager::remove_file_or_dir(mmap_folder);
+                }
+                bq::string oversize_folder = bq::file_manager::combine_path(mmap_folder, "os");
+                bq::log_buffer test_buffer(config);
+
+                // All the entries have the same size, so their oversize buffers fall into the same pool class.
+                constexpr uint32_t oversize_chunk_size = 100 * 1024;
+                auto write_from_new_thread = [&test_buffer, &result](uint8_t tag) {
+                    std::thread write_thread([&test_buffer, &result, tag]() {
+                        auto handle = test_buffer.alloc_write_chunk(oversize_chunk_size, bq::platform::high_performance_epoch_ms());
+                        result.add_result(handle.result == enum_buffer_result_code::success, "oversize buffer pool test write alloc, tag:%" PRIu32, static_cast<uint32_t>(tag));
+                        if (handle.result == enum_buffer_result_code::success) {
+                            memset(handle.data_addr, tag, oversize_chunk_size);
+                            test_buffer.commit_write_chunk(handle);
+                        }
+                    });
+                    write_thread.join();
+                };
+                auto read_and_verify = [&test_buffer, &result](uint8_t tag) {
+                    auto handle = test_buffer.read_chunk();
+                    bq::scoped_log_buffer_handle<log_buffer> scoped_handle(test_buffer, handle);
+                    result.add_result(handle.result == enum_buffer_result_code::success && handle.data_size == oversize_chunk_size, "oversize buffer pool test read, tag:%" PRIu32, static_cast<uint32_t>(tag));
+                    if (handle.result == enum_buffer_result_code::success) {
+                        bool valid = true;
+                        for (uint32_t i = 0; i < handle.data_size; ++i) {
+                            if (handle.data_addr[i] != tag) {
+                                valid = false;
+                                break;
+                            }
+                        }
+                        result.add_result(valid, "oversize buffer pool test content, tag:%" PRIu32, static_cast<uint32_t>(tag));
+                    }
+                };
+
+                // Every thread gets its own oversize buffer, the one read last stays referenced by the reader and is not recycled.
+                write_from_new_thread(1);
+                write_from_new_thread(2);
+                read_and_verify(1);
+                read_and_verify(2);
+                bq::platform::thread::sleep(log_buffer::OVERSIZE_BUFFER_RECYCLE_INTERVAL_MS * 2);
+                {
+                    auto handle = test_buffer.read_chunk();
+                    bq::scoped_log_buffer_handle<log_buffer> scoped_handle(test_buffer, handle);
+                    result.add_result(handle.result == enum_buffer_result_code::err_empty_log_buffer, "oversize buffer pool test empty read");
+                }
+                uint32_t pooled_count = test_buffer.get_pooled_oversize_buffer_count();
+                result.add_result(pooled_count > 0, "oversize buffer pool test, no idle oversize buffer is pooled, active:%" PRIu64, static_cast<uint64_t>(test_buffer.get_oversize_buffer_count()));
+                bq::array<bq::string> files_before;
+                if (config.need_recovery) {
+                    files_before = bq::file_manager::get_sub_dirs_and_files_name(oversize_folder);
+                }
+
+                // A new entry of the same size class must take the pooled buffer instead of creating a new one.
+                write_from_new_thread(3);
+                result.add_result(test_buffer.get_pooled_oversize_buffer_count() + 1 == pooled_count, "oversize buffer pool test, pooled buffer is not reused, pooled before:%" PRIu32 ", after:%" PRIu32, pooled_count, test_buffer.get_pooled_oversize_buffer_count());
+                if (config.need_recovery) {
+                    bq::array<bq::string> files_after = bq::file_manager::get_sub_dirs_and_files_name(oversize_folder);
+                    bool same_files = (files_after.size() == files_before.size());
+                    for (const bq::string& file_name : files_after) {
+                        if (files_before.find(file_name) == files_before.end()) {
+                            same_files = false;
+                        }
+                    }
+                    result.add_result(same_files, "oversize buffer pool test, new memory map file created, before:%" PRIu64 ", after:%" PRIu64, static_cast<uint64_t>(files_before.size()), static_cast<uint64_t>(files_after.size()));
+                }
+                read_and_verify(3);
+                test_output_dynamic(bq::log_level::info, "[log buffer] do oversize buffer pool test end...\n");
+            }
+
             void do_recovery_test(test_result& result)
             {
                 if (!bq::memory_map::is_platform_support()) {
@@ -844,9 +926,111 @@ namespace bq {
                     result.add_result(handle.result == enum_buffer_result_code::err_empty_log_buffer, "recovery multi thread test read content final for single thread");
                 }
 
+                {
+                    // the first HP groups live in the arena file, only the groups exceeding its slots get their own files.
+                    bq::string arena_path = TO_ABSOLUTE_PATH("bqlog_mmap/mmap_log_buffer_recovery_test/hp/log_buffer_recovery_test.arena", 0);
+                    result.add_result(bq::file_manager::is_file(arena_path), "recovery test hp arena file existence");
+                }
+
                 test_output_dynamic(bq::log_level::info, "[log buffer] do recovery test end...\n");
             }
 
+            // Fills several HP groups from many threads, so that the recovery maps them with more than one thread.
+            void do_multi_group_recovery_test(test_result& result)
+            {
+                if (!bq::memory_map::is_platform_support()) {
+                    return;
+                }
+                test_output_dynamic(bq::log_level::info, "=======================\n[log buffer] do multi group recovery test begin...\n");
+                log_buffer_config config;
+                config.log_name = "log_buffer_group_recovery_test";
+                config.log_categories_name = { "_default" };
+                config.need_recovery = true;
+                config.policy = log_memory_policy::auto_expand_when_full;
+                config.high_frequency_threshold_per_second = 1; // every thread writes to its own HP block from the first entry.
+                bq::string mmap_folder = TO_ABSOLUTE_PATH("bqlog_mmap/mmap_log_buffer_group_recovery_test", 0);
+                if (bq::file_manager::is_dir(mmap_folder)) {
+                    bq::file_manager::remove_file_or_dir(mmap_folder);
+                }
+
+                // Nothing is read while writing, so no block is recycled and every thread takes a new one.
+                constexpr uint32_t THREAD_COUNT = static_cast<uint32_t>(log_buffer::BLOCKS_PER_GROUP_NODE) * group_list::MAX_RECOVERY_THREADS + 1;
+                constexpr uint32_t MESSAGE_PER_THREAD = 200;
+                {
+                    bq::log_buffer write_buffer(config);
+                    std::vector<std::thread> task_thread_vector;
+                    for (uint32_t thread_idx = 0; thread_idx < THREAD_COUNT; ++thread_idx) {
+                        task_thread_vector.emplace_back([&write_buffer, &result, thread_idx]() {
+                            for (uint32_t i = 0; i < MESSAGE_PER_THREAD; ++i) {
+                                uint32_t alloc_size = static_cast<uint32_t>(2 * sizeof(uint32_t)) * (1 + i % 32);
+                                auto handle = write_buffer.alloc_write_chunk(alloc_size, bq::platform::high_performance_epoch_ms());
+                                while (handle.result == enum_buffer_result_code::err_not_enough_space
+                                    || handle.result == enum_buffer_result_code::err_wait_and_retry) {
+                                    write_buffer.commit_write_chunk(handle);
+                                    bq::platform::thread::yield();
+                                    handle = write_buffer.alloc_write_chunk(alloc_size, bq::platform::high_performance_epoch_ms());
+                                }
+                                result.add_result(handle.result == enum_buffer_result_code::success, "multi group recovery test write alloc, thread idx:%" PRIu32 ", index:%" PRIu32, thread_idx, i);
+                                if (handle.result == enum_buffer_result_code::success) {
+                                    bq::scoped_log_buffer_handle<log_buffer> scoped_handle(write_buffer, handle);
+                                    for (size_t pos = 0; pos + 2 * sizeof(uint32_t) <= alloc_size; pos += 2 * sizeof(uint32_t)) {
+                                        uint32_t* ptr = reinterpret_cast<uint32_t*>(handle.data_addr + pos);
+                                        ptr[0] = thread_idx;
+                                        ptr[1] = i;
+                                    }
+                                }
+                            }
+                        });
+                    }
+                    for (auto& task : task_thread_vector) {
+                        task.join();
+                    }
+                    result.add_result(write_buffer.get_groups_count() >= static_cast<int32_t>(group_list::MAX_RECOVERY_THREADS), "multi group recovery test, not enough HP groups written:%" PRId32, write_buffer.get_groups_count());
+                }
+
+                bq::log_buffer recovery_buffer(config);
+                const auto& recovered_indices = recovery_buffer.get_recovered_group_indices();
+                result.add_result(recovered_indices.size() >= group_list::MAX_RECOVERY_THREADS, "multi group recovery test, recovered groups:%" PRIu64, static_cast<uint64_t>(recovered_indices.size()));
+                // Groups mapped by different threads must still be linked in the order they were collected.
+                bq::array<uint64_t> group_indices = recovery_buffer.get_group_indices();
+                bool order_valid = (group_indices.size() == recovered_indices.size());
+                for (size_t i = 0; order_valid && i < group_indices.size(); ++i) {
+                    order_valid = (group_indices[i] == recovered_indices[recovered_indices.size() - 1 - i]);
+                }
+                result.add_result(order_valid, "multi group recovery test group order");
+
+                uint32_t expected_message_idx[THREAD_COUNT];
+                memset(expected_message_idx, 0, sizeof(expected_message_idx));
+                for (uint32_t read_idx = 0; read_idx < THREAD_COUNT * MESSAGE_PER_THREAD; ++read_idx) {
+                    auto handle = recovery_buffer.read_chunk();
+                    bq::scoped_log_buffer_handle<log_buffer> scoped_handle(recovery_buffer, handle);
+                    result.add_result(handle.result == enum_buffer_result_code::success, "multi group recovery test read chunk, result_code:%" PRId32, static_cast<int32_t>(handle.result));
+                    if (handle.result != enum_buffer_result_code::success) {
+                        continue;
+                    }
+                    uint32_t read_thread_idx = reinterpret_cast<const uint32_t*>(handle.data_addr)[0];
+                    uint32_t read_message_idx = reinterpret_cast<const uint32_t*>(handle.data_addr)[1];
+                    bool valid = (read_thread_idx < THREAD_COUNT)
+                        && (handle.data_size == static_cast<uint32_t>(2 * sizeof(uint32_t)) * (1 + read_message_idx % 32));
+                    for (size_t pos = 0; valid && pos + 2 * sizeof(uint32_t) <= handle.data_size; pos += 2 * sizeof(uint32_t)) {
+                        const uint32_t* ptr = reinterpret_cast<const uint32_t*>(handle.data_addr + pos);
+                        valid = (ptr[0] == read_thread_idx && ptr[1] == read_message_idx);
+                    }
+                    result.add_result(valid, "multi group recovery test read content check, thread idx:%" PRIu32 ", index:%" PRIu32, read_thread_idx, read_message_idx);
+                    if (valid) {
+                        result.add_result(expected_message_idx[read_thread_idx] == read_message_idx, "multi group recovery test read order check, thread idx:%" PRIu32 ", index:%" PRIu32 ", expected index:%" PRIu32, read_thread_idx, read_message_idx, expected_message_idx[read_thread_idx]);
+                        expected_message_idx[read_thread_idx] = read_message_idx + 1;
+                    }
+                }
+                for (uint32_t thread_idx = 0; thread_idx < THREAD_COUNT; ++thread_idx) {
+                    result.add_result(expected_message_idx[thread_idx] == MESSAGE_PER_THREAD, "multi group recovery test read count check, thread idx:%" PRIu32 ", read:%" PRIu32, thread_idx, expected_message_idx[thread_idx]);
+                }
+                auto final_handle = recovery_buffer.read_chunk();
+                bq::scoped_log_buffer_handle<log_buffer> scoped_final_handle(recovery_buffer, final_handle);
+                result.add_result(final_handle.result == enum_buffer_result_code::err_empty_log_buffer, "multi group recovery test final read");
+                test_output_dynamic(bq::log_level::info, "[log buffer] do multi group recovery test end...\n");
+            }
+
         public:
             virtual test_result test() override
             {
@@ -882,9 +1066,12 @@ namespace bq {
                 config.policy = log_memory_policy::auto_expand_when_full;
                 do_log_buffer_test(result, config);
 
+                do_oversize_pool_test(result);
+
                 // Run in a separate thread to ensure TLS cleanup and avoid Sanitizer leak reports.
                 std::thread recovery_test_thread([this, &result]() {
                     do_recovery_test(result);
+                    do_multi_group_recovery_test(result);
                 });
                 recovery_test_thread.join();
                 return result;
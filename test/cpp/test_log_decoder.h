@@ -0,0 +1,44 @@
+#pragma once
+/*
+ * Copyright (C) 2025 Tencent.
+ * BQLOG is licensed under the Apache License, Version 2.0.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test_base.h"
+
+namespace bq {
+    namespace test {
+        class test_log_decoder : public test_base {
+        public:
+            test_result test() override;
+
+        private:
+            void prepare_log_files();
+            test_result test_parallel_decode();
+            test_result test_seek_to_time();
+            test_result test_filter();
+            test_result test_follow();
+            test_result test_merge();
+            test_result test_decode_batch();
+            test_result test_export();
+            test_result test_template_stats();
+            test_result test_resync();
+            test_result test_arg_type_signature();
+            test_result test_string_dictionary();
+            test_result test_delta_encoding();
+            test_result test_block_compression();
+            test_result test_block_write_failure();
+            test_result test_encrypted_restart_points();
+
+        private:
+            // boundary_epochs_[k] lies after the epoch of log entry k * DECODER_TEST_SEEK_STEP - 1 and not after the epoch of entry k * DECODER_TEST_SEEK_STEP
+            bq::array<uint64_t> boundary_epochs_;
+        };
+    }
+}
@@ -13,6 +13,11 @@
 #include "bq_log/bq_log.h"
 #include "bq_log/log/appender/appender_file_compressed.h"
 #include "bq_log/log/appender/appender_file_raw.h"
+#include "bq_log/log/decoder/appender_decoder_manager.h"
+#include "bq_log/log/decoder/appender_decoder_merge.h"
+#include "bq_log/log/decoder/appender_decoder_parallel.h"
+#include "bq_log/log/decoder/log_entry_exporter.h"
+#include "bq_log/log/log_level_bitmap.h"
 #include "common_header.h"
 #if defined(WIN32)
 #include "Windows.h"
@@ -21,8 +26,17 @@
 
 struct Options {
     bq::string input_path;
+    bq::array<bq::string> merge_paths; // all input files when merging
     bq::string output_path; // "-" or empty => stdout
     bq::string private_key_path; // File path to RSA-2048 PEM private key
+    uint32_t jobs = 1; // decoding threads, 1 => sequential decoding
+    bool follow = false; // keep decoding new logs appended to the file
+    bool merge = false; // merge several files into one timeline
+    bool stats = false; // report log volume per format template instead of decoding
+    bq::log_decode_output_format output_format = bq::log_decode_output_format::text;
+    bq::log_decode_filter filter = {}; // all zero => no filter
+    bq::string category_prefixes;
+    bq::array<uint64_t> format_hashes;
     bool show_help = false;
     bool show_version = false;
 };
@@ -41,6 +55,10 @@ static void print_version()
     CONSOLE_OUTPUT(bq::log_level::debug, "  compressed file format version:        %" PRIu32 "", bq::appender_file_compressed::format_version);
 }
 
+// how long decode_follow waits before the decoded text is flushed
+static constexpr uint64_t FOLLOW_WAIT_MS = 200;
+static constexpr size_t FOLLOW_OUTPUT_FLUSH_SIZE = 64 * 1024;
+
 static void print_help(const char* prog)
 {
     bq::string output = bq::string("")
@@ -54,6 +72,30 @@ static void print_help(const char* prog)
         + "  -k, --key PATH        RSA private key file generated by ssh-keygen\n"
         + "                        (RSA-2048, PEM format). Example:\n"
         + "                          ssh-keygen -t rsa -b 2048 -m PEM -f private_key\n"
+        + "  -j, --jobs N          Decode with N threads (default: 1). The file is cut into\n"
+        + "                        chunks decoded in parallel, output order is unchanged\n"
+        + "  -f, --follow          Keep decoding logs appended to the file by a running process,\n"
+        + "                        including new segments and rotation to the next indexed file\n"
+        + "                        (name_1.ext, name_2.ext, ...). Runs until interrupted, -j is ignored\n"
+        + "  -m, --merge           Accept several input files and merge them into one timeline\n"
+        + "                        ordered by log time, each line is prefixed with \"[input_path] \".\n"
+        + "                        Every file is decoded by its own thread, -j is ignored\n"
+        + "      --levels L1,L2    Only decode these levels (verbose,debug,info,warning,error,fatal)\n"
+        + "      --categories P1,P2\n"
+        + "                        Only decode categories whose names start with one of the prefixes\n"
+        + "      --thread ID       Only decode logs written by this thread id\n"
+        + "      --begin EPOCH_MS  Skip logs earlier than this epoch in milliseconds\n"
+        + "      --end EPOCH_MS    Skip logs not earlier than this epoch in milliseconds\n"
+        + "      --format-hash H1,H2\n"
+        + "                        Only decode logs whose format string hash is in the list\n"
+        + "                        (decimal or 0x prefixed hex). Filtered logs are never formatted\n"
+        + "      --output-format text|jsonl|csv\n"
+        + "                        jsonl and csv export one record per log with time, level, category,\n"
+        + "                        thread, format string hash, format string and the typed arguments,\n"
+        + "                        instead of the formatted text. Can not be used with --merge\n"
+        + "      --stats           Report the count, stored bytes and rate of each format template\n"
+        + "                        (format string with level and category), the largest first.\n"
+        + "                        Logs are not formatted, filter options apply, -j is ignored\n"
         + "  -h, --help            Show this help and exit\n"
         + "  -V, --version         Show version and supported format versions, then exit\n"
         + "\n\n"
@@ -65,10 +107,56 @@ static void print_help(const char* prog)
         + "Examples:\n"
         + "  " + prog + " input.logcompr\n"
         + "  " + prog + " input.logcompr -o output.txt\n"
-        + "  " + prog + " input.logcompr -k private_key\n";
+        + "  " + prog + " input.logcompr -k private_key\n"
+        + "  " + prog + " input.logcompr -j 8 -o output.txt\n"
+        + "  " + prog + " -f input.logcompr --levels warning,error,fatal\n"
+        + "  " + prog + " -m proc_a_1.logcompr proc_b_1.logcompr proc_b_2.logcompr -o timeline.txt\n"
+        + "  " + prog + " input.logcompr --levels error,fatal --begin 1735689600000\n"
+        + "  " + prog + " input.logcompr -j 8 --output-format jsonl -o output.jsonl\n"
+        + "  " + prog + " input.logcompr --stats --begin 1735689600000\n";
     CONSOLE_OUTPUT(bq::log_level::debug, "%s", output.c_str());
 }
 
+// accepts both "--name value" and "--name=value"
+static bool read_option_value(int32_t argc, char* argv[], int32_t& i, const bq::string& arg, const char* name, bq::string& out_value)
+{
+    const bq::string name_with_equal = bq::string(name) + "=";
+    if (arg.find(name_with_equal, 0) == 0) {
+        out_value = arg.substr(name_with_equal.size());
+        return true;
+    }
+    if (i + 1 >= argc) {
+        CONSOLE_OUTPUT(bq::log_level::error, "error: missing value for %s\n", arg.c_str());
+        return false;
+    }
+    out_value = argv[++i];
+    return true;
+}
+
+static bool parse_uint64(const bq::string& value, uint64_t& out_value)
+{
+    const bq::string trimmed_value = value.trim();
+    char* end = nullptr;
+    out_value = static_cast<uint64_t>(strtoull(trimmed_value.c_str(), &end, 0));
+    if (trimmed_value.is_empty() || !end || *end != '\0') {
+        CONSOLE_OUTPUT(bq::log_level::error, "error: invalid number '%s'\n", value.c_str());
+        return false;
+    }
+    return true;
+}
+
+static bool is_option(const bq::string& arg, const char* name)
+{
+    return arg == name || arg.find(bq::string(name) + "=", 0) == 0;
+}
+
+static bool has_filter(const Options& opt)
+{
+    const bq::log_decode_filter& filter = opt.filter;
+    return filter.level_mask != 0 || !opt.category_prefixes.is_empty() || filter.thread_id != 0
+        || filter.begin_epoch_ms != 0 || filter.end_epoch_ms != 0 || !opt.format_hashes.is_empty();
+}
+
 static bool parse_args(int32_t argc, char* argv[], Options& opt)
 {
     if (argc <= 1) {
@@ -99,18 +187,115 @@ static bool parse_args(int32_t argc, char* argv[], Options& opt)
             opt.private_key_path = argv[++i];
         } else if (arg.find("--key=", 0) == 0) {
             opt.private_key_path = arg.substr(strlen("--key="));
+        } else if (arg == "-j" || arg == "--jobs" || arg.find("--jobs=", 0) == 0) {
+            bq::string value;
+            if (arg.find("--jobs=", 0) == 0) {
+                value = arg.substr(strlen("--jobs="));
+            } else if (i + 1 >= argc) {
+                CONSOLE_OUTPUT(bq::log_level::error, "error: missing value for %s\n", arg.c_str());
+                return false;
+            } else {
+                value = argv[++i];
+            }
+            int32_t jobs = atoi(value.c_str());
+            if (jobs <= 0) {
+                CONSOLE_OUTPUT(bq::log_level::error, "error: invalid thread count '%s'\n", value.c_str());
+                return false;
+            }
+            opt.jobs = static_cast<uint32_t>(jobs);
+        } else if (arg == "-f" || arg == "--follow") {
+            opt.follow = true;
+        } else if (arg == "-m" || arg == "--merge") {
+            opt.merge = true;
+        } else if (arg == "--stats") {
+            opt.stats = true;
+        } else if (is_option(arg, "--levels")) {
+            bq::string value;
+            if (!read_option_value(argc, argv, i, arg, "--levels", value)) {
+                return false;
+            }
+            bq::log_level_bitmap levels;
+            for (const bq::string& level : value.split(",")) {
+                levels.add_level(level.trim());
+            }
+            opt.filter.level_mask = *levels.get_bitmap_ptr();
+            if (opt.filter.level_mask == 0) {
+                CONSOLE_OUTPUT(bq::log_level::error, "error: invalid levels '%s'\n", value.c_str());
+                return false;
+            }
+        } else if (is_option(arg, "--categories")) {
+            if (!read_option_value(argc, argv, i, arg, "--categories", opt.category_prefixes)) {
+                return false;
+            }
+        } else if (is_option(arg, "--thread")) {
+            bq::string value;
+            if (!read_option_value(argc, argv, i, arg, "--thread", value) || !parse_uint64(value, opt.filter.thread_id)) {
+                return false;
+            }
+        } else if (is_option(arg, "--begin")) {
+            bq::string value;
+            if (!read_option_value(argc, argv, i, arg, "--begin", value) || !parse_uint64(value, opt.filter.begin_epoch_ms)) {
+                return false;
+            }
+        } else if (is_option(arg, "--end")) {
+            bq::string value;
+            if (!read_option_value(argc, argv, i, arg, "--end", value) || !parse_uint64(value, opt.filter.end_epoch_ms)) {
+                return false;
+            }
+        } else if (is_option(arg, "--format-hash")) {
+            bq::string value;
+            if (!read_option_value(argc, argv, i, arg, "--format-hash", value)) {
+                return false;
+            }
+            for (const bq::string& hash_str : value.split(",")) {
+                uint64_t hash;
+                if (!parse_uint64(hash_str, hash)) {
+                    return false;
+                }
+                opt.format_hashes.push_back(hash);
+            }
+        } else if (is_option(arg, "--output-format")) {
+            bq::string value;
+            if (!read_option_value(argc, argv, i, arg, "--output-format", value)) {
+                return false;
+            }
+            if (value == "text") {
+                opt.output_format = bq::log_decode_output_format::text;
+            } else if (value == "jsonl") {
+                opt.output_format = bq::log_decode_output_format::json_lines;
+            } else if (value == "csv") {
+                opt.output_format = bq::log_decode_output_format::csv;
+            } else {
+                CONSOLE_OUTPUT(bq::log_level::error, "error: invalid output format '%s', expected text, jsonl or csv\n", value.c_str());
+                return false;
+            }
         } else if (!arg.is_empty() && arg[0] == '-') {
             CONSOLE_OUTPUT(bq::log_level::error, "error: unknown option '%s'\n", arg.c_str());
             return false;
         } else {
-            if (!opt.input_path.is_empty()) {
-                CONSOLE_OUTPUT(bq::log_level::error, "error: multiple input files provided: '%s' and '%s'\n",
-                    opt.input_path.c_str(), arg.c_str());
-                return false;
+            if (opt.input_path.is_empty()) {
+                opt.input_path = arg;
             }
-            opt.input_path = arg;
+            opt.merge_paths.push_back(arg);
         }
     }
+    if (!opt.merge && opt.merge_paths.size() > 1) {
+        CONSOLE_OUTPUT(bq::log_level::error, "error: multiple input files provided: '%s' and '%s', use --merge to merge them\n",
+            opt.merge_paths[0].c_str(), opt.merge_paths[1].c_str());
+        return false;
+    }
+    if (opt.merge && opt.follow) {
+        CONSOLE_OUTPUT(bq::log_level::error, "error: --merge and --follow can not be used together\n");
+        return false;
+    }
+    if (opt.merge && opt.output_format != bq::log_decode_output_format::text) {
+        CONSOLE_OUTPUT(bq::log_level::error, "error: --output-format can not be used with --merge\n");
+        return false;
+    }
+    if (opt.stats && (opt.merge || opt.follow || opt.output_format != bq::log_decode_output_format::text)) {
+        CONSOLE_OUTPUT(bq::log_level::error, "error: --stats can not be used with --merge, --follow or --output-format\n");
+        return false;
+    }
     if (!opt.show_help && !opt.show_version && opt.input_path.is_empty()) {
         CONSOLE_OUTPUT(bq::log_level::error, "error: missing required <input_log_file>\n");
         return false;
@@ -128,6 +313,190 @@ static bool looks_like_pem_pkcs1(const bq::string& key)
     return key.find("BEGIN RSA PRIVATE KEY") != bq::string::npos;
 }
 
+static void write_to_stdout(const char* text, size_t len, void* user_data)
+{
+    (void)user_data;
+    fwrite(text, 1, len, stdout);
+}
+
+static void write_to_file(const char* text, size_t len, void* user_data)
+{
+    bq::file_manager::instance().write_file(*static_cast<bq::file_handle*>(user_data), text, len);
+}
+
+// the returned filter points into opt, nullptr if there is no filter option
+static const bq::log_decode_filter* build_filter(const Options& opt, bq::log_decode_filter& out_filter)
+{
+    if (!has_filter(opt)) {
+        return nullptr;
+    }
+    out_filter = opt.filter;
+    out_filter.category_prefixes = opt.category_prefixes.is_empty() ? nullptr : opt.category_prefixes.c_str();
+    out_filter.format_hashes = opt.format_hashes.is_empty() ? nullptr : &opt.format_hashes[0];
+    out_filter.format_hash_count = static_cast<uint32_t>(opt.format_hashes.size());
+    return &out_filter;
+}
+
+static bool open_output_file(const bq::string& output_path, bq::file_handle& out_handle)
+{
+    out_handle = bq::file_manager::instance().open_file(output_path, bq::file_open_mode_enum::auto_create | bq::file_open_mode_enum::read_write);
+    if (!out_handle) {
+        CONSOLE_OUTPUT(bq::log_level::error, "error: create output file failed: %s", output_path.c_str());
+        return false;
+    }
+    bq::file_manager::instance().seek(out_handle, bq::file_manager::seek_option::end, 0);
+    return true;
+}
+
+// the first line of a csv output
+static bq::string get_output_header(const Options& opt)
+{
+    if (opt.output_format != bq::log_decode_output_format::csv) {
+        return "";
+    }
+    return bq::string(bq::log_entry_exporter::CSV_HEADER) + "\n";
+}
+
+static int32_t decode_follow(const Options& opt, const bq::string& priv_key_str)
+{
+    bq::log_decode_filter filter;
+    bq::tools::log_decoder decoder(opt.input_path, priv_key_str, build_filter(opt, filter));
+    decoder.set_output_format(opt.output_format);
+    bq::file_handle output_handle;
+    if (!opt.output_path.is_empty() && !open_output_file(TO_ABSOLUTE_PATH(opt.output_path, 1), output_handle)) {
+        return 1;
+    }
+    bq::string text = get_output_header(opt);
+    while (true) {
+        auto result = decoder.decode_follow(FOLLOW_WAIT_MS);
+        if (result == bq::appender_decode_result::success) {
+            text += decoder.get_last_decoded_log_entry();
+            text.push_back('\n');
+            if (text.size() < FOLLOW_OUTPUT_FLUSH_SIZE) {
+                continue;
+            }
+        }
+        // flush when the decoder is idle, so new logs show up promptly
+        if (output_handle) {
+            write_to_file(text.c_str(), text.size(), &output_handle);
+            bq::file_manager::instance().flush_file(output_handle);
+        } else {
+            write_to_stdout(text.c_str(), text.size(), nullptr);
+            fflush(stdout);
+        }
+        text.clear();
+        if (result != bq::appender_decode_result::success && result != bq::appender_decode_result::eof) {
+            CONSOLE_OUTPUT(bq::log_level::error, "error: decode failed, reason:%" PRId32 "", static_cast<int32_t>(result));
+            return -1 * static_cast<int32_t>(result);
+        }
+    }
+}
+
+static int32_t decode_merged(const Options& opt, const bq::string& priv_key_str)
+{
+    bq::appender_decoder_merge decoder;
+    bq::log_decode_filter filter;
+    decoder.set_filter(build_filter(opt, filter));
+    // the paths as typed are short and tell the files apart
+    const bq::array<bq::string>& tags = opt.merge_paths;
+    bq::appender_decode_result result;
+    if (opt.output_path.is_empty()) {
+        result = decoder.decode(opt.merge_paths, tags, priv_key_str, &write_to_stdout, nullptr);
+        fflush(stdout);
+    } else {
+        bq::string output_path = TO_ABSOLUTE_PATH(opt.output_path, 1);
+        bq::file_handle output_handle;
+        if (!open_output_file(output_path, output_handle)) {
+            return 1;
+        }
+        result = decoder.decode(opt.merge_paths, tags, priv_key_str, &write_to_file, &output_handle);
+        bq::file_manager::instance().flush_file(output_handle);
+        if (result == bq::appender_decode_result::eof) {
+            CONSOLE_OUTPUT(bq::log_level::info, "Successfully decoded! see output:%s", output_path.c_str());
+        }
+    }
+    if (result != bq::appender_decode_result::eof) {
+        CONSOLE_OUTPUT(bq::log_level::error, "error: decode failed, reason:%" PRId32 "", static_cast<int32_t>(result));
+        return -1 * static_cast<int32_t>(result);
+    }
+    return 0;
+}
+
+static int32_t decode_stats(const Options& opt, const bq::string& priv_key_str)
+{
+    bq::unique_ptr<bq::appender_decoder_base> decoder;
+    bq::appender_decode_result result = bq::appender_decoder_manager::open_decoder(opt.input_path, priv_key_str, decoder);
+    bq::log_template_stats stats;
+    if (result == bq::appender_decode_result::success) {
+        bq::log_decode_filter filter_tmp;
+        const bq::log_decode_filter* filter = build_filter(opt, filter_tmp);
+        if (filter) {
+            decoder->set_filter(*filter);
+        }
+        decoder->set_template_stats(&stats);
+        // eof from seek_to_time means nothing is inside the time range.
+        if (filter && filter->begin_epoch_ms > 0) {
+            result = decoder->seek_to_time(filter->begin_epoch_ms);
+        }
+        if (result == bq::appender_decode_result::success) {
+            // every entry is counted, decode() only returns at the end of the file or on error
+            result = decoder->decode();
+        }
+    }
+    if (result != bq::appender_decode_result::eof) {
+        CONSOLE_OUTPUT(bq::log_level::error, "error: decode failed, reason:%" PRId32 "", static_cast<int32_t>(result));
+        return -1 * static_cast<int32_t>(result);
+    }
+    bq::string report;
+    stats.make_report(decoder->get_category_names(), report);
+    if (opt.output_path.is_empty()) {
+        write_to_stdout(report.c_str(), report.size(), nullptr);
+        fflush(stdout);
+        return 0;
+    }
+    bq::string output_path = TO_ABSOLUTE_PATH(opt.output_path, 1);
+    bq::file_handle output_handle;
+    if (!open_output_file(output_path, output_handle)) {
+        return 1;
+    }
+    write_to_file(report.c_str(), report.size(), &output_handle);
+    bq::file_manager::instance().flush_file(output_handle);
+    CONSOLE_OUTPUT(bq::log_level::info, "Successfully decoded! see output:%s", output_path.c_str());
+    return 0;
+}
+
+static int32_t decode_in_parallel(const Options& opt, const bq::string& priv_key_str)
+{
+    bq::appender_decoder_parallel decoder(opt.jobs);
+    bq::log_decode_filter filter;
+    decoder.set_filter(build_filter(opt, filter));
+    decoder.set_output_format(opt.output_format);
+    const bq::string header = get_output_header(opt);
+    bq::appender_decode_result result;
+    if (opt.output_path.is_empty()) {
+        write_to_stdout(header.c_str(), header.size(), nullptr);
+        result = decoder.decode(opt.input_path, priv_key_str, &write_to_stdout, nullptr);
+        fflush(stdout);
+    } else {
+        bq::string output_path = TO_ABSOLUTE_PATH(opt.output_path, 1);
+        bq::file_handle output_handle;
+        if (!open_output_file(output_path, output_handle)) {
+            return 1;
+        }
+        write_to_file(header.c_str(), header.size(), &output_handle);
+        result = decoder.decode(opt.input_path, priv_key_str, &write_to_file, &output_handle);
+        bq::file_manager::instance().flush_file(output_handle);
+        if (result == bq::appender_decode_result::eof) {
+            CONSOLE_OUTPUT(bq::log_level::info, "Successfully decoded! see output:%s", output_path.c_str());
+        }
+    }
+    if (result != bq::appender_decode_result::eof) {
+        CONSOLE_OUTPUT(bq::log_level::error, "error: decode failed, reason:%" PRId32 "", static_cast<int32_t>(result));
+        return -1 * static_cast<int32_t>(result);
+    }
+    return 0;
+}
+
 #if defined(WIN32)
 // Convert wide string to UTF-8
 static bq::string wchar_to_utf8(const wchar_t* wstr)
@@ -211,6 +580,19 @@ int32_t main(int32_t argc, char* argv[])
         }
     }
 
+    if (opt.stats) {
+        return decode_stats(opt, priv_key_str);
+    }
+    if (opt.follow) {
+        return decode_follow(opt, priv_key_str);
+    }
+    if (opt.merge) {
+        return decode_merged(opt, priv_key_str);
+    }
+    if (opt.jobs > 1 || has_filter(opt) || opt.output_format != bq::log_decode_output_format::text) {
+        return decode_in_parallel(opt, priv_key_str);
+    }
+
     if (!opt.output_path.is_empty()) {
         bool ret = bq::tools::log_decoder::decode_file(opt.input_path, opt.output_path, priv_key_str);
         if (!ret) {
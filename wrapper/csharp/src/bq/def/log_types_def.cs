@@ -97,6 +97,15 @@ namespace bq.def
         public uint len;
     }
 
+    [StructLayout(LayoutKind.Sequential)]
+    public struct log_decode_entry_info
+    {
+        public ulong epoch_ms;
+        public ulong thread_id;
+        public uint category_idx;
+        public uint level;
+    }
+
     [UnmanagedFunctionPointer(CallingConvention.StdCall, CharSet = CharSet.Unicode)]
     public unsafe delegate void type_func_ptr_console_callback(ulong log_id, int category_idx, bq.def.log_level log_level,sbyte* content, int length);
     
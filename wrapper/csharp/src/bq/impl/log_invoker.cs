@@ -80,11 +80,14 @@ namespace bq.impl
         public unsafe static extern sbyte* __api_get_file_base_dir(int base_dir_type);
         
         [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl,CharSet = CharSet.Unicode)]
-        public unsafe static extern bq.tools.log_decoder.appender_decode_result __api_log_decoder_create(byte* log_file_path_utf8, byte* priv_key_utf8, uint* out_handle);
+        public unsafe static extern bq.tools.log_decoder.appender_decode_result __api_log_decoder_create(byte* log_file_path_utf8, byte* priv_key_utf8, void* filter, uint* out_handle);
 
         [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl,CharSet = CharSet.Unicode)]
         public unsafe static extern bq.tools.log_decoder.appender_decode_result __api_log_decoder_decode(uint handle, bq.def._api_string_def* out_decoded_log_text);
 
+        [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl,CharSet = CharSet.Unicode)]
+        public unsafe static extern bq.tools.log_decoder.appender_decode_result __api_log_decoder_decode_batch(uint handle, byte* text_buffer, uint text_buffer_size, uint* out_text_offsets, bq.def.log_decode_entry_info* out_entries, uint max_entry_count, uint* out_entry_count);
+
         [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl,CharSet = CharSet.Unicode)]
         public unsafe static extern void __api_log_decoder_destroy(uint handle);
 
@@ -28,6 +28,10 @@ namespace bq.tools
         private string decode_text_ = "";
         private appender_decode_result result_ = appender_decode_result.success;
         private uint handle_ = 0xFFFFFFFF;
+        private byte[] batch_text_buffer_ = new byte[64 * 1024];
+        private uint[] batch_text_offsets_ = new uint[1];
+        private bq.def.log_decode_entry_info[] batch_entries_ = new bq.def.log_decode_entry_info[0];
+        private uint batch_entry_count_ = 0;
 
         public log_decoder(string log_file_absolute_path, string priv_key = "")
         {
@@ -41,7 +45,7 @@ namespace bq.tools
                     fixed (byte* utf8_priv_key_c_str = utf8_priv_key)
                     {
                         uint handle_tmp;
-                        result_ = bq.impl.log_invoker.__api_log_decoder_create(utf8_path_c_str, utf8_priv_key_c_str, & handle_tmp);
+                        result_ = bq.impl.log_invoker.__api_log_decoder_create(utf8_path_c_str, utf8_priv_key_c_str, null, & handle_tmp);
                         if (result_ != appender_decode_result.success)
                         {
                             handle_ = 0xFFFFFFFF;
@@ -83,6 +87,66 @@ namespace bq.tools
             return result_;
         }
 
+        /// <summary>
+        /// Decode up to max_entry_count log entries with one native call, which is much cheaper than calling decode() for each entry.
+        /// Read the entries with get_batch_entry_count() and get_batch_entry(i) afterwards.
+        /// </summary>
+        /// <returns>success if at least one entry is decoded, otherwise the same as decode()</returns>
+        public appender_decode_result decode_batch(uint max_entry_count)
+        {
+            batch_entry_count_ = 0;
+            if (result_ != appender_decode_result.success)
+            {
+                return result_;
+            }
+            max_entry_count = Math.Max(max_entry_count, 1);
+            if (batch_entries_.Length < max_entry_count)
+            {
+                batch_text_offsets_ = new uint[max_entry_count + 1];
+                batch_entries_ = new bq.def.log_decode_entry_info[max_entry_count];
+            }
+            while (true)
+            {
+                uint entry_count = 0;
+                unsafe
+                {
+                    fixed (byte* text_buffer = batch_text_buffer_)
+                    fixed (uint* text_offsets = batch_text_offsets_)
+                    fixed (bq.def.log_decode_entry_info* entries = batch_entries_)
+                    {
+                        result_ = log_invoker.__api_log_decoder_decode_batch(handle_, text_buffer, (uint)batch_text_buffer_.Length, text_offsets, entries, max_entry_count, &entry_count);
+                    }
+                }
+                if (result_ != appender_decode_result.success)
+                {
+                    return result_;
+                }
+                if (entry_count == 0)
+                {
+                    //the next entry is larger than the text buffer.
+                    batch_text_buffer_ = new byte[Math.Max(batch_text_offsets_[1], (uint)batch_text_buffer_.Length * 2)];
+                    continue;
+                }
+                batch_entry_count_ = entry_count;
+                return result_;
+            }
+        }
+
+        public uint get_batch_entry_count()
+        {
+            return batch_entry_count_;
+        }
+
+        public string get_batch_entry(uint index)
+        {
+            return System.Text.Encoding.UTF8.GetString(batch_text_buffer_, (int)batch_text_offsets_[index], (int)(batch_text_offsets_[index + 1] - batch_text_offsets_[index]));
+        }
+
+        public bq.def.log_decode_entry_info get_batch_entry_info(uint index)
+        {
+            return batch_entries_[index];
+        }
+
         public appender_decode_result get_last_decode_result()
         { 
             return result_;
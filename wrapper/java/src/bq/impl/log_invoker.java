@@ -53,6 +53,13 @@ public class log_invoker {
 
 	public static native int __api_log_decoder_decode(long handle, bq.def.string_holder out_decoded_text);
 
+	/**
+	 * decode up to max_entry_count log entries, the text of entry i is text_buffer[text_offsets[i], text_offsets[i + 1]) in UTF-8.
+	 * @return count of entries decoded, or -(appender_decode_result) on failure.
+	 * if it returns 0, text_offsets[1] is the text_buffer size needed by the next entry.
+	 */
+	public static native int __api_log_decoder_decode_batch(long handle, byte[] text_buffer, int[] text_offsets, long[] epoch_ms, long[] thread_ids, int[] category_indices, int[] levels, int max_entry_count);
+
 	public static native void __api_log_decoder_destroy(long handle);
 	
 	public static native boolean __api_log_decode(String in_file_path, String out_file_path, String priv_key);
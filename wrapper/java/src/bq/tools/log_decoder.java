@@ -31,6 +31,14 @@ public class log_decoder implements AutoCloseable {
     private appender_decode_result result_ = appender_decode_result.success;
     private long handle_ = 0;
 
+    private byte[] batch_text_buffer_ = new byte[64 * 1024];
+    private int[] batch_text_offsets_ = new int[1];
+    private long[] batch_epoch_ms_ = new long[0];
+    private long[] batch_thread_ids_ = new long[0];
+    private int[] batch_category_indices_ = new int[0];
+    private int[] batch_levels_ = new int[0];
+    private int batch_entry_count_ = 0;
+
     public log_decoder(String log_file_absolute_path)
     {
         long create_result = log_invoker.__api_log_decoder_create(log_file_absolute_path, "");
@@ -73,6 +81,76 @@ public class log_decoder implements AutoCloseable {
         return result_;
     }
 
+    /**
+     * Decode up to max_entry_count log entries with one native call, which is much cheaper than calling decode() for each entry.
+     * Read the entries with get_batch_entry_count() and get_batch_entry(i) afterwards.
+     * @return success if at least one entry is decoded, otherwise the same as decode().
+     */
+    public appender_decode_result decode_batch(int max_entry_count)
+    {
+        batch_entry_count_ = 0;
+        if(result_ != appender_decode_result.success)
+        {
+            return result_;
+        }
+        max_entry_count = Math.max(max_entry_count, 1);
+        if(batch_levels_.length < max_entry_count)
+        {
+            batch_text_offsets_ = new int[max_entry_count + 1];
+            batch_epoch_ms_ = new long[max_entry_count];
+            batch_thread_ids_ = new long[max_entry_count];
+            batch_category_indices_ = new int[max_entry_count];
+            batch_levels_ = new int[max_entry_count];
+        }
+        while(true)
+        {
+            int decode_result = log_invoker.__api_log_decoder_decode_batch(handle_, batch_text_buffer_, batch_text_offsets_, batch_epoch_ms_, batch_thread_ids_, batch_category_indices_, batch_levels_, max_entry_count);
+            if(decode_result < 0)
+            {
+                result_ = appender_decode_result.from_int(-decode_result);
+                return result_;
+            }
+            if(decode_result == 0)
+            {
+                //the next entry is larger than the text buffer.
+                batch_text_buffer_ = new byte[Math.max(batch_text_offsets_[1], batch_text_buffer_.length * 2)];
+                continue;
+            }
+            batch_entry_count_ = decode_result;
+            return appender_decode_result.success;
+        }
+    }
+
+    public int get_batch_entry_count()
+    {
+        return batch_entry_count_;
+    }
+
+    public String get_batch_entry(int index)
+    {
+        return new String(batch_text_buffer_, batch_text_offsets_[index], batch_text_offsets_[index + 1] - batch_text_offsets_[index], java.nio.charset.StandardCharsets.UTF_8);
+    }
+
+    public long get_batch_entry_epoch_ms(int index)
+    {
+        return batch_epoch_ms_[index];
+    }
+
+    public long get_batch_entry_thread_id(int index)
+    {
+        return batch_thread_ids_[index];
+    }
+
+    public int get_batch_entry_category_idx(int index)
+    {
+        return batch_category_indices_[index];
+    }
+
+    public log_level get_batch_entry_level(int index)
+    {
+        return log_level.values()[batch_levels_[index]];
+    }
+
     public appender_decode_result get_last_decode_result()
     {
         return result_;
@@ -104,6 +104,17 @@ export class log_invoker {
         return obj?.code ?? 0;
     }
 
+    public static __api_log_decoder_decode_batch(handle: number, max_entry_count: number): {
+        code: number;
+        texts: string[];
+        epochs: number[];
+        thread_ids: bigint[];
+        category_indices: number[];
+        levels: number[];
+    } {
+        return native_export("log_decoder_decode_batch")(handle, max_entry_count);
+    }
+
     public static __api_attach_decoder_inst(decoder_inst: any): void {
         native_export("attach_decoder_inst")(decoder_inst, decoder_inst['handle_']);
     }
@@ -25,6 +25,11 @@ export class log_decoder {
     private decode_text_: string_holder = new string_holder();
     private result_: appender_decode_result = appender_decode_result.success;
     private handle_: number = 0xFFFFFFFF;
+    private batch_texts_: string[] = [];
+    private batch_epochs_: number[] = [];
+    private batch_thread_ids_: bigint[] = [];
+    private batch_category_indices_: number[] = [];
+    private batch_levels_: number[] = [];
 
     public constructor(log_file_absolute_path: string, priv_key?: string) {
         let create_result = log_invoker.__api_log_decoder_create(log_file_absolute_path, priv_key);
@@ -46,6 +51,56 @@ export class log_decoder {
         return this.result_;
     }
 
+    /**
+     * Decode up to max_entry_count log entries with one native call, which is much cheaper than calling decode() for each entry.
+     * Read the entries with get_batch_entry_count() and get_batch_entry(i) afterwards.
+     * @returns success if at least one entry is decoded, otherwise the same as decode().
+     */
+    public decode_batch(max_entry_count: number): appender_decode_result {
+        this.batch_texts_ = [];
+        this.batch_epochs_ = [];
+        this.batch_thread_ids_ = [];
+        this.batch_category_indices_ = [];
+        this.batch_levels_ = [];
+        if (this.result_ != appender_decode_result.success) {
+            return this.result_;
+        }
+        const batch = log_invoker.__api_log_decoder_decode_batch(this.handle_, max_entry_count);
+        this.result_ = batch.code as appender_decode_result;
+        if (this.result_ == appender_decode_result.success) {
+            this.batch_texts_ = batch.texts;
+            this.batch_epochs_ = batch.epochs;
+            this.batch_thread_ids_ = batch.thread_ids;
+            this.batch_category_indices_ = batch.category_indices;
+            this.batch_levels_ = batch.levels;
+        }
+        return this.result_;
+    }
+
+    public get_batch_entry_count(): number {
+        return this.batch_texts_.length;
+    }
+
+    public get_batch_entry(index: number): string {
+        return this.batch_texts_[index];
+    }
+
+    public get_batch_entry_epoch_ms(index: number): number {
+        return this.batch_epochs_[index];
+    }
+
+    public get_batch_entry_thread_id(index: number): bigint {
+        return this.batch_thread_ids_[index];
+    }
+
+    public get_batch_entry_category_idx(index: number): number {
+        return this.batch_category_indices_[index];
+    }
+
+    public get_batch_entry_level(index: number): number {
+        return this.batch_levels_[index];
+    }
+
     public get_last_decode_result(): appender_decode_result {
         return this.result_;
     }